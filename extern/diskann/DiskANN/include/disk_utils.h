@@ -28,6 +28,7 @@ typedef int FileHandle;
 #include "cached_io.h"
 #include "common_includes.h"
 
+#include "sector_layout.h"
 #include "utils.h"
 #include "windows_customizations.h"
 
@@ -84,6 +85,36 @@ DISKANN_DLLEXPORT int build_merged_vamana_index(std::string base_file, diskann::
                                                 const std::string &labels_to_medoids_file = std::string(""),
                                                 const std::string &universal_label = "", const uint32_t Lf = 0);
 
+// builds the vamana graph of data in overlapping kmeans shards whose graphs fit in ram_budget bytes, then merges
+// them into graph_stream in the Index::save format; the finished shard graphs are kept in temporary files under
+// spill_dir (the system temp directory when empty). Returns the locations skipped for duplicated tags
+template <typename T, typename TagT>
+DISKANN_DLLEXPORT std::vector<size_t> build_partitioned_vamana_index(
+    const T *data, size_t npts, size_t ndims, const std::vector<TagT> &tags, diskann::Metric compareMetric, uint32_t L,
+    uint32_t R, double sampling_rate, double ram_budget, uint32_t num_threads, std::stringstream &graph_stream,
+    std::stringstream &tag_stream, const std::string &spill_dir = "");
+
+// splits data into min_parts (3 when 0) overlapping kmeans shards, adding parts until the largest shard graph of
+// degree 2R/3 fits in ram_budget bytes (unbounded when ram_budget is 0); shard ids index valid_locs, the kept
+// non-duplicated locations
+template <typename T, typename TagT>
+DISKANN_DLLEXPORT std::vector<size_t> partition_vamana_shards(const T *data, size_t npts, size_t ndims,
+                                                              const std::vector<TagT> &tags, uint32_t R,
+                                                              double sampling_rate, double ram_budget, size_t min_parts,
+                                                              std::vector<uint32_t> &valid_locs,
+                                                              std::vector<std::vector<uint32_t>> &shard_ids);
+
+// builds the vamana graph of degree R of one shard into shard_graph in the Index::save format
+template <typename T, typename TagT>
+DISKANN_DLLEXPORT void build_vamana_shard(const T *data, size_t ndims, const std::vector<uint32_t> &valid_locs,
+                                          const std::vector<uint32_t> &shard, diskann::Metric compareMetric,
+                                          uint32_t L, uint32_t R, uint32_t num_threads, std::stringstream &shard_graph);
+
+// merges the shard graphs into graph_stream, empty shards are expected to have empty graphs
+DISKANN_DLLEXPORT void merge_vamana_shards(const std::vector<std::vector<uint32_t>> &shard_ids,
+                                           std::vector<std::unique_ptr<std::iostream>> &shard_graphs,
+                                           size_t num_points, uint32_t R, std::stringstream &graph_stream);
+
 template <typename T, typename LabelT>
 DISKANN_DLLEXPORT uint32_t optimize_beamwidth(std::unique_ptr<diskann::PQFlashIndex<T, LabelT>> &_pFlashIndex,
                                               T *tuning_sample, uint64_t tuning_sample_num,
@@ -106,5 +137,6 @@ DISKANN_DLLEXPORT void create_disk_layout(const std::string base_file, const std
                                           const std::string reorder_data_file = std::string(""));
 template <typename T>
 void create_disk_layout(const T *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::stringstream &vamana_reader,
-                        std::stringstream &diskann_writer, size_t sector_len, diskann::Metric metric);
+                        std::stringstream &diskann_writer, size_t sector_len, diskann::Metric metric,
+                        SectorVectorType vector_type = SectorVectorType::FP32);
 } // namespace diskann
@@ -17,7 +17,8 @@ enum class IOErrorCode;
 
 typedef std::function<void(vsag::IOErrorCode code, const std::string& message)> CallBack;
 typedef std::vector<std::tuple<uint64_t, uint64_t, void*>> batch_request;
-typedef std::function<void(batch_request, bool, CallBack)> reader_function;
+// returns the number of requests served by reads already in flight for other queries
+typedef std::function<uint64_t(batch_request, bool, CallBack)> reader_function;
 
 struct AlignedRead
 {
@@ -51,7 +52,8 @@ public:
 
     // process batch of aligned requests in parallel
     // NOTE :: blocking call
-    void read(std::vector<AlignedRead> &read_reqs, bool async = false, CallBack callBack = nullptr);
+    // returns the number of requests that shared a read already in flight
+    uint64_t read(std::vector<AlignedRead> &read_reqs, bool async = false, CallBack callBack = nullptr);
 };
 
 
@@ -18,6 +18,9 @@ namespace vsag {
 
 typedef void (*PQDistanceFunc)(const void* single_dim_centers, float single_dim_val, void* result);
 
+typedef void (*PQDistanceLookupBatchFunc)(const uint8_t* codes, uint64_t count, uint64_t chunks, const float* tables,
+                                          float* result);
+
 }
 
 namespace diskann
@@ -59,6 +62,10 @@ class FixedChunkPQTable
     // assumes no rotation is involved
     void inflate_vector(uint8_t *base_vec, float *out_vec);
 
+    // picks the nearest center of every chunk, the vector is centered and rotated like a query.
+    // Returns the squared quantization error
+    float encode_vector(const float *vec, uint8_t *code);
+
     void populate_chunk_inner_products(const float *query_vec, float *dist_vec);
 
     void load_pq_centroid_bin(std::stringstream &pq_table, size_t num_chunks);
@@ -4,6 +4,11 @@
 #pragma once
 #include "common_includes.h"
 
+#include <functional>
+#include <limits>
+#include <map>
+#include <unordered_set>
+
 #include "local_file_reader.h"
 #include "concurrent_queue.h"
 #include "neighbor.h"
@@ -13,10 +18,13 @@
 #include "utils.h"
 #include "windows_customizations.h"
 #include "scratch.h"
+#include "sector_layout.h"
 #include "tsl/robin_map.h"
 #include "tsl/robin_set.h"
 
 #define FULL_PRECISION_REORDER_MULTIPLIER 3
+// a pipelined search gives up if no sector read completes within this many milliseconds
+#define PIPELINE_IO_TIMEOUT_MS 10000
 
 namespace diskann
 {
@@ -24,6 +32,33 @@ namespace diskann
 template <typename T, typename LabelT = uint32_t> class PQFlashIndex
 {
   public:
+    // reads and writes of the disk layout during a merge, offsets and lengths are in bytes
+    using LayoutReadFunc = std::function<void(uint64_t offset, uint64_t len, void *dest)>;
+    using LayoutWriteFunc = std::function<void(uint64_t offset, uint64_t len, const void *src)>;
+
+    // the tag of a location that a merge freed and no insert has taken over yet
+    static constexpr LabelT FREE_LOCATION_TAG = std::numeric_limits<LabelT>::max();
+
+    // everything a merge changes, computed by plan_merge and published by apply_merge
+    struct MergePlan
+    {
+        // patched sectors by sector number, only the touched ones
+        std::map<uint64_t, std::unique_ptr<char[]>> sectors;
+        // locations whose node record changed
+        std::vector<uint32_t> touched;
+        // new tags, pq codes and bsa errors of reassigned locations
+        std::unordered_map<uint32_t, LabelT> tags;
+        std::unordered_map<uint32_t, std::vector<uint8_t>> codes;
+        std::unordered_map<uint32_t, float> errors;
+        // tags of the inserts that got a location, the others found none
+        std::vector<LabelT> placed;
+        uint64_t num_points = 0;
+        uint64_t num_free_points = 0;
+        uint32_t medoid = 0;
+        std::vector<float> medoid_coords;
+        uint64_t ext_start_sector = 0;
+    };
+
     DISKANN_DLLEXPORT PQFlashIndex(std::shared_ptr<LocalFileReader> &fileReader, diskann::Metric m, size_t len, size_t dim, bool use_bsa = false);
     DISKANN_DLLEXPORT ~PQFlashIndex();
 
@@ -51,8 +86,22 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
     DISKANN_DLLEXPORT size_t load_graph(std::stringstream &in);
 
 
+    // replaces the node cache with the given nodes, reading their sectors through the reader
     DISKANN_DLLEXPORT void load_cache_list(std::vector<uint32_t> &node_list);
 
+    DISKANN_DLLEXPORT void clear_cache();
+
+    DISKANN_DLLEXPORT void get_cache_list(std::vector<uint32_t> &node_list);
+
+    // memory taken by one cached node, used to turn a byte budget into a node count
+    DISKANN_DLLEXPORT uint64_t get_cached_node_size();
+
+    // replays in-memory sample queries on the disk path and returns the most visited nodes
+    DISKANN_DLLEXPORT void generate_cache_list_from_queries(const T *queries, uint64_t query_num, uint64_t l_search,
+                                                            uint64_t beam_width, uint32_t io_limit,
+                                                            uint64_t num_nodes_to_cache,
+                                                            std::vector<uint32_t> &node_list);
+
 #ifdef EXEC_ENV_OLS
     DISKANN_DLLEXPORT void generate_cache_list_from_sample_queries(MemoryMappedFiles &files, std::string sample_bin,
                                                                    uint64_t l_search, uint64_t beamwidth,
@@ -68,11 +117,24 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
     DISKANN_DLLEXPORT void cache_bfs_levels(uint64_t num_nodes_to_cache, std::vector<uint32_t> &node_list,
                                             const bool shuffle = false);
 
+    // nodes rejected by filter are not read unless the search has to expand through them, entry_points are
+    // searched from besides the medoid. use_reorder_data reranks the closest candidates of a compact layout with
+    // their full-precision vectors
     DISKANN_DLLEXPORT int64_t cached_beam_search(const T *query, const uint64_t k_search, const uint64_t l_search,
                                               uint64_t *res_ids, float *res_dists, const uint64_t beam_width,
                                               std::function<bool(int64_t)> filter,
                                               const uint32_t io_limit, const bool use_reorder_data = false,
-                                              QueryStats *stats = nullptr);
+                                              QueryStats *stats = nullptr,
+                                              const std::vector<uint32_t> &entry_points = {});
+    // keeps up to beam_width sector reads in flight through the async reader and expands each
+    // node as soon as its sector arrives, instead of waiting for the whole beam
+    DISKANN_DLLEXPORT int64_t cached_beam_search_pipeline(const T *query, const uint64_t k_search,
+                                                          const uint64_t l_search, uint64_t *indices,
+                                                          float *distances, const uint64_t beam_width,
+                                                          std::function<bool(int64_t)> filter,
+                                                          const uint32_t io_limit, const bool use_reorder_data = false,
+                                                          QueryStats *stats = nullptr,
+                                                          const std::vector<uint32_t> &entry_points = {});
     DISKANN_DLLEXPORT int64_t cached_beam_search_memory(const T *query, const uint64_t k_search, const uint64_t l_search,
                                               uint64_t *indices, float *distances, const uint64_t beam_width,
                                               std::function<bool(int64_t)> filter,
@@ -91,12 +153,41 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
                                            std::vector<float> &distances, const uint64_t min_beam_width,
                                            uint32_t io_limit,  const bool reorder,
                                            std::function<bool(int64_t)> filter, bool memory,
-                                           QueryStats *stats = nullptr);
+                                           QueryStats *stats = nullptr,
+                                           const std::vector<uint32_t> &entry_points = {});
 
     DISKANN_DLLEXPORT uint64_t get_data_dim();
 
     DISKANN_DLLEXPORT uint64_t get_data_num();
 
+    // tag of every location, get_data_num() entries
+    DISKANN_DLLEXPORT const LabelT *get_tags();
+
+    // reads the stored full-precision vectors of the given locations into vectors (count * data_dim)
+    DISKANN_DLLEXPORT void read_vectors(const uint32_t *locations, uint64_t count, T *vectors);
+
+    // locations freed by merges that are still waiting for an insert
+    DISKANN_DLLEXPORT uint64_t get_free_num();
+
+    // merges deletes and inserts into the disk layout in place, in the spirit of FreshDiskANN's
+    // StreamingMerge: nodes pointing at a deleted location take over its neighbors, inserts reuse
+    // the freed locations or are appended, and are linked by a greedy search plus backward edges.
+    // Only the index is read, searches may run meanwhile. layout_size is the current size of the
+    // layout in bytes, read_layout should read inline rather than through the search reader
+    DISKANN_DLLEXPORT MergePlan plan_merge(const std::unordered_set<LabelT> &deleted_tags, const LabelT *insert_tags,
+                                           const float *insert_vectors, uint64_t insert_num, uint64_t l_search,
+                                           float alpha, uint64_t layout_size, const LayoutReadFunc &read_layout);
+
+    // writes the patched sectors in ascending order and publishes the in-memory changes, no search
+    // may run meanwhile
+    DISKANN_DLLEXPORT void apply_merge(MergePlan &plan, const LayoutWriteFunc &write_layout);
+
+    // the tag, compressed vector and graph files of the current state, as load_from_separate_paths and
+    // load_graph expect them
+    DISKANN_DLLEXPORT void save_tags(std::stringstream &out);
+    DISKANN_DLLEXPORT void save_compressed_vectors(std::stringstream &out);
+    DISKANN_DLLEXPORT void save_graph(std::stringstream &out);
+
     std::shared_ptr<LocalFileReader> &reader;
 
     DISKANN_DLLEXPORT diskann::Metric get_metric();
@@ -118,6 +209,28 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
     DISKANN_DLLEXPORT void generate_random_labels(std::vector<LabelT> &labels, const uint32_t num_labels,
                                                   const uint32_t nthreads);
 
+    // coords of a node record as floats, decoded into scratch (data_dim) on a compact layout
+    const float *node_coords(const char *node_buf, float *scratch);
+    // nbrs of a node record, unpacked into scratch (max_degree) on a compact layout
+    const uint32_t *node_nhood(const char *node_buf, uint64_t &nnbrs, uint32_t *scratch);
+    // re-scores the closest candidates of a compact layout with their full-precision vectors
+    void rerank_full_precision(const float *query, std::vector<Neighbor> &full_retset, uint64_t k_search,
+                               const std::function<bool(int64_t)> &filter, QueryStats *stats);
+
+    // sector and offset of the node record and of the full-precision vector of a location, locations
+    // from ext_base on live in the extension blocks that merges append at ext_start
+    uint64_t node_sector_no(uint64_t id, uint64_t ext_start) const;
+    uint64_t node_offset(uint64_t id) const;
+    uint64_t vector_sector_no(uint64_t id, uint64_t ext_start) const;
+    uint64_t vector_sector_offset(uint64_t id) const;
+    // sectors of one extension block, a node sector followed by the full-precision vectors of its nodes
+    uint64_t ext_block_sectors() const;
+
+    // alpha pruning of the candidates, sorted by their distance to the node, down to max_degree.
+    // vectors holds the vector of every candidate in the same order
+    void prune_neighbors(const std::vector<Neighbor> &candidates, const float *vectors, float alpha,
+                         std::vector<uint32_t> &pruned);
+
     // index info
     // nhood of node `i` is in sector: [i / nnodes_per_sector]
     // offset in sector: [(i % nnodes_per_sector) * max_node_len]
@@ -198,6 +311,18 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
     bool reorder_data_exists = false;
     uint64_t reoreder_data_offset = 0;
 
+    // compact layouts keep approximate vectors and packed nbr ids in the node records,
+    // the full-precision vectors are in the re-ordering region
+    SectorVectorType sector_vector_type = SectorVectorType::FP32;
+    uint64_t nbr_id_bytes = sizeof(uint32_t);
+    std::unique_ptr<float[]> sq8_params; // [lower][scale] of every dimension
+
+    // locations past what the built layout holds are appended by merges in extension blocks,
+    // ext_start_sector stays 0 until the first one is written. Only set by the stream loader
+    uint64_t ext_base = std::numeric_limits<uint64_t>::max();
+    uint64_t ext_start_sector = 0;
+    uint64_t num_free_points = 0;
+
 
 
     // Graph related data structures
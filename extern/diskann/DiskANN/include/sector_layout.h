@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace diskann
+{
+
+// how the vector of a node record is stored on the disk layout.
+// FP32 keeps the classic record [COORDS(T)][NNBRS][NBR_ID(uint32_t)], the compact types keep an
+// approximate vector and neighbor ids packed into as few bytes as the point count needs, the
+// full-precision vectors then live in a separate region that is only read to rerank the result
+enum class SectorVectorType : uint64_t
+{
+    FP32 = 0,
+    FP16 = 1,
+    SQ8 = 2,
+};
+
+inline uint64_t sector_vector_bytes(SectorVectorType type, uint64_t ndims)
+{
+    switch (type)
+    {
+    case SectorVectorType::FP16:
+        return ndims * sizeof(uint16_t);
+    case SectorVectorType::SQ8:
+        return ndims * sizeof(uint8_t);
+    default:
+        return ndims * sizeof(float);
+    }
+}
+
+// bytes needed to address every location of npts points
+inline uint32_t packed_id_bytes(uint64_t npts)
+{
+    uint32_t bytes = 1;
+    while (bytes < sizeof(uint32_t) && npts > (1ULL << (8 * bytes)))
+    {
+        bytes++;
+    }
+    return bytes;
+}
+
+// ids are packed little-endian, id_bytes each
+inline void pack_ids(const uint32_t *ids, uint64_t count, uint32_t id_bytes, char *out)
+{
+    for (uint64_t i = 0; i < count; i++)
+    {
+        std::memcpy(out + i * id_bytes, ids + i, id_bytes);
+    }
+}
+
+inline void unpack_ids(const char *in, uint64_t count, uint32_t id_bytes, uint32_t *ids)
+{
+    for (uint64_t i = 0; i < count; i++)
+    {
+        ids[i] = 0;
+        std::memcpy(ids + i, in + i * id_bytes, id_bytes);
+    }
+}
+
+// IEEE half precision with round to nearest even
+inline uint16_t float_to_half(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t abs = bits & 0x7fffffff;
+    if (abs >= 0x7f800000)
+    {
+        return sign | (abs > 0x7f800000 ? 0x7e00 : 0x7c00);
+    }
+    if (abs >= 0x477ff000)
+    {
+        // rounds beyond the largest half
+        return sign | 0x7c00;
+    }
+    if (abs < 0x38800000)
+    {
+        // subnormal half
+        if (abs < 0x33000000)
+        {
+            return sign;
+        }
+        uint32_t mant = (abs & 0x7fffff) | 0x800000;
+        uint32_t shift = 126 - (abs >> 23);
+        uint32_t half = mant >> shift;
+        uint32_t rem = mant & ((1u << shift) - 1);
+        uint32_t half_way = 1u << (shift - 1);
+        if (rem > half_way || (rem == half_way && (half & 1)))
+        {
+            half++;
+        }
+        return sign | half;
+    }
+    uint32_t half = (abs >> 13) - (112 << 10);
+    uint32_t rem = abs & 0x1fff;
+    if (rem > 0x1000 || (rem == 0x1000 && (half & 1)))
+    {
+        half++;
+    }
+    return sign | half;
+}
+
+inline float half_to_float(uint16_t half)
+{
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exp = (half >> 10) & 0x1f;
+    uint32_t mant = half & 0x3ff;
+    uint32_t bits;
+    if (exp == 0x1f)
+    {
+        bits = sign | 0x7f800000 | (mant << 13);
+    }
+    else if (exp != 0)
+    {
+        bits = sign | ((exp + 112) << 23) | (mant << 13);
+    }
+    else
+    {
+        float value = std::ldexp((float)mant, -24);
+        return sign ? -value : value;
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// SQ8 keeps a [lower, lower + 255 * scale] range per dimension
+inline void encode_sector_vector(SectorVectorType type, const float *vec, uint64_t ndims, const float *sq8_lower,
+                                 const float *sq8_scale, char *out)
+{
+    if (type == SectorVectorType::FP16)
+    {
+        for (uint64_t d = 0; d < ndims; d++)
+        {
+            uint16_t half = float_to_half(vec[d]);
+            std::memcpy(out + d * sizeof(uint16_t), &half, sizeof(uint16_t));
+        }
+    }
+    else if (type == SectorVectorType::SQ8)
+    {
+        for (uint64_t d = 0; d < ndims; d++)
+        {
+            float code = sq8_scale[d] > 0 ? std::round((vec[d] - sq8_lower[d]) / sq8_scale[d]) : 0.0f;
+            out[d] = (char)(uint8_t)(std::min)(255.0f, (std::max)(0.0f, code));
+        }
+    }
+    else
+    {
+        std::memcpy(out, vec, ndims * sizeof(float));
+    }
+}
+
+inline void decode_sector_vector(SectorVectorType type, const char *in, uint64_t ndims, const float *sq8_lower,
+                                 const float *sq8_scale, float *vec)
+{
+    if (type == SectorVectorType::FP16)
+    {
+        for (uint64_t d = 0; d < ndims; d++)
+        {
+            uint16_t half;
+            std::memcpy(&half, in + d * sizeof(uint16_t), sizeof(uint16_t));
+            vec[d] = half_to_float(half);
+        }
+    }
+    else if (type == SectorVectorType::SQ8)
+    {
+        for (uint64_t d = 0; d < ndims; d++)
+        {
+            vec[d] = sq8_lower[d] + (float)(uint8_t)in[d] * sq8_scale[d];
+        }
+    }
+    else
+    {
+        std::memcpy(vec, in, ndims * sizeof(float));
+    }
+}
+
+} // namespace diskann
@@ -3,6 +3,10 @@
 
 #include "common_includes.h"
 
+#include <filesystem>
+#include <fstream>
+#include <random>
+
 #if defined(RELEASE_UNUSED_TCMALLOC_MEMORY_AT_CHECKPOINTS) && defined(DISKANN_BUILD)
 #include "gperftools/malloc_extension.h"
 #endif
@@ -15,6 +19,7 @@
 #include "omp.h"
 #include "percentile_stats.h"
 #include "partition.h"
+#include "math_utils.h"
 #include "pq_flash_index.h"
 #include "timer.h"
 #include "tsl/robin_set.h"
@@ -761,6 +766,294 @@ int build_merged_vamana_index(std::string base_file, diskann::Metric compareMetr
     return 0;
 }
 
+template <typename T, typename TagT>
+std::vector<size_t> partition_vamana_shards(const T *data, size_t npts, size_t ndims, const std::vector<TagT> &tags,
+                                            uint32_t R, double sampling_rate, double ram_budget, size_t min_parts,
+                                            std::vector<uint32_t> &valid_locs,
+                                            std::vector<std::vector<uint32_t>> &shard_ids)
+{
+    const size_t k_base = 2;
+    const size_t max_k_means_reps = 10;
+    const size_t assign_block_size = 65536;
+    const uint32_t shard_degree = 2 * R / 3;
+
+    // duplicated tags are skipped like Index::build does, graph ids are locations among the kept points
+    std::vector<size_t> fail_idx;
+    valid_locs.clear();
+    tsl::robin_set<TagT> unique_tags_set;
+    for (size_t i = 0; i < npts; i++)
+    {
+        if (!unique_tags_set.insert(tags[i]).second)
+        {
+            fail_idx.push_back(i);
+            continue;
+        }
+        valid_locs.push_back((uint32_t)i);
+    }
+    unique_tags_set.clear();
+    size_t num_points = valid_locs.size();
+
+    // kmeans on a sample, add parts until the largest shard graph fits in the budget
+    Timer timer;
+    float *train_data_float = nullptr;
+    size_t num_train = 0;
+    gen_random_slice<T>(data, npts, ndims, sampling_rate, train_data_float, num_train);
+    std::unique_ptr<float[]> train_data(train_data_float);
+    if (num_train == 0)
+    {
+        throw ANNException("No sample drawn for partitioning", -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+    double sample_ratio = (double)num_train / (double)npts;
+
+    size_t num_parts = min_parts > 0 ? min_parts : 3;
+    std::vector<float> pivot_data;
+    while (true)
+    {
+        if (num_parts > num_train)
+        {
+            throw ANNException("RAM budget is too small to partition the data", -1, __FUNCSIG__, __FILE__, __LINE__);
+        }
+        pivot_data.assign(num_parts * ndims, 0);
+        kmeans::kmeanspp_selecting_pivots(train_data.get(), num_train, ndims, pivot_data.data(), num_parts);
+        kmeans::run_lloyds(train_data.get(), num_train, ndims, pivot_data.data(), num_parts, max_k_means_reps, NULL,
+                           NULL);
+        if (ram_budget <= 0)
+        {
+            break;
+        }
+
+        std::vector<size_t> cluster_sizes;
+        estimate_cluster_sizes(train_data.get(), num_train, pivot_data.data(), num_parts, ndims, k_base, cluster_sizes);
+        double max_ram_usage = 0;
+        for (auto &p : cluster_sizes)
+        {
+            max_ram_usage = (std::max)(max_ram_usage, estimate_ram_usage((size_t)(p / sample_ratio), (uint32_t)ndims,
+                                                                         sizeof(T), shard_degree));
+        }
+        if (max_ram_usage <= ram_budget)
+        {
+            break;
+        }
+        num_parts += 2;
+    }
+    train_data.reset();
+
+    // every point joins its k_base closest shards, shard ids stay in ascending order
+    size_t k = (std::min)(k_base, num_parts);
+    shard_ids.assign(num_parts, {});
+    {
+        size_t block_size = (std::min)(num_points, assign_block_size);
+        std::vector<float> block_data(block_size * ndims);
+        std::vector<uint32_t> block_closest_centers(block_size * k);
+        for (size_t start = 0; start < num_points; start += block_size)
+        {
+            size_t end = (std::min)(start + block_size, num_points);
+            for (size_t i = start; i < end; i++)
+            {
+                const T *cur_vector = data + (size_t)valid_locs[i] * ndims;
+                std::copy(cur_vector, cur_vector + ndims, block_data.data() + (i - start) * ndims);
+            }
+            math_utils::compute_closest_centers(block_data.data(), end - start, ndims, pivot_data.data(), num_parts, k,
+                                                block_closest_centers.data());
+            for (size_t i = start; i < end; i++)
+            {
+                for (size_t j = 0; j < k; j++)
+                {
+                    shard_ids[block_closest_centers[(i - start) * k + j]].push_back((uint32_t)i);
+                }
+            }
+        }
+    }
+    diskann::cout << timer.elapsed_seconds_for_step("partitioning data into " + std::to_string(num_parts) + " parts")
+                  << std::endl;
+    return fail_idx;
+}
+
+template <typename T, typename TagT>
+void build_vamana_shard(const T *data, size_t ndims, const std::vector<uint32_t> &valid_locs,
+                        const std::vector<uint32_t> &shard, diskann::Metric compareMetric, uint32_t L, uint32_t R,
+                        uint32_t num_threads, std::stringstream &shard_graph)
+{
+    if (shard.empty())
+    {
+        return;
+    }
+    diskann::IndexWriteParameters paras =
+        diskann::IndexWriteParametersBuilder(L, R).with_num_threads(num_threads).build();
+    std::vector<T> shard_data(shard.size() * ndims);
+    for (size_t i = 0; i < shard.size(); i++)
+    {
+        memcpy(shard_data.data() + i * ndims, data + (size_t)valid_locs[shard[i]] * ndims, ndims * sizeof(T));
+    }
+    std::vector<TagT> shard_tags(shard.begin(), shard.end());
+    diskann::Index<T, TagT, TagT> shard_index(compareMetric, ndims, shard.size(), false, true, false, false, 0, false);
+    shard_index.build(shard_data.data(), shard.size(), paras, shard_tags, true);
+    std::stringstream shard_tag_stream;
+    shard_index.save(shard_graph, shard_tag_stream);
+}
+
+void merge_vamana_shards(const std::vector<std::vector<uint32_t>> &shard_ids,
+                         std::vector<std::unique_ptr<std::iostream>> &shard_graphs, size_t num_points, uint32_t R,
+                         std::stringstream &graph_stream)
+{
+    // a node takes the union of its shard neighbors cut to R
+    Timer timer;
+    size_t num_parts = shard_ids.size();
+    std::vector<std::pair<uint32_t, uint32_t>> node_shard;
+    uint32_t medoid = 0;
+    size_t largest_shard = 0;
+    for (size_t p = 0; p < num_parts; p++)
+    {
+        if (shard_ids[p].empty())
+        {
+            continue;
+        }
+        for (auto id : shard_ids[p])
+        {
+            node_shard.emplace_back(id, (uint32_t)p);
+        }
+        uint64_t shard_size, shard_frozen;
+        uint32_t shard_width, shard_medoid;
+        shard_graphs[p]->read((char *)&shard_size, sizeof(uint64_t));
+        shard_graphs[p]->read((char *)&shard_width, sizeof(uint32_t));
+        shard_graphs[p]->read((char *)&shard_medoid, sizeof(uint32_t));
+        shard_graphs[p]->read((char *)&shard_frozen, sizeof(uint64_t));
+        if (shard_ids[p].size() > largest_shard)
+        {
+            largest_shard = shard_ids[p].size();
+            medoid = shard_ids[p][shard_medoid];
+        }
+    }
+    std::sort(node_shard.begin(), node_shard.end());
+
+    uint64_t merged_index_size = sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t);
+    uint64_t merged_frozen = 0;
+    uint32_t max_degree = 0;
+    graph_stream.write((char *)&merged_index_size, sizeof(uint64_t));
+    graph_stream.write((char *)&R, sizeof(uint32_t));
+    graph_stream.write((char *)&medoid, sizeof(uint32_t));
+    graph_stream.write((char *)&merged_frozen, sizeof(uint64_t));
+
+    std::mt19937 urng(0);
+    std::vector<bool> nhood_set(num_points, false);
+    std::vector<uint32_t> shard_nhood;
+    std::vector<uint32_t> final_nhood;
+    size_t cur = 0;
+    for (uint32_t node = 0; node < num_points; node++)
+    {
+        final_nhood.clear();
+        for (; cur < node_shard.size() && node_shard[cur].first == node; cur++)
+        {
+            auto shard = node_shard[cur].second;
+            uint32_t nnbrs;
+            shard_graphs[shard]->read((char *)&nnbrs, sizeof(uint32_t));
+            shard_nhood.resize(nnbrs);
+            shard_graphs[shard]->read((char *)shard_nhood.data(), nnbrs * sizeof(uint32_t));
+            for (auto nbr : shard_nhood)
+            {
+                uint32_t global_nbr = shard_ids[shard][nbr];
+                if (!nhood_set[global_nbr])
+                {
+                    nhood_set[global_nbr] = true;
+                    final_nhood.push_back(global_nbr);
+                }
+            }
+        }
+        for (auto nbr : final_nhood)
+        {
+            nhood_set[nbr] = false;
+        }
+        std::shuffle(final_nhood.begin(), final_nhood.end(), urng);
+        uint32_t nnbrs = (uint32_t)(std::min)(final_nhood.size(), (size_t)R);
+        graph_stream.write((char *)&nnbrs, sizeof(uint32_t));
+        graph_stream.write((char *)final_nhood.data(), nnbrs * sizeof(uint32_t));
+        merged_index_size += (uint64_t)(nnbrs + 1) * sizeof(uint32_t);
+        max_degree = (std::max)(max_degree, nnbrs);
+    }
+    graph_stream.seekp(0, graph_stream.beg);
+    graph_stream.write((char *)&merged_index_size, sizeof(uint64_t));
+    graph_stream.write((char *)&max_degree, sizeof(uint32_t));
+    graph_stream.seekp(0, graph_stream.end);
+    diskann::cout << timer.elapsed_seconds_for_step("merging indices") << std::endl;
+}
+
+template <typename T, typename TagT>
+std::vector<size_t> build_partitioned_vamana_index(const T *data, size_t npts, size_t ndims, const std::vector<TagT> &tags,
+                                                   diskann::Metric compareMetric, uint32_t L, uint32_t R,
+                                                   double sampling_rate, double ram_budget, uint32_t num_threads,
+                                                   std::stringstream &graph_stream, std::stringstream &tag_stream,
+                                                   const std::string &spill_dir)
+{
+    std::vector<uint32_t> valid_locs;
+    std::vector<std::vector<uint32_t>> shard_ids;
+    std::vector<size_t> fail_idx = partition_vamana_shards<T, TagT>(data, npts, ndims, tags, R, sampling_rate,
+                                                                    ram_budget, 0, valid_locs, shard_ids);
+
+    // only one shard is held in memory while its graph is built, the finished shard graphs wait in
+    // temporary files until they are merged
+    Timer timer;
+    std::string spill_prefix =
+        ((spill_dir.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(spill_dir)) /
+         ("diskann_shard_" + std::to_string(std::random_device()()) + "_"))
+            .string();
+    std::vector<std::string> spill_files;
+    std::vector<std::unique_ptr<std::iostream>> shard_graphs(shard_ids.size());
+    auto remove_spill_files = [&]() {
+        shard_graphs.clear();
+        for (const auto &file : spill_files)
+        {
+            std::remove(file.c_str());
+        }
+    };
+    try
+    {
+        for (size_t p = 0; p < shard_ids.size(); p++)
+        {
+            std::stringstream shard_graph;
+            build_vamana_shard<T, TagT>(data, ndims, valid_locs, shard_ids[p], compareMetric, L, 2 * R / 3,
+                                        num_threads, shard_graph);
+            auto path = spill_prefix + std::to_string(p);
+            auto file = std::make_unique<std::fstream>(path, std::ios::in | std::ios::out | std::ios::trunc |
+                                                                 std::ios::binary);
+            if (!file->is_open())
+            {
+                throw ANNException("failed to create the shard graph file " + path, -1, __FUNCSIG__, __FILE__,
+                                   __LINE__);
+            }
+            spill_files.push_back(path);
+            if (!shard_ids[p].empty())
+            {
+                *file << shard_graph.rdbuf();
+                file->flush();
+                file->seekg(0, std::ios::beg);
+            }
+            if (file->fail())
+            {
+                throw ANNException("failed to write the shard graph file " + path, -1, __FUNCSIG__, __FILE__,
+                                   __LINE__);
+            }
+            shard_graphs[p] = std::move(file);
+        }
+        diskann::cout << timer.elapsed_seconds_for_step("building indices on shards") << std::endl;
+
+        merge_vamana_shards(shard_ids, shard_graphs, valid_locs.size(), R, graph_stream);
+    }
+    catch (...)
+    {
+        remove_spill_files();
+        throw;
+    }
+    remove_spill_files();
+
+    std::vector<TagT> unique_tags(valid_locs.size());
+    for (size_t i = 0; i < valid_locs.size(); i++)
+    {
+        unique_tags[i] = tags[valid_locs[i]];
+    }
+    diskann::save_bin<TagT>(tag_stream, unique_tags.data(), unique_tags.size(), 1);
+    return fail_idx;
+}
+
 // General purpose support for DiskANN interface
 
 // optimizes the beamwidth to maximize QPS for a given L_search subject to
@@ -1024,7 +1317,8 @@ void create_disk_layout(const std::string base_file, const std::string mem_index
 
 template <typename T>
 void create_disk_layout(const T *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::stringstream &vamana_reader,
-                        std::stringstream &diskann_writer, size_t sector_len, diskann::Metric metric)
+                        std::stringstream &diskann_writer, size_t sector_len, diskann::Metric metric,
+                        SectorVectorType vector_type)
     {
         // amount to read or write in one shot
         size_t read_blk_size = 64 * 1024 * 1024;
@@ -1034,12 +1328,15 @@ void create_disk_layout(const T *data, uint32_t npts, uint32_t ndims, const std:
         npts_64 = npts;
         ndims_64 = ndims;
 
-        // Check if we need to append data for re-ordering
-        bool append_reorder_data = false;
+        // compact layouts keep the full-precision vectors in the re-ordering region
+        bool append_reorder_data = vector_type != SectorVectorType::FP32;
+        if (append_reorder_data && !std::is_same<T, float>::value)
+        {
+            throw diskann::ANNException("compact sector layouts only support float data", -1, __FUNCSIG__, __FILE__,
+                                        __LINE__);
+        }
         std::ifstream reorder_data_reader;
 
-        uint32_t npts_reorder_file = 0, ndims_reorder_file = 0;
-
         // create cached reader + writer
         size_t actual_file_size = vamana_reader.str().size();
         // diskann::cout << "Vamana index file size=" << actual_file_size << std::endl;
@@ -1069,9 +1366,49 @@ void create_disk_layout(const T *data, uint32_t npts, uint32_t ndims, const std:
         medoid = (uint64_t)medoid_u32;
         if (vamana_frozen_num == 1)
             vamana_frozen_loc = medoid;
-        max_node_len = (((uint64_t)width_u32 + 1) * sizeof(uint32_t)) + (ndims_64 * sizeof(T));
+        uint64_t vector_bytes = append_reorder_data ? sector_vector_bytes(vector_type, ndims_64) : ndims_64 * sizeof(T);
+        uint32_t id_bytes = append_reorder_data ? packed_id_bytes(npts_64) : sizeof(uint32_t);
+        max_node_len = vector_bytes + sizeof(uint32_t) + (uint64_t)width_u32 * id_bytes;
         nnodes_per_sector = sector_len / max_node_len;
 
+        // the vector of location i as it is searched, normalized for cosine
+        std::vector<float> vec_buf(ndims_64);
+        auto load_vector = [&](uint64_t loc) {
+            for (uint64_t d = 0; d < ndims_64; d++)
+            {
+                vec_buf[d] = (float)data[loc * ndims_64 + d];
+            }
+            if (diskann::Metric::COSINE == metric)
+            {
+                normalize(vec_buf.data(), ndims);
+            }
+        };
+
+        // SQ8 range of every dimension, [lower][scale]
+        std::vector<float> sq8_params;
+        const float *sq8_lower = nullptr, *sq8_scale = nullptr;
+        if (vector_type == SectorVectorType::SQ8)
+        {
+            sq8_params.resize(2 * ndims_64);
+            std::vector<float> upper(ndims_64, std::numeric_limits<float>::lowest());
+            std::fill(sq8_params.begin(), sq8_params.begin() + ndims_64, std::numeric_limits<float>::max());
+            for (uint64_t loc = 0; loc < npts_64; loc++)
+            {
+                load_vector(loc);
+                for (uint64_t d = 0; d < ndims_64; d++)
+                {
+                    sq8_params[d] = (std::min)(sq8_params[d], vec_buf[d]);
+                    upper[d] = (std::max)(upper[d], vec_buf[d]);
+                }
+            }
+            for (uint64_t d = 0; d < ndims_64; d++)
+            {
+                sq8_params[ndims_64 + d] = (std::max)(0.0f, upper[d] - sq8_params[d]) / 255.0f;
+            }
+            sq8_lower = sq8_params.data();
+            sq8_scale = sq8_params.data() + ndims_64;
+        }
+
         // diskann::cout << "medoid: " << medoid << "B" << std::endl;
         // diskann::cout << "max_node_len: " << max_node_len << "B" << std::endl;
         // diskann::cout << "nnodes_per_sector: " << nnodes_per_sector << "B" << std::endl;
@@ -1079,15 +1416,27 @@ void create_disk_layout(const T *data, uint32_t npts, uint32_t ndims, const std:
         // sector_len buffer for each sector
         std::unique_ptr<char[]> sector_buf = std::make_unique<char[]>(sector_len);
         std::unique_ptr<char[]> node_buf = std::make_unique<char[]>(max_node_len);
-        uint32_t &nnbrs = *(uint32_t *)(node_buf.get() + ndims_64 * sizeof(T));
-        uint32_t *nhood_buf = (uint32_t *)(node_buf.get() + (ndims_64 * sizeof(T)) + sizeof(uint32_t));
+        uint32_t nnbrs = 0;
+        std::vector<uint32_t> nhood_buf(width_u32);
 
         // number of sectors (1 for meta data)
         uint64_t n_sectors = ROUND_UP(npts_64, nnodes_per_sector) / nnodes_per_sector;
         uint64_t n_reorder_sectors = 0;
         uint64_t n_data_nodes_per_sector = 0;
+        uint64_t n_codec_sectors = 0;
+        if (append_reorder_data)
+        {
+            n_data_nodes_per_sector = sector_len / (ndims_64 * sizeof(float));
+            if (nnodes_per_sector == 0 || n_data_nodes_per_sector == 0)
+            {
+                throw diskann::ANNException("full-precision vector does not fit into one sector", -1, __FUNCSIG__,
+                                            __FILE__, __LINE__);
+            }
+            n_reorder_sectors = ROUND_UP(npts_64, n_data_nodes_per_sector) / n_data_nodes_per_sector;
+            n_codec_sectors = DIV_ROUND_UP(sq8_params.size() * sizeof(float), sector_len);
+        }
 
-        uint64_t disk_index_file_size = (n_sectors + n_reorder_sectors + 1) * sector_len;
+        uint64_t disk_index_file_size = (n_sectors + n_reorder_sectors + n_codec_sectors + 1) * sector_len;
 
         std::vector<uint64_t> output_file_meta;
         output_file_meta.push_back(npts_64 - skip_locs.size());
@@ -1101,10 +1450,17 @@ void create_disk_layout(const T *data, uint32_t npts, uint32_t ndims, const std:
         if (append_reorder_data)
         {
             output_file_meta.push_back(n_sectors + 1);
-            output_file_meta.push_back(ndims_reorder_file);
+            output_file_meta.push_back(ndims_64);
             output_file_meta.push_back(n_data_nodes_per_sector);
         }
         output_file_meta.push_back(disk_index_file_size);
+        if (append_reorder_data)
+        {
+            output_file_meta.push_back((uint64_t)vector_type);
+            output_file_meta.push_back(id_bytes);
+            output_file_meta.push_back(width_u32);
+            output_file_meta.push_back(n_codec_sectors > 0 ? n_sectors + n_reorder_sectors + 1 : 0);
+        }
 
         diskann_writer.write(sector_buf.get(), sector_len);
 
@@ -1135,23 +1491,32 @@ void create_disk_layout(const T *data, uint32_t npts, uint32_t ndims, const std:
                 assert(nnbrs <= width_u32);
 
                 // read node's nhood
-                vamana_reader.read((char *)nhood_buf, (std::min)(nnbrs, width_u32) * sizeof(uint32_t));
+                vamana_reader.read((char *)nhood_buf.data(), (std::min)(nnbrs, width_u32) * sizeof(uint32_t));
                 if (nnbrs > width_u32)
                 {
                     vamana_reader.seekg((nnbrs - width_u32) * sizeof(uint32_t), vamana_reader.cur);
                 }
 
                 // write coords of node first
-                memcpy(node_buf.get(), data + ((uint64_t) ndims_64 * cur_node_id), ndims_64 * sizeof(T));
-                if (diskann::Metric::COSINE == metric) {
-                    normalize((float *)node_buf.get(), ndims);
+                if (append_reorder_data)
+                {
+                    load_vector(cur_node_id);
+                    encode_sector_vector(vector_type, vec_buf.data(), ndims_64, sq8_lower, sq8_scale,
+                                         node_buf.get());
+                }
+                else
+                {
+                    memcpy(node_buf.get(), data + ((uint64_t) ndims_64 * cur_node_id), ndims_64 * sizeof(T));
+                    if (diskann::Metric::COSINE == metric) {
+                        normalize((float *)node_buf.get(), ndims);
+                    }
                 }
                 // write nnbrs
-                *(uint32_t *)(node_buf.get() + ndims_64 * sizeof(T)) = (std::min)(nnbrs, width_u32);
+                uint32_t stored_nnbrs = (std::min)(nnbrs, width_u32);
+                memcpy(node_buf.get() + vector_bytes, &stored_nnbrs, sizeof(uint32_t));
 
                 // write nhood next
-                memcpy(node_buf.get() + ndims_64 * sizeof(T) + sizeof(uint32_t), nhood_buf,
-                       (std::min)(nnbrs, width_u32) * sizeof(uint32_t));
+                pack_ids(nhood_buf.data(), stored_nnbrs, id_bytes, node_buf.get() + vector_bytes + sizeof(uint32_t));
 
                 // get offset into sector_buf
                 char *sector_node_buf = sector_buf.get() + (sector_node_id * max_node_len);
@@ -1163,6 +1528,29 @@ void create_disk_layout(const T *data, uint32_t npts, uint32_t ndims, const std:
             // flush sector to disk
             diskann_writer.write(sector_buf.get(), sector_len);
         }
+        // full-precision vectors, only read to rerank the final candidates
+        for (uint64_t sector = 0; sector < n_reorder_sectors; sector++)
+        {
+            memset(sector_buf.get(), 0, sector_len);
+            for (uint64_t i = 0; i < n_data_nodes_per_sector; i++)
+            {
+                uint64_t loc = sector * n_data_nodes_per_sector + i;
+                if (loc >= npts_64)
+                {
+                    break;
+                }
+                load_vector(loc);
+                memcpy(sector_buf.get() + i * ndims_64 * sizeof(float), vec_buf.data(), ndims_64 * sizeof(float));
+            }
+            diskann_writer.write(sector_buf.get(), sector_len);
+        }
+        // SQ8 lower bounds and scales
+        if (n_codec_sectors > 0)
+        {
+            std::vector<char> codec_buf(n_codec_sectors * sector_len, 0);
+            memcpy(codec_buf.data(), sq8_params.data(), sq8_params.size() * sizeof(float));
+            diskann_writer.write(codec_buf.data(), codec_buf.size());
+        }
         diskann::save_bin<uint64_t>(diskann_writer, output_file_meta.data(), output_file_meta.size(), 1, 0);
         // diskann::cout << "Output disk index file written to diskann_writer" << std::endl;
     }
@@ -1441,11 +1829,11 @@ template DISKANN_DLLEXPORT void create_disk_layout<float>(const std::string base
 
 
 template DISKANN_DLLEXPORT void create_disk_layout<int8_t>(const int8_t *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::stringstream &vamana_reader, std::stringstream &diskann_writer,
-                                                           size_t sector_len, diskann::Metric metric);
+                                                           size_t sector_len, diskann::Metric metric, SectorVectorType vector_type);
 template DISKANN_DLLEXPORT void create_disk_layout<uint8_t>(const uint8_t *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::stringstream &vamana_reader, std::stringstream &diskann_writer,
-                                                            size_t sector_len, diskann::Metric metric);
+                                                            size_t sector_len, diskann::Metric metric, SectorVectorType vector_type);
 template DISKANN_DLLEXPORT void create_disk_layout<float>(const float *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::stringstream &vamana_reader, std::stringstream &diskann_writer,
-                                                          size_t sector_len, diskann::Metric metric);
+                                                          size_t sector_len, diskann::Metric metric, SectorVectorType vector_type);
 template DISKANN_DLLEXPORT int8_t *load_warmup<int8_t>(const std::string &cache_warmup_file, uint64_t &warmup_num,
                                                        uint64_t warmup_dim, uint64_t warmup_aligned_dim);
 template DISKANN_DLLEXPORT uint8_t *load_warmup<uint8_t>(const std::string &cache_warmup_file, uint64_t &warmup_num,
@@ -1534,6 +1922,17 @@ template DISKANN_DLLEXPORT int build_merged_vamana_index<int8_t, uint32_t>(
     double ram_budget, std::string mem_index_path, std::string medoids_path, std::string centroids_file,
     size_t build_pq_bytes, bool use_opq, uint32_t num_threads, bool use_filters, const std::string &label_file,
     const std::string &labels_to_medoids_file, const std::string &universal_label, const uint32_t Lf);
+template DISKANN_DLLEXPORT std::vector<size_t> build_partitioned_vamana_index<float, int64_t>(
+    const float *data, size_t npts, size_t ndims, const std::vector<int64_t> &tags, diskann::Metric compareMetric,
+    uint32_t L, uint32_t R, double sampling_rate, double ram_budget, uint32_t num_threads,
+    std::stringstream &graph_stream, std::stringstream &tag_stream, const std::string &spill_dir);
+template DISKANN_DLLEXPORT std::vector<size_t> partition_vamana_shards<float, int64_t>(
+    const float *data, size_t npts, size_t ndims, const std::vector<int64_t> &tags, uint32_t R, double sampling_rate,
+    double ram_budget, size_t min_parts, std::vector<uint32_t> &valid_locs,
+    std::vector<std::vector<uint32_t>> &shard_ids);
+template DISKANN_DLLEXPORT void build_vamana_shard<float, int64_t>(
+    const float *data, size_t ndims, const std::vector<uint32_t> &valid_locs, const std::vector<uint32_t> &shard,
+    diskann::Metric compareMetric, uint32_t L, uint32_t R, uint32_t num_threads, std::stringstream &shard_graph);
 template DISKANN_DLLEXPORT int build_merged_vamana_index<float, uint32_t>(
     std::string base_file, diskann::Metric compareMetric, uint32_t L, uint32_t R, double sampling_rate,
     double ram_budget, std::string mem_index_path, std::string medoids_path, std::string centroids_file,
@@ -19,6 +19,9 @@ namespace vsag {
 extern PQDistanceFunc
 GetPQDistanceFunc();
 
+extern PQDistanceLookupBatchFunc
+GetPQDistanceLookupBatchFunc();
+
 }
 
 namespace diskann
@@ -351,6 +354,35 @@ void FixedChunkPQTable::inflate_vector(uint8_t *base_vec, float *out_vec)
     }
 }
 
+float FixedChunkPQTable::encode_vector(const float *vec, uint8_t *code)
+{
+    std::vector<float> tmp(vec, vec + ndims);
+    preprocess_query(tmp.data());
+    float error = 0;
+    for (size_t chunk = 0; chunk < n_chunks; chunk++)
+    {
+        float best_dist = std::numeric_limits<float>::max();
+        uint32_t best_center = 0;
+        for (uint32_t center = 0; center < NUM_PQ_CENTROIDS; center++)
+        {
+            float dist = 0;
+            for (size_t j = chunk_offsets[chunk]; j < chunk_offsets[chunk + 1]; j++)
+            {
+                float diff = tables[center * ndims + j] - tmp[j];
+                dist += diff * diff;
+            }
+            if (dist < best_dist)
+            {
+                best_dist = dist;
+                best_center = center;
+            }
+        }
+        code[chunk] = (uint8_t)best_center;
+        error += best_dist;
+    }
+    return error;
+}
+
 void FixedChunkPQTable::populate_chunk_inner_products(const float *query_vec, float *dist_vec)
 {
     memset(dist_vec, 0, 256 * n_chunks * sizeof(float));
@@ -386,31 +418,8 @@ void aggregate_coords(const std::vector<uint32_t> &ids, const uint8_t *all_coord
 void pq_dist_lookup(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_nchunks, const float *pq_dists,
                     std::vector<float> &dists_out)
 {
-    //_mm_prefetch((char*) dists_out, _MM_HINT_T0);
-    // FIXME: alternative instruction on aarch64
-#if defined(__i386__) || defined(__x86_64__)
-    _mm_prefetch((char *)pq_ids, _MM_HINT_T0);
-    _mm_prefetch((char *)(pq_ids + 64), _MM_HINT_T0);
-    _mm_prefetch((char *)(pq_ids + 128), _MM_HINT_T0);
-#endif
-    dists_out.clear();
-    dists_out.resize(n_pts, 0);
-    for (size_t chunk = 0; chunk < pq_nchunks; chunk++)
-    {
-        const float *chunk_dists = pq_dists + 256 * chunk;
-        if (chunk < pq_nchunks - 1)
-        {
-	    // FIXME: alternative instruction on aarch64
-#if defined(__i386__) || defined(__x86_64__)
-            _mm_prefetch((char *)(chunk_dists + 256), _MM_HINT_T0);
-#endif
-        }
-        for (size_t idx = 0; idx < n_pts; idx++)
-        {
-            uint8_t pq_centerid = pq_ids[pq_nchunks * idx + chunk];
-            dists_out[idx] += chunk_dists[pq_centerid];
-        }
-    }
+    dists_out.resize(n_pts);
+    pq_dist_lookup(pq_ids, n_pts, pq_nchunks, pq_dists, dists_out.data());
 }
 
 // Need to replace calls to these functions with calls to vector& based
@@ -427,30 +436,9 @@ void aggregate_coords(const uint32_t *ids, const size_t n_ids, const uint8_t *al
 void pq_dist_lookup(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_nchunks, const float *pq_dists,
                     float *dists_out)
 {
-    // FIXME: alternative instruction on aarch64
-#if defined(__i386__) || defined(__x86_64__)
-    _mm_prefetch((char *)dists_out, _MM_HINT_T0);
-    _mm_prefetch((char *)pq_ids, _MM_HINT_T0);
-    _mm_prefetch((char *)(pq_ids + 64), _MM_HINT_T0);
-    _mm_prefetch((char *)(pq_ids + 128), _MM_HINT_T0);
-#endif
-    memset(dists_out, 0, n_pts * sizeof(float));
-    for (size_t chunk = 0; chunk < pq_nchunks; chunk++)
-    {
-        const float *chunk_dists = pq_dists + 256 * chunk;
-        if (chunk < pq_nchunks - 1)
-        {
-	    // FIXME: alternative instruction on aarch64
-#if defined(__i386__) || defined(__x86_64__)
-            _mm_prefetch((char *)(chunk_dists + 256), _MM_HINT_T0);
-#endif
-        }
-        for (size_t idx = 0; idx < n_pts; idx++)
-        {
-            uint8_t pq_centerid = pq_ids[pq_nchunks * idx + chunk];
-            dists_out[idx] += chunk_dists[pq_centerid];
-        }
-    }
+    // scores a whole batch of candidates per call with gathered table lookups
+    static const vsag::PQDistanceLookupBatchFunc lookup_batch = vsag::GetPQDistanceLookupBatchFunc();
+    lookup_batch(pq_ids, n_pts, pq_nchunks, pq_dists, dists_out);
 }
 
 // given training data in train_data of dimensions num_train * dim, generate
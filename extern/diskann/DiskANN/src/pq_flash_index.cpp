@@ -2,7 +2,12 @@
 // Licensed under the MIT license.
 
 #include <map>
+#include <numeric>
 #include <future>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
 
 #include "common_includes.h"
 #include <vector>
@@ -21,11 +26,10 @@
 #define READ_UNSIGNED(stream, val) stream.read((char *)&val, sizeof(unsigned))
 
 // sector # on disk where node_id is present with in the graph part
-#define NODE_SECTOR_NO(node_id) (((uint64_t)(node_id)) / nnodes_per_sector + 1)
+#define NODE_SECTOR_NO(node_id) node_sector_no((uint64_t)(node_id), ext_start_sector)
 
 // obtains region of sector containing node
-#define OFFSET_TO_NODE(sector_buf, node_id)                                                                            \
-    ((char *)sector_buf + (((uint64_t)node_id) % nnodes_per_sector) * max_node_len)
+#define OFFSET_TO_NODE(sector_buf, node_id) ((char *)(sector_buf) + node_offset((uint64_t)(node_id)))
 
 // returns region of `node_buf` containing [NNBRS][NBR_ID(uint32_t)]
 #define OFFSET_TO_NODE_NHOOD(node_buf) (unsigned *)((char *)node_buf + disk_bytes_per_point)
@@ -34,14 +38,88 @@
 #define OFFSET_TO_NODE_COORDS(node_buf) (T *)(node_buf)
 
 // sector # beyond the end of graph where data for id is present for reordering
-#define VECTOR_SECTOR_NO(id) (((uint64_t)(id)) / nvecs_per_sector + reorder_data_start_sector)
+#define VECTOR_SECTOR_NO(id) vector_sector_no((uint64_t)(id), ext_start_sector)
 
 // sector # beyond the end of graph where data for id is present for reordering
-#define VECTOR_SECTOR_OFFSET(id) ((((uint64_t)(id)) % nvecs_per_sector) * data_dim * sizeof(float))
+#define VECTOR_SECTOR_OFFSET(id) vector_sector_offset((uint64_t)(id))
+
+// node records of a compact layout only hold approximate vectors
+#define COMPACT_LAYOUT (sector_vector_type != SectorVectorType::FP32)
+
+// sector # holding the full-precision vector of id
+#define FULL_VECTOR_SECTOR_NO(id) (COMPACT_LAYOUT ? VECTOR_SECTOR_NO(id) : NODE_SECTOR_NO(id))
+
+// returns the full-precision vector of id inside its sector
+#define OFFSET_TO_FULL_VECTOR(sector_buf, id)                                                                          \
+    (COMPACT_LAYOUT ? (float *)((char *)(sector_buf) + VECTOR_SECTOR_OFFSET(id))                                      \
+                    : (float *)OFFSET_TO_NODE_COORDS(OFFSET_TO_NODE(sector_buf, id)))
 
 namespace diskann
 {
 
+// candidates rejected by the filter are kept out of the sector reads, they are only read to expand
+// through them once no valid candidate is left and they may still lead to a better valid result
+template <typename LabelT> class DeferredCandidates
+{
+  public:
+    DeferredCandidates(const std::function<bool(int64_t)> &filter, const LabelT *tags, uint64_t k)
+        : filter(filter), tags(tags), k(k)
+    {
+    }
+
+    bool rejects(uint32_t id) const
+    {
+        return filter && filter(tags[id]);
+    }
+
+    void defer(const Neighbor &nbr)
+    {
+        deferred.push(nbr);
+    }
+
+    // records the exact distance of an expanded valid node
+    void add_valid(float distance)
+    {
+        valid_top.push(distance);
+        if (valid_top.size() > k)
+        {
+            valid_top.pop();
+        }
+    }
+
+    bool pop(Neighbor &nbr)
+    {
+        if (deferred.empty() || (valid_top.size() >= k && deferred.top().distance >= valid_top.top()))
+        {
+            deferred = {};
+            return false;
+        }
+        nbr = deferred.top();
+        deferred.pop();
+        return true;
+    }
+
+    bool has_pending() const
+    {
+        return not deferred.empty();
+    }
+
+  private:
+    struct CloserFirst
+    {
+        bool operator()(const Neighbor &a, const Neighbor &b) const
+        {
+            return b < a;
+        }
+    };
+
+    const std::function<bool(int64_t)> &filter;
+    const LabelT *tags;
+    uint64_t k;
+    std::priority_queue<Neighbor, std::vector<Neighbor>, CloserFirst> deferred;
+    std::priority_queue<float> valid_top;
+};
+
 template <typename T, typename LabelT>
 PQFlashIndex<T, LabelT>::PQFlashIndex(std::shared_ptr<LocalFileReader> &fileReader, diskann::Metric m, size_t sector_len, size_t dim, bool use_bsa)
     : reader(fileReader), metric(m), thread_data(nullptr), sector_len(sector_len), use_bsa(use_bsa), data_dim(dim)
@@ -110,18 +188,145 @@ void PQFlashIndex<T, LabelT>::setup_thread_data(uint64_t nthreads, uint64_t visi
     load_flag = true;
 }
 
+template <typename T, typename LabelT>
+const float *PQFlashIndex<T, LabelT>::node_coords(const char *node_buf, float *scratch)
+{
+    if (!COMPACT_LAYOUT)
+    {
+        return (const float *)OFFSET_TO_NODE_COORDS(node_buf);
+    }
+    const float *sq8_lower = sq8_params ? sq8_params.get() : nullptr;
+    const float *sq8_scale = sq8_params ? sq8_params.get() + data_dim : nullptr;
+    decode_sector_vector(sector_vector_type, node_buf, data_dim, sq8_lower, sq8_scale, scratch);
+    return scratch;
+}
+
+template <typename T, typename LabelT>
+const uint32_t *PQFlashIndex<T, LabelT>::node_nhood(const char *node_buf, uint64_t &nnbrs, uint32_t *scratch)
+{
+    const char *nhood_buf = (const char *)OFFSET_TO_NODE_NHOOD(node_buf);
+    uint32_t count;
+    memcpy(&count, nhood_buf, sizeof(uint32_t));
+    nnbrs = std::min<uint64_t>(count, max_degree);
+    if (nbr_id_bytes == sizeof(uint32_t))
+    {
+        return (const uint32_t *)(nhood_buf + sizeof(uint32_t));
+    }
+    unpack_ids(nhood_buf + sizeof(uint32_t), nnbrs, (uint32_t)nbr_id_bytes, scratch);
+    return scratch;
+}
+
+template <typename T, typename LabelT> uint64_t PQFlashIndex<T, LabelT>::ext_block_sectors() const
+{
+    return 1 + (COMPACT_LAYOUT ? DIV_ROUND_UP(nnodes_per_sector, nvecs_per_sector) : 0);
+}
+
+template <typename T, typename LabelT>
+uint64_t PQFlashIndex<T, LabelT>::node_sector_no(uint64_t id, uint64_t ext_start) const
+{
+    if (id < ext_base)
+    {
+        return id / nnodes_per_sector + 1;
+    }
+    return ext_start + (id - ext_base) / nnodes_per_sector * ext_block_sectors();
+}
+
+template <typename T, typename LabelT> uint64_t PQFlashIndex<T, LabelT>::node_offset(uint64_t id) const
+{
+    uint64_t slot = id < ext_base ? id : id - ext_base;
+    return (slot % nnodes_per_sector) * max_node_len;
+}
+
+template <typename T, typename LabelT>
+uint64_t PQFlashIndex<T, LabelT>::vector_sector_no(uint64_t id, uint64_t ext_start) const
+{
+    if (id < ext_base)
+    {
+        return id / nvecs_per_sector + reorder_data_start_sector;
+    }
+    uint64_t slot = id - ext_base;
+    return ext_start + slot / nnodes_per_sector * ext_block_sectors() + 1 + slot % nnodes_per_sector / nvecs_per_sector;
+}
+
+template <typename T, typename LabelT> uint64_t PQFlashIndex<T, LabelT>::vector_sector_offset(uint64_t id) const
+{
+    uint64_t slot = id < ext_base ? id : (id - ext_base) % nnodes_per_sector;
+    return (slot % nvecs_per_sector) * data_dim * sizeof(float);
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::rerank_full_precision(const float *query, std::vector<Neighbor> &full_retset,
+                                                    uint64_t k_search, const std::function<bool(int64_t)> &filter,
+                                                    QueryStats *stats)
+{
+    // full_retset is sorted by the approximate distances, only its closest valid part is re-scored
+    uint64_t rerank_num = k_search * FULL_PRECISION_REORDER_MULTIPLIER;
+    std::vector<Neighbor> reranked, rest;
+    reranked.reserve(rerank_num);
+    for (auto &nbr : full_retset)
+    {
+        if (reranked.size() < rerank_num && !(filter && filter(tags[nbr.id])))
+        {
+            reranked.push_back(nbr);
+        }
+        else
+        {
+            rest.push_back(nbr);
+        }
+    }
+    if (reranked.empty())
+    {
+        return;
+    }
+
+    // neighboring candidates often share a sector of the region
+    std::vector<uint64_t> sectors;
+    sectors.reserve(reranked.size());
+    for (auto &nbr : reranked)
+    {
+        sectors.push_back(VECTOR_SECTOR_NO(nbr.id));
+    }
+    std::sort(sectors.begin(), sectors.end());
+    sectors.erase(std::unique(sectors.begin(), sectors.end()), sectors.end());
+    auto sector_scratch = std::shared_ptr<char[]>(new char[sectors.size() * sector_len]);
+    std::vector<AlignedRead> read_reqs;
+    read_reqs.reserve(sectors.size());
+    for (uint64_t i = 0; i < sectors.size(); i++)
+    {
+        read_reqs.emplace_back(sectors[i] * sector_len, sector_len, sector_scratch.get() + i * sector_len);
+    }
+    Timer io_timer;
+    reader->read(read_reqs);
+    if (stats != nullptr)
+    {
+        stats->io_us += (float)io_timer.elapsed();
+        stats->n_ios += (uint32_t)read_reqs.size();
+    }
+
+    for (auto &nbr : reranked)
+    {
+        auto loc = std::lower_bound(sectors.begin(), sectors.end(), VECTOR_SECTOR_NO(nbr.id)) - sectors.begin();
+        const float *vec = (const float *)(sector_scratch.get() + loc * sector_len + VECTOR_SECTOR_OFFSET(nbr.id));
+        nbr.distance = dist_cmp_float->compare(query, vec, (uint32_t)data_dim);
+    }
+    std::sort(reranked.begin(), reranked.end());
+    reranked.insert(reranked.end(), rest.begin(), rest.end());
+    full_retset.swap(reranked);
+}
+
 template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::load_cache_list(std::vector<uint32_t> &node_list)
 {
     diskann::cout << "Loading the cache list into memory.." << std::flush;
+    this->clear_cache();
     size_t num_cached_nodes = node_list.size();
-
-    // borrow thread data
-    ScratchStoreManager<SSDThreadData<T>> manager(this->thread_data);
-    auto this_thread_data = manager.scratch_space();
-
+    if (num_cached_nodes == 0)
+    {
+        diskann::cout << "..done." << std::endl;
+        return;
+    }
 
     nhood_cache_buf = new uint32_t[num_cached_nodes * (max_degree + 1)];
-    memset(nhood_cache_buf, 0, num_cached_nodes * (max_degree + 1));
+    memset(nhood_cache_buf, 0, num_cached_nodes * (max_degree + 1) * sizeof(uint32_t));
 
     size_t coord_cache_buf_len = num_cached_nodes * aligned_dim;
     diskann::alloc_aligned((void **)&coord_cache_buf, coord_cache_buf_len * sizeof(T), 8 * sizeof(T));
@@ -129,6 +334,7 @@ template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::load_cache_
 
     size_t BLOCK_SIZE = 8;
     size_t num_blocks = DIV_ROUND_UP(num_cached_nodes, BLOCK_SIZE);
+    auto sector_scratch = std::shared_ptr<char[]>(new char[BLOCK_SIZE * sector_len]);
 
     for (size_t block = 0; block < num_blocks; block++)
     {
@@ -139,12 +345,11 @@ template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::load_cache_
         for (size_t node_idx = start_idx; node_idx < end_idx; node_idx++)
         {
             AlignedRead read;
-            char *buf = nullptr;
-            alloc_aligned((void **)&buf, SECTOR_LEN, SECTOR_LEN);
+            char *buf = sector_scratch.get() + (node_idx - start_idx) * sector_len;
             nhoods.push_back(std::make_pair(node_list[node_idx], buf));
-            read.len = SECTOR_LEN;
+            read.len = sector_len;
             read.buf = buf;
-            read.offset = NODE_SECTOR_NO(node_list[node_idx]) * SECTOR_LEN;
+            read.offset = NODE_SECTOR_NO(node_list[node_idx]) * sector_len;
             read_reqs.push_back(read);
         }
 
@@ -155,28 +360,104 @@ template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::load_cache_
         {
             auto &nhood = nhoods[i];
             char *node_buf = OFFSET_TO_NODE(nhood.second, nhood.first);
-            T *node_coords = OFFSET_TO_NODE_COORDS(node_buf);
             T *cached_coords = coord_cache_buf + node_idx * aligned_dim;
-            memcpy(cached_coords, node_coords, disk_bytes_per_point);
+            if (COMPACT_LAYOUT)
+            {
+                // compact layouts are only written for float data
+                node_coords(node_buf, (float *)cached_coords);
+            }
+            else
+            {
+                memcpy(cached_coords, OFFSET_TO_NODE_COORDS(node_buf), disk_bytes_per_point);
+            }
             coord_cache.insert(std::make_pair(nhood.first, cached_coords));
 
             // insert node nhood into nhood_cache
-            uint32_t *node_nhood = OFFSET_TO_NODE_NHOOD(node_buf);
-
-            auto nnbrs = *node_nhood;
-            uint32_t *nbrs = node_nhood + 1;
             std::pair<uint32_t, uint32_t *> cnhood;
-            cnhood.first = nnbrs;
             cnhood.second = nhood_cache_buf + node_idx * (max_degree + 1);
-            memcpy(cnhood.second, nbrs, nnbrs * sizeof(uint32_t));
+            uint64_t nnbrs;
+            const uint32_t *nbrs = node_nhood(node_buf, nnbrs, cnhood.second);
+            cnhood.first = nnbrs;
+            if (nbrs != cnhood.second)
+            {
+                memcpy(cnhood.second, nbrs, nnbrs * sizeof(uint32_t));
+            }
             nhood_cache.insert(std::make_pair(nhood.first, cnhood));
-            aligned_free(nhood.second);
             node_idx++;
         }
     }
     diskann::cout << "..done." << std::endl;
 }
 
+template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::clear_cache()
+{
+    nhood_cache.clear();
+    coord_cache.clear();
+    if (nhood_cache_buf != nullptr)
+    {
+        delete[] nhood_cache_buf;
+        nhood_cache_buf = nullptr;
+        diskann::aligned_free(coord_cache_buf);
+        coord_cache_buf = nullptr;
+    }
+}
+
+template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::get_cache_list(std::vector<uint32_t> &node_list)
+{
+    node_list.clear();
+    node_list.reserve(nhood_cache.size());
+    for (auto &item : nhood_cache)
+    {
+        node_list.push_back(item.first);
+    }
+    std::sort(node_list.begin(), node_list.end());
+}
+
+template <typename T, typename LabelT> uint64_t PQFlashIndex<T, LabelT>::get_cached_node_size()
+{
+    return (max_degree + 1) * sizeof(uint32_t) + aligned_dim * sizeof(T);
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::generate_cache_list_from_queries(const T *queries, uint64_t query_num,
+                                                               uint64_t l_search, uint64_t beam_width,
+                                                               uint32_t io_limit, uint64_t num_nodes_to_cache,
+                                                               std::vector<uint32_t> &node_list)
+{
+    this->count_visited_nodes = true;
+    this->node_visit_counter.clear();
+    this->node_visit_counter.resize(this->num_points);
+    for (uint32_t i = 0; i < node_visit_counter.size(); i++)
+    {
+        this->node_visit_counter[i].first = i;
+        this->node_visit_counter[i].second = 0;
+    }
+
+    // replay the queries on the disk path, so every counted node is one that costs a sector read
+    std::vector<uint64_t> tmp_result_ids_64(l_search, 0);
+    std::vector<float> tmp_result_dists(l_search, 0);
+    for (uint64_t i = 0; i < query_num; i++)
+    {
+        cached_beam_search(queries + i * this->data_dim, 1, l_search, tmp_result_ids_64.data(),
+                           tmp_result_dists.data(), beam_width, nullptr, io_limit, false);
+    }
+
+    std::sort(this->node_visit_counter.begin(), node_visit_counter.end(),
+              [](std::pair<uint32_t, uint32_t> &left, std::pair<uint32_t, uint32_t> &right) {
+                  return left.second > right.second;
+              });
+    node_list.clear();
+    num_nodes_to_cache = std::min(num_nodes_to_cache, this->node_visit_counter.size());
+    node_list.reserve(num_nodes_to_cache);
+    for (uint64_t i = 0; i < num_nodes_to_cache && this->node_visit_counter[i].second > 0; i++)
+    {
+        node_list.push_back(this->node_visit_counter[i].first);
+    }
+    this->count_visited_nodes = false;
+    this->node_visit_counter.clear();
+    this->node_visit_counter.shrink_to_fit();
+}
+
 #ifdef EXEC_ENV_OLS
 template <typename T, typename LabelT>
 void PQFlashIndex<T, LabelT>::generate_cache_list_from_sample_queries(MemoryMappedFiles &files, std::string sample_bin,
@@ -272,21 +553,17 @@ void PQFlashIndex<T, LabelT>::cache_bfs_levels(uint64_t num_nodes_to_cache, std:
 
     tsl::robin_set<uint32_t> node_set;
 
-    // Do not cache more than 10% of the nodes in the index
-    uint64_t tenp_nodes = (uint64_t)(std::round(this->num_points * 0.1));
-    if (num_nodes_to_cache > tenp_nodes)
+    // the caller sizes the cache, it can not exceed the index
+    num_nodes_to_cache = std::min<uint64_t>(num_nodes_to_cache, this->num_points);
+    node_list.clear();
+    if (num_nodes_to_cache == 0)
     {
-        diskann::cout << "Reducing nodes to cache from: " << num_nodes_to_cache << " to: " << tenp_nodes
-                      << "(10 percent of total nodes:" << this->num_points << ")" << std::endl;
-        num_nodes_to_cache = tenp_nodes == 0 ? 1 : tenp_nodes;
+        return;
     }
     diskann::cout << "Caching " << num_nodes_to_cache << "..." << std::endl;
 
-    // borrow thread data
-    ScratchStoreManager<SSDThreadData<T>> manager(this->thread_data);
-    auto this_thread_data = manager.scratch_space();
-
     std::unique_ptr<tsl::robin_set<uint32_t>> cur_level, prev_level;
+    std::vector<uint32_t> nbr_scratch(max_degree);
     cur_level = std::make_unique<tsl::robin_set<uint32_t>>();
     prev_level = std::make_unique<tsl::robin_set<uint32_t>>();
 
@@ -341,6 +618,8 @@ void PQFlashIndex<T, LabelT>::cache_bfs_levels(uint64_t num_nodes_to_cache, std:
 
         uint64_t BLOCK_SIZE = 1024;
         uint64_t nblocks = DIV_ROUND_UP(nodes_to_expand.size(), BLOCK_SIZE);
+        auto sector_scratch = std::shared_ptr<char[]>(
+            new char[(std::min)(BLOCK_SIZE, (uint64_t)nodes_to_expand.size()) * sector_len]);
         for (size_t block = 0; block < nblocks && !finish_flag; block++)
         {
             diskann::cout << "." << std::flush;
@@ -350,13 +629,12 @@ void PQFlashIndex<T, LabelT>::cache_bfs_levels(uint64_t num_nodes_to_cache, std:
             std::vector<std::pair<uint32_t, char *>> nhoods;
             for (size_t cur_pt = start; cur_pt < end; cur_pt++)
             {
-                char *buf = nullptr;
-                alloc_aligned((void **)&buf, SECTOR_LEN, SECTOR_LEN);
+                char *buf = sector_scratch.get() + (cur_pt - start) * sector_len;
                 nhoods.emplace_back(nodes_to_expand[cur_pt], buf);
                 AlignedRead read;
-                read.len = SECTOR_LEN;
+                read.len = sector_len;
                 read.buf = buf;
-                read.offset = NODE_SECTOR_NO(nodes_to_expand[cur_pt]) * SECTOR_LEN;
+                read.offset = NODE_SECTOR_NO(nodes_to_expand[cur_pt]) * sector_len;
                 read_reqs.push_back(read);
             }
 
@@ -370,9 +648,8 @@ void PQFlashIndex<T, LabelT>::cache_bfs_levels(uint64_t num_nodes_to_cache, std:
 
                 // insert node coord into coord_cache
                 char *node_buf = OFFSET_TO_NODE(nhood.second, nhood.first);
-                uint32_t *node_nhood = OFFSET_TO_NODE_NHOOD(node_buf);
-                uint64_t nnbrs = (uint64_t)*node_nhood;
-                uint32_t *nbrs = node_nhood + 1;
+                uint64_t nnbrs;
+                const uint32_t *nbrs = node_nhood(node_buf, nnbrs, nbr_scratch.data());
                 // explore next level
                 for (uint64_t j = 0; j < nnbrs && !finish_flag; j++)
                 {
@@ -385,7 +662,6 @@ void PQFlashIndex<T, LabelT>::cache_bfs_levels(uint64_t num_nodes_to_cache, std:
                         finish_flag = true;
                     }
                 }
-                aligned_free(nhood.second);
             }
         }
 
@@ -437,7 +713,11 @@ template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::use_medoids
         T *medoid_disk_coords = OFFSET_TO_NODE_COORDS(medoid_node_buf);
         memcpy(medoid_coords.get(), medoid_disk_coords, disk_bytes_per_point);
 
-        if (!use_disk_index_pq)
+        if (COMPACT_LAYOUT)
+        {
+            node_coords(medoid_node_buf, centroid_data + cur_m * aligned_dim);
+        }
+        else if (!use_disk_index_pq)
         {
             for (uint32_t i = 0; i < data_dim; i++)
                 centroid_data[cur_m * aligned_dim + i] = medoid_coords[i];
@@ -1393,8 +1673,36 @@ int PQFlashIndex<T, LabelT>::load_from_separate_paths(std::stringstream &pivots_
     read_reqs.emplace_back(40, 8, &nnodes_per_sector);
     read_reqs.emplace_back(48, 8, &this->num_frozen_points);
     read_reqs.emplace_back(56, 8, &file_frozen_id);
-    read_reqs.emplace_back(64, 8, &this->reorder_data_exists);
+    uint64_t reorder_data_flag = 0;
+    read_reqs.emplace_back(64, 8, &reorder_data_flag);
     reader->read(read_reqs);
+    this->reorder_data_exists = reorder_data_flag != 0;
+    if (this->reorder_data_exists)
+    {
+        // written along with a compact layout, see create_disk_layout
+        uint64_t vector_type = 0, id_bytes = 0, codec_start_sector = 0;
+        read_reqs.clear();
+        read_reqs.emplace_back(72, 8, &this->reorder_data_start_sector);
+        read_reqs.emplace_back(80, 8, &this->ndims_reorder_vecs);
+        read_reqs.emplace_back(88, 8, &this->nvecs_per_sector);
+        read_reqs.emplace_back(104, 8, &vector_type);
+        read_reqs.emplace_back(112, 8, &id_bytes);
+        read_reqs.emplace_back(128, 8, &codec_start_sector);
+        reader->read(read_reqs);
+        this->sector_vector_type = (SectorVectorType)vector_type;
+        this->nbr_id_bytes = id_bytes;
+        this->disk_bytes_per_point = sector_vector_bytes(this->sector_vector_type, this->data_dim);
+        if (codec_start_sector != 0)
+        {
+            uint64_t codec_len = ROUND_UP(2 * this->data_dim * sizeof(float), sector_len);
+            auto codec_buf = std::shared_ptr<char[]>(new char[codec_len]);
+            read_reqs.clear();
+            read_reqs.emplace_back(codec_start_sector * sector_len, codec_len, codec_buf.get());
+            reader->read(read_reqs);
+            this->sq8_params.reset(new float[2 * this->data_dim]);
+            memcpy(this->sq8_params.get(), codec_buf.get(), 2 * this->data_dim * sizeof(float));
+        }
+    }
 //    READ_U32(index_metadata, nr);
 //    READ_U32(index_metadata, nc);
 //    READ_U64(index_metadata, disk_nnodes);
@@ -1413,7 +1721,28 @@ int PQFlashIndex<T, LabelT>::load_from_separate_paths(std::stringstream &pivots_
                       << disk_nnodes << " vs " << num_points << std::endl;
         return -1;
     }
-    max_degree = ((max_node_len - disk_bytes_per_point) / sizeof(uint32_t)) - 1;
+    max_degree = (max_node_len - disk_bytes_per_point - sizeof(uint32_t)) / nbr_id_bytes;
+
+    // locations appended by merges, see plan_merge
+    uint64_t file_ext_base = 0;
+    read_reqs.clear();
+    read_reqs.emplace_back(136, 8, &file_ext_base);
+    read_reqs.emplace_back(144, 8, &this->ext_start_sector);
+    reader->read(read_reqs);
+    if (this->ext_start_sector != 0)
+    {
+        this->ext_base = file_ext_base;
+    }
+    else
+    {
+        // the first location without a slot in the node sectors or the full-precision region
+        this->ext_base = ROUND_UP(num_points, nnodes_per_sector);
+        if (COMPACT_LAYOUT)
+        {
+            this->ext_base = (std::min)(this->ext_base, (uint64_t)ROUND_UP(num_points, nvecs_per_sector));
+        }
+    }
+    this->num_free_points = std::count(this->tags, this->tags + num_points, FREE_LOCATION_TAG);
 
     if (max_degree > MAX_GRAPH_DEGREE)
     {
@@ -1453,7 +1782,7 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
                                                  uint64_t *indices, float *distances, const uint64_t beam_width,
                                                  std::function<bool(int64_t)> filter,
                                                  const uint32_t io_limit, const bool use_reorder_data,
-                                                 QueryStats *stats)
+                                                 QueryStats *stats, const std::vector<uint32_t> &entry_points)
 {
     std::shared_ptr<float[]> aligned_query_T = std::shared_ptr<float[]>(new float[this->data_dim]);
 
@@ -1484,6 +1813,10 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
     auto dist_scratch = std::shared_ptr<float[]>(new float[this->max_degree]);
     auto pq_coord_scratch = std::shared_ptr<uint8_t[]>(new uint8_t[this->max_degree * this->n_chunks]);
 
+    // decoded node records of a compact layout
+    auto coord_scratch = std::shared_ptr<float[]>(new float[this->data_dim]);
+    auto nbr_scratch = std::shared_ptr<uint32_t[]>(new uint32_t[this->max_degree]);
+
     // lambda to batch compute query<-> node distances in PQ space
     auto compute_dists = [this, pq_coord_scratch, pq_dists](const uint32_t *ids, const uint64_t n_ids,
                                                             float *dists_out) {
@@ -1516,6 +1849,16 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
     compute_dists(&best_medoid, 1, dist_scratch.get());
     retset.insert(Neighbor(best_medoid, dist_scratch[0]));
     visited.insert(best_medoid);
+    for (auto entry : entry_points)
+    {
+        // extra entry points, e.g. nodes known to pass a categorical filter
+        if (entry < num_points && visited.insert(entry).second)
+        {
+            compute_dists(&entry, 1, dist_scratch.get());
+            retset.insert(Neighbor(entry, dist_scratch[0]));
+        }
+    }
+    DeferredCandidates<LabelT> deferred(filter, tags, k_search);
 
     uint32_t cmps = 0;
     uint32_t hops = 0;
@@ -1531,7 +1874,7 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
     std::vector<std::pair<uint32_t, std::pair<uint32_t, uint32_t *>>> cached_nhoods;
     cached_nhoods.reserve(2 * beam_width);
 
-    while (retset.has_unexpanded_node() && num_ios < io_limit)
+    while ((retset.has_unexpanded_node() || deferred.has_pending()) && num_ios < io_limit)
     {
         // clear iteration state
         frontier.clear();
@@ -1544,8 +1887,13 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
         while (retset.has_unexpanded_node() && frontier.size() < beam_width && num_seen < beam_width)
         {
             auto nbr = retset.closest_unexpanded();
-            num_seen++;
             auto iter = nhood_cache.find(nbr.id);
+            if (iter == nhood_cache.end() && deferred.rejects(nbr.id))
+            {
+                deferred.defer(nbr);
+                continue;
+            }
+            num_seen++;
             if (iter != nhood_cache.end())
             {
                 cached_nhoods.push_back(std::make_pair(nbr.id, iter->second));
@@ -1563,6 +1911,15 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
                 reinterpret_cast<std::atomic<uint32_t> &>(this->node_visit_counter[nbr.id].second).fetch_add(1);
             }
         }
+        // no valid candidate is left, expand through the closest rejected ones
+        if (frontier.empty() && cached_nhoods.empty())
+        {
+            Neighbor deferred_nbr;
+            while (frontier.size() < beam_width && deferred.pop(deferred_nbr))
+            {
+                frontier.push_back(deferred_nbr.id);
+            }
+        }
 
         // read nhoods of frontier ids
         if (!frontier.empty())
@@ -1585,7 +1942,9 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
                 }
                 num_ios++;
             }
-            reader->read(frontier_read_reqs);
+            // io_limit budgets the device reads of this query, a sector shared with a read already
+            // in flight for another query is given back
+            num_ios -= reader->read(frontier_read_reqs);
 
 //            diskann_stream.seekg(13598720);
 //            auto x = new char[4096];
@@ -1613,6 +1972,10 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
             float cur_expanded_dist;
             cur_expanded_dist = dist_cmp_float->compare(aligned_query_T.get(), (float *)node_fp_coords_copy, (uint32_t)data_dim);
             full_retset.push_back(Neighbor((uint32_t)cached_nhood.first, cur_expanded_dist));
+            if (not deferred.rejects(cached_nhood.first))
+            {
+                deferred.add_valid(cur_expanded_dist);
+            }
 
             uint64_t nnbrs = cached_nhood.second.first;
             uint32_t *node_nbrs = cached_nhood.second.second;
@@ -1636,12 +1999,15 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
         for (auto &frontier_nhood : frontier_nhoods)
         {
             char *node_disk_buf = OFFSET_TO_NODE(frontier_nhood.second, frontier_nhood.first);
-            uint32_t *node_buf = OFFSET_TO_NODE_NHOOD(node_disk_buf);
-            uint64_t nnbrs = (uint64_t)(*node_buf);
-            T *node_fp_coords = OFFSET_TO_NODE_COORDS(node_disk_buf);
-            float cur_expanded_dist = dist_cmp_float->compare((float *)aligned_query_T.get(), (float *)node_fp_coords, (uint32_t)data_dim);
+            uint64_t nnbrs;
+            const uint32_t *node_nbrs = node_nhood(node_disk_buf, nnbrs, nbr_scratch.get());
+            const float *node_fp_coords = node_coords(node_disk_buf, coord_scratch.get());
+            float cur_expanded_dist = dist_cmp_float->compare((float *)aligned_query_T.get(), node_fp_coords, (uint32_t)data_dim);
             full_retset.push_back(Neighbor(frontier_nhood.first, cur_expanded_dist));
-            uint32_t *node_nbrs = (node_buf + 1);
+            if (not deferred.rejects(frontier_nhood.first))
+            {
+                deferred.add_valid(cur_expanded_dist);
+            }
             // compute node_nbrs <-> query dist in PQ space
             compute_dists(node_nbrs, nnbrs, dist_scratch.get());
             if (stats != nullptr)
@@ -1668,6 +2034,10 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
 
     // re-sort by distance
     std::sort(full_retset.begin(), full_retset.end());
+    if (COMPACT_LAYOUT && use_reorder_data)
+    {
+        rerank_full_precision(aligned_query_T.get(), full_retset, k_search, filter, stats);
+    }
 
     // copy k_search values
     int64_t result_size = 0;
@@ -1697,74 +2067,352 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
 }
 
 template <typename T, typename LabelT>
-size_t PQFlashIndex<T, LabelT>::load_graph(std::stringstream &in)
-{
-    size_t expected_file_size;
-    size_t file_frozen_pts;
-
-    uint32_t max_observed_degree, start, max_range_of_loaded_graph;
-
-    size_t file_offset = 0; // will need this for single file format support
-    in.seekg(0);
-    in.read((char *)&expected_file_size, sizeof(expected_file_size));
-    in.read((char *)&max_observed_degree, sizeof(max_observed_degree));
-    in.read((char *)&start, sizeof(start));
-    in.read((char *)&file_frozen_pts, sizeof(file_frozen_pts));
-    size_t vamana_metadata_size = sizeof(expected_file_size) + sizeof(max_observed_degree) + sizeof(start) + sizeof(file_frozen_pts);
-
-    size_t bytes_read = vamana_metadata_size;
-    size_t cc = 0;
-    uint32_t nodes_read = 0;
-    final_graph.resize(num_points);
-    while (bytes_read < expected_file_size)
-    {
-        uint32_t k;
-        in.read((char *)&k, sizeof(uint32_t));
-        graph_size += k;
-        if (k == 0)
-        {
-            throw diskann::ANNException("ERROR: Point found with no out-neighbors.", -1);
-        }
-        max_degree = std::max(max_degree, (uint64_t)k);
-        cc += k;
-        ++nodes_read;
-        std::vector<uint32_t> tmp(k);
-        tmp.reserve(k);
-        in.read((char *)tmp.data(), k * sizeof(uint32_t));
-
-        final_graph[nodes_read - 1].swap(tmp);
-        bytes_read += sizeof(uint32_t) * ((size_t)k + 1);
-        if (k > max_range_of_loaded_graph)
-        {
-            max_range_of_loaded_graph = k;
-        }
-    }
-
-    if (bytes_read != expected_file_size)
-    {
-        throw diskann::ANNException("ERROR: the size of the file being read does not match the expected size.", -1);
-    }
-    return nodes_read;
-}
-
-
-template <typename T, typename LabelT>
-int64_t PQFlashIndex<T, LabelT>::cached_beam_search_memory(const T *query, const uint64_t k_search, const uint64_t l_search,
-                                                 uint64_t *indices, float *distances, const uint64_t beam_width,
-                                                 std::function<bool(int64_t)> filter,
-                                                 const uint32_t io_limit, const bool reorder,
-                                                 QueryStats *stats, bool use_for_range)
+int64_t PQFlashIndex<T, LabelT>::cached_beam_search_pipeline(const T *query1, const uint64_t k_search,
+                                                          const uint64_t l_search, uint64_t *indices,
+                                                          float *distances, const uint64_t beam_width,
+                                                          std::function<bool(int64_t)> filter,
+                                                          const uint32_t io_limit, const bool use_reorder_data,
+                                                          QueryStats *stats, const std::vector<uint32_t> &entry_points)
 {
     std::shared_ptr<float[]> aligned_query_T = std::shared_ptr<float[]>(new float[this->data_dim]);
 
-    // if inner product, we also normalize the query and set the last coordinate
-    // to 0 (this is the extra coordinate used to convert MIPS to L2 search)
-
     for (size_t i = 0; i < this->data_dim; i++)
     {
-        aligned_query_T[i] = (float) query[i];
+        aligned_query_T[i] = (float) query1[i];
     }
-
+    if (diskann::Metric::COSINE == metric) {
+        normalize(aligned_query_T.get(), this->data_dim);
+    }
+
+    // FIXME: alternative instruction on aarch64
+#if defined(__i386__) || defined(__x86_64__)
+    _mm_prefetch((char *)aligned_query_T.get(), _MM_HINT_T1);
+#endif
+
+    // query <-> PQ chunk centers distances
+    pq_table.preprocess_query(aligned_query_T.get()); // center the query and rotate if
+    // we have a rotation matrix
+    auto pq_dists = std::shared_ptr<float[]>(new float[NUM_CENTROID * this->n_chunks]);
+    pq_table.populate_chunk_distances(aligned_query_T.get(), pq_dists.get());
+
+    // query <-> neighbor list
+    auto dist_scratch = std::shared_ptr<float[]>(new float[this->max_degree]);
+    auto pq_coord_scratch = std::shared_ptr<uint8_t[]>(new uint8_t[this->max_degree * this->n_chunks]);
+
+    // lambda to batch compute query<-> node distances in PQ space
+    auto compute_dists = [this, pq_coord_scratch, pq_dists](const uint32_t *ids, const uint64_t n_ids,
+                                                            float *dists_out) {
+        diskann::aggregate_coords(ids, n_ids, this->data, this->n_chunks, pq_coord_scratch.get());
+        diskann::pq_dist_lookup(pq_coord_scratch.get(), n_ids, this->n_chunks, pq_dists.get(), dists_out);
+    };
+
+    tsl::robin_set<uint64_t> visited;
+    std::vector<Neighbor> full_retset;
+    NeighborPriorityQueue retset;
+    visited.reserve(l_search);
+    full_retset.reserve(l_search);
+    retset.reserve(l_search);
+
+    uint32_t best_medoid = 0;
+    float best_dist = std::numeric_limits<float>::max();
+
+    for (uint64_t cur_m = 0; cur_m < num_medoids; cur_m++)
+    {
+        float cur_expanded_dist =
+            dist_cmp_float->compare(aligned_query_T.get(), centroid_data + aligned_dim * cur_m, (uint32_t)data_dim);
+        if (cur_expanded_dist < best_dist)
+        {
+            best_medoid = medoids[cur_m];
+            best_dist = cur_expanded_dist;
+        }
+    }
+
+    compute_dists(&best_medoid, 1, dist_scratch.get());
+    retset.insert(Neighbor(best_medoid, dist_scratch[0]));
+    visited.insert(best_medoid);
+    for (auto entry : entry_points)
+    {
+        if (entry < num_points && visited.insert(entry).second)
+        {
+            compute_dists(&entry, 1, dist_scratch.get());
+            retset.insert(Neighbor(entry, dist_scratch[0]));
+        }
+    }
+    DeferredCandidates<LabelT> deferred(filter, tags, k_search);
+
+    // decoded node records of a compact layout
+    auto coord_scratch = std::shared_ptr<float[]>(new float[this->data_dim]);
+    auto nbr_scratch = std::shared_ptr<uint32_t[]>(new uint32_t[this->max_degree]);
+
+    // lambda to push a node with its exact distance and queue its unseen neighbors
+    auto expand_node = [&](uint32_t id, const float *node_fp_coords, uint64_t nnbrs, const uint32_t *node_nbrs) {
+        float cur_expanded_dist = dist_cmp_float->compare(aligned_query_T.get(), node_fp_coords, (uint32_t)data_dim);
+        full_retset.push_back(Neighbor(id, cur_expanded_dist));
+        if (not deferred.rejects(id))
+        {
+            deferred.add_valid(cur_expanded_dist);
+        }
+        compute_dists(node_nbrs, nnbrs, dist_scratch.get());
+        if (stats != nullptr)
+        {
+            stats->n_cmps += (uint32_t)nnbrs;
+        }
+        for (uint64_t m = 0; m < nnbrs; ++m)
+        {
+            uint32_t nbr_id = node_nbrs[m];
+            if (visited.insert(nbr_id).second)
+            {
+                retset.insert(Neighbor(nbr_id, dist_scratch[m]));
+            }
+        }
+    };
+
+    // the callbacks share this state, so a read finishing after the query has given up
+    // still writes into a live sector buffer
+    struct PipelineState
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<uint64_t> completed_slots;
+        bool failed = false;
+        std::string message;
+        std::shared_ptr<char[]> sectors;
+    };
+    auto state = std::make_shared<PipelineState>();
+    state->sectors.reset(new char[beam_width * sector_len]);
+
+    std::vector<uint32_t> slot_ids(beam_width);
+    std::vector<uint64_t> free_slots;
+    free_slots.reserve(beam_width);
+    for (uint64_t slot = beam_width; slot > 0; --slot)
+    {
+        free_slots.push_back(slot - 1);
+    }
+
+    uint64_t in_flight = 0;
+    uint32_t num_ios = 0;
+    bool io_failed = false;
+    std::string io_message;
+    std::vector<uint64_t> arrived_slots;
+    arrived_slots.reserve(beam_width);
+    std::vector<AlignedRead> read_req(1);
+
+    while (true)
+    {
+        // refill the pipeline with the closest unexpanded nodes
+        while (not io_failed && in_flight < beam_width && num_ios < io_limit)
+        {
+            Neighbor nbr;
+            if (retset.has_unexpanded_node())
+            {
+                nbr = retset.closest_unexpanded();
+                if (nhood_cache.find(nbr.id) == nhood_cache.end() && deferred.rejects(nbr.id))
+                {
+                    deferred.defer(nbr);
+                    continue;
+                }
+            }
+            else if (in_flight > 0 || not deferred.pop(nbr))
+            {
+                // pending reads may still bring valid candidates, rejected nodes wait for them
+                break;
+            }
+            if (this->count_visited_nodes)
+            {
+                reinterpret_cast<std::atomic<uint32_t> &>(this->node_visit_counter[nbr.id].second).fetch_add(1);
+            }
+            auto iter = nhood_cache.find(nbr.id);
+            if (iter != nhood_cache.end())
+            {
+                if (stats != nullptr)
+                {
+                    stats->n_cache_hits++;
+                }
+                expand_node(nbr.id, (const float *)coord_cache.find(nbr.id)->second, iter->second.first,
+                            iter->second.second);
+                continue;
+            }
+
+            uint64_t slot = free_slots.back();
+            free_slots.pop_back();
+            slot_ids[slot] = nbr.id;
+            read_req[0] = AlignedRead(NODE_SECTOR_NO(((size_t)nbr.id)) * sector_len, sector_len,
+                                      state->sectors.get() + slot * sector_len);
+            CallBack callBack = [state, slot](vsag::IOErrorCode code, const std::string &message) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if ((int)code != 0)
+                {
+                    state->failed = true;
+                    state->message = message;
+                }
+                state->completed_slots.push_back(slot);
+                state->cv.notify_one();
+            };
+            in_flight++;
+            num_ios++;
+            if (stats != nullptr)
+            {
+                stats->n_4k++;
+                stats->n_ios++;
+            }
+            // io_limit budgets the device reads of this query, a sector shared with a read already
+            // in flight for another query is given back
+            num_ios -= reader->read(read_req, true, callBack);
+        }
+
+        if (in_flight == 0)
+        {
+            break;
+        }
+
+        // wait for at least one sector and expand everything that has arrived meanwhile
+        Timer io_timer;
+        arrived_slots.clear();
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            // the pending callbacks keep state alive if the query gives up
+            if (not state->cv.wait_for(lock, std::chrono::milliseconds(PIPELINE_IO_TIMEOUT_MS),
+                                       [&state] { return not state->completed_slots.empty(); }))
+            {
+                throw std::runtime_error("timed out waiting for " + std::to_string(in_flight) +
+                                         " sector reads in pipelined beam search");
+            }
+            arrived_slots.swap(state->completed_slots);
+            if (state->failed && not io_failed)
+            {
+                io_failed = true;
+                io_message = state->message;
+            }
+        }
+        if (stats != nullptr)
+        {
+            stats->io_us += (float)io_timer.elapsed();
+            stats->n_hops++;
+        }
+        in_flight -= arrived_slots.size();
+
+        for (auto slot : arrived_slots)
+        {
+            free_slots.push_back(slot);
+            if (io_failed)
+            {
+                continue;
+            }
+            uint32_t id = slot_ids[slot];
+            char *node_disk_buf = OFFSET_TO_NODE(state->sectors.get() + slot * sector_len, id);
+            uint64_t nnbrs;
+            const uint32_t *node_nbrs = node_nhood(node_disk_buf, nnbrs, nbr_scratch.get());
+            expand_node(id, node_coords(node_disk_buf, coord_scratch.get()), nnbrs, node_nbrs);
+        }
+    }
+
+    if (io_failed)
+    {
+        throw std::runtime_error("failed to read sector in pipelined beam search: " + io_message);
+    }
+
+    // re-sort by distance
+    std::sort(full_retset.begin(), full_retset.end());
+    if (COMPACT_LAYOUT && use_reorder_data)
+    {
+        rerank_full_precision(aligned_query_T.get(), full_retset, k_search, filter, stats);
+    }
+
+    // copy k_search values
+    int64_t result_size = 0;
+    for (uint64_t i = 0; i < full_retset.size(); i++)
+    {
+        if (filter && filter(tags[full_retset[i].id])) {
+            continue;
+        }
+        if (result_size >= k_search) {
+            break;
+        }
+        indices[result_size] = tags[full_retset[i].id];
+        if (distances != nullptr)
+        {
+            distances[result_size] = full_retset[i].distance;
+            if (metric == diskann::Metric::INNER_PRODUCT || metric == diskann::Metric::COSINE)
+            {
+                // When using L2 distance to calculate IP distance, the L2
+                // distance is exactly twice the IP distance.
+                distances[result_size] = distances[result_size] / 2;
+            }
+        }
+        result_size ++;
+    }
+    return result_size;
+}
+
+template <typename T, typename LabelT>
+size_t PQFlashIndex<T, LabelT>::load_graph(std::stringstream &in)
+{
+    size_t expected_file_size;
+    size_t file_frozen_pts;
+
+    uint32_t max_observed_degree, start, max_range_of_loaded_graph;
+
+    size_t file_offset = 0; // will need this for single file format support
+    in.seekg(0);
+    in.read((char *)&expected_file_size, sizeof(expected_file_size));
+    in.read((char *)&max_observed_degree, sizeof(max_observed_degree));
+    in.read((char *)&start, sizeof(start));
+    in.read((char *)&file_frozen_pts, sizeof(file_frozen_pts));
+    size_t vamana_metadata_size = sizeof(expected_file_size) + sizeof(max_observed_degree) + sizeof(start) + sizeof(file_frozen_pts);
+
+    size_t bytes_read = vamana_metadata_size;
+    size_t cc = 0;
+    uint32_t nodes_read = 0;
+    final_graph.resize(num_points);
+    while (bytes_read < expected_file_size)
+    {
+        uint32_t k;
+        in.read((char *)&k, sizeof(uint32_t));
+        graph_size += k;
+        if (k == 0)
+        {
+            throw diskann::ANNException("ERROR: Point found with no out-neighbors.", -1);
+        }
+        max_degree = std::max(max_degree, (uint64_t)k);
+        cc += k;
+        ++nodes_read;
+        std::vector<uint32_t> tmp(k);
+        tmp.reserve(k);
+        in.read((char *)tmp.data(), k * sizeof(uint32_t));
+
+        final_graph[nodes_read - 1].swap(tmp);
+        bytes_read += sizeof(uint32_t) * ((size_t)k + 1);
+        if (k > max_range_of_loaded_graph)
+        {
+            max_range_of_loaded_graph = k;
+        }
+    }
+
+    if (bytes_read != expected_file_size)
+    {
+        throw diskann::ANNException("ERROR: the size of the file being read does not match the expected size.", -1);
+    }
+    return nodes_read;
+}
+
+
+template <typename T, typename LabelT>
+int64_t PQFlashIndex<T, LabelT>::cached_beam_search_memory(const T *query, const uint64_t k_search, const uint64_t l_search,
+                                                 uint64_t *indices, float *distances, const uint64_t beam_width,
+                                                 std::function<bool(int64_t)> filter,
+                                                 const uint32_t io_limit, const bool reorder,
+                                                 QueryStats *stats, bool use_for_range)
+{
+    std::shared_ptr<float[]> aligned_query_T = std::shared_ptr<float[]>(new float[this->data_dim]);
+
+    // if inner product, we also normalize the query and set the last coordinate
+    // to 0 (this is the extra coordinate used to convert MIPS to L2 search)
+
+    for (size_t i = 0; i < this->data_dim; i++)
+    {
+        aligned_query_T[i] = (float) query[i];
+    }
+
     if (diskann::Metric::COSINE == metric) {
         normalize(aligned_query_T.get(), this->data_dim);
     }
@@ -1873,7 +2521,7 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_memory(const T *query, const
                 if (not use_bsa || reorder_retset.empty() || reorder_retset.size() < k_search ||
                     distance_ranks.top() + this->errors[id] > full_retset[loc].distance) {
                     ids.push_back(id);
-                    sorted_read_reqs.push_back({NODE_SECTOR_NO(((size_t)id)) * sector_len, sector_len,
+                    sorted_read_reqs.push_back({FULL_VECTOR_SECTOR_NO(((size_t)id)) * sector_len, sector_len,
                                                 sector_scratch.get() + cur_loc * sector_len});
                     cur_loc ++;
                 }
@@ -1892,10 +2540,9 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_memory(const T *query, const
             for (int j = 0; j < sorted_read_reqs.size(); j ++)
             {
                 uint32_t id = ids[j];
-                char *node_disk_buf = OFFSET_TO_NODE(sorted_read_reqs[j].buf, id);
-                T *node_fp_coords = OFFSET_TO_NODE_COORDS(node_disk_buf);
+                float *node_fp_coords = OFFSET_TO_FULL_VECTOR(sorted_read_reqs[j].buf, id);
                 float exact_dist;
-                exact_dist = dist_cmp_float->compare(aligned_query_T.get(), (float *)node_fp_coords, (uint32_t)data_dim);
+                exact_dist = dist_cmp_float->compare(aligned_query_T.get(), node_fp_coords, (uint32_t)data_dim);
                 reorder_retset.push_back(Neighbor(id, exact_dist));
                 distance_ranks.push(exact_dist);
                 if (distance_ranks.size() > k_search) {
@@ -2023,7 +2670,7 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_async(const T *query, const
         auto nohood_id = nbr.id;
 
         if (reorder) {
-            sorted_read_reqs.emplace_back(NODE_SECTOR_NO(((size_t)nohood_id)) * sector_len, sector_len,
+            sorted_read_reqs.emplace_back(FULL_VECTOR_SECTOR_NO(((size_t)nohood_id)) * sector_len, sector_len,
                                           cache_sectors.get() + has_searched * sector_len);
             if (sorted_read_reqs.size() >= beam_width || has_searched == l_search - 1) {
                 int io_count = has_searched / beam_width;
@@ -2092,10 +2739,9 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_async(const T *query, const
 
             if (not use_bsa || reorder_retset.empty() || reorder_retset.size() < k_search ||
                 distance_ranks.top() + this->errors[id] > full_retset[j].distance) {
-                char *node_disk_buf = OFFSET_TO_NODE(cache_sectors.get() + loc * sector_len, id);
-                T *node_fp_coords = OFFSET_TO_NODE_COORDS(node_disk_buf);
+                float *node_fp_coords = OFFSET_TO_FULL_VECTOR(cache_sectors.get() + loc * sector_len, id);
                 float exact_dist;
-                exact_dist = dist_cmp_float->compare((float *)aligned_query_T.get(), (float *)node_fp_coords, (uint32_t)data_dim);
+                exact_dist = dist_cmp_float->compare((float *)aligned_query_T.get(), node_fp_coords, (uint32_t)data_dim);
                 if (stats != nullptr)
                 {
                     stats->n_cmps += 1;
@@ -2148,7 +2794,7 @@ int64_t PQFlashIndex<T, LabelT>::range_search(const T *query, const double range
                                               std::vector<float> &distances, const uint64_t min_beam_width,
                                               uint32_t io_limit, const bool reorder,
                                               std::function<bool(int64_t)> filter, bool memory,
-                                              QueryStats *stats)
+                                              QueryStats *stats, const std::vector<uint32_t> &entry_points)
 {
     int64_t res_count = 0;
     bool stop_flag = false;
@@ -2164,7 +2810,8 @@ int64_t PQFlashIndex<T, LabelT>::range_search(const T *query, const double range
         if (memory) {
             result_size = this->cached_beam_search_memory(query, l_search, l_search, indices.data(), distances.data(), min_beam_width, filter, io_limit, reorder, stats, true);
         } else {
-            result_size = this->cached_beam_search(query, l_search, l_search, indices.data(), distances.data(), min_beam_width, filter, io_limit, false, stats);
+            result_size = this->cached_beam_search(query, l_search, l_search, indices.data(), distances.data(),
+                                                   min_beam_width, filter, io_limit, reorder, stats, entry_points);
         }
         for (uint32_t i = 0; i < result_size; i++)
         {
@@ -2196,6 +2843,601 @@ template <typename T, typename LabelT> uint64_t PQFlashIndex<T, LabelT>::get_dat
     return num_points;
 }
 
+template <typename T, typename LabelT> const LabelT *PQFlashIndex<T, LabelT>::get_tags()
+{
+    return tags;
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::read_vectors(const uint32_t *locations, uint64_t count, T *vectors)
+{
+    const uint64_t BLOCK_SIZE = 64;
+    auto sector_scratch = std::shared_ptr<char[]>(new char[(std::min)(BLOCK_SIZE, count) * sector_len]);
+    std::vector<AlignedRead> read_reqs;
+    read_reqs.reserve(BLOCK_SIZE);
+    for (uint64_t start = 0; start < count; start += BLOCK_SIZE)
+    {
+        uint64_t end = (std::min)(start + BLOCK_SIZE, count);
+        read_reqs.clear();
+        for (uint64_t i = start; i < end; i++)
+        {
+            read_reqs.emplace_back(FULL_VECTOR_SECTOR_NO(((size_t)locations[i])) * sector_len, sector_len,
+                                   sector_scratch.get() + (i - start) * sector_len);
+        }
+        reader->read(read_reqs);
+        for (uint64_t i = start; i < end; i++)
+        {
+            memcpy(vectors + i * data_dim, OFFSET_TO_FULL_VECTOR(read_reqs[i - start].buf, locations[i]),
+                   data_dim * sizeof(T));
+        }
+    }
+}
+
+template <typename T, typename LabelT> uint64_t PQFlashIndex<T, LabelT>::get_free_num()
+{
+    return num_free_points;
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::prune_neighbors(const std::vector<Neighbor> &candidates, const float *vectors,
+                                              float alpha, std::vector<uint32_t> &pruned)
+{
+    // the occlusion of Index::occlude_list, tolerating more occlusion each round up to alpha
+    pruned.clear();
+    std::vector<float> occlude_factor(candidates.size(), 0.0f);
+    float cur_alpha = 1.0f;
+    while (cur_alpha <= alpha && pruned.size() < max_degree)
+    {
+        for (size_t i = 0; i < candidates.size() && pruned.size() < max_degree; i++)
+        {
+            if (occlude_factor[i] > cur_alpha)
+            {
+                continue;
+            }
+            occlude_factor[i] = std::numeric_limits<float>::max();
+            pruned.push_back(candidates[i].id);
+            for (size_t j = i + 1; j < candidates.size(); j++)
+            {
+                if (occlude_factor[j] > alpha)
+                {
+                    continue;
+                }
+                float djk = dist_cmp_float->compare(vectors + i * data_dim, vectors + j * data_dim, (uint32_t)data_dim);
+                occlude_factor[j] = djk == 0 ? std::numeric_limits<float>::max()
+                                             : (std::max)(occlude_factor[j], candidates[j].distance / djk);
+            }
+        }
+        cur_alpha *= 1.2f;
+    }
+}
+
+template <typename T, typename LabelT>
+typename PQFlashIndex<T, LabelT>::MergePlan PQFlashIndex<T, LabelT>::plan_merge(
+    const std::unordered_set<LabelT> &deleted_tags, const LabelT *insert_tags, const float *insert_vectors,
+    uint64_t insert_num, uint64_t l_search, float alpha, uint64_t layout_size, const LayoutReadFunc &read_layout)
+{
+    if (!std::is_same<T, float>::value || ext_base == std::numeric_limits<uint64_t>::max())
+    {
+        throw diskann::ANNException("merge needs a float index loaded from streams", -1, __FUNCSIG__, __FILE__,
+                                    __LINE__);
+    }
+    MergePlan plan;
+    plan.num_points = num_points;
+    plan.medoid = medoids[0];
+    plan.ext_start_sector = ext_start_sector;
+
+    // the patched sectors shadow the layout, a sector past its end starts zeroed
+    auto sector_of = [&](uint64_t sector) -> char * {
+        auto &buf = plan.sectors[sector];
+        if (buf == nullptr)
+        {
+            buf.reset(new char[sector_len]);
+            if ((sector + 1) * sector_len <= layout_size)
+            {
+                read_layout(sector * sector_len, sector_len, buf.get());
+            }
+            else
+            {
+                memset(buf.get(), 0, sector_len);
+            }
+        }
+        return buf.get();
+    };
+    // the record of loc as planned so far, valid until the next call
+    auto read_scratch = std::unique_ptr<char[]>(new char[sector_len]);
+    auto node_of = [&](uint32_t loc) -> const char * {
+        uint64_t sector = node_sector_no(loc, plan.ext_start_sector);
+        auto iter = plan.sectors.find(sector);
+        if (iter != plan.sectors.end())
+        {
+            return iter->second.get() + node_offset(loc);
+        }
+        read_layout(sector * sector_len, sector_len, read_scratch.get());
+        return read_scratch.get() + node_offset(loc);
+    };
+    auto nbr_scratch = std::unique_ptr<uint32_t[]>(new uint32_t[max_degree]);
+    auto nhood_of = [&](const char *node_buf, std::vector<uint32_t> &nhood) {
+        uint64_t nnbrs;
+        const uint32_t *nbrs = node_nhood(node_buf, nnbrs, nbr_scratch.get());
+        nhood.assign(nbrs, nbrs + nnbrs);
+    };
+    auto set_nhood = [&](uint32_t loc, const std::vector<uint32_t> &nhood) {
+        char *nhood_buf = sector_of(node_sector_no(loc, plan.ext_start_sector)) + node_offset(loc) +
+                          disk_bytes_per_point;
+        auto nnbrs = (uint32_t)nhood.size();
+        memcpy(nhood_buf, &nnbrs, sizeof(uint32_t));
+        memset(nhood_buf + sizeof(uint32_t), 0, max_degree * nbr_id_bytes);
+        pack_ids(nhood.data(), nnbrs, (uint32_t)nbr_id_bytes, nhood_buf + sizeof(uint32_t));
+        plan.touched.push_back(loc);
+    };
+
+    // pq reconstructions stand in for the vectors that would cost a read
+    auto code_of = [&](uint32_t loc) -> uint8_t * {
+        auto iter = plan.codes.find(loc);
+        return iter != plan.codes.end() ? iter->second.data() : data + (uint64_t)loc * n_chunks;
+    };
+    std::vector<float> node_vector(data_dim);
+    std::vector<float> candidate_vectors;
+    std::vector<Neighbor> candidates;
+    std::vector<uint32_t> pruned;
+    auto prune_on_pq = [&](uint32_t loc, std::vector<uint32_t> &nhood) {
+        pq_table.inflate_vector(code_of(loc), node_vector.data());
+        candidates.clear();
+        std::vector<float> vectors(nhood.size() * data_dim);
+        for (size_t i = 0; i < nhood.size(); i++)
+        {
+            pq_table.inflate_vector(code_of(nhood[i]), vectors.data() + i * data_dim);
+            candidates.emplace_back(
+                nhood[i], dist_cmp_float->compare(node_vector.data(), vectors.data() + i * data_dim, (uint32_t)data_dim));
+        }
+        std::vector<size_t> order(candidates.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return candidates[a] < candidates[b]; });
+        std::vector<Neighbor> sorted;
+        candidate_vectors.resize(order.size() * data_dim);
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            sorted.push_back(candidates[order[i]]);
+            memcpy(candidate_vectors.data() + i * data_dim, vectors.data() + order[i] * data_dim,
+                   data_dim * sizeof(float));
+        }
+        prune_neighbors(sorted, candidate_vectors.data(), alpha, pruned);
+        nhood = pruned;
+    };
+
+    // locations freed by earlier merges and the ones deleted now are dead until an insert takes them over
+    std::vector<uint32_t> free_locs;
+    tsl::robin_set<uint32_t> deleted;
+    for (uint32_t loc = 0; loc < num_points; loc++)
+    {
+        if (tags[loc] == FREE_LOCATION_TAG)
+        {
+            free_locs.push_back(loc);
+        }
+        else if (deleted_tags.count(tags[loc]) > 0)
+        {
+            deleted.insert(loc);
+            free_locs.push_back(loc);
+        }
+    }
+    tsl::robin_set<uint32_t> dead(free_locs.begin(), free_locs.end());
+    uint64_t alive = num_points - free_locs.size();
+    if (alive == 0)
+    {
+        throw diskann::ANNException("merge would delete every location of the layout", -1, __FUNCSIG__, __FILE__,
+                                    __LINE__);
+    }
+
+    std::vector<uint32_t> nhood;
+    tsl::robin_map<uint32_t, std::vector<uint32_t>> deleted_nhoods;
+    for (auto loc : deleted)
+    {
+        nhood_of(node_of(loc), deleted_nhoods[loc]);
+    }
+
+    if (dead.count(plan.medoid) > 0)
+    {
+        // searches start from the medoid, hand the role over to its first surviving neighbor
+        uint32_t medoid = plan.medoid;
+        for (auto nbr : deleted_nhoods[plan.medoid])
+        {
+            if (dead.count(nbr) == 0)
+            {
+                medoid = nbr;
+                break;
+            }
+        }
+        for (uint32_t loc = 0; medoid == plan.medoid; loc++)
+        {
+            if (dead.count(loc) == 0)
+            {
+                medoid = loc;
+            }
+        }
+        plan.medoid = medoid;
+        plan.medoid_coords.resize(aligned_dim, 0.0f);
+        auto coord_scratch = std::unique_ptr<float[]>(new float[data_dim]);
+        memcpy(plan.medoid_coords.data(), node_coords(node_of(medoid), coord_scratch.get()), data_dim * sizeof(float));
+    }
+
+    if (!deleted.empty())
+    {
+        // nodes pointing at a deleted location take over its neighbors, the node sectors are scanned
+        // in runs of consecutive sectors
+        const uint64_t SCAN_SECTORS = 64;
+        auto scan_buf = std::unique_ptr<char[]>(new char[SCAN_SECTORS * sector_len]);
+        auto sector_end = [&](uint64_t loc) -> uint64_t {
+            if (loc < ext_base)
+            {
+                return (std::min)(ext_base, (loc / nnodes_per_sector + 1) * nnodes_per_sector);
+            }
+            return ext_base + ((loc - ext_base) / nnodes_per_sector + 1) * nnodes_per_sector;
+        };
+        tsl::robin_set<uint32_t> seen;
+        uint64_t loc = 0;
+        while (loc < num_points)
+        {
+            uint64_t first_sector = node_sector_no(loc, ext_start_sector);
+            uint64_t run_end = loc;
+            uint64_t run_sectors = 0;
+            while (run_end < num_points && run_sectors < SCAN_SECTORS &&
+                   node_sector_no(run_end, ext_start_sector) == first_sector + run_sectors)
+            {
+                run_end = (std::min)(sector_end(run_end), num_points);
+                run_sectors++;
+            }
+            read_layout(first_sector * sector_len, run_sectors * sector_len, scan_buf.get());
+            for (; loc < run_end; loc++)
+            {
+                if (dead.count((uint32_t)loc) > 0)
+                {
+                    continue;
+                }
+                uint64_t sector = node_sector_no(loc, ext_start_sector);
+                const char *sector_buf = scan_buf.get() + (sector - first_sector) * sector_len;
+                nhood_of(sector_buf + node_offset(loc), nhood);
+                bool affected = std::any_of(nhood.begin(), nhood.end(),
+                                            [&](uint32_t nbr) { return deleted.count(nbr) > 0; });
+                if (!affected)
+                {
+                    continue;
+                }
+                std::vector<uint32_t> repaired;
+                seen.clear();
+                auto add = [&](uint32_t nbr) {
+                    if (nbr != loc && dead.count(nbr) == 0 && seen.insert(nbr).second)
+                    {
+                        repaired.push_back(nbr);
+                    }
+                };
+                for (auto nbr : nhood)
+                {
+                    if (deleted.count(nbr) == 0)
+                    {
+                        add(nbr);
+                        continue;
+                    }
+                    for (auto next : deleted_nhoods[nbr])
+                    {
+                        add(next);
+                    }
+                }
+                if (repaired.size() > max_degree)
+                {
+                    prune_on_pq((uint32_t)loc, repaired);
+                }
+                if (repaired.empty() && loc != plan.medoid)
+                {
+                    repaired.push_back(plan.medoid);
+                }
+                auto &patched = plan.sectors[sector];
+                if (patched == nullptr)
+                {
+                    patched.reset(new char[sector_len]);
+                    memcpy(patched.get(), sector_buf, sector_len);
+                }
+                set_nhood((uint32_t)loc, repaired);
+            }
+        }
+    }
+
+    for (auto loc : deleted)
+    {
+        plan.tags[loc] = FREE_LOCATION_TAG;
+    }
+
+    // inserts take over the dead locations first and are appended after them, up to what a packed
+    // neighbor id can address
+    uint64_t id_limit = nbr_id_bytes < sizeof(uint32_t) ? (1ULL << (8 * nbr_id_bytes))
+                                                        : (uint64_t)std::numeric_limits<uint32_t>::max();
+    size_t next_free = 0;
+    auto allocate = [&](uint32_t &loc) -> bool {
+        if (next_free < free_locs.size())
+        {
+            loc = free_locs[next_free++];
+            dead.erase(loc);
+            return true;
+        }
+        if (plan.num_points >= id_limit)
+        {
+            return false;
+        }
+        if (plan.num_points >= ext_base && plan.ext_start_sector == 0)
+        {
+            plan.ext_start_sector = DIV_ROUND_UP(layout_size, sector_len);
+        }
+        loc = (uint32_t)plan.num_points++;
+        return true;
+    };
+
+    const float *sq8_lower = sq8_params ? sq8_params.get() : nullptr;
+    const float *sq8_scale = sq8_params ? sq8_params.get() + data_dim : nullptr;
+    auto pq_dists = std::unique_ptr<float[]>(new float[NUM_CENTROID * n_chunks]);
+    auto coord_scratch = std::unique_ptr<float[]>(new float[data_dim]);
+    std::vector<float> vec(data_dim), query(data_dim);
+    std::vector<Neighbor> expanded;
+    std::vector<float> expanded_vectors;
+    tsl::robin_set<uint32_t> visited;
+    for (uint64_t i = 0; i < insert_num; i++)
+    {
+        uint32_t loc;
+        if (!allocate(loc))
+        {
+            break;
+        }
+        const float *insert_vector = insert_vectors + i * data_dim;
+        auto &code = plan.codes[loc];
+        code.resize(n_chunks);
+        float error = pq_table.encode_vector(insert_vector, code.data());
+        if (use_bsa)
+        {
+            plan.errors[loc] = error;
+        }
+        memcpy(vec.data(), insert_vector, data_dim * sizeof(float));
+        if (diskann::Metric::COSINE == metric)
+        {
+            normalize(vec.data(), data_dim);
+        }
+
+        // greedy search from the medoid, ranked by pq distance and expanded with the stored vectors
+        memcpy(query.data(), vec.data(), data_dim * sizeof(float));
+        pq_table.preprocess_query(query.data());
+        pq_table.populate_chunk_distances(query.data(), pq_dists.get());
+        auto pq_distance = [&](uint32_t id) {
+            float dist;
+            pq_dist_lookup(code_of(id), 1, n_chunks, pq_dists.get(), &dist);
+            return dist;
+        };
+        NeighborPriorityQueue retset(l_search);
+        visited.clear();
+        expanded.clear();
+        expanded_vectors.clear();
+        retset.insert(Neighbor(plan.medoid, pq_distance(plan.medoid)));
+        visited.insert(plan.medoid);
+        while (retset.has_unexpanded_node())
+        {
+            auto nbr = retset.closest_unexpanded();
+            const char *node_buf = node_of(nbr.id);
+            const float *coords = node_coords(node_buf, coord_scratch.get());
+            expanded.emplace_back(nbr.id, dist_cmp_float->compare(vec.data(), coords, (uint32_t)data_dim));
+            expanded_vectors.insert(expanded_vectors.end(), coords, coords + data_dim);
+            nhood_of(node_buf, nhood);
+            for (auto id : nhood)
+            {
+                if (id < plan.num_points && id != loc && dead.count(id) == 0 && visited.insert(id).second)
+                {
+                    retset.insert(Neighbor(id, pq_distance(id)));
+                }
+            }
+        }
+        std::vector<size_t> order(expanded.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return expanded[a] < expanded[b]; });
+        std::vector<Neighbor> sorted;
+        candidate_vectors.resize(order.size() * data_dim);
+        for (size_t j = 0; j < order.size(); j++)
+        {
+            sorted.push_back(expanded[order[j]]);
+            memcpy(candidate_vectors.data() + j * data_dim, expanded_vectors.data() + order[j] * data_dim,
+                   data_dim * sizeof(float));
+        }
+        prune_neighbors(sorted, candidate_vectors.data(), alpha, pruned);
+        std::vector<uint32_t> new_nhood = pruned;
+
+        // the node record, and the full-precision vector of a compact layout
+        char *node_buf = sector_of(node_sector_no(loc, plan.ext_start_sector)) + node_offset(loc);
+        memset(node_buf, 0, max_node_len);
+        if (COMPACT_LAYOUT)
+        {
+            encode_sector_vector(sector_vector_type, vec.data(), data_dim, sq8_lower, sq8_scale, node_buf);
+            memcpy(sector_of(vector_sector_no(loc, plan.ext_start_sector)) + vector_sector_offset(loc), vec.data(),
+                   data_dim * sizeof(float));
+        }
+        else
+        {
+            memcpy(node_buf, vec.data(), data_dim * sizeof(float));
+        }
+        set_nhood(loc, new_nhood);
+        plan.tags[loc] = insert_tags[i];
+        plan.placed.push_back(insert_tags[i]);
+
+        // backward edges, a full neighbor list is pruned again on pq reconstructions
+        for (auto nbr : new_nhood)
+        {
+            nhood_of(node_of(nbr), nhood);
+            if (std::find(nhood.begin(), nhood.end(), loc) != nhood.end())
+            {
+                continue;
+            }
+            nhood.push_back(loc);
+            if (nhood.size() > max_degree)
+            {
+                prune_on_pq(nbr, nhood);
+            }
+            set_nhood(nbr, nhood);
+        }
+    }
+    plan.num_free_points = free_locs.size() - next_free;
+
+    if (plan.sectors.empty() && plan.num_points == num_points && plan.medoid == medoids[0])
+    {
+        return plan;
+    }
+    // appended sectors are written in order, fill the gaps an extension block leaves
+    uint64_t layout_sectors = DIV_ROUND_UP(layout_size, sector_len);
+    if (!plan.sectors.empty())
+    {
+        for (uint64_t sector = layout_sectors; sector < plan.sectors.rbegin()->first; sector++)
+        {
+            sector_of(sector);
+        }
+    }
+    // metadata: the point count, the medoid, the file size and the extension blocks
+    char *meta = sector_of(0);
+    uint32_t meta_num;
+    memcpy(&meta_num, meta, sizeof(uint32_t));
+    meta_num = (std::max)(meta_num, (uint32_t)18);
+    memcpy(meta, &meta_num, sizeof(uint32_t));
+    uint64_t medoid_u64 = plan.medoid;
+    uint64_t file_size = (std::max)(layout_sectors, plan.sectors.rbegin()->first + 1) * sector_len;
+    uint64_t file_ext_base = plan.ext_start_sector != 0 ? ext_base : 0;
+    memcpy(meta + 8, &plan.num_points, sizeof(uint64_t));
+    memcpy(meta + 24, &medoid_u64, sizeof(uint64_t));
+    memcpy(meta + (COMPACT_LAYOUT ? 96 : 72), &file_size, sizeof(uint64_t));
+    memcpy(meta + 136, &file_ext_base, sizeof(uint64_t));
+    memcpy(meta + 144, &plan.ext_start_sector, sizeof(uint64_t));
+    return plan;
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::apply_merge(MergePlan &plan, const LayoutWriteFunc &write_layout)
+{
+    for (auto &[sector, buf] : plan.sectors)
+    {
+        write_layout(sector * sector_len, sector_len, buf.get());
+    }
+
+    if (plan.num_points > num_points)
+    {
+        auto *new_data = new uint8_t[plan.num_points * n_chunks];
+        memcpy(new_data, data, num_points * n_chunks * sizeof(uint8_t));
+        delete[] data;
+        data = new_data;
+        auto *new_tags = new LabelT[plan.num_points];
+        memcpy(new_tags, tags, num_points * sizeof(LabelT));
+        delete[] tags;
+        tags = new_tags;
+        if (use_bsa)
+        {
+            std::shared_ptr<float[]> new_errors(new float[plan.num_points]);
+            memcpy(new_errors.get(), errors.get(), num_points * sizeof(float));
+            errors = new_errors;
+        }
+        if (!final_graph.empty())
+        {
+            final_graph.resize(plan.num_points);
+        }
+        num_points = plan.num_points;
+    }
+    for (auto &[loc, tag] : plan.tags)
+    {
+        tags[loc] = tag;
+    }
+    for (auto &[loc, code] : plan.codes)
+    {
+        memcpy(data + (uint64_t)loc * n_chunks, code.data(), n_chunks * sizeof(uint8_t));
+    }
+    for (auto &[loc, error] : plan.errors)
+    {
+        errors[loc] = error;
+    }
+    medoids[0] = plan.medoid;
+    if (!plan.medoid_coords.empty())
+    {
+        memcpy(centroid_data, plan.medoid_coords.data(), data_dim * sizeof(float));
+    }
+    ext_start_sector = plan.ext_start_sector;
+    num_free_points = plan.num_free_points;
+
+    // the node cache and the preloaded graph follow the patched records
+    std::sort(plan.touched.begin(), plan.touched.end());
+    plan.touched.erase(std::unique(plan.touched.begin(), plan.touched.end()), plan.touched.end());
+    auto nbr_scratch = std::unique_ptr<uint32_t[]>(new uint32_t[max_degree]);
+    for (auto loc : plan.touched)
+    {
+        const char *node_buf = OFFSET_TO_NODE(plan.sectors.at(NODE_SECTOR_NO(loc)).get(), loc);
+        uint64_t nnbrs;
+        const uint32_t *nbrs = node_nhood(node_buf, nnbrs, nbr_scratch.get());
+        if (!final_graph.empty())
+        {
+            graph_size += (int64_t)nnbrs - (int64_t)final_graph[loc].size();
+            final_graph[loc].assign(nbrs, nbrs + nnbrs);
+        }
+        auto cached = nhood_cache.find(loc);
+        if (cached == nhood_cache.end())
+        {
+            continue;
+        }
+        memcpy(cached.value().second, nbrs, nnbrs * sizeof(uint32_t));
+        cached.value().first = (uint32_t)nnbrs;
+        T *cached_coords = coord_cache.at(loc);
+        if (COMPACT_LAYOUT)
+        {
+            node_coords(node_buf, (float *)cached_coords);
+        }
+        else
+        {
+            memcpy(cached_coords, node_buf, disk_bytes_per_point);
+        }
+    }
+}
+
+template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::save_tags(std::stringstream &out)
+{
+    auto npts = (int32_t)num_points;
+    int32_t dim = 1;
+    out.write((char *)&npts, sizeof(int32_t));
+    out.write((char *)&dim, sizeof(int32_t));
+    out.write((char *)tags, num_points * sizeof(LabelT));
+}
+
+template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::save_compressed_vectors(std::stringstream &out)
+{
+    auto npts = (uint32_t)num_points;
+    auto nchunks = (uint32_t)n_chunks;
+    out.write((char *)&npts, sizeof(uint32_t));
+    out.write((char *)&nchunks, sizeof(uint32_t));
+    out.write((char *)data, num_points * n_chunks * sizeof(uint8_t));
+    if (use_bsa)
+    {
+        out.write((char *)errors.get(), num_points * sizeof(float));
+    }
+}
+
+template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::save_graph(std::stringstream &out)
+{
+    // the vamana file layout load_graph reads
+    uint64_t file_size = sizeof(uint64_t) + 2 * sizeof(uint32_t) + sizeof(uint64_t);
+    uint32_t max_observed_degree = 0;
+    for (const auto &nhood : final_graph)
+    {
+        file_size += (nhood.size() + 1) * sizeof(uint32_t);
+        max_observed_degree = (std::max)(max_observed_degree, (uint32_t)nhood.size());
+    }
+    uint32_t start = medoids[0];
+    uint64_t frozen_pts = num_frozen_points;
+    out.write((char *)&file_size, sizeof(uint64_t));
+    out.write((char *)&max_observed_degree, sizeof(uint32_t));
+    out.write((char *)&start, sizeof(uint32_t));
+    out.write((char *)&frozen_pts, sizeof(uint64_t));
+    for (const auto &nhood : final_graph)
+    {
+        auto nnbrs = (uint32_t)nhood.size();
+        out.write((char *)&nnbrs, sizeof(uint32_t));
+        out.write((char *)nhood.data(), nnbrs * sizeof(uint32_t));
+    }
+}
+
 template <typename T, typename LabelT> diskann::Metric PQFlashIndex<T, LabelT>::get_metric()
 {
     return this->metric;
@@ -2208,7 +3450,7 @@ template <typename T, typename LabelT>  int64_t PQFlashIndex<T, LabelT>::get_mem
     memory_size += pq_table.get_memory_usage();
     memory_size += disk_pq_table.get_memory_usage();
     memory_size += nhood_cache.size() * (max_degree + 1) * sizeof(uint32_t);
-    memory_size += coord_cache.size() * nhood_cache.size() * aligned_dim * sizeof(T);
+    memory_size += coord_cache.size() * aligned_dim * sizeof(T);
     memory_size += _labels.size() * sizeof(LabelT);
     memory_size += _filter_list.size() * sizeof(LabelT);
     memory_size += graph_size * sizeof(uint32_t);
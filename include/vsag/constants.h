@@ -36,6 +36,10 @@ extern const char* const DISKANN_COMPRESSED_VECTOR;
 extern const char* const DISKANN_LAYOUT_FILE;
 extern const char* const DISKANN_TAG_FILE;
 extern const char* const DISKANN_GRAPH;
+extern const char* const DISKANN_CACHE_NODES;
+extern const char* const DISKANN_DELTA_IDS;
+extern const char* const DISKANN_DELTA_VECTORS;
+extern const char* const DISKANN_DELETED_IDS;
 extern const char* const SIMPLEFLAT_VECTORS;
 extern const char* const SIMPLEFLAT_IDS;
 extern const char* const METRIC_L2;
@@ -61,17 +65,25 @@ extern const char* const DISKANN_PARAMETER_USE_REFERENCE;
 extern const char* const DISKANN_PARAMETER_USE_OPQ;
 extern const char* const DISKANN_PARAMETER_USE_ASYNC_IO;
 extern const char* const DISKANN_PARAMETER_USE_BSA;
+extern const char* const DISKANN_PARAMETER_CACHE_SIZE;
+extern const char* const DISKANN_PARAMETER_MERGE_THRESHOLD;
+extern const char* const DISKANN_PARAMETER_BUILD_MEMORY_BUDGET;
 extern const char* const DISKANN_PARAMETER_GRAPH_TYPE;
 extern const char* const DISKANN_PARAMETER_ALPHA;
 extern const char* const DISKANN_PARAMETER_GRAPH_ITER_TURN;
 extern const char* const DISKANN_PARAMETER_NEIGHBOR_SAMPLE_RATE;
+extern const char* const DISKANN_PARAMETER_SECTOR_VECTOR_TYPE;
 extern const char* const DISKANN_GRAPH_TYPE_VAMANA;
 extern const char* const DISKANN_GRAPH_TYPE_ODESCENT;
+extern const char* const DISKANN_SECTOR_VECTOR_TYPE_FP32;
+extern const char* const DISKANN_SECTOR_VECTOR_TYPE_FP16;
+extern const char* const DISKANN_SECTOR_VECTOR_TYPE_SQ8;
 
 extern const char* const DISKANN_PARAMETER_BEAM_SEARCH;
 extern const char* const DISKANN_PARAMETER_IO_LIMIT;
 extern const char* const DISKANN_PARAMETER_EF_SEARCH;
 extern const char* const DISKANN_PARAMETER_REORDER;
+extern const char* const DISKANN_PARAMETER_ENTRY_IDS;
 
 extern const char* const HNSW_PARAMETER_EF_RUNTIME;
 extern const char* const HNSW_PARAMETER_M;
@@ -79,6 +91,7 @@ extern const char* const HNSW_PARAMETER_CONSTRUCTION;
 extern const char* const HNSW_PARAMETER_USE_STATIC;
 extern const char* const HNSW_PARAMETER_REVERSED_EDGES;
 extern const char* const HNSW_PARAMETER_SKIP_RATIO;
+extern const char* const HNSW_PARAMETER_GRAPH_REORDER;
 
 extern const char* const INDEX_PARAM;
 
@@ -89,6 +102,10 @@ extern const char PART_SLASH;
 extern const char* const STATSTIC_MEMORY;
 extern const char* const STATSTIC_INDEX_NAME;
 extern const char* const STATSTIC_DATA_NUM;
+extern const char* const STATSTIC_HUGEPAGE_MEMORY;
+extern const char* const STATSTIC_PREFETCH_JUMP_CODE_SIZE;
+extern const char* const STATSTIC_PREFETCH_CACHE_LINE_SIZE;
+extern const char* const STATSTIC_PREFETCH_NEIGHBOR_VISIT_NUM;
 
 extern const char* const STATSTIC_KNN_TIME;
 extern const char* const STATSTIC_KNN_IO;
@@ -100,6 +117,11 @@ extern const char* const STATSTIC_RANGE_IO;
 extern const char* const STATSTIC_RANGE_HOP;
 extern const char* const STATSTIC_RANGE_CACHE_HIT;
 extern const char* const STATSTIC_RANGE_IO_TIME;
+extern const char* const STATSTIC_IO_QUEUE_DEPTH;
+extern const char* const STATSTIC_IO_MAX_QUEUE_DEPTH;
+extern const char* const STATSTIC_IO_DEVICE_READS;
+extern const char* const STATSTIC_IO_SHARED_READS;
+extern const char* const STATSTIC_IO_COALESCED_READS;
 
 //Error message
 extern const char* const MESSAGE_PARAMETER;
@@ -112,10 +134,25 @@ extern const char* const SERIALIZE_VERSION;
 extern const char* const HGRAPH_USE_REORDER;
 extern const char* const HGRAPH_BASE_QUANTIZATION_TYPE;
 extern const char* const HGRAPH_GRAPH_MAX_DEGREE;
+extern const char* const HGRAPH_GRAPH_USE_COMPRESSION;
+extern const char* const HGRAPH_COLOCATE_GRAPH;
+extern const char* const HGRAPH_USE_HUGEPAGE;
+extern const char* const HGRAPH_NUMA_INTERLEAVE;
 extern const char* const HGRAPH_BUILD_EF_CONSTRUCTION;
 extern const char* const HGRAPH_INIT_CAPACITY;
 extern const char* const HGRAPH_BUILD_THREAD_COUNT;
+extern const char* const HGRAPH_BUILD_GRAPH_REORDER;
+extern const char* const HGRAPH_BUILD_TUNE_PREFETCH;
 extern const char* const HGRAPH_PRECISE_QUANTIZATION_TYPE;
+extern const char* const HGRAPH_PRECISE_IO_TYPE;
+extern const char* const HGRAPH_PRECISE_IO_HOT_SIZE;
+extern const char* const HGRAPH_BASE_DRIFT_THRESHOLD;
+extern const char* const HGRAPH_BASE_TRANSFORM_TYPE;
+extern const char* const HGRAPH_BASE_TRANSFORM_DIM;
+extern const char* const HGRAPH_RERANK_STAGES;
+extern const char* const HGRAPH_RERANK_STAGE_QUANTIZATION_TYPE;
+extern const char* const HGRAPH_RERANK_STAGE_IO_TYPE;
+extern const char* const HGRAPH_RERANK_STAGE_CANDIDATE_FACTOR;
 
 extern const char* const BRUTE_FORCE_QUANTIZATION_TYPE;
 extern const char* const BRUTE_FORCE_IO_TYPE;
@@ -17,6 +17,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <limits>
 #include <queue>
 #include <stdexcept>
@@ -37,6 +38,7 @@ namespace vsag {
 class Index;
 using IndexPtr = std::shared_ptr<Index>;
 using IdMapFunction = std::function<std::tuple<bool, int64_t>(int64_t)>;
+using WriteFuncType = std::function<void(uint64_t offset, uint64_t size, void* data)>;
 
 struct MergeUnit {
     IndexPtr index = nullptr;
@@ -395,6 +397,31 @@ public:
         throw std::runtime_error("Index not support deserialize from a file stream");
     }
 
+public:
+    // [serialize with write function]
+
+    /**
+      * @brief Serialize index through a write function, the sections are streamed one after
+      *   another without keeping a copy of the whole index in memory
+      *
+      * @param write_func is called as write_func(offset, size, data) with increasing offsets,
+      *   the written bytes hold every key of Serialize() as | key_size | key | size | data |
+      */
+    virtual tl::expected<void, Error>
+    Serialize(WriteFuncType write_func) const {
+        throw std::runtime_error("Index not support serialize with a write function");
+    }
+
+    /**
+      * @brief Return the number of bytes Serialize(write_func) writes, without serializing
+      *
+      * @return size of the serialized index in bytes.
+      */
+    [[nodiscard]] virtual uint64_t
+    CalSerializeSize() const {
+        throw std::runtime_error("Index not support serialize with a write function");
+    }
+
 public:
     // [statstics methods]
 
@@ -63,6 +63,8 @@ enum IndexFeature {
 
     SUPPORT_MERGE_INDEX, /**< Supports to merge indices of the same type */
 
+    SUPPORT_SERIALIZE_WRITE_FUNC, /**< Supports serialization through a write function */
+
     INDEX_FEATURE_COUNT /** must be last one */
 };
 }  // namespace vsag
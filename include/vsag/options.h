@@ -115,6 +115,29 @@ public:
     void
     set_block_size_limit(size_t size);
 
+    /**
+     * @brief Gets whether the workers of the default thread pool are bound to NUMA nodes.
+     *
+     * @return bool True if each worker is pinned to the cpus of one NUMA node.
+     */
+    [[nodiscard]] inline bool
+    numa_bind_threads() const {
+        return numa_bind_threads_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Sets whether the workers of the default thread pool are bound to NUMA nodes.
+     *
+     * The workers are spread round-robin across the nodes, thread pools created before the
+     * call are not affected.
+     *
+     * @param bind True to pin each worker to the cpus of one NUMA node.
+     */
+    inline void
+    set_numa_bind_threads(bool bind) {
+        numa_bind_threads_.store(bind, std::memory_order_release);
+    }
+
     /**
      * @brief Gets the current logger instance.
      *
@@ -160,6 +183,9 @@ private:
     ///< The size of the maximum memory allocated each time (default is 128MB).
     std::atomic<size_t> block_size_limit_{128 * 1024 * 1024};
 
+    ///< Whether the workers of the default thread pool are bound to NUMA nodes.
+    std::atomic<bool> numa_bind_threads_{false};
+
     ///< Pointer to the logger instance.
     Logger* logger_ = nullptr;
 };
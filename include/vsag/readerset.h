@@ -102,6 +102,30 @@ public:
     Size() const = 0;
 };
 
+/**
+ * @class WritableReader
+ * @brief A `Reader` whose data source can also be patched in place.
+ *
+ * Indexes that update their files after deserialization (e.g. the DiskANN merge) write through
+ * this interface, a plain `Reader` is left untouched and the updates are kept in memory instead.
+ */
+class WritableReader : public Reader {
+public:
+    /**
+     * @brief Writes a specified number of bytes to the data source.
+     *
+     * This pure virtual function synchronously writes `len` bytes from `src` to the source
+     * starting at `offset`. Writing at the end of the source extends it. This method is
+     * thread-safe, but reads overlapping a running write may observe either content.
+     *
+     * @param offset The starting position for writing in the data source.
+     * @param len The number of bytes to write.
+     * @param src Pointer to the memory holding the bytes to write.
+     */
+    virtual void
+    Write(uint64_t offset, uint64_t len, const void* src) = 0;
+};
+
 /**
  * @class ReaderSet
  * @brief A class for managing a collection of `Reader` objects.
@@ -17,11 +17,15 @@
 
 #include <fmt/format-inl.h>
 
+#include <chrono>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 
 #include "common.h"
+#include "data_cell/compressed_graph_datacell.h"
 #include "data_cell/sparse_graph_datacell.h"
+#include "impl/graph_reorder.h"
 #include "index/hgraph_index_zparameters.h"
 #include "logger.h"
 
@@ -42,6 +46,11 @@ empty_binaryset() {
     return bs;
 }
 
+// marks the optional prefetch trailer, indexes written before it existed end after the route
+// graphs and load with the configured prefetch values
+static constexpr uint64_t PREFETCH_TRAILER_MAGIC = 0x3146504850524748;  // "HGRPHPF1"
+static constexpr uint64_t PREFETCH_TRAILER_SIZE = sizeof(uint64_t) + 3 * sizeof(uint32_t);
+
 static uint64_t
 next_multiple_of_power_of_two(uint64_t x, uint64_t n) {
     if (n > 63) {
@@ -61,17 +70,34 @@ HGraph::HGraph(const HGraphParameter& hgraph_param, const vsag::IndexCommonParam
       neighbors_mutex_(0, common_param.allocator_.get()),
       route_graphs_(common_param.allocator_.get()),
       labels_(common_param.allocator_.get()),
+      rerank_codes_(common_param.allocator_.get()),
+      rerank_candidate_factors_(hgraph_param.rerank_candidate_factors_.begin(),
+                                hgraph_param.rerank_candidate_factors_.end(),
+                                common_param.allocator_.get()),
       use_reorder_(hgraph_param.use_reorder_),
       ef_construct_(hgraph_param.ef_construction_),
-      build_thread_count_(hgraph_param.build_thread_count_) {
+      build_thread_count_(hgraph_param.build_thread_count_),
+      graph_reorder_(hgraph_param.graph_reorder_),
+      tune_prefetch_(hgraph_param.tune_prefetch_),
+      colocate_graph_(hgraph_param.colocate_graph_) {
     this->basic_flatten_codes_ =
         FlattenInterface::MakeInstance(hgraph_param.base_codes_param_, common_param);
     if (use_reorder_) {
         this->high_precise_codes_ =
             FlattenInterface::MakeInstance(hgraph_param.precise_codes_param_, common_param);
     }
-    this->bottom_graph_ =
-        GraphInterface::MakeInstance(hgraph_param.bottom_graph_param_, common_param);
+    for (const auto& stage_param : hgraph_param.rerank_stages_param_) {
+        this->rerank_codes_.emplace_back(FlattenInterface::MakeInstance(stage_param, common_param));
+    }
+    if (hgraph_param.colocate_graph_) {
+        this->bottom_graph_ = this->basic_flatten_codes_->MakeColocatedGraph(
+            hgraph_param.bottom_graph_param_, common_param);
+        CHECK_ARGUMENT(this->bottom_graph_ != nullptr,
+                       "base codes do not support a colocated graph");
+    } else {
+        this->bottom_graph_ =
+            GraphInterface::MakeInstance(hgraph_param.bottom_graph_param_, common_param);
+    }
     mult_ = 1 / log(1.0 * static_cast<double>(this->bottom_graph_->MaximumDegree()));
     resize(bottom_graph_->max_capacity_);
     if (this->build_thread_count_ > 1) {
@@ -82,7 +108,23 @@ HGraph::HGraph(const HGraphParameter& hgraph_param, const vsag::IndexCommonParam
 
 tl::expected<std::vector<int64_t>, Error>
 HGraph::Build(const DatasetPtr& data) {
-    return this->Add(data);
+    auto result = this->Add(data);
+    if (result.has_value()) {
+        if (this->graph_reorder_ != GRAPH_REORDER_TYPE_VALUE_NONE) {
+            this->reorder_graph();
+        }
+        // route layers are mostly read from now on, later adds of new ids fall back to locks
+        for (auto& route_graph : this->route_graphs_) {
+            auto sparse_graph = std::dynamic_pointer_cast<SparseGraphDataCell>(route_graph);
+            if (sparse_graph != nullptr) {
+                sparse_graph->Freeze();
+            }
+        }
+        if (this->tune_prefetch_) {
+            this->tune_prefetch(data->GetFloat32Vectors(), data->GetNumElements());
+        }
+    }
+    return result;
 }
 
 tl::expected<std::vector<int64_t>, Error>
@@ -106,6 +148,11 @@ HGraph::Add(const DatasetPtr& data) {
                 this->high_precise_codes_->BatchInsertVector(data_ptr->GetFloat32Vectors(),
                                                              data_ptr->GetNumElements());
             }
+            for (auto& rerank_codes : this->rerank_codes_) {
+                rerank_codes->Train(data_ptr->GetFloat32Vectors(), data_ptr->GetNumElements());
+                rerank_codes->BatchInsertVector(data_ptr->GetFloat32Vectors(),
+                                                data_ptr->GetNumElements());
+            }
             this->hnsw_add(data_ptr);
         }
         return failed_ids;
@@ -157,9 +204,7 @@ HGraph::KnnSearch(const DatasetPtr& query,
                                                     this->basic_flatten_codes_,
                                                     search_param);
 
-        if (use_reorder_) {
-            this->reorder(query->GetFloat32Vectors(), this->high_precise_codes_, search_result, k);
-        }
+        this->rerank(query->GetFloat32Vectors(), search_result, k);
 
         while (search_result.size() > k) {
             search_result.pop();
@@ -208,18 +253,29 @@ HGraph::EstimateMemory(uint64_t num_elements) const {
             static_cast<double>(block_size));
     };
 
-    auto base_memory = this->basic_flatten_codes_->code_size_ * element_count;
+    // a colocated bottom graph is part of the base code records
+    auto base_memory = this->basic_flatten_codes_->CodeStride() * element_count;
     estimate_memory += block_memory_ceil(base_memory, block_size);
 
-    auto bottom_graph_memory =
-        (this->bottom_graph_->maximum_degree_ + 1) * sizeof(InnerIdType) * element_count;
-    estimate_memory += block_memory_ceil(bottom_graph_memory, block_size);
+    if (std::dynamic_pointer_cast<CompressedGraphDataCell>(this->bottom_graph_) != nullptr) {
+        estimate_memory += CompressedGraphDataCell::EstimateMemory(
+            element_count, this->bottom_graph_->maximum_degree_);
+    } else if (not this->colocate_graph_) {
+        auto bottom_graph_memory =
+            (this->bottom_graph_->maximum_degree_ + 1) * sizeof(InnerIdType) * element_count;
+        estimate_memory += block_memory_ceil(bottom_graph_memory, block_size);
+    }
 
     if (use_reorder_) {
         auto precise_memory = this->high_precise_codes_->code_size_ * element_count;
         estimate_memory += block_memory_ceil(precise_memory, block_size);
     }
 
+    for (const auto& rerank_codes : this->rerank_codes_) {
+        auto rerank_memory = rerank_codes->code_size_ * element_count;
+        estimate_memory += block_memory_ceil(rerank_memory, block_size);
+    }
+
     auto label_map_memory =
         element_count * (sizeof(std::pair<LabelType, InnerIdType>) + 2 * sizeof(void*));
     estimate_memory += label_map_memory;
@@ -235,6 +291,29 @@ HGraph::EstimateMemory(uint64_t num_elements) const {
     return estimate_memory;
 }
 
+std::string
+HGraph::GetStats() const {
+    JsonType stats;
+    stats[STATSTIC_DATA_NUM] = this->GetNumElements();
+    stats[STATSTIC_INDEX_NAME] = INDEX_HGRAPH;
+    stats[STATSTIC_MEMORY] = this->GetMemoryUsage();
+
+    uint64_t hugepage_memory = this->basic_flatten_codes_->HugePageMemory();
+    hugepage_memory += this->bottom_graph_->HugePageMemory();
+    if (use_reorder_) {
+        hugepage_memory += this->high_precise_codes_->HugePageMemory();
+    }
+    for (const auto& rerank_codes : this->rerank_codes_) {
+        hugepage_memory += rerank_codes->HugePageMemory();
+    }
+    stats[STATSTIC_HUGEPAGE_MEMORY] = hugepage_memory;
+    const auto& codes = this->basic_flatten_codes_;
+    stats[STATSTIC_PREFETCH_JUMP_CODE_SIZE] = codes->prefetch_jump_code_size_;
+    stats[STATSTIC_PREFETCH_CACHE_LINE_SIZE] = codes->prefetch_cache_line_size_;
+    stats[STATSTIC_PREFETCH_NEIGHBOR_VISIT_NUM] = this->prefetch_neighbor_visit_num_;
+    return stats.dump();
+}
+
 tl::expected<BinarySet, Error>
 HGraph::Serialize() const {
     if (GetNumElements() == 0) {
@@ -261,6 +340,27 @@ HGraph::Serialize() const {
     }
 }
 
+tl::expected<void, Error>
+HGraph::Serialize(const WriteFuncType& write_func) const {
+    WriteFuncStreamWriter writer(write_func, 0);
+    if (GetNumElements() == 0) {
+        StreamWriter::WriteBinarySet(writer, empty_binaryset());
+        return {};
+    }
+    SlowTaskTimer t("hgraph Serialize");
+    StreamWriter::WriteSectionHeader(writer, INDEX_HGRAPH, this->cal_serialize_size());
+    this->Serialize(writer);
+    return {};
+}
+
+uint64_t
+HGraph::CalSerializeSize() const {
+    if (GetNumElements() == 0) {
+        return StreamWriter::BinarySetSize(empty_binaryset());
+    }
+    return StreamWriter::SectionHeaderSize(INDEX_HGRAPH) + this->cal_serialize_size();
+}
+
 tl::expected<void, Error>
 HGraph::Deserialize(const ReaderSet& reader_set) {
     SlowTaskTimer t("hgraph Deserialize");
@@ -270,12 +370,13 @@ HGraph::Deserialize(const ReaderSet& reader_set) {
     }
 
     try {
+        auto index_reader = reader_set.Get(INDEX_HGRAPH);
         auto func = [&](uint64_t offset, uint64_t len, void* dest) -> void {
-            reader_set.Get(INDEX_HGRAPH)->Read(offset, len, dest);
+            index_reader->Read(offset, len, dest);
         };
         uint64_t cursor = 0;
         auto reader = ReadFuncStreamReader(func, cursor);
-        this->Deserialize(reader);
+        this->Deserialize(reader, index_reader->Size());
     } catch (const std::runtime_error& e) {
         LOG_ERROR_AND_RETURNS(ErrorType::READ_ERROR, "failed to Deserialize: ", e.what());
     }
@@ -351,8 +452,11 @@ HGraph::search_one_graph(const float* query,
 
     auto* visited_array = visited_list->mass;
     auto visited_array_tag = visited_list->curV;
+    // one pin on the codes for the whole search instead of one per read
+    auto codes_pin = flatten->PinCodes();
     auto computer = flatten->FactoryComputer(query);
-    auto prefetch_neighbor_visit_num = 1;  // TODO(LHT) Optimize the param;
+    auto prefetch_neighbor_visit_num = this->prefetch_neighbor_visit_num_;
+    bool colocated = this->colocate_graph_ and graph == this->bottom_graph_;
 
     auto* is_id_allowed = inner_search_param.is_id_allowed_;
     auto ep = inner_search_param.ep_;
@@ -375,7 +479,6 @@ HGraph::search_one_graph(const float* query,
     candidate_set.emplace(-dist, ep);
     visited_array[ep] = visited_array_tag;
 
-    Vector<InnerIdType> neighbors(allocator_);
     Vector<InnerIdType> to_be_visited(graph->MaximumDegree(), allocator_);
     Vector<float> tmp_result(graph->MaximumDegree(), allocator_);
 
@@ -388,34 +491,46 @@ HGraph::search_one_graph(const float* query,
             }
         }
         candidate_set.pop();
+        if (colocated and not candidate_set.empty()) {
+            // the record of the next node to expand holds its neighbor list, fetch it while
+            // this one is expanded
+            flatten->Prefetch(candidate_set.top().second);
+        }
 
         auto current_node_id = current_node_pair.second;
+        auto count_no_visited = 0;
         {
+            // the borrowed list may be rewritten in place by inserts, hold the lock until
+            // the unvisited ids are copied out
             std::shared_lock<std::shared_mutex> lock(neighbors_mutex_[current_node_id]);
-            graph->GetNeighbors(current_node_id, neighbors);
-        }
-        if (!neighbors.empty()) {
-            flatten->Prefetch(neighbors[0]);
+            uint32_t neighbor_count = 0;
+            bool release = false;
+            const auto* neighbors = graph->GetNeighborsPtr(current_node_id, neighbor_count, release);
+            if (neighbor_count > 0) {
+                flatten->Prefetch(neighbors[0]);
 #ifdef USE_SSE
-            _mm_prefetch((char*)(visited_array + neighbors[0]), _MM_HINT_T0);
-            for (uint32_t i = 0; i < prefetch_neighbor_visit_num; i++) {
-                _mm_prefetch(visited_list->mass + neighbors[i], _MM_HINT_T0);
-            }
+                _mm_prefetch((char*)(visited_array + neighbors[0]), _MM_HINT_T0);
+                for (uint32_t i = 0; i < prefetch_neighbor_visit_num and i < neighbor_count; i++) {
+                    _mm_prefetch(visited_list->mass + neighbors[i], _MM_HINT_T0);
+                }
 #endif
-        }
-        auto count_no_visited = 0;
-        for (uint64_t i = 0; i < neighbors.size(); ++i) {  // NOLINT(modernize-loop-convert)
-            const auto& neighbor = neighbors[i];
-#if defined(USE_SSE)
-            if (i + prefetch_neighbor_visit_num < neighbors.size()) {
-                _mm_prefetch(visited_array + neighbors[i + prefetch_neighbor_visit_num],
-                             _MM_HINT_T0);
             }
+            for (uint32_t i = 0; i < neighbor_count; ++i) {
+                const auto& neighbor = neighbors[i];
+#if defined(USE_SSE)
+                if (i + prefetch_neighbor_visit_num < neighbor_count) {
+                    _mm_prefetch(visited_array + neighbors[i + prefetch_neighbor_visit_num],
+                                 _MM_HINT_T0);
+                }
 #endif
-            if (visited_array[neighbor] != visited_array_tag) {
-                to_be_visited[count_no_visited] = neighbor;
-                count_no_visited++;
-                visited_array[neighbor] = visited_array_tag;
+                if (visited_array[neighbor] != visited_array_tag) {
+                    to_be_visited[count_no_visited] = neighbor;
+                    count_no_visited++;
+                    visited_array[neighbor] = visited_array_tag;
+                }
+            }
+            if (release) {
+                graph->ReleaseNeighbors(neighbors);
             }
         }
 
@@ -489,10 +604,7 @@ HGraph::RangeSearch(const DatasetPtr& query,
                                                     this->bottom_graph_,
                                                     this->basic_flatten_codes_,
                                                     search_param);
-        if (use_reorder_) {
-            this->reorder(
-                query->GetFloat32Vectors(), this->high_precise_codes_, search_result, limited_size);
-        }
+        this->rerank(query->GetFloat32Vectors(), search_result, limited_size);
 
         if (limited_size > 0) {
             while (search_result.size() > limited_size) {
@@ -570,6 +682,7 @@ HGraph::mutually_connect_new_element(InnerIdType cur_c,
                                      FlattenInterfacePtr flatten,
                                      bool is_update) {
     const size_t max_size = graph->MaximumDegree();
+    auto codes_pin = flatten->PinCodes();
     this->select_edges_by_heuristic(top_candidates, max_size, flatten);
     if (top_candidates.size() > max_size) {
         throw std::runtime_error(
@@ -679,19 +792,29 @@ HGraph::Serialize(StreamWriter& writer) const {
     if (this->use_reorder_) {
         this->high_precise_codes_->Serialize(writer);
     }
+    for (const auto& rerank_codes : this->rerank_codes_) {
+        rerank_codes->Serialize(writer);
+    }
     for (auto i = 0; i < this->max_level_; ++i) {
         this->route_graphs_[i]->Serialize(writer);
     }
+    StreamWriter::WriteObj(writer, PREFETCH_TRAILER_MAGIC);
+    StreamWriter::WriteObj(writer, this->basic_flatten_codes_->prefetch_jump_code_size_);
+    StreamWriter::WriteObj(writer, this->basic_flatten_codes_->prefetch_cache_line_size_);
+    StreamWriter::WriteObj(writer, this->prefetch_neighbor_visit_num_);
 }
 
 void
-HGraph::Deserialize(StreamReader& reader) {
+HGraph::Deserialize(StreamReader& reader, uint64_t end_cursor) {
     this->deserialize_basic_info(reader);
     this->basic_flatten_codes_->Deserialize(reader);
     this->bottom_graph_->Deserialize(reader);
     if (this->use_reorder_) {
         this->high_precise_codes_->Deserialize(reader);
     }
+    for (auto& rerank_codes : this->rerank_codes_) {
+        rerank_codes->Deserialize(reader);
+    }
 
     for (uint64_t i = 0; i < this->max_level_; ++i) {
         this->route_graphs_.emplace_back(this->generate_one_route_graph());
@@ -700,6 +823,7 @@ HGraph::Deserialize(StreamReader& reader) {
     for (uint64_t i = 0; i < this->max_level_; ++i) {
         this->route_graphs_[i]->Deserialize(reader);
     }
+    this->deserialize_prefetch_trailer(reader, end_cursor);
     resize(max_capacity_);
 }
 
@@ -726,6 +850,23 @@ HGraph::deserialize_basic_info(StreamReader& reader) {
     }
 }
 
+void
+HGraph::deserialize_prefetch_trailer(StreamReader& reader, uint64_t end_cursor) {
+    auto cursor = reader.GetCursor();
+    if (cursor + PREFETCH_TRAILER_SIZE > end_cursor) {
+        return;
+    }
+    uint64_t magic = 0;
+    StreamReader::ReadObj(reader, magic);
+    if (magic != PREFETCH_TRAILER_MAGIC) {
+        reader.Seek(cursor);
+        return;
+    }
+    StreamReader::ReadObj(reader, this->basic_flatten_codes_->prefetch_jump_code_size_);
+    StreamReader::ReadObj(reader, this->basic_flatten_codes_->prefetch_cache_line_size_);
+    StreamReader::ReadObj(reader, this->prefetch_neighbor_visit_num_);
+}
+
 uint64_t
 HGraph::cal_serialize_size() const {
     auto cal_size_func = [](uint64_t cursor, uint64_t size, void* buf) { return; };
@@ -761,13 +902,17 @@ HGraph::Deserialize(const BinarySet& binary_set) {
 
     Binary b = binary_set.Get(INDEX_HGRAPH);
     auto func = [&](uint64_t offset, uint64_t len, void* dest) -> void {
+        if (offset + len > b.size) {
+            throw std::runtime_error(fmt::format(
+                "read {} bytes at offset {} beyond the binary of {} bytes", len, offset, b.size));
+        }
         std::memcpy(dest, b.data.get() + offset, len);
     };
 
     try {
         uint64_t cursor = 0;
         auto reader = ReadFuncStreamReader(func, cursor);
-        this->Deserialize(reader);
+        this->Deserialize(reader, b.size);
     } catch (const std::runtime_error& e) {
         LOG_ERROR_AND_RETURNS(ErrorType::READ_ERROR, "failed to Deserialize: ", e.what());
     } catch (const std::out_of_range& e) {
@@ -785,8 +930,16 @@ HGraph::Deserialize(std::istream& in_stream) {
                               "failed to Deserialize: index is not empty");
     }
     try {
+        // the prefetch trailer is read only if the stream is seekable
+        uint64_t end_cursor = 0;
+        auto begin = in_stream.tellg();
+        if (begin != -1 and in_stream.seekg(0, std::ios::end)) {
+            end_cursor = in_stream.tellg();
+            in_stream.seekg(begin);
+        }
+        in_stream.clear();
         IOStreamReader reader(in_stream);
-        this->Deserialize(reader);
+        this->Deserialize(reader, end_cursor);
         return {};
     } catch (const std::bad_alloc& e) {
         LOG_ERROR_AND_RETURNS(
@@ -854,6 +1007,108 @@ HGraph::add_one_point(const float* data, int level, InnerIdType inner_id) {
     bottom_graph_->IncreaseTotalCount(1);
 }
 
+void
+HGraph::reorder_graph() {
+    std::unique_lock<std::shared_mutex> global_lock(this->global_mutex_);
+    std::unique_lock<std::shared_mutex> label_lock(this->label_lookup_mutex_);
+    auto total_count = static_cast<InnerIdType>(this->GetNumElements());
+    auto new_ids = ComputeGraphOrder(
+        this->bottom_graph_, total_count, this->entry_point_id_, this->graph_reorder_, allocator_);
+
+    // graphs first, a colocated bottom graph shares its records with the base codes
+    this->bottom_graph_->Permute(new_ids);
+    for (auto& route_graph : this->route_graphs_) {
+        route_graph->Permute(new_ids);
+    }
+    this->basic_flatten_codes_->Permute(new_ids);
+    if (use_reorder_) {
+        this->high_precise_codes_->Permute(new_ids);
+    }
+    for (auto& rerank_codes : this->rerank_codes_) {
+        rerank_codes->Permute(new_ids);
+    }
+
+    Vector<LabelType> labels(this->labels_.size(), allocator_);
+    for (InnerIdType id = 0; id < total_count; ++id) {
+        labels[new_ids[id]] = this->labels_[id];
+    }
+    this->labels_.swap(labels);
+    for (auto& [label, inner_id] : this->label_lookup_) {
+        inner_id = new_ids[inner_id];
+    }
+    if (this->entry_point_id_ < total_count) {
+        this->entry_point_id_ = new_ids[this->entry_point_id_];
+    }
+}
+
+void
+HGraph::tune_prefetch(const float* queries, uint64_t count) {
+    constexpr uint64_t max_sample_count = 64;
+    constexpr uint64_t tune_ef_search = 100;
+    constexpr int time_rounds = 3;
+    if (queries == nullptr or count == 0 or this->GetNumElements() == 0) {
+        return;
+    }
+    auto sample_count = std::min(count, max_sample_count);
+    auto sample_step = count / sample_count;
+
+    // the minimum over several rounds filters out the noise of other threads
+    auto time_searches = [&]() -> double {
+        double best = std::numeric_limits<double>::max();
+        for (int round = 0; round < time_rounds; ++round) {
+            auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < sample_count; ++i) {
+                const auto* query = queries + i * sample_step * dim_;
+                InnerSearchParam search_param;
+                search_param.ep_ = this->entry_point_id_;
+                search_param.ef_ = 1;
+                search_param.is_id_allowed_ = nullptr;
+                for (auto j = static_cast<int64_t>(this->route_graphs_.size() - 1); j >= 0; --j) {
+                    auto result = this->search_one_graph(
+                        query, this->route_graphs_[j], this->basic_flatten_codes_, search_param);
+                    search_param.ep_ = result.top().second;
+                }
+                search_param.ef_ = tune_ef_search;
+                this->search_one_graph(
+                    query, this->bottom_graph_, this->basic_flatten_codes_, search_param);
+            }
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(end - start).count());
+        }
+        return best;
+    };
+
+    // coordinate descent, each knob keeps its best value while the next one is tuned
+    auto tune = [&](uint32_t& knob, const std::vector<uint32_t>& candidates) {
+        auto best_value = knob;
+        auto best_time = time_searches();
+        for (auto candidate : candidates) {
+            if (candidate == best_value) {
+                continue;
+            }
+            knob = candidate;
+            auto cost = time_searches();
+            if (cost < best_time) {
+                best_time = cost;
+                best_value = candidate;
+            }
+        }
+        knob = best_value;
+    };
+
+    auto& codes = this->basic_flatten_codes_;
+    auto code_lines = static_cast<uint32_t>(
+        next_multiple_of_power_of_two(std::max(codes->code_size_, 1U), 6));
+    tune(codes->prefetch_jump_code_size_, {1, 2, 4, 8});
+    tune(codes->prefetch_cache_line_size_, {1, code_lines});
+    tune(this->prefetch_neighbor_visit_num_, {1, 2, 4});
+    logger::info(fmt::format("hgraph tuned prefetch: jump_code_size {}, cache_line_size {}, "
+                             "neighbor_visit_num {}",
+                             codes->prefetch_jump_code_size_,
+                             codes->prefetch_cache_line_size_,
+                             this->prefetch_neighbor_visit_num_));
+}
+
 void
 HGraph::resize(uint64_t new_size) {
     auto cur_size = this->neighbors_mutex_.size();
@@ -892,6 +1147,7 @@ HGraph::init_features() {
         IndexFeature::SUPPORT_DESERIALIZE_READER_SET,
         IndexFeature::SUPPORT_SERIALIZE_BINARY_SET,
         IndexFeature::SUPPORT_SERIALIZE_FILE,
+        IndexFeature::SUPPORT_SERIALIZE_WRITE_FUNC,
     });
     // other
     feature_list_.SetFeatures({
@@ -996,4 +1252,23 @@ HGraph::reorder(const float* query,
     }
 }
 
+void
+HGraph::rerank(const float* query, MaxHeap& candidate_heap, int64_t k) const {
+    // every intermediate stage narrows the candidates to a multiple of k with cheaper codes,
+    // the precise codes (if any) finally pick the top k among the survivors
+    for (uint64_t i = 0; i < this->rerank_codes_.size(); ++i) {
+        auto keep_count = k;
+        if (k > 0) {
+            keep_count = std::max(
+                k,
+                static_cast<int64_t>(std::ceil(static_cast<float>(k) *
+                                               this->rerank_candidate_factors_[i])));
+        }
+        this->reorder(query, this->rerank_codes_[i], candidate_heap, keep_count);
+    }
+    if (use_reorder_) {
+        this->reorder(query, this->high_precise_codes_, candidate_heap, k);
+    }
+}
+
 }  // namespace vsag
@@ -63,6 +63,13 @@ public:
     tl::expected<BinarySet, Error>
     Serialize() const;
 
+    tl::expected<void, Error>
+    Serialize(const WriteFuncType& write_func) const;
+
+    // bytes written by Serialize(write_func)
+    uint64_t
+    CalSerializeSize() const;
+
     void
     Serialize(StreamWriter& writer) const;
 
@@ -75,8 +82,9 @@ public:
     tl::expected<void, Error>
     Deserialize(std::istream& in_stream);
 
+    // end_cursor is the reader cursor after the last byte of the index, 0 if unknown
     void
-    Deserialize(StreamReader& reader);
+    Deserialize(StreamReader& reader, uint64_t end_cursor);
 
     inline int64_t
     GetNumElements() const {
@@ -92,6 +100,9 @@ public:
         return 0;
     }
 
+    std::string
+    GetStats() const;
+
     tl::expected<float, Error>
     CalculateDistanceById(const float* vector, int64_t id) const;
 
@@ -162,6 +173,9 @@ private:
     void
     deserialize_basic_info(StreamReader& reader);
 
+    void
+    deserialize_prefetch_trailer(StreamReader& reader, uint64_t end_cursor);
+
     uint64_t
     cal_serialize_size() const;
 
@@ -188,9 +202,20 @@ private:
             MaxHeap& candidate_heap,
             int64_t k) const;
 
+    void
+    rerank(const float* query, MaxHeap& candidate_heap, int64_t k) const;
+
+    void
+    reorder_graph();
+
+    void
+    tune_prefetch(const float* queries, uint64_t count);
+
 private:
     FlattenInterfacePtr basic_flatten_codes_{nullptr};
     FlattenInterfacePtr high_precise_codes_{nullptr};
+    Vector<FlattenInterfacePtr> rerank_codes_;
+    Vector<float> rerank_candidate_factors_;
     Vector<GraphInterfacePtr> route_graphs_;
     GraphInterfacePtr bottom_graph_{nullptr};
 
@@ -222,6 +247,14 @@ private:
 
     std::unique_ptr<progschj::ThreadPool> build_pool_{nullptr};
     uint64_t build_thread_count_{100};
+    std::string graph_reorder_{GRAPH_REORDER_TYPE_VALUE_NONE};
+
+    // the prefetch values of the base codes and of this are serialized in an optional trailer
+    bool tune_prefetch_{false};
+    uint32_t prefetch_neighbor_visit_num_{1};
+
+    // the bottom graph lives in the records of the base codes
+    bool colocate_graph_{false};
 
     InnerIdType max_capacity_{0};
 
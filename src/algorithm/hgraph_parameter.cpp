@@ -17,6 +17,7 @@
 
 #include <fmt/format-inl.h>
 
+#include "data_cell/graph_datacell_parameter.h"
 #include "data_cell/graph_interface_parameter.h"
 #include "inner_string_params.h"
 
@@ -49,11 +50,46 @@ HGraphParameter::FromJson(const JsonType& json) {
         this->precise_codes_param_->FromJson(precise_codes_json);
     }
 
+    if (json.contains(HGRAPH_RERANK_STAGES_KEY)) {
+        const auto& stages_json = json[HGRAPH_RERANK_STAGES_KEY];
+        CHECK_ARGUMENT(
+            stages_json.is_array(),
+            fmt::format("hgraph parameter {} must be an array", HGRAPH_RERANK_STAGES_KEY));
+        for (const auto& stage_json : stages_json) {
+            auto stage_param = std::make_shared<FlattenDataCellParameter>();
+            stage_param->FromJson(stage_json);
+            float candidate_factor = 1.0F;
+            if (stage_json.contains(HGRAPH_RERANK_CANDIDATE_FACTOR_KEY)) {
+                candidate_factor = stage_json[HGRAPH_RERANK_CANDIDATE_FACTOR_KEY];
+            }
+            CHECK_ARGUMENT(candidate_factor >= 1.0F,
+                           fmt::format("rerank stage {}({}) must be greater equal than 1",
+                                       HGRAPH_RERANK_CANDIDATE_FACTOR_KEY,
+                                       candidate_factor));
+            this->rerank_stages_param_.emplace_back(stage_param);
+            this->rerank_candidate_factors_.emplace_back(candidate_factor);
+        }
+    }
+
     CHECK_ARGUMENT(json.contains(HGRAPH_GRAPH_KEY),
                    fmt::format("hgraph parameters must contains {}", HGRAPH_GRAPH_KEY));
     const auto& graph_json = json[HGRAPH_GRAPH_KEY];
     this->bottom_graph_param_ = GraphInterfaceParameter::GetGraphParameterByJson(graph_json);
 
+    if (json.contains(HGRAPH_COLOCATE_GRAPH_KEY)) {
+        this->colocate_graph_ = json[HGRAPH_COLOCATE_GRAPH_KEY];
+    }
+    if (this->colocate_graph_) {
+        auto graph_param =
+            std::dynamic_pointer_cast<GraphDataCellParameter>(this->bottom_graph_param_);
+        CHECK_ARGUMENT(graph_param != nullptr and not graph_param->use_compression_,
+                       fmt::format("hgraph {} is not supported with a compressed graph",
+                                   HGRAPH_COLOCATE_GRAPH_KEY));
+        CHECK_ARGUMENT(this->base_codes_param_->drift_threshold_ <= 0.0F,
+                       fmt::format("hgraph {} is not supported with base codes drift detection",
+                                   HGRAPH_COLOCATE_GRAPH_KEY));
+    }
+
     if (json.contains(BUILD_PARAMS_KEY)) {
         const auto& build_params = json[BUILD_PARAMS_KEY];
         if (build_params.contains(BUILD_EF_CONSTRUCTION)) {
@@ -62,6 +98,21 @@ HGraphParameter::FromJson(const JsonType& json) {
         if (build_params.contains(BUILD_THREAD_COUNT)) {
             this->build_thread_count_ = build_params[BUILD_THREAD_COUNT];
         }
+        if (build_params.contains(BUILD_GRAPH_REORDER)) {
+            this->graph_reorder_ = build_params[BUILD_GRAPH_REORDER];
+            CHECK_ARGUMENT(this->graph_reorder_ == GRAPH_REORDER_TYPE_VALUE_NONE or
+                               this->graph_reorder_ == GRAPH_REORDER_TYPE_VALUE_BFS or
+                               this->graph_reorder_ == GRAPH_REORDER_TYPE_VALUE_RCM,
+                           fmt::format("hgraph {} must be one of {}, {}, {}, got {}",
+                                       BUILD_GRAPH_REORDER,
+                                       GRAPH_REORDER_TYPE_VALUE_NONE,
+                                       GRAPH_REORDER_TYPE_VALUE_BFS,
+                                       GRAPH_REORDER_TYPE_VALUE_RCM,
+                                       this->graph_reorder_));
+        }
+        if (build_params.contains(BUILD_TUNE_PREFETCH)) {
+            this->tune_prefetch_ = build_params[BUILD_TUNE_PREFETCH];
+        }
     }
 }
 
@@ -75,10 +126,18 @@ HGraphParameter::ToJson() {
     if (use_reorder_) {
         json[HGRAPH_PRECISE_CODES_KEY] = this->precise_codes_param_->ToJson();
     }
+    for (uint64_t i = 0; i < this->rerank_stages_param_.size(); ++i) {
+        auto stage_json = this->rerank_stages_param_[i]->ToJson();
+        stage_json[HGRAPH_RERANK_CANDIDATE_FACTOR_KEY] = this->rerank_candidate_factors_[i];
+        json[HGRAPH_RERANK_STAGES_KEY].push_back(stage_json);
+    }
     json[HGRAPH_GRAPH_KEY] = this->bottom_graph_param_->ToJson();
+    json[HGRAPH_COLOCATE_GRAPH_KEY] = this->colocate_graph_;
 
     json[BUILD_PARAMS_KEY][BUILD_EF_CONSTRUCTION] = this->ef_construction_;
     json[BUILD_PARAMS_KEY][BUILD_THREAD_COUNT] = this->build_thread_count_;
+    json[BUILD_PARAMS_KEY][BUILD_GRAPH_REORDER] = this->graph_reorder_;
+    json[BUILD_PARAMS_KEY][BUILD_TUNE_PREFETCH] = this->tune_prefetch_;
     return json;
 }
 
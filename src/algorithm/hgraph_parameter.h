@@ -17,6 +17,7 @@
 
 #include "data_cell/flatten_datacell_parameter.h"
 #include "data_cell/graph_interface_parameter.h"
+#include "inner_string_params.h"
 #include "parameter.h"
 
 namespace vsag {
@@ -38,9 +39,20 @@ public:
     FlattenDataCellParamPtr precise_codes_param_{nullptr};
     GraphInterfaceParamPtr bottom_graph_param_{nullptr};
 
+    // intermediate rerank stages applied in order before precise_codes,
+    // stage i keeps ceil(k * rerank_candidate_factors_[i]) candidates
+    std::vector<FlattenDataCellParamPtr> rerank_stages_param_;
+    std::vector<float> rerank_candidate_factors_;
+
     bool use_reorder_{false};
+    // store the bottom graph neighbors next to the base codes of each id
+    bool colocate_graph_{false};
     uint64_t ef_construction_{400};
     uint64_t build_thread_count_{100};
+    // renumbering of the ids applied once Build() is done, none, bfs or rcm
+    std::string graph_reorder_{GRAPH_REORDER_TYPE_VALUE_NONE};
+    // pick the prefetch distances by timing sample searches once Build() is done
+    bool tune_prefetch_{false};
 
     std::string name_;
 };
@@ -23,6 +23,7 @@
 #include "base_filter_functor.h"
 #include "space_interface.h"
 #include "stream_reader.h"
+#include "stream_writer.h"
 #include "typing.h"
 #include "vsag/dataset.h"
 #include "vsag/errors.h"
@@ -64,6 +65,9 @@ public:
     virtual void
     saveIndex(std::ostream& out_stream) = 0;
 
+    virtual void
+    saveIndex(StreamWriter& writer) = 0;
+
     virtual size_t
     getMaxElements() = 0;
 
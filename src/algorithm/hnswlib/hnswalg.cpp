@@ -18,6 +18,7 @@
 #include <memory>
 #include "../../utils.h"
 #include "data_cell/graph_interface.h"
+#include "impl/graph_reorder.h"
 namespace hnswlib {
 
 constexpr float BRUTE_FORCE_RATIO = 0.03f;
@@ -835,6 +836,11 @@ HierarchicalNSW::saveIndex(std::ostream& out_stream) {
     SerializeImpl(writer);
 }
 
+void
+HierarchicalNSW::saveIndex(StreamWriter& writer) {
+    SerializeImpl(writer);
+}
+
 template <typename T>
 static void
 WriteOne(StreamWriter& writer, T& value) {
@@ -1126,6 +1132,107 @@ HierarchicalNSW::swapConnections(InnerIdType pre_internal_id, InnerIdType post_i
     return true;
 }
 
+void
+HierarchicalNSW::reorderGraph(const std::string& reorder_type) {
+    // same order as addPoint, which resizes while holding the label lock
+    std::unique_lock label_lock(label_lookup_lock_);
+    std::unique_lock resize_lock(resize_mutex_);
+    std::unique_lock max_level_lock(max_level_mutex_);
+    auto count = static_cast<InnerIdType>(cur_element_count_);
+    auto entry_point = enterpoint_node_ < 0 ? count : static_cast<InnerIdType>(enterpoint_node_);
+    auto new_ids = vsag::ComputeGraphOrder(
+        [this](InnerIdType id, vsag::Vector<InnerIdType>& neighbors) {
+            auto* data = getLinklist0(id);
+            auto* links = (InnerIdType*)(data + 1);
+            neighbors.insert(neighbors.end(), links, links + getListCount(data));
+        },
+        count,
+        entry_point,
+        reorder_type,
+        allocator_);
+
+    // move the level 0 elements along the cycles of the permutation, data and label included
+    vsag::Vector<bool> moved(count, false, allocator_);
+    vsag::Vector<char> carry(size_data_per_element_, allocator_);
+    vsag::Vector<char> next(size_data_per_element_, allocator_);
+    for (InnerIdType start = 0; start < count; ++start) {
+        if (moved[start] or new_ids[start] == start) {
+            continue;
+        }
+        memcpy(carry.data(), getLinklist0(start), size_data_per_element_);
+        for (auto from = start; not moved[from]; from = new_ids[from]) {
+            moved[from] = true;
+            auto to = new_ids[from];
+            if (to != start) {
+                memcpy(next.data(), getLinklist0(to), size_data_per_element_);
+            }
+            memcpy(getLinklist0(to), carry.data(), size_data_per_element_);
+            carry.swap(next);
+        }
+    }
+
+    auto permute = [&](auto* values) {
+        using ValueType = std::remove_pointer_t<decltype(values)>;
+        vsag::Vector<ValueType> old_values(values, values + count, allocator_);
+        for (InnerIdType id = 0; id < count; ++id) {
+            values[new_ids[id]] = old_values[id];
+        }
+    };
+    permute(element_levels_);
+    permute(link_lists_);
+    if (normalize_ and molds_ != nullptr) {
+        permute(molds_);
+    }
+    auto remap = [&](linklistsizeint* data) {
+        auto* links = (InnerIdType*)(data + 1);
+        for (size_t i = 0; i < getListCount(data); ++i) {
+            links[i] = new_ids[links[i]];
+        }
+    };
+    for (InnerIdType id = 0; id < count; ++id) {
+        for (int level = 0; level <= element_levels_[id]; ++level) {
+            remap(getLinklistAtLevel(id, level));
+        }
+    }
+
+    if (use_reversed_edges_) {
+        permute(reversed_level0_link_list_);
+        permute(reversed_link_lists_);
+        auto remap_edges = [&](reverselinklist& edges) {
+            reverselinklist new_edges(allocator_);
+            for (auto in_node : edges) {
+                new_edges.insert(new_ids[in_node]);
+            }
+            edges.swap(new_edges);
+        };
+        for (InnerIdType id = 0; id < count; ++id) {
+            if (reversed_level0_link_list_[id] != nullptr) {
+                remap_edges(*reversed_level0_link_list_[id]);
+            }
+            if (reversed_link_lists_[id] != nullptr) {
+                for (auto& [level, edges] : *reversed_link_lists_[id]) {
+                    remap_edges(edges);
+                }
+            }
+        }
+    }
+
+    for (auto& [label, internal_id] : label_lookup_) {
+        internal_id = new_ids[internal_id];
+    }
+    {
+        std::unique_lock<std::mutex> lock_deleted_elements(deleted_elements_lock_);
+        vsag::UnorderedSet<InnerIdType> deleted_elements(allocator_);
+        for (auto internal_id : deleted_elements_) {
+            deleted_elements.insert(new_ids[internal_id]);
+        }
+        deleted_elements_.swap(deleted_elements);
+    }
+    if (entry_point < count) {
+        enterpoint_node_ = new_ids[entry_point];
+    }
+}
+
 void
 HierarchicalNSW::dealNoInEdge(InnerIdType id, int level, int m_curmax, int skip_c) {
     // Establish edges from the neighbors of the id pointing to the id.
@@ -29,6 +29,7 @@
 #include <random>
 #include <shared_mutex>
 #include <stdexcept>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -327,6 +328,9 @@ public:
     void
     saveIndex(std::ostream& out_stream) override;
 
+    void
+    saveIndex(StreamWriter& writer) override;
+
     void
     SerializeImpl(StreamWriter& writer);
 
@@ -390,6 +394,13 @@ public:
     bool
     swapConnections(InnerIdType pre_internal_id, InnerIdType post_internal_id);
 
+    /*
+    * Renumbers the internal ids in the "bfs" or "rcm" order of the level 0 graph, so that
+    * neighbors are stored close to each other. Not safe to call concurrently with other calls.
+    */
+    void
+    reorderGraph(const std::string& reorder_type);
+
     void
     dealNoInEdge(InnerIdType id, int level, int m_curmax, int skip_c);
 
@@ -1132,6 +1132,12 @@ public:
         out.write((char*)&podRef, sizeof(T));
     }
 
+    template <typename T>
+    static void
+    writeBinaryPOD(StreamWriter& writer, const T& podRef) {
+        writer.Write((char*)&podRef, sizeof(T));
+    }
+
     template <typename T>
     static void
     readBinaryPOD(StreamReader& in, T& podRef) {
@@ -1141,44 +1147,50 @@ public:
     // save index to a file stream
     void
     saveIndex(std::ostream& out_stream) override {
-        writeBinaryPOD(out_stream, offsetLevel0_);
-        writeBinaryPOD(out_stream, max_elements_);
-        writeBinaryPOD(out_stream, cur_element_count_);
-        writeBinaryPOD(out_stream, size_data_per_element_);
-        writeBinaryPOD(out_stream, label_offset_);
-        writeBinaryPOD(out_stream, offsetData_);
-        writeBinaryPOD(out_stream, maxlevel_);
-        writeBinaryPOD(out_stream, enterpoint_node_);
-        writeBinaryPOD(out_stream, maxM_);
-
-        writeBinaryPOD(out_stream, maxM0_);
-        writeBinaryPOD(out_stream, M_);
-        writeBinaryPOD(out_stream, mult_);
-        writeBinaryPOD(out_stream, ef_construction_);
-
-        writeBinaryPOD(out_stream, pq_chunk);
-        writeBinaryPOD(out_stream, pq_cluster);
-        writeBinaryPOD(out_stream, pq_sub_dim);
-
-        data_level0_memory_->Serialize(out_stream, cur_element_count_);
+        IOStreamWriter writer(out_stream);
+        saveIndex(writer);
+    }
+
+    void
+    saveIndex(StreamWriter& writer) override {
+        writeBinaryPOD(writer, offsetLevel0_);
+        writeBinaryPOD(writer, max_elements_);
+        writeBinaryPOD(writer, cur_element_count_);
+        writeBinaryPOD(writer, size_data_per_element_);
+        writeBinaryPOD(writer, label_offset_);
+        writeBinaryPOD(writer, offsetData_);
+        writeBinaryPOD(writer, maxlevel_);
+        writeBinaryPOD(writer, enterpoint_node_);
+        writeBinaryPOD(writer, maxM_);
+
+        writeBinaryPOD(writer, maxM0_);
+        writeBinaryPOD(writer, M_);
+        writeBinaryPOD(writer, mult_);
+        writeBinaryPOD(writer, ef_construction_);
+
+        writeBinaryPOD(writer, pq_chunk);
+        writeBinaryPOD(writer, pq_cluster);
+        writeBinaryPOD(writer, pq_sub_dim);
+
+        data_level0_memory_->SerializeImpl(writer, cur_element_count_);
 
         for (size_t i = 0; i < cur_element_count_; i++) {
             unsigned int linkListSize =
                 element_levels_[i] > 0 ? size_links_per_element_ * element_levels_[i] : 0;
-            writeBinaryPOD(out_stream, linkListSize);
+            writeBinaryPOD(writer, linkListSize);
             if (linkListSize) {
-                out_stream.write(linkLists_[i], linkListSize);
+                writer.Write(linkLists_[i], linkListSize);
             }
         }
 
-        out_stream.write((char*)pq_map, max_elements_ * pq_chunk * sizeof(uint8_t));
+        writer.Write((char*)pq_map, max_elements_ * pq_chunk * sizeof(uint8_t));
 
         for (auto& chunk : pq_book) {
             for (auto& cluster : chunk) {
-                out_stream.write((char*)cluster.data(), pq_sub_dim * sizeof(float));
+                writer.Write((char*)cluster.data(), pq_sub_dim * sizeof(float));
             }
         }
-        out_stream.write((char*)node_cluster_dist_, max_elements_ * sizeof(float));
+        writer.Write((char*)node_cluster_dist_, max_elements_ * sizeof(float));
     }
 
     // load index from a file stream
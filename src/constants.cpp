@@ -39,6 +39,10 @@ const char* const DISKANN_COMPRESSED_VECTOR = "diskann_compressed_vector";
 const char* const DISKANN_LAYOUT_FILE = "diskann_layout_file";
 const char* const DISKANN_TAG_FILE = "diskann_tag_file";
 const char* const DISKANN_GRAPH = "diskann_graph";
+const char* const DISKANN_CACHE_NODES = "diskann_cache_nodes";
+const char* const DISKANN_DELTA_IDS = "diskann_delta_ids";
+const char* const DISKANN_DELTA_VECTORS = "diskann_delta_vectors";
+const char* const DISKANN_DELETED_IDS = "diskann_deleted_ids";
 const char* const SIMPLEFLAT_VECTORS = "simpleflat_vectors";
 const char* const SIMPLEFLAT_IDS = "simpleflat_ids";
 const char* const METRIC_L2 = "l2";
@@ -64,18 +68,26 @@ const char* const DISKANN_PARAMETER_USE_REFERENCE = "use_reference";
 const char* const DISKANN_PARAMETER_USE_OPQ = "use_opq";
 const char* const DISKANN_PARAMETER_USE_ASYNC_IO = "use_async_io";
 const char* const DISKANN_PARAMETER_USE_BSA = "use_bsa";
+const char* const DISKANN_PARAMETER_CACHE_SIZE = "cache_size";
+const char* const DISKANN_PARAMETER_MERGE_THRESHOLD = "merge_threshold";
+const char* const DISKANN_PARAMETER_BUILD_MEMORY_BUDGET = "build_memory_budget";
 
 const char* const DISKANN_PARAMETER_BEAM_SEARCH = "beam_search";
 const char* const DISKANN_PARAMETER_IO_LIMIT = "io_limit";
 const char* const DISKANN_PARAMETER_EF_SEARCH = "ef_search";
 const char* const DISKANN_PARAMETER_REORDER = "use_reorder";
+const char* const DISKANN_PARAMETER_ENTRY_IDS = "entry_ids";
 const char* const DISKANN_PARAMETER_GRAPH_TYPE = "graph_type";
 const char* const DISKANN_PARAMETER_ALPHA = "alpha";
 const char* const DISKANN_PARAMETER_GRAPH_ITER_TURN = "graph_iter_turn";
 const char* const DISKANN_PARAMETER_NEIGHBOR_SAMPLE_RATE = "neighbor_sample_rate";
+const char* const DISKANN_PARAMETER_SECTOR_VECTOR_TYPE = "sector_vector_type";
 
 const char* const DISKANN_GRAPH_TYPE_VAMANA = "vamana";
 const char* const DISKANN_GRAPH_TYPE_ODESCENT = "odescent";
+const char* const DISKANN_SECTOR_VECTOR_TYPE_FP32 = "fp32";
+const char* const DISKANN_SECTOR_VECTOR_TYPE_FP16 = "fp16";
+const char* const DISKANN_SECTOR_VECTOR_TYPE_SQ8 = "sq8";
 
 const char* const HNSW_PARAMETER_EF_RUNTIME = "ef_search";
 const char* const HNSW_PARAMETER_M = "max_degree";
@@ -83,6 +95,7 @@ const char* const HNSW_PARAMETER_CONSTRUCTION = "ef_construction";
 const char* const HNSW_PARAMETER_USE_STATIC = "use_static";
 const char* const HNSW_PARAMETER_REVERSED_EDGES = "use_reversed_edges";
 const char* const HNSW_PARAMETER_SKIP_RATIO = "skip_ratio";
+const char* const HNSW_PARAMETER_GRAPH_REORDER = BUILD_GRAPH_REORDER;
 
 const char* const INDEX_PARAM = "index_param";
 
@@ -93,6 +106,10 @@ const char PART_SLASH = '/';
 const char* const STATSTIC_MEMORY = "memory";
 const char* const STATSTIC_INDEX_NAME = "index_name";
 const char* const STATSTIC_DATA_NUM = "data_num";
+const char* const STATSTIC_HUGEPAGE_MEMORY = "hugepage_memory";
+const char* const STATSTIC_PREFETCH_JUMP_CODE_SIZE = "prefetch_jump_code_size";
+const char* const STATSTIC_PREFETCH_CACHE_LINE_SIZE = "prefetch_cache_line_size";
+const char* const STATSTIC_PREFETCH_NEIGHBOR_VISIT_NUM = "prefetch_neighbor_visit_num";
 
 const char* const STATSTIC_KNN_TIME = "knn_time";
 const char* const STATSTIC_KNN_IO = "knn_io";
@@ -104,6 +121,11 @@ const char* const STATSTIC_RANGE_IO = "range_io";
 const char* const STATSTIC_RANGE_HOP = "range_hop";
 const char* const STATSTIC_RANGE_CACHE_HIT = "range_cache_hit";
 const char* const STATSTIC_RANGE_IO_TIME = "range_io_time";
+const char* const STATSTIC_IO_QUEUE_DEPTH = "io_queue_depth";
+const char* const STATSTIC_IO_MAX_QUEUE_DEPTH = "io_max_queue_depth";
+const char* const STATSTIC_IO_DEVICE_READS = "io_device_reads";
+const char* const STATSTIC_IO_SHARED_READS = "io_shared_reads";
+const char* const STATSTIC_IO_COALESCED_READS = "io_coalesced_reads";
 
 //Error message
 const char* const MESSAGE_PARAMETER = "invalid parameter";
@@ -115,10 +137,25 @@ const char* const SERIALIZE_VERSION = "VERSION";
 const char* const HGRAPH_USE_REORDER = HGRAPH_USE_REORDER_KEY;
 const char* const HGRAPH_BASE_QUANTIZATION_TYPE = "base_quantization_type";
 const char* const HGRAPH_GRAPH_MAX_DEGREE = "max_degree";
+const char* const HGRAPH_GRAPH_USE_COMPRESSION = "graph_use_compression";
+const char* const HGRAPH_COLOCATE_GRAPH = HGRAPH_COLOCATE_GRAPH_KEY;
+const char* const HGRAPH_USE_HUGEPAGE = BLOCK_IO_USE_HUGEPAGE_KEY;
+const char* const HGRAPH_NUMA_INTERLEAVE = BLOCK_IO_NUMA_INTERLEAVE_KEY;
 const char* const HGRAPH_BUILD_EF_CONSTRUCTION = "ef_construction";
 const char* const HGRAPH_INIT_CAPACITY = "hgraph_init_capacity";
 const char* const HGRAPH_BUILD_THREAD_COUNT = "build_thread_count";
+const char* const HGRAPH_BUILD_GRAPH_REORDER = BUILD_GRAPH_REORDER;
+const char* const HGRAPH_BUILD_TUNE_PREFETCH = BUILD_TUNE_PREFETCH;
 const char* const HGRAPH_PRECISE_QUANTIZATION_TYPE = "precise_quantization_type";
+const char* const HGRAPH_PRECISE_IO_TYPE = "precise_io_type";
+const char* const HGRAPH_PRECISE_IO_HOT_SIZE = "precise_io_hot_size";
+const char* const HGRAPH_BASE_DRIFT_THRESHOLD = "base_drift_threshold";
+const char* const HGRAPH_BASE_TRANSFORM_TYPE = "base_transform_type";
+const char* const HGRAPH_BASE_TRANSFORM_DIM = "base_transform_dim";
+const char* const HGRAPH_RERANK_STAGES = HGRAPH_RERANK_STAGES_KEY;
+const char* const HGRAPH_RERANK_STAGE_QUANTIZATION_TYPE = "quantization_type";
+const char* const HGRAPH_RERANK_STAGE_IO_TYPE = "io_type";
+const char* const HGRAPH_RERANK_STAGE_CANDIDATE_FACTOR = HGRAPH_RERANK_CANDIDATE_FACTOR_KEY;
 
 const char* const BRUTE_FORCE_QUANTIZATION_TYPE = "quantization_type";
 const char* const BRUTE_FORCE_IO_TYPE = "io_type";
@@ -0,0 +1,347 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "compressed_graph_datacell.h"
+
+#include <fmt/format-inl.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "common.h"
+#include "graph_datacell_parameter.h"
+#include "logger.h"
+#include "prefetch.h"
+#include "simd/simd.h"
+#include "utils/scratch_buffer.h"
+
+namespace vsag {
+
+static uint64_t
+round_up(uint64_t size, uint64_t align) {
+    return (size + align - 1) / align * align;
+}
+
+CompressedGraphDataCell::CompressedGraphDataCell(Allocator* allocator, uint32_t max_degree)
+    : allocator_(allocator),
+      offsets_(allocator),
+      blocks_(allocator),
+      stripes_(LOCK_STRIPE_COUNT, allocator) {
+    CHECK_ARGUMENT(max_degree <= std::numeric_limits<uint16_t>::max(),
+                   fmt::format("compressed graph supports max degree up to {}, got {}",
+                               std::numeric_limits<uint16_t>::max(),
+                               max_degree));
+    this->maximum_degree_ = max_degree;
+}
+
+CompressedGraphDataCell::CompressedGraphDataCell(const GraphInterfaceParamPtr& param,
+                                                 const IndexCommonParam& common_param)
+    : CompressedGraphDataCell(
+          common_param.allocator_.get(),
+          std::dynamic_pointer_cast<GraphDataCellParameter>(param)->max_degree_) {
+    this->max_capacity_ =
+        std::dynamic_pointer_cast<GraphDataCellParameter>(param)->init_max_capacity_;
+}
+
+void
+CompressedGraphDataCell::InsertNeighborsById(InnerIdType id,
+                                             const Vector<InnerIdType>& neighbor_ids) {
+    if (neighbor_ids.size() > this->maximum_degree_) {
+        logger::warn(fmt::format(
+            "insert neighbors count {} more than {}", neighbor_ids.size(), this->maximum_degree_));
+    }
+    auto size = std::min(this->maximum_degree_, static_cast<uint32_t>(neighbor_ids.size()));
+    Vector<InnerIdType> sorted_ids(
+        neighbor_ids.begin(), neighbor_ids.begin() + size, this->allocator_);
+    Vector<uint8_t> block(this->allocator_);
+    this->encode_block(sorted_ids, block);
+
+    std::lock_guard<std::mutex> write_lock(this->write_mutex_);
+    this->max_capacity_ = std::max(this->max_capacity_, id + 1);
+    // blocks are appended behind used_size_, which no reader touches, so only moving
+    // offsets_ or blocks_ needs every stripe
+    bool grow_offsets = id >= this->offsets_.size();
+    bool grow_blocks =
+        this->blocks_.size() < this->used_size_ + block.size() + DELTA_DECODE_PADDING;
+    {
+        Vector<std::unique_lock<std::shared_mutex>> locks(this->allocator_);
+        if (grow_offsets or grow_blocks) {
+            locks = this->lock_all_stripes();
+        } else {
+            locks.emplace_back(this->stripe(id));
+        }
+        if (grow_offsets) {
+            this->offsets_.resize(this->max_capacity_, EMPTY_OFFSET);
+        }
+        auto offset = this->offsets_[id];
+        if (offset != EMPTY_OFFSET) {
+            auto* old_block = this->blocks_.data() + static_cast<uint64_t>(offset) * BLOCK_ALIGN;
+            auto old_size = block_size(old_block);
+            if (not block.empty() and block.size() <= old_size) {
+                std::memcpy(old_block, block.data(), block.size());
+                this->garbage_size_ += old_size - block.size();
+                return;
+            }
+            this->garbage_size_ += old_size;
+        }
+        this->append_block(id, block);
+    }
+    if (this->used_size_ > COMPACT_MIN_SIZE and this->garbage_size_ * 2 > this->used_size_) {
+        auto locks = this->lock_all_stripes();
+        this->compact();
+    }
+}
+
+uint32_t
+CompressedGraphDataCell::GetNeighborSize(InnerIdType id) const {
+    std::shared_lock<std::shared_mutex> rlock(this->stripe(id));
+    const auto* block = this->get_block(id);
+    if (block == nullptr) {
+        return 0;
+    }
+    uint16_t count;
+    std::memcpy(&count, block, sizeof(count));
+    return count;
+}
+
+void
+CompressedGraphDataCell::GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const {
+    std::shared_lock<std::shared_mutex> rlock(this->stripe(id));
+    const auto* block = this->get_block(id);
+    if (block == nullptr) {
+        neighbor_ids.clear();
+        return;
+    }
+    uint16_t count;
+    std::memcpy(&count, block, sizeof(count));
+    neighbor_ids.resize(count);
+    decode_block(block, neighbor_ids.data());
+}
+
+const InnerIdType*
+CompressedGraphDataCell::GetNeighborsPtr(InnerIdType id,
+                                         uint32_t& neighbor_count,
+                                         bool& need_release) const {
+    std::shared_lock<std::shared_mutex> rlock(this->stripe(id));
+    const auto* block = this->get_block(id);
+    uint16_t count = 0;
+    if (block != nullptr) {
+        std::memcpy(&count, block, sizeof(count));
+    }
+    neighbor_count = count;
+    auto size = std::max<uint64_t>(count, 1) * sizeof(InnerIdType);
+    auto* neighbors =
+        reinterpret_cast<InnerIdType*>(ScratchBuffer::Cached(size, ScratchBuffer::NEIGHBORS));
+    need_release = neighbors == nullptr;
+    if (need_release) {
+        neighbors = reinterpret_cast<InnerIdType*>(this->allocator_->Allocate(size));
+    }
+    if (count > 0) {
+        decode_block(block, neighbors);
+    }
+    return neighbors;
+}
+
+void
+CompressedGraphDataCell::decode_block(const uint8_t* block, InnerIdType* neighbor_ids) {
+    uint16_t count;
+    std::memcpy(&count, block, sizeof(count));
+    uint32_t bit_width = block[2];
+    InnerIdType smallest_id;
+    std::memcpy(&smallest_id, block + 4, sizeof(smallest_id));
+    neighbor_ids[0] = smallest_id;
+    DeltaDecodeIds(block + BLOCK_HEADER_SIZE, bit_width, count - 1, smallest_id, neighbor_ids + 1);
+}
+
+void
+CompressedGraphDataCell::Resize(InnerIdType new_size) {
+    std::lock_guard<std::mutex> write_lock(this->write_mutex_);
+    if (new_size < this->max_capacity_) {
+        return;
+    }
+    auto locks = this->lock_all_stripes();
+    this->max_capacity_ = new_size;
+    this->offsets_.resize(new_size, EMPTY_OFFSET);
+}
+
+void
+CompressedGraphDataCell::Prefetch(InnerIdType id, uint32_t neighbor_i) {
+    // a hint must not wait for a writer
+    std::shared_lock<std::shared_mutex> rlock(this->stripe(id), std::try_to_lock);
+    if (not rlock.owns_lock()) {
+        return;
+    }
+    const auto* block = this->get_block(id);
+    if (block != nullptr) {
+        PrefetchLines(block, PREFETCH_BLOCK_SIZE);
+    }
+}
+
+void
+CompressedGraphDataCell::Serialize(StreamWriter& writer) {
+    std::lock_guard<std::mutex> write_lock(this->write_mutex_);
+    GraphInterface::Serialize(writer);
+    StreamWriter::WriteVector(writer, this->offsets_);
+    StreamWriter::WriteObj(writer, this->used_size_);
+    StreamWriter::WriteObj(writer, this->garbage_size_);
+    writer.Write(reinterpret_cast<const char*>(this->blocks_.data()), this->used_size_);
+}
+
+void
+CompressedGraphDataCell::Deserialize(StreamReader& reader) {
+    std::lock_guard<std::mutex> write_lock(this->write_mutex_);
+    auto locks = this->lock_all_stripes();
+    GraphInterface::Deserialize(reader);
+    StreamReader::ReadVector(reader, this->offsets_);
+    StreamReader::ReadObj(reader, this->used_size_);
+    StreamReader::ReadObj(reader, this->garbage_size_);
+    this->blocks_.resize(this->used_size_ + DELTA_DECODE_PADDING, 0);
+    reader.Read(reinterpret_cast<char*>(this->blocks_.data()), this->used_size_);
+}
+
+uint64_t
+CompressedGraphDataCell::GetMemoryUsage() const {
+    std::lock_guard<std::mutex> write_lock(this->write_mutex_);
+    return this->offsets_.capacity() * sizeof(uint32_t) + this->blocks_.capacity();
+}
+
+uint64_t
+CompressedGraphDataCell::EstimateMemory(uint64_t element_count, uint32_t max_degree) {
+    uint64_t bit_width = 1;
+    while (bit_width < 32 and (element_count >> bit_width) != 0) {
+        ++bit_width;
+    }
+    auto count = static_cast<uint16_t>(std::max<uint32_t>(max_degree, 1));
+    auto block = block_size(count, static_cast<uint32_t>(bit_width));
+    return element_count * (sizeof(uint32_t) + block) + DELTA_DECODE_PADDING;
+}
+
+const uint8_t*
+CompressedGraphDataCell::get_block(InnerIdType id) const {
+    if (id >= this->offsets_.size() or this->offsets_[id] == EMPTY_OFFSET) {
+        return nullptr;
+    }
+    return this->blocks_.data() + static_cast<uint64_t>(this->offsets_[id]) * BLOCK_ALIGN;
+}
+
+void
+CompressedGraphDataCell::encode_block(Vector<InnerIdType>& neighbor_ids,
+                                      Vector<uint8_t>& block) const {
+    block.clear();
+    if (neighbor_ids.empty()) {
+        return;
+    }
+    std::sort(neighbor_ids.begin(), neighbor_ids.end());
+    InnerIdType max_delta = 0;
+    for (uint64_t i = 1; i < neighbor_ids.size(); ++i) {
+        max_delta = std::max(max_delta, neighbor_ids[i] - neighbor_ids[i - 1]);
+    }
+    uint32_t bit_width = 0;
+    while (bit_width < 32 and (max_delta >> bit_width) != 0) {
+        ++bit_width;
+    }
+
+    auto count = static_cast<uint16_t>(neighbor_ids.size());
+    auto size = block_size(count, bit_width);
+    // pack with 64-bit words, the spare tail is dropped afterwards
+    block.resize(size + sizeof(uint64_t), 0);
+    std::memcpy(block.data(), &count, sizeof(count));
+    block[2] = static_cast<uint8_t>(bit_width);
+    std::memcpy(block.data() + 4, neighbor_ids.data(), sizeof(InnerIdType));
+
+    auto* packed = block.data() + BLOCK_HEADER_SIZE;
+    uint64_t bit_pos = 0;
+    for (uint64_t i = 1; i < neighbor_ids.size(); ++i) {
+        uint64_t delta = neighbor_ids[i] - neighbor_ids[i - 1];
+        uint64_t word;
+        std::memcpy(&word, packed + (bit_pos >> 3), sizeof(word));
+        word |= delta << (bit_pos & 7);
+        std::memcpy(packed + (bit_pos >> 3), &word, sizeof(word));
+        bit_pos += bit_width;
+    }
+    block.resize(size);
+}
+
+void
+CompressedGraphDataCell::append_block(InnerIdType id, const Vector<uint8_t>& block) {
+    if (block.empty()) {
+        this->offsets_[id] = EMPTY_OFFSET;
+        return;
+    }
+    if (this->used_size_ / BLOCK_ALIGN >= EMPTY_OFFSET) {
+        throw std::runtime_error(
+            fmt::format("compressed graph exceeds {} bytes", this->used_size_));
+    }
+    // keep DELTA_DECODE_PADDING readable bytes behind the last block
+    auto required_size = this->used_size_ + block.size() + DELTA_DECODE_PADDING;
+    if (this->blocks_.size() < required_size) {
+        this->blocks_.resize(std::max(required_size, this->blocks_.size() * 2), 0);
+    }
+    std::memcpy(this->blocks_.data() + this->used_size_, block.data(), block.size());
+    this->offsets_[id] = static_cast<uint32_t>(this->used_size_ / BLOCK_ALIGN);
+    this->used_size_ += block.size();
+}
+
+void
+CompressedGraphDataCell::compact() {
+    Vector<uint8_t> blocks(this->allocator_);
+    blocks.resize(this->used_size_ - this->garbage_size_ + DELTA_DECODE_PADDING, 0);
+    uint64_t used_size = 0;
+    for (auto& offset : this->offsets_) {
+        if (offset == EMPTY_OFFSET) {
+            continue;
+        }
+        const auto* block = this->blocks_.data() + static_cast<uint64_t>(offset) * BLOCK_ALIGN;
+        auto size = block_size(block);
+        std::memcpy(blocks.data() + used_size, block, size);
+        offset = static_cast<uint32_t>(used_size / BLOCK_ALIGN);
+        used_size += size;
+    }
+    this->blocks_.swap(blocks);
+    this->used_size_ = used_size;
+    this->garbage_size_ = 0;
+}
+
+Vector<std::unique_lock<std::shared_mutex>>
+CompressedGraphDataCell::lock_all_stripes() const {
+    Vector<std::unique_lock<std::shared_mutex>> locks(this->allocator_);
+    locks.reserve(LOCK_STRIPE_COUNT);
+    for (auto& stripe : this->stripes_) {
+        locks.emplace_back(stripe);
+    }
+    return locks;
+}
+
+uint64_t
+CompressedGraphDataCell::block_size(uint16_t count, uint32_t bit_width) {
+    auto packed_size = (static_cast<uint64_t>(count - 1) * bit_width + 7) / 8;
+    auto size = BLOCK_HEADER_SIZE + packed_size;
+    if (count > 1) {
+        // the decoder reads DELTA_DECODE_PADDING bytes from the byte holding the last delta,
+        // keep them inside the block so that a reader never touches a block being written
+        auto last_delta_byte = static_cast<uint64_t>(count - 2) * bit_width / 8;
+        size = std::max(size, BLOCK_HEADER_SIZE + last_delta_byte + DELTA_DECODE_PADDING);
+    }
+    return round_up(size, BLOCK_ALIGN);
+}
+
+uint64_t
+CompressedGraphDataCell::block_size(const uint8_t* block) {
+    uint16_t count;
+    std::memcpy(&count, block, sizeof(count));
+    return block_size(count, block[2]);
+}
+
+}  // namespace vsag
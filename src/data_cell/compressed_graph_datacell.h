@@ -0,0 +1,149 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+
+#include "graph_interface.h"
+
+namespace vsag {
+
+/**
+ * graph with variable sized neighbor lists for static or rarely updated indexes
+ *
+ * each list is sorted and stored as the smallest id followed by bit-packed deltas,
+ * so a node takes space for its real degree only and ids are narrowed to the bits
+ * of the largest gap; GetNeighbors returns ids in ascending order
+ *
+ * readers lock only the stripe of their id, a block is rewritten under its stripe and
+ * decoding never reads past the end of its own block; blocks_ and offsets_ move only with
+ * every stripe held
+ */
+class CompressedGraphDataCell : public GraphInterface {
+public:
+    CompressedGraphDataCell(const GraphInterfaceParamPtr& graph_param,
+                            const IndexCommonParam& common_param);
+
+    explicit CompressedGraphDataCell(Allocator* allocator, uint32_t max_degree = 32);
+
+    void
+    InsertNeighborsById(InnerIdType id, const Vector<InnerIdType>& neighbor_ids) override;
+
+    [[nodiscard]] uint32_t
+    GetNeighborSize(InnerIdType id) const override;
+
+    void
+    GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const override;
+
+    /**
+     * @brief Decodes the neighbors into the calling thread's ScratchBuffer block, which
+     * stays valid until the thread's next call. Lists that do not fit into the block are
+     * decoded into an allocated buffer and need_release is set.
+     */
+    [[nodiscard]] const InnerIdType*
+    GetNeighborsPtr(InnerIdType id, uint32_t& neighbor_count, bool& need_release) const override;
+
+    void
+    ReleaseNeighbors(const InnerIdType* neighbors) const override {
+        this->allocator_->Deallocate(const_cast<InnerIdType*>(neighbors));
+    }
+
+    void
+    Resize(InnerIdType new_size) override;
+
+    /****
+     * prefetch the block offset and the block of a base point with id, skipped while a
+     * writer holds the stripe of id
+     * @param id of base point
+     * @param neighbor_i unused, a block is decoded as a whole
+     */
+    void
+    Prefetch(InnerIdType id, uint32_t neighbor_i) override;
+
+    void
+    Serialize(StreamWriter& writer) override;
+
+    void
+    Deserialize(StreamReader& reader) override;
+
+    [[nodiscard]] uint64_t
+    GetMemoryUsage() const override;
+
+    /**
+     * @brief Estimates the bytes of element_count full neighbor lists, assuming the deltas
+     * need as many bits as element_count.
+     */
+    static uint64_t
+    EstimateMemory(uint64_t element_count, uint32_t max_degree);
+
+private:
+    [[nodiscard]] const uint8_t*
+    get_block(InnerIdType id) const;
+
+    static void
+    decode_block(const uint8_t* block, InnerIdType* neighbor_ids);
+
+    void
+    encode_block(Vector<InnerIdType>& neighbor_ids, Vector<uint8_t>& block) const;
+
+    void
+    append_block(InnerIdType id, const Vector<uint8_t>& block);
+
+    void
+    compact();
+
+    [[nodiscard]] std::shared_mutex&
+    stripe(InnerIdType id) const {
+        return this->stripes_[id % LOCK_STRIPE_COUNT];
+    }
+
+    // held while offsets_ or blocks_ may move
+    [[nodiscard]] Vector<std::unique_lock<std::shared_mutex>>
+    lock_all_stripes() const;
+
+    static uint64_t
+    block_size(uint16_t count, uint32_t bit_width);
+
+    static uint64_t
+    block_size(const uint8_t* block);
+
+private:
+    // block layout: uint16 count, uint8 bit width, uint8 unused, uint32 smallest id, deltas
+    static constexpr uint64_t BLOCK_HEADER_SIZE = 8;
+    // blocks start at multiples of BLOCK_ALIGN, offsets_ are stored in these units
+    static constexpr uint64_t BLOCK_ALIGN = 4;
+    static constexpr uint32_t EMPTY_OFFSET = std::numeric_limits<uint32_t>::max();
+    // rewrite blocks_ once more than half of it is no longer referenced
+    static constexpr uint64_t COMPACT_MIN_SIZE = 1 << 20;
+    static constexpr uint64_t LOCK_STRIPE_COUNT = 32;
+    // a block of 32 neighbors with gaps up to 2^30
+    static constexpr uint64_t PREFETCH_BLOCK_SIZE = 128;
+
+    Allocator* const allocator_{nullptr};
+
+    Vector<uint32_t> offsets_;
+    Vector<uint8_t> blocks_;
+    uint64_t used_size_{0};
+    uint64_t garbage_size_{0};
+
+    // serializes the writers, guards used_size_ and garbage_size_
+    mutable std::mutex write_mutex_{};
+    mutable Vector<std::shared_mutex> stripes_;
+};
+
+}  // namespace vsag
@@ -15,15 +15,24 @@
 
 #pragma once
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <future>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
 
 #include "flatten_interface.h"
+#include "graph_datacell.h"
 #include "io/basic_io.h"
 #include "quantization/quantizer.h"
+#include "quantization/transform/vector_transformer.h"
+#include "utils/scratch_buffer.h"
 namespace vsag {
 /*
-* thread unsafe
+* thread unsafe, except that a drift re-encode may run in background while the cell is in use
 */
 template <typename QuantTmpl, typename IOTmpl>
 class FlattenDataCell : public FlattenInterface {
@@ -34,6 +43,10 @@ public:
                              const IOParamPtr& io_param,
                              const IndexCommonParam& common_param);
 
+    ~FlattenDataCell() override {
+        this->WaitForReEncode();
+    }
+
     void
     Query(float* result_dists,
           const ComputerInterfacePtr& computer,
@@ -65,9 +78,16 @@ public:
         this->max_capacity_ = std::max(capacity, this->total_count_);  // TODO(LHT): add warning
     }
 
+    void
+    Permute(const Vector<InnerIdType>& new_ids) override;
+
     void
     Prefetch(InnerIdType id) override {
-        io_->Prefetch(id * code_size_, code_size_);
+        this->with_current(
+            [&](Quantizer<QuantTmpl>& quantizer, BasicIO<IOTmpl>& io) {
+                io.Prefetch(this->code_offset(id), this->code_stride_);
+            },
+            id);
     };
 
     [[nodiscard]] std::string
@@ -82,30 +102,199 @@ public:
     bool
     GetCodesById(InnerIdType id, uint8_t* codes) const override;
 
+    void
+    ReleaseCodes(const uint8_t* codes) const override {
+        allocator_->Deallocate(const_cast<uint8_t*>(codes));
+    }
+
+    [[nodiscard]] std::shared_ptr<void>
+    PinCodes() const override;
+
     void
     Serialize(StreamWriter& writer) override;
 
     void
     Deserialize(StreamReader& reader) override;
 
+    void
+    WaitForReEncode() override;
+
+    [[nodiscard]] uint64_t
+    HugePageMemory() const override {
+        return this->with_current([](Quantizer<QuantTmpl>& quantizer, BasicIO<IOTmpl>& io) {
+            return io.HugePageMemory();
+        });
+    }
+
+    GraphInterfacePtr
+    MakeColocatedGraph(const GraphInterfaceParamPtr& graph_param,
+                       const IndexCommonParam& common_param) override;
+
+    [[nodiscard]] uint64_t
+    CodeStride() const override {
+        return this->code_stride_;
+    }
+
+    /**
+     * @brief Enables tracking of vectors that fall outside the trained quantizer range.
+     *
+     * Once at least min_count vectors were inserted and the out-of-range fraction exceeds
+     * threshold, the quantizer is re-trained and all codes are re-encoded into a second
+     * code array in background; searches keep using the current codes until the swap.
+     * Requires the cell to be created from parameters, a threshold of 0 disables it.
+     */
+    void
+    SetDriftDetection(float threshold, uint64_t min_count) {
+        this->drift_threshold_ = threshold;
+        this->drift_min_count_ = std::max<uint64_t>(min_count, 1);
+    }
+
     inline void
     SetQuantizer(std::shared_ptr<Quantizer<QuantTmpl>> quantizer) {
         this->quantizer_ = quantizer;
         this->code_size_ = quantizer_->GetCodeSize();
+        this->code_stride_ = this->code_size_;
+        this->publish_generation();
     }
 
     inline void
     SetIO(std::shared_ptr<BasicIO<IOTmpl>> io) {
         this->io_ = io;
+        this->publish_generation();
+    }
+
+    /**
+     * @brief Sets a transform applied to every vector and query before quantization.
+     *
+     * The quantizer must be created with the output dimension of the transform.
+     */
+    inline void
+    SetTransformer(VectorTransformerPtr transformer) {
+        this->transformer_ = std::move(transformer);
     }
 
 public:
     std::shared_ptr<Quantizer<QuantTmpl>> quantizer_{nullptr};
     std::shared_ptr<BasicIO<IOTmpl>> io_{nullptr};
+    VectorTransformerPtr transformer_{nullptr};
 
     Allocator* const allocator_{nullptr};
 
 private:
+    /**
+     * @brief A trained quantizer together with the codes it encoded.
+     *
+     * Computers hold their generation by refcount, so a retired generation is released
+     * together with the last computer created from it.
+     */
+    struct Generation : public std::enable_shared_from_this<Generation> {
+        std::shared_ptr<Quantizer<QuantTmpl>> quantizer{nullptr};
+        std::shared_ptr<BasicIO<IOTmpl>> io{nullptr};
+        // ids inserted after the generation was retired have no codes in io
+        std::atomic<InnerIdType> valid_count{std::numeric_limits<InnerIdType>::max()};
+    };
+
+    /**
+     * @brief Pins current_generation_ without blocking the swap.
+     *
+     * A reader registers in the epoch it starts in, the swap waits until both epochs that
+     * may still see the old pointer are empty before dropping it.
+     */
+    class GenerationGuard {
+    public:
+        explicit GenerationGuard(const FlattenDataCell* cell)
+            : readers_(cell->active_readers_[cell->epoch_.load() & 1]) {
+            readers_.fetch_add(1);
+            generation_ = cell->current_generation_.load();
+        }
+
+        ~GenerationGuard() {
+            readers_.fetch_sub(1);
+        }
+
+        Generation*
+        operator->() const {
+            return generation_;
+        }
+
+    private:
+        std::atomic<uint64_t>& readers_;
+        Generation* generation_{nullptr};
+    };
+
+    // a generation pinned by PinCodes on this thread
+    struct ThreadPin {
+        const FlattenDataCell* cell{nullptr};
+        Generation* generation{nullptr};
+    };
+
+    /**
+     * @brief Runs func on the codes that hold every id up to max_id.
+     *
+     * A generation pinned by this thread is used without touching the reader counters,
+     * unless it was retired before max_id was inserted.
+     */
+    template <typename Func>
+    auto
+    with_current(Func&& func, InnerIdType max_id = 0) const {
+        if (not this->drift_enabled()) {
+            return func(*this->quantizer_, *this->io_);
+        }
+        const auto* pinned = this->pinned_generation();
+        if (pinned != nullptr and max_id < pinned->valid_count.load()) {
+            return func(*pinned->quantizer, *pinned->io);
+        }
+        GenerationGuard generation(this);
+        return func(*generation->quantizer, *generation->io);
+    }
+
+    [[nodiscard]] const Generation*
+    pinned_generation() const {
+        for (uint64_t i = 0; i < thread_pin_count; ++i) {
+            if (thread_pins[i].cell == this) {
+                return thread_pins[i].generation;
+            }
+        }
+        return nullptr;
+    }
+
+    static void
+    unpin(const FlattenDataCell* cell, const Generation* generation) {
+        for (uint64_t i = thread_pin_count; i > 0; --i) {
+            auto& pin = thread_pins[i - 1];
+            if (pin.cell == cell and pin.generation == generation) {
+                pin = thread_pins[--thread_pin_count];
+                return;
+            }
+        }
+    }
+
+    void
+    publish_generation() {
+        if (this->quantizer_ == nullptr or this->io_ == nullptr) {
+            return;
+        }
+        auto generation = std::make_shared<Generation>();
+        generation->quantizer = this->quantizer_;
+        generation->io = this->io_;
+        this->generation_ = generation;
+        this->current_generation_.store(generation.get());
+    }
+
+    void
+    wait_for_readers() {
+        // two flips, a reader that read the epoch before the first one may register late
+        for (int i = 0; i < 2; ++i) {
+            auto epoch = this->epoch_.fetch_add(1);
+            while (this->active_readers_[epoch & 1].load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void
+    add_drift_sample(const float* vector, InnerIdType id);
+
     inline void
     query(float* result_dists,
           const float* query_vector,
@@ -118,27 +307,177 @@ private:
           const InnerIdType* idx,
           InnerIdType id_count);
 
+    void
+    encode_batch(Quantizer<QuantTmpl>& quantizer,
+                 const float* vectors,
+                 uint8_t* codes,
+                 InnerIdType count);
+
     ComputerInterfacePtr
     factory_computer(const float* query) {
-        auto computer = this->quantizer_->FactoryComputer();
+        ScratchBuffer transformed(this->transformed_size(), ScratchBuffer::TRANSFORM, allocator_);
+        query = this->transform(query, reinterpret_cast<float*>(transformed.Data()));
+        if (not this->drift_enabled()) {
+            auto computer = this->quantizer_->FactoryComputer();
+            computer->SetQuery(query);
+            return computer;
+        }
+        GenerationGuard guard(this);
+        auto generation = guard->shared_from_this();
+        auto computer = generation->quantizer->FactoryComputer();
         computer->SetQuery(query);
+        // queries keep reading the codes of this generation after a swap
+        computer->owner_ = generation;
         return computer;
     }
+
+    /**
+     * @brief Applies transformer_ to count vectors.
+     *
+     * @return vectors itself without a transformer, otherwise buffer holding the results.
+     */
+    const float*
+    transform(const float* vectors, uint64_t count, Vector<float>& buffer) const {
+        if (this->transformer_ == nullptr) {
+            return vectors;
+        }
+        buffer.resize(count * static_cast<uint64_t>(this->transformer_->GetOutputDim()));
+        if (count == 1) {
+            this->transformer_->Transform(vectors, buffer.data());
+        } else {
+            this->transformer_->TransformBatch(vectors, buffer.data(), count);
+        }
+        return buffer.data();
+    }
+
+    /**
+     * @brief Applies transformer_ to one vector.
+     *
+     * @return vector itself without a transformer, otherwise buffer holding the result.
+     */
+    const float*
+    transform(const float* vector, float* buffer) const {
+        if (this->transformer_ == nullptr) {
+            return vector;
+        }
+        this->transformer_->Transform(vector, buffer);
+        return buffer;
+    }
+
+    // bytes of one transformed vector, 0 without a transformer
+    [[nodiscard]] uint64_t
+    transformed_size() const {
+        if (this->transformer_ == nullptr) {
+            return 0;
+        }
+        return static_cast<uint64_t>(this->transformer_->GetOutputDim()) * sizeof(float);
+    }
+
+    [[nodiscard]] inline uint64_t
+    code_offset(InnerIdType id) const {
+        return static_cast<uint64_t>(id) * this->code_stride_;
+    }
+
+    [[nodiscard]] inline bool
+    drift_enabled() const {
+        return this->drift_threshold_ > 0.0F and this->quantization_param_ != nullptr;
+    }
+
+    void
+    write_pending_codes(const float* vectors, InnerIdType count, InnerIdType first_id);
+
+    void
+    count_out_of_range(const float* vectors, InnerIdType count, InnerIdType first_id);
+
+    void
+    try_trigger_reencode();
+
+    void
+    reencode();
+
+    void
+    reencode_from_samples();
+
+private:
+    // sample sizes used to re-train the quantizer when drift is detected
+    static constexpr uint64_t DRIFT_DECODED_SAMPLE_COUNT = 16384;
+    static constexpr uint64_t DRIFT_OUT_OF_RANGE_SAMPLE_COUNT = 4096;
+    // smallest number of vectors encoded by one task of BatchInsertVector
+    static constexpr uint64_t ENCODE_BATCH_MIN_SIZE = 1024;
+    // ids re-encoded per hold of write_mutex_ in background
+    static constexpr InnerIdType REENCODE_BATCH_SIZE = 1024;
+    // pins a thread may hold at once, further pins fall back to pinning per call
+    static constexpr uint64_t MAX_THREAD_PINS = 4;
+
+    static inline thread_local std::array<ThreadPin, MAX_THREAD_PINS> thread_pins{};
+    static inline thread_local uint64_t thread_pin_count{0};
+
+    QuantizerParamPtr quantization_param_{nullptr};
+    IOParamPtr io_param_{nullptr};
+    IndexCommonParam common_param_{};
+
+    // distance between the codes of neighboring ids in io_, larger than code_size_ when
+    // the neighbor lists of a colocated graph are stored behind the codes
+    uint64_t code_stride_{0};
+
+    float drift_threshold_{0.0F};
+    uint64_t drift_min_count_{0};
+    std::atomic<uint64_t> drift_checked_count_{0};
+    std::atomic<uint64_t> drift_out_of_range_count_{0};
+
+    // serializes inserts with the background re-encode, guards all members below
+    std::mutex write_mutex_;
+
+    // quantizer_ and io_ as seen by readers, swapped after a re-encode
+    std::shared_ptr<Generation> generation_{nullptr};
+    std::atomic<Generation*> current_generation_{nullptr};
+    mutable std::atomic<uint64_t> epoch_{0};
+    mutable std::array<std::atomic<uint64_t>, 2> active_readers_{};
+
+    // a reservoir of the clipped raw vectors with their ids, used to train and encode the
+    // next generation
+    Vector<float> drift_samples_{allocator_};
+    Vector<InnerIdType> drift_sample_ids_{allocator_};
+    uint64_t drift_seen_count_{0};
+    std::mt19937 drift_rng_{0};
+
+    // the next generation, written by inserts in addition to the current one while
+    // the background task re-encodes ids in [reencode_cursor_, reencode_snapshot_count_)
+    std::shared_ptr<Quantizer<QuantTmpl>> pending_quantizer_{nullptr};
+    std::shared_ptr<BasicIO<IOTmpl>> pending_io_{nullptr};
+    InnerIdType reencode_cursor_{0};
+    InnerIdType reencode_snapshot_count_{0};
+    // ids below reencode_snapshot_count_ that inserts already wrote to the next generation
+    Vector<uint8_t> reencode_written_{allocator_};
+
+    std::atomic<bool> reencode_running_{false};
+    std::mutex reencode_future_mutex_;
+    std::future<void> reencode_future_;
 };
 
 template <typename QuantTmpl, typename IOTmpl>
 FlattenDataCell<QuantTmpl, IOTmpl>::FlattenDataCell(const QuantizerParamPtr& quantization_param,
                                                     const IOParamPtr& io_param,
                                                     const IndexCommonParam& common_param)
-    : allocator_(common_param.allocator_.get()) {
+    : allocator_(common_param.allocator_.get()),
+      quantization_param_(quantization_param),
+      io_param_(io_param),
+      common_param_(common_param) {
     this->quantizer_ = std::make_shared<QuantTmpl>(quantization_param, common_param);
     this->io_ = std::make_shared<IOTmpl>(io_param, common_param);
     this->code_size_ = quantizer_->GetCodeSize();
+    this->code_stride_ = this->code_size_;
+    this->publish_generation();
 }
 
 template <typename QuantTmpl, typename IOTmpl>
 void
 FlattenDataCell<QuantTmpl, IOTmpl>::Train(const float* data, uint64_t count) {
+    if (this->transformer_) {
+        this->transformer_->Train(data, count);
+    }
+    Vector<float> transformed(this->allocator_);
+    data = this->transform(data, count, transformed);
     if (this->quantizer_) {
         this->quantizer_->Train(data, count);
     }
@@ -147,6 +486,12 @@ FlattenDataCell<QuantTmpl, IOTmpl>::Train(const float* data, uint64_t count) {
 template <typename QuantTmpl, typename IOTmpl>
 void
 FlattenDataCell<QuantTmpl, IOTmpl>::InsertVector(const float* vector, InnerIdType idx) {
+    ScratchBuffer transformed(this->transformed_size(), ScratchBuffer::TRANSFORM, allocator_);
+    vector = this->transform(vector, reinterpret_cast<float*>(transformed.Data()));
+    std::unique_lock<std::mutex> lock(this->write_mutex_, std::defer_lock);
+    if (this->drift_enabled()) {
+        lock.lock();
+    }
     if (idx == std::numeric_limits<InnerIdType>::max()) {
         idx = total_count_;
         ++total_count_;
@@ -154,10 +499,16 @@ FlattenDataCell<QuantTmpl, IOTmpl>::InsertVector(const float* vector, InnerIdTyp
         total_count_ = std::max(total_count_, idx + 1);
     }
 
-    auto* codes = reinterpret_cast<uint8_t*>(allocator_->Allocate(code_size_));
-    quantizer_->EncodeOne(vector, codes);
-    io_->Write(codes, code_size_, static_cast<uint64_t>(idx) * static_cast<uint64_t>(code_size_));
-    allocator_->Deallocate(codes);
+    ScratchBuffer codes(code_size_, ScratchBuffer::ENCODE, allocator_);
+    quantizer_->EncodeOne(vector, codes.Data());
+    io_->Write(codes.Data(), code_size_, this->code_offset(idx));
+
+    if (lock.owns_lock()) {
+        this->write_pending_codes(vector, 1, idx);
+        this->count_out_of_range(vector, 1, idx);
+        lock.unlock();
+        this->try_trigger_reencode();
+    }
 }
 
 struct BufferWrapper {
@@ -181,32 +532,104 @@ void
 FlattenDataCell<QuantTmpl, IOTmpl>::BatchInsertVector(const float* vectors,
                                                       InnerIdType count,
                                                       InnerIdType* idx) {
+    Vector<float> transformed(this->allocator_);
+    vectors = this->transform(vectors, count, transformed);
+    BufferWrapper codes(static_cast<uint64_t>(count) * static_cast<uint64_t>(code_size_),
+                        allocator_);
+    std::unique_lock<std::mutex> lock(this->write_mutex_, std::defer_lock);
+    if (not this->drift_enabled()) {
+        this->encode_batch(*quantizer_, vectors, codes.data, count);
+    } else {
+        // encode without the lock, the pool tasks may queue behind a re-encode waiting for it
+        lock.lock();
+        auto quantizer = this->quantizer_;
+        lock.unlock();
+        this->encode_batch(*quantizer, vectors, codes.data, count);
+        lock.lock();
+        if (quantizer != this->quantizer_) {
+            // the quantizer was swapped in the meantime
+            quantizer_->EncodeBatch(vectors, codes.data, count);
+        }
+    }
     if (idx == nullptr) {
-        BufferWrapper codes(static_cast<uint64_t>(count) * static_cast<uint64_t>(code_size_),
-                            allocator_);
-        quantizer_->EncodeBatch(vectors, codes.data, count);
-        io_->Write(codes.data,
-                   static_cast<uint64_t>(count) * static_cast<uint64_t>(code_size_),
-                   static_cast<uint64_t>(total_count_) * static_cast<uint64_t>(code_size_));
+        if (this->code_stride_ == code_size_) {
+            io_->Write(codes.data,
+                       static_cast<uint64_t>(count) * static_cast<uint64_t>(code_size_),
+                       this->code_offset(total_count_));
+        } else {
+            for (InnerIdType i = 0; i < count; ++i) {
+                io_->Write(codes.data + static_cast<uint64_t>(i) * code_size_,
+                           code_size_,
+                           this->code_offset(total_count_ + i));
+            }
+        }
+        auto first_id = total_count_;
         total_count_ += count;
+
+        if (lock.owns_lock()) {
+            this->write_pending_codes(vectors, count, first_id);
+            this->count_out_of_range(vectors, count, first_id);
+        }
     } else {
-        auto dim = quantizer_->GetDim();
-        for (int64_t i = 0; i < count; ++i) {
-            this->InsertVector(vectors + dim * i, idx[i]);
+        auto dim = static_cast<uint64_t>(quantizer_->GetDim());
+        for (InnerIdType i = 0; i < count; ++i) {
+            io_->Write(codes.data + static_cast<uint64_t>(i) * static_cast<uint64_t>(code_size_),
+                       code_size_,
+                       this->code_offset(idx[i]));
+            total_count_ = std::max(total_count_, idx[i] + 1);
+            if (lock.owns_lock()) {
+                this->write_pending_codes(vectors + i * dim, 1, idx[i]);
+                this->count_out_of_range(vectors + i * dim, 1, idx[i]);
+            }
         }
     }
+
+    if (lock.owns_lock()) {
+        lock.unlock();
+        this->try_trigger_reencode();
+    }
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::encode_batch(Quantizer<QuantTmpl>& quantizer,
+                                                 const float* vectors,
+                                                 uint8_t* codes,
+                                                 InnerIdType count) {
+    auto* thread_pool = this->common_param_.thread_pool_.get();
+    uint64_t thread_count = std::max<uint64_t>(Options::Instance().num_threads_building(), 1);
+    if (thread_pool == nullptr or thread_count == 1 or count < 2 * ENCODE_BATCH_MIN_SIZE) {
+        quantizer.EncodeBatch(vectors, codes, count);
+        return;
+    }
+
+    auto dim = static_cast<uint64_t>(quantizer.GetDim());
+    auto block_size = std::max<uint64_t>((count + thread_count - 1) / thread_count,
+                                         ENCODE_BATCH_MIN_SIZE);
+    std::vector<std::future<void>> futures;
+    for (uint64_t begin = 0; begin < count; begin += block_size) {
+        auto end = std::min<uint64_t>(begin + block_size, count);
+        futures.emplace_back(thread_pool->GeneralEnqueue([&, begin, end]() {
+            quantizer.EncodeBatch(vectors + begin * dim, codes + begin * code_size_, end - begin);
+        }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
 }
 
 template <typename QuantTmpl, typename IOTmpl>
 std::string
 FlattenDataCell<QuantTmpl, IOTmpl>::GetQuantizerName() {
-    return this->quantizer_->Name();
+    return this->with_current(
+        [](Quantizer<QuantTmpl>& quantizer, BasicIO<IOTmpl>& io) { return quantizer.Name(); });
 }
 
 template <typename QuantTmpl, typename IOTmpl>
 MetricType
 FlattenDataCell<QuantTmpl, IOTmpl>::GetMetricType() {
-    return this->quantizer_->Metric();
+    return this->with_current(
+        [](Quantizer<QuantTmpl>& quantizer, BasicIO<IOTmpl>& io) { return quantizer.Metric(); });
 }
 
 template <typename QuantTmpl, typename IOTmpl>
@@ -215,9 +638,7 @@ FlattenDataCell<QuantTmpl, IOTmpl>::query(float* result_dists,
                                           const float* query_vector,
                                           const InnerIdType* idx,
                                           InnerIdType id_count) {
-    auto computer = quantizer_->FactoryComputer();
-    computer->SetQuery(query_vector);
-    this->Query(result_dists, computer, idx, id_count);
+    this->Query(result_dists, this->factory_computer(query_vector), idx, id_count);
 }
 
 template <typename QuantTmpl, typename IOTmpl>
@@ -226,71 +647,392 @@ FlattenDataCell<QuantTmpl, IOTmpl>::query(float* result_dists,
                                           const std::shared_ptr<Computer<QuantTmpl>>& computer,
                                           const InnerIdType* idx,
                                           InnerIdType id_count) {
+    BasicIO<IOTmpl>* io = nullptr;
+    auto valid_count = std::numeric_limits<InnerIdType>::max();
+    if (computer->owner_ != nullptr) {
+        // the generation the computer was created from, possibly retired since, io_ may be
+        // swapped concurrently
+        const auto* generation = static_cast<const Generation*>(computer->owner_.get());
+        io = generation->io.get();
+        valid_count = generation->valid_count.load();
+    } else {
+        io = this->io_.get();
+    }
+
+    ScratchBuffer buffer(code_size_, ScratchBuffer::READ_FIRST, allocator_);
     for (uint32_t i = 0; i < this->prefetch_jump_code_size_ and i < id_count; i++) {
-        this->io_->Prefetch(static_cast<uint64_t>(idx[i]) * static_cast<uint64_t>(code_size_),
-                            this->prefetch_cache_line_size_);
+        io->Prefetch(this->code_offset(idx[i]), this->prefetch_cache_line_size_);
     }
 
     for (int64_t i = 0; i < id_count; ++i) {
         if (i + this->prefetch_jump_code_size_ < id_count) {
-            this->io_->Prefetch(static_cast<uint64_t>(idx[i + this->prefetch_jump_code_size_]) *
-                                    static_cast<uint64_t>(code_size_),
-                                this->prefetch_cache_line_size_);
+            io->Prefetch(this->code_offset(idx[i + this->prefetch_jump_code_size_]),
+                         this->prefetch_cache_line_size_);
+        }
+        if (idx[i] >= valid_count) {
+            result_dists[i] = std::numeric_limits<float>::max();
+            continue;
         }
 
-        bool release = false;
-        const auto* codes = this->GetCodesById(idx[i], release);
+        const auto* codes =
+            io->ReadOrCopy(code_size_, this->code_offset(idx[i]), buffer.Data());
         computer->ComputeDist(codes, result_dists + i);
-        if (release) {
-            this->io_->Release(codes);
-        }
     }
 }
 
 template <typename QuantTmpl, typename IOTmpl>
 float
 FlattenDataCell<QuantTmpl, IOTmpl>::ComputePairVectors(InnerIdType id1, InnerIdType id2) {
-    bool release1, release2;
-    const auto* codes1 = this->GetCodesById(id1, release1);
-    const auto* codes2 = this->GetCodesById(id2, release2);
-    auto result = this->quantizer_->Compute(codes1, codes2);
-    if (release1) {
-        io_->Release(codes1);
-    }
-    if (release2) {
-        io_->Release(codes2);
-    }
-
-    return result;
+    return this->with_current(
+        [&](Quantizer<QuantTmpl>& quantizer, BasicIO<IOTmpl>& io) {
+            ScratchBuffer buffer1(code_size_, ScratchBuffer::READ_FIRST, allocator_);
+            ScratchBuffer buffer2(code_size_, ScratchBuffer::READ_SECOND, allocator_);
+            const auto* codes1 =
+                io.ReadOrCopy(code_size_, this->code_offset(id1), buffer1.Data());
+            const auto* codes2 =
+                io.ReadOrCopy(code_size_, this->code_offset(id2), buffer2.Data());
+            return quantizer.Compute(codes1, codes2);
+        },
+        std::max(id1, id2));
 }
 
 template <typename QuantTmpl, typename IOTmpl>
 const uint8_t*
 FlattenDataCell<QuantTmpl, IOTmpl>::GetCodesById(InnerIdType id, bool& need_release) const {
-    return io_->Read(
-        code_size_, static_cast<uint64_t>(id) * static_cast<uint64_t>(code_size_), need_release);
+    // codes that can not be read in place go to the thread's own block for this call, or to
+    // a buffer given back by ReleaseCodes if they do not fit
+    auto* buffer = ScratchBuffer::Cached(code_size_, ScratchBuffer::GET_CODES);
+    bool owned = buffer == nullptr;
+    if (owned) {
+        buffer = static_cast<uint8_t*>(allocator_->Allocate(code_size_));
+    }
+    const uint8_t* codes = nullptr;
+    if (this->drift_enabled()) {
+        // the generation may be released after the call, never hand out its memory
+        bool read = this->with_current(
+            [&](Quantizer<QuantTmpl>& quantizer, BasicIO<IOTmpl>& io) {
+                return io.Read(code_size_, this->code_offset(id), buffer);
+            },
+            id);
+        if (read) {
+            codes = buffer;
+        }
+    } else {
+        codes = io_->ReadOrCopy(code_size_, this->code_offset(id), buffer);
+    }
+    need_release = owned and codes == buffer;
+    if (owned and not need_release) {
+        allocator_->Deallocate(buffer);
+    }
+    return codes;
 }
 
 template <typename QuantTmpl, typename IOTmpl>
 bool
 FlattenDataCell<QuantTmpl, IOTmpl>::GetCodesById(InnerIdType id, uint8_t* codes) const {
-    return io_->Read(
-        code_size_, static_cast<uint64_t>(id) * static_cast<uint64_t>(code_size_), codes);
+    return this->with_current(
+        [&](Quantizer<QuantTmpl>& quantizer, BasicIO<IOTmpl>& io) {
+            return io.Read(code_size_, this->code_offset(id), codes);
+        },
+        id);
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+std::shared_ptr<void>
+FlattenDataCell<QuantTmpl, IOTmpl>::PinCodes() const {
+    if (not this->drift_enabled() or thread_pin_count == MAX_THREAD_PINS) {
+        return nullptr;
+    }
+    // the refcount keeps the generation alive, the reader counters are only taken to get it
+    std::shared_ptr<Generation> generation;
+    {
+        GenerationGuard guard(this);
+        generation = guard->shared_from_this();
+    }
+    thread_pins[thread_pin_count++] = {this, generation.get()};
+    return {generation.get(), [this, generation](void*) { unpin(this, generation.get()); }};
 }
 
 template <typename QuantTmpl, typename IOTmpl>
 void
 FlattenDataCell<QuantTmpl, IOTmpl>::Serialize(StreamWriter& writer) {
+    this->WaitForReEncode();
     FlattenInterface::Serialize(writer);
     this->io_->Serialize(writer);
     this->quantizer_->Serialize(writer);
+    if (this->transformer_ != nullptr) {
+        this->transformer_->Serialize(writer);
+    }
 }
 
 template <typename QuantTmpl, typename IOTmpl>
 void
 FlattenDataCell<QuantTmpl, IOTmpl>::Deserialize(StreamReader& reader) {
+    this->WaitForReEncode();
     FlattenInterface::Deserialize(reader);
     this->io_->Deserialize(reader);
     this->quantizer_->Deserialize(reader);
+    if (this->transformer_ != nullptr) {
+        this->transformer_->Deserialize(reader);
+    }
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::WaitForReEncode() {
+    std::future<void> future;
+    {
+        std::lock_guard<std::mutex> lock(this->reencode_future_mutex_);
+        future = std::move(this->reencode_future_);
+    }
+    if (future.valid()) {
+        future.get();
+    }
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::Permute(const Vector<InnerIdType>& new_ids) {
+    this->WaitForReEncode();
+    std::lock_guard<std::mutex> lock(this->write_mutex_);
+    CHECK_ARGUMENT(new_ids.size() == this->total_count_,
+                   fmt::format("permutation size({}) must be equal to count({})",
+                               new_ids.size(),
+                               this->total_count_));
+    // only code_size_ bytes of each id are moved, the rest of a colocated record belongs
+    // to the graph
+    auto code_size = static_cast<uint64_t>(this->code_size_);
+    Vector<uint8_t> codes(this->total_count_ * code_size, this->allocator_);
+    for (InnerIdType id = 0; id < this->total_count_; ++id) {
+        io_->Read(code_size, this->code_offset(id), codes.data() + id * code_size);
+    }
+    for (InnerIdType id = 0; id < this->total_count_; ++id) {
+        io_->Write(codes.data() + id * code_size, code_size, this->code_offset(new_ids[id]));
+    }
+    for (auto& sample_id : this->drift_sample_ids_) {
+        if (sample_id < new_ids.size()) {
+            sample_id = new_ids[sample_id];
+        }
+    }
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+GraphInterfacePtr
+FlattenDataCell<QuantTmpl, IOTmpl>::MakeColocatedGraph(const GraphInterfaceParamPtr& graph_param,
+                                                       const IndexCommonParam& common_param) {
+    auto param = std::dynamic_pointer_cast<GraphDataCellParameter>(graph_param);
+    CHECK_ARGUMENT(param != nullptr and not param->use_compression_,
+                   "colocated graph requires an uncompressed graph data cell");
+    CHECK_ARGUMENT(not this->drift_enabled(), "colocated graph is not supported with drift");
+    CHECK_ARGUMENT(this->total_count_ == 0, "colocated graph must be created on an empty cell");
+
+    auto graph = std::make_shared<GraphDataCell<IOTmpl, false>>(param, common_param);
+    // neighbor lists are 4 bytes aligned, a record is padded to whole cache lines so that
+    // one id never shares a line with the next one
+    constexpr uint64_t cache_line_size = 64;
+    uint64_t graph_offset = (static_cast<uint64_t>(code_size_) + 3) / 4 * 4;
+    uint64_t line_size =
+        static_cast<uint64_t>(param->max_degree_) * sizeof(InnerIdType) + sizeof(uint32_t);
+    this->code_stride_ =
+        (graph_offset + line_size + cache_line_size - 1) / cache_line_size * cache_line_size;
+    graph->SetSharedIO(this->io_, this->code_stride_, graph_offset);
+    return graph;
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::write_pending_codes(const float* vectors,
+                                                        InnerIdType count,
+                                                        InnerIdType first_id) {
+    if (this->pending_io_ == nullptr) {
+        return;
+    }
+    BufferWrapper codes(static_cast<uint64_t>(count) * static_cast<uint64_t>(code_size_),
+                        allocator_);
+    pending_quantizer_->EncodeBatch(vectors, codes.data, count);
+    pending_io_->Write(codes.data,
+                       static_cast<uint64_t>(count) * static_cast<uint64_t>(code_size_),
+                       this->code_offset(first_id));
+
+    // ids not reached by the background task yet must not be overwritten from the old codes
+    for (InnerIdType i = 0; i < count; ++i) {
+        auto id = first_id + i;
+        if (id >= this->reencode_cursor_ and id < this->reencode_snapshot_count_) {
+            this->reencode_written_[id] = 1;
+        }
+    }
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::count_out_of_range(const float* vectors,
+                                                       InnerIdType count,
+                                                       InnerIdType first_id) {
+    auto dim = static_cast<uint64_t>(quantizer_->GetDim());
+    uint64_t out_of_range_count = 0;
+    for (InnerIdType i = 0; i < count; ++i) {
+        const auto* vector = vectors + i * dim;
+        if (not quantizer_->IsOutOfRange(vector)) {
+            continue;
+        }
+        ++out_of_range_count;
+        this->add_drift_sample(vector, first_id + i);
+    }
+    this->drift_checked_count_ += count;
+    this->drift_out_of_range_count_ += out_of_range_count;
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::add_drift_sample(const float* vector, InnerIdType id) {
+    // reservoir sampling, every clipped vector is kept with the same probability
+    auto dim = static_cast<uint64_t>(quantizer_->GetDim());
+    auto seen = this->drift_seen_count_++;
+    uint64_t slot = drift_sample_ids_.size();
+    if (slot == DRIFT_OUT_OF_RANGE_SAMPLE_COUNT) {
+        slot = std::uniform_int_distribution<uint64_t>(0, seen)(this->drift_rng_);
+        if (slot >= DRIFT_OUT_OF_RANGE_SAMPLE_COUNT) {
+            return;
+        }
+        std::copy(vector, vector + dim, drift_samples_.begin() + static_cast<int64_t>(slot * dim));
+        drift_sample_ids_[slot] = id;
+        return;
+    }
+    drift_samples_.insert(drift_samples_.end(), vector, vector + dim);
+    drift_sample_ids_.emplace_back(id);
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::try_trigger_reencode() {
+    auto checked_count = this->drift_checked_count_.load();
+    auto out_of_range_count = this->drift_out_of_range_count_.load();
+    if (checked_count < this->drift_min_count_ or
+        static_cast<double>(out_of_range_count) <=
+            static_cast<double>(this->drift_threshold_) * static_cast<double>(checked_count)) {
+        return;
+    }
+    bool expected = false;
+    if (not this->reencode_running_.compare_exchange_strong(expected, true)) {
+        return;
+    }
+    logger::info(fmt::format("quantizer drift detected: {} of {} vectors out of range, re-encode",
+                             out_of_range_count,
+                             checked_count));
+    if (this->common_param_.thread_pool_ == nullptr) {
+        this->reencode();
+        return;
+    }
+    std::lock_guard<std::mutex> lock(this->reencode_future_mutex_);
+    this->reencode_future_ =
+        this->common_param_.thread_pool_->GeneralEnqueue([this]() { this->reencode(); });
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::reencode() {
+    std::unique_lock<std::mutex> lock(this->write_mutex_);
+    auto old_quantizer = this->quantizer_;
+    auto old_io = this->io_;
+    auto dim = static_cast<uint64_t>(old_quantizer->GetDim());
+
+    // train on decoded current codes plus the raw vectors that were clipped
+    Vector<float> train_datas(this->allocator_);
+    Vector<uint8_t> codes(this->code_size_, this->allocator_);
+    auto sample_count = std::min<uint64_t>(this->total_count_, DRIFT_DECODED_SAMPLE_COUNT);
+    train_datas.resize(sample_count * dim + drift_samples_.size());
+    for (uint64_t i = 0; i < sample_count; ++i) {
+        auto id = i * this->total_count_ / sample_count;
+        old_io->Read(this->code_size_, this->code_offset(id), codes.data());
+        old_quantizer->DecodeOne(codes.data(), train_datas.data() + i * dim);
+    }
+    std::copy(drift_samples_.begin(),
+              drift_samples_.end(),
+              train_datas.begin() + static_cast<int64_t>(sample_count * dim));
+    lock.unlock();
+
+    // the task occupies a pool thread already, train without waiting on the same pool
+    auto common_param = this->common_param_;
+    common_param.thread_pool_ = nullptr;
+    auto new_quantizer = std::make_shared<QuantTmpl>(this->quantization_param_, common_param);
+    new_quantizer->Train(train_datas.data(), train_datas.size() / dim);
+    auto new_io = std::make_shared<IOTmpl>(this->io_param_, common_param);
+
+    // from here on inserts write both generations
+    lock.lock();
+    this->pending_quantizer_ = new_quantizer;
+    this->pending_io_ = new_io;
+    this->reencode_cursor_ = 0;
+    this->reencode_snapshot_count_ = this->total_count_;
+    this->reencode_written_.assign(this->reencode_snapshot_count_, 0);
+    lock.unlock();
+
+    Vector<float> vector(dim, this->allocator_);
+    Vector<uint8_t> new_codes(this->code_size_, this->allocator_);
+    for (InnerIdType begin = 0; begin < this->reencode_snapshot_count_;
+         begin += REENCODE_BATCH_SIZE) {
+        lock.lock();
+        auto end = std::min(begin + REENCODE_BATCH_SIZE, this->reencode_snapshot_count_);
+        for (InnerIdType id = begin; id < end; ++id) {
+            if (this->reencode_written_[id] != 0) {
+                continue;
+            }
+            auto offset = this->code_offset(id);
+            old_io->Read(this->code_size_, offset, codes.data());
+            old_quantizer->DecodeOne(codes.data(), vector.data());
+            new_quantizer->EncodeOne(vector.data(), new_codes.data());
+            new_io->Write(new_codes.data(), this->code_size_, offset);
+        }
+        this->reencode_cursor_ = end;
+        lock.unlock();
+    }
+
+    lock.lock();
+    this->reencode_from_samples();
+    // computers created before the swap keep the old generation alive for the ids it holds
+    auto retired = this->generation_;
+    retired->valid_count.store(this->total_count_);
+    this->quantizer_ = new_quantizer;
+    this->io_ = new_io;
+    this->publish_generation();
+    this->wait_for_readers();
+    retired.reset();
+    this->pending_quantizer_ = nullptr;
+    this->pending_io_ = nullptr;
+    this->reencode_cursor_ = 0;
+    this->reencode_snapshot_count_ = 0;
+    this->reencode_written_.clear();
+    this->reencode_written_.shrink_to_fit();
+    this->drift_checked_count_ = 0;
+    this->drift_out_of_range_count_ = 0;
+    this->reencode_running_ = false;
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::reencode_from_samples() {
+    // vectors clipped by the old generation are encoded again from their raw values
+    auto dim = static_cast<uint64_t>(quantizer_->GetDim());
+    Vector<uint8_t> codes(this->code_size_, this->allocator_);
+    Vector<uint8_t> sample_codes(this->code_size_, this->allocator_);
+    for (uint64_t i = 0; i < drift_sample_ids_.size(); ++i) {
+        auto id = drift_sample_ids_[i];
+        if (id >= this->reencode_snapshot_count_ or this->reencode_written_[id] != 0) {
+            continue;
+        }
+        const auto* sample = drift_samples_.data() + i * dim;
+        auto offset = this->code_offset(id);
+        // skip samples whose slot has been overwritten since they were recorded
+        io_->Read(this->code_size_, offset, codes.data());
+        quantizer_->EncodeOne(sample, sample_codes.data());
+        if (codes != sample_codes) {
+            continue;
+        }
+        pending_quantizer_->EncodeOne(sample, sample_codes.data());
+        pending_io_->Write(sample_codes.data(), this->code_size_, offset);
+    }
+    drift_samples_.clear();
+    drift_sample_ids_.clear();
+    drift_seen_count_ = 0;
 }
 }  // namespace vsag
@@ -33,6 +33,24 @@ FlattenDataCellParameter::FromJson(const JsonType& json) {
         fmt::format("flatten interface parameters must contains {}", QUANTIZATION_PARAMS_KEY));
     this->quantizer_parameter_ =
         QuantizerParameter::GetQuantizerParameterByJson(json[QUANTIZATION_PARAMS_KEY]);
+
+    if (json.contains(TRANSFORM_PARAMS_KEY)) {
+        this->transformer_parameter_ = std::make_shared<TransformerParameter>();
+        this->transformer_parameter_->FromJson(json[TRANSFORM_PARAMS_KEY]);
+    }
+
+    if (json.contains(FLATTEN_DRIFT_THRESHOLD_KEY)) {
+        this->drift_threshold_ = json[FLATTEN_DRIFT_THRESHOLD_KEY];
+        CHECK_ARGUMENT(this->drift_threshold_ >= 0.0F and this->drift_threshold_ <= 1.0F,
+                       fmt::format("{} must be in [0, 1], got {}",
+                                   FLATTEN_DRIFT_THRESHOLD_KEY,
+                                   this->drift_threshold_));
+    }
+    if (json.contains(FLATTEN_DRIFT_MIN_COUNT_KEY)) {
+        this->drift_min_count_ = json[FLATTEN_DRIFT_MIN_COUNT_KEY];
+        CHECK_ARGUMENT(this->drift_min_count_ > 0,
+                       fmt::format("{} must be greater than 0", FLATTEN_DRIFT_MIN_COUNT_KEY));
+    }
 }
 
 JsonType
@@ -40,6 +58,14 @@ FlattenDataCellParameter::ToJson() {
     JsonType json;
     json[IO_PARAMS_KEY] = this->io_parameter_->ToJson();
     json[QUANTIZATION_PARAMS_KEY] = this->quantizer_parameter_->ToJson();
+    if (this->transformer_parameter_ != nullptr) {
+        json[TRANSFORM_PARAMS_KEY] = this->transformer_parameter_->ToJson();
+    }
+    // drift detection is off by default, keep the json of existing configurations unchanged
+    if (this->drift_threshold_ > 0.0F) {
+        json[FLATTEN_DRIFT_THRESHOLD_KEY] = this->drift_threshold_;
+        json[FLATTEN_DRIFT_MIN_COUNT_KEY] = this->drift_min_count_;
+    }
     return json;
 }
 }  // namespace vsag
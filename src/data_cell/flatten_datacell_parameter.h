@@ -18,6 +18,7 @@
 #include "io/io_parameter.h"
 #include "parameter.h"
 #include "quantization/quantizer_parameter.h"
+#include "quantization/transform/transformer_parameter.h"
 namespace vsag {
 
 class FlattenDataCellParameter : public Parameter {
@@ -34,6 +35,16 @@ public:
     QuantizerParamPtr quantizer_parameter_{nullptr};
 
     IOParamPtr io_parameter_{nullptr};
+
+    // optional transform applied before quantization, nullptr keeps the raw vectors
+    TransformerParamPtr transformer_parameter_{nullptr};
+
+    // re-train the quantizer once this fraction of inserted vectors falls outside
+    // the trained value range, 0 disables drift detection
+    float drift_threshold_{0.0F};
+
+    // minimum number of inserted vectors observed before the drift rate is trusted
+    uint64_t drift_min_count_{10000};
 };
 
 using FlattenDataCellParamPtr = std::shared_ptr<FlattenDataCellParameter>;
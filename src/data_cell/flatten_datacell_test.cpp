@@ -16,8 +16,12 @@
 #include "flatten_datacell.h"
 
 #include <algorithm>
+#include <atomic>
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <fstream>
+#include <numeric>
+#include <thread>
 #include <utility>
 
 #include "default_allocator.h"
@@ -73,3 +77,323 @@ TEST_CASE("FlattenDataCell Basic Test", "[ut][FlattenDataCell] ") {
         }
     }
 }
+
+TEST_CASE("FlattenDataCell Transform", "[ut][FlattenDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto dim = GENERATE(32, 100);
+    std::string transform_type = GENERATE("pca", "random_rotation");
+    MetricType metrics[3] = {
+        MetricType::METRIC_TYPE_L2SQR, MetricType::METRIC_TYPE_COSINE, MetricType::METRIC_TYPE_IP};
+    constexpr const char* param_temp =
+        R"(
+        {{
+            "io_params": {{
+                "type": "block_memory_io"
+            }},
+            "quantization_params": {{
+                "type": "fp32"
+            }},
+            "transform_params": {{
+                "type": "{}"
+            }}
+        }}
+        )";
+    // a full dimension orthogonal transform keeps all distances
+    for (auto& metric : metrics) {
+        auto param_json = JsonType::parse(fmt::format(param_temp, transform_type));
+        auto param = std::make_shared<FlattenDataCellParameter>();
+        param->FromJson(param_json);
+        IndexCommonParam common_param;
+        common_param.allocator_ = allocator;
+        common_param.dim_ = dim;
+        common_param.metric_ = metric;
+
+        TestFlattenDataCell(param, common_param, 1e-3);
+    }
+}
+
+TEST_CASE("FlattenDataCell Drift ReEncode", "[ut][FlattenDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 32;
+    uint64_t count = 2000;
+    std::string io_type = GENERATE("memory_io", "block_memory_io");
+    bool use_thread_pool = GENERATE(true, false);
+    constexpr const char* param_temp =
+        R"(
+        {{
+            "io_params": {{
+                "type": "{}"
+            }},
+            "quantization_params": {{
+                "type": "sq8"
+            }},
+            "drift_threshold": {},
+            "drift_min_count": 1000
+        }}
+        )";
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    common_param.dim_ = dim;
+    common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    if (use_thread_pool) {
+        common_param.thread_pool_ = SafeThreadPool::FactoryDefaultThreadPool();
+    }
+
+    auto base = fixtures::generate_vectors(count, dim, false);
+    auto drifted = fixtures::generate_vectors(count, dim, false, 48);
+    for (auto& value : drifted) {
+        value *= 3.0F;
+    }
+
+    auto max_self_distance = [&](float threshold) {
+        auto param = std::make_shared<FlattenDataCellParameter>();
+        param->FromJson(JsonType::parse(fmt::format(param_temp, io_type, threshold)));
+        auto flatten = FlattenInterface::MakeInstance(param, common_param);
+        flatten->Train(base.data(), count);
+        flatten->BatchInsertVector(base.data(), count);
+        for (uint64_t i = 0; i < count; ++i) {
+            flatten->InsertVector(drifted.data() + i * dim);
+        }
+        flatten->WaitForReEncode();
+        REQUIRE(flatten->TotalCount() == count * 2);
+
+        float max_distance = 0.0F;
+        for (uint64_t i = 0; i < count; ++i) {
+            auto computer = flatten->FactoryComputer(drifted.data() + i * dim);
+            InnerIdType id = count + i;
+            float distance = 0.0F;
+            flatten->Query(&distance, computer, &id, 1);
+            max_distance = std::max(max_distance, distance);
+        }
+        return max_distance;
+    };
+
+    auto clipped_distance = max_self_distance(0.0F);
+    auto reencoded_distance = max_self_distance(0.1F);
+    REQUIRE(reencoded_distance < clipped_distance * 0.1F);
+}
+
+TEST_CASE("FlattenDataCell Search During ReEncode", "[ut][FlattenDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 32;
+    uint64_t count = 2000;
+    uint64_t reader_count = 4;
+    auto param = std::make_shared<FlattenDataCellParameter>();
+    param->FromJson(JsonType::parse(R"(
+        {
+            "io_params": {
+                "type": "block_memory_io"
+            },
+            "quantization_params": {
+                "type": "sq8"
+            },
+            "drift_threshold": 0.1,
+            "drift_min_count": 1000
+        }
+        )"));
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    common_param.dim_ = dim;
+    common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    common_param.thread_pool_ = SafeThreadPool::FactoryDefaultThreadPool();
+
+    auto base = fixtures::generate_vectors(count, dim, false);
+    auto drifted = fixtures::generate_vectors(count, dim, false, 48);
+    for (auto& value : drifted) {
+        value *= 3.0F;
+    }
+    auto flatten = FlattenInterface::MakeInstance(param, common_param);
+    flatten->Train(base.data(), count);
+    flatten->BatchInsertVector(base.data(), count);
+
+    // readers only touch the base ids, their codes stay valid across the swap
+    std::atomic<bool> inserting{true};
+    std::atomic<uint64_t> failed_count{0};
+    std::vector<std::thread> readers;
+    for (uint64_t t = 0; t < reader_count; ++t) {
+        readers.emplace_back([&, t]() {
+            std::vector<uint8_t> codes(flatten->CodeStride());
+            uint64_t round = 0;
+            while (inserting.load() or round < count / reader_count) {
+                auto id = static_cast<InnerIdType>((round * reader_count + t) % count);
+                auto other = static_cast<InnerIdType>((id + 1) % count);
+                ++round;
+                auto pin = flatten->PinCodes();
+                auto computer = flatten->FactoryComputer(base.data() + id * dim);
+                flatten->Prefetch(other);
+                float distance = -1.0F;
+                flatten->Query(&distance, computer, &id, 1);
+                float pair_distance = flatten->ComputePairVectors(id, other);
+                bool read = flatten->GetCodesById(id, codes.data());
+                if (not read or distance < 0.0F or distance > 1.0F or pair_distance < 0.0F) {
+                    ++failed_count;
+                }
+            }
+        });
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        flatten->InsertVector(drifted.data() + i * dim);
+    }
+    flatten->WaitForReEncode();
+    inserting.store(false);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    REQUIRE(failed_count.load() == 0);
+    REQUIRE(flatten->TotalCount() == count * 2);
+}
+
+TEST_CASE("FlattenDataCell Parallel BatchInsert", "[ut][FlattenDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 48;
+    uint64_t count = 5000;
+    std::string quantization_type = GENERATE("sq8", "fp32");
+    constexpr const char* param_temp =
+        R"(
+        {{
+            "io_params": {{
+                "type": "block_memory_io"
+            }},
+            "quantization_params": {{
+                "type": "{}"
+            }}
+        }}
+        )";
+    auto param = std::make_shared<FlattenDataCellParameter>();
+    param->FromJson(JsonType::parse(fmt::format(param_temp, quantization_type)));
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    common_param.dim_ = dim;
+    common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    auto serial = FlattenInterface::MakeInstance(param, common_param);
+    common_param.thread_pool_ = SafeThreadPool::FactoryDefaultThreadPool();
+    auto parallel = FlattenInterface::MakeInstance(param, common_param);
+
+    auto vectors = fixtures::generate_vectors(count, dim);
+    std::vector<InnerIdType> idx(count);
+    std::iota(idx.rbegin(), idx.rend(), 0);
+    serial->Train(vectors.data(), count);
+    parallel->Train(vectors.data(), count);
+    serial->BatchInsertVector(vectors.data(), count);
+    parallel->BatchInsertVector(vectors.data(), count);
+    serial->BatchInsertVector(vectors.data(), count, idx.data());
+    parallel->BatchInsertVector(vectors.data(), count, idx.data());
+    REQUIRE(parallel->TotalCount() == count);
+
+    std::vector<uint8_t> serial_codes(serial->code_size_);
+    std::vector<uint8_t> parallel_codes(parallel->code_size_);
+    for (InnerIdType i = 0; i < count; ++i) {
+        REQUIRE(serial->GetCodesById(i, serial_codes.data()));
+        REQUIRE(parallel->GetCodesById(i, parallel_codes.data()));
+        REQUIRE(serial_codes == parallel_codes);
+    }
+}
+
+TEST_CASE("FlattenDataCell Colocated Graph", "[ut][FlattenDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = GENERATE(17, 64);
+    uint32_t max_degree = GENERATE(5, 32);
+    uint64_t count = 1000;
+    std::string io_type = GENERATE("memory_io", "block_memory_io");
+    std::string quantization_type = GENERATE("sq8", "fp32");
+    constexpr const char* param_temp =
+        R"(
+        {{
+            "io_params": {{
+                "type": "{}"
+            }},
+            "quantization_params": {{
+                "type": "{}"
+            }}
+        }}
+        )";
+    constexpr const char* graph_param_temp =
+        R"(
+        {{
+            "io_params": {{
+                "type": "{}"
+            }},
+            "max_degree": {},
+            "init_capacity": 100
+        }}
+        )";
+    auto param = std::make_shared<FlattenDataCellParameter>();
+    param->FromJson(JsonType::parse(fmt::format(param_temp, io_type, quantization_type)));
+    auto graph_param = GraphInterfaceParameter::GetGraphParameterByJson(
+        JsonType::parse(fmt::format(graph_param_temp, io_type, max_degree)));
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    common_param.dim_ = dim;
+    common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+
+    auto plain = FlattenInterface::MakeInstance(param, common_param);
+    auto flatten = FlattenInterface::MakeInstance(param, common_param);
+    auto graph = flatten->MakeColocatedGraph(graph_param, common_param);
+    REQUIRE(graph != nullptr);
+
+    auto vectors = fixtures::generate_vectors(count, dim);
+    plain->Train(vectors.data(), count);
+    flatten->Train(vectors.data(), count);
+    // neighbors written before and after the codes of the same ids must both survive
+    std::vector<Vector<InnerIdType>> neighbors;
+    std::mt19937 rng(47);
+    for (uint64_t i = 0; i < count; ++i) {
+        Vector<InnerIdType> ids(rng() % (max_degree + 1), allocator.get());
+        for (auto& id : ids) {
+            id = rng() % count;
+        }
+        neighbors.emplace_back(std::move(ids));
+    }
+    auto half = count / 2;
+    for (uint64_t i = half; i < count; ++i) {
+        graph->InsertNeighborsById(i, neighbors[i]);
+    }
+    plain->BatchInsertVector(vectors.data(), half);
+    flatten->BatchInsertVector(vectors.data(), half);
+    for (uint64_t i = half; i < count; ++i) {
+        plain->InsertVector(vectors.data() + i * dim);
+        flatten->InsertVector(vectors.data() + i * dim);
+    }
+    for (uint64_t i = 0; i < half; ++i) {
+        graph->InsertNeighborsById(i, neighbors[i]);
+    }
+
+    auto check = [&](const FlattenInterfacePtr& codes, const GraphInterfacePtr& neighbor_graph) {
+        REQUIRE(codes->TotalCount() == count);
+        std::vector<uint8_t> expect_codes(plain->code_size_);
+        std::vector<uint8_t> real_codes(codes->code_size_);
+        Vector<InnerIdType> real_neighbors(allocator.get());
+        for (InnerIdType i = 0; i < count; ++i) {
+            REQUIRE(plain->GetCodesById(i, expect_codes.data()));
+            REQUIRE(codes->GetCodesById(i, real_codes.data()));
+            REQUIRE(expect_codes == real_codes);
+            neighbor_graph->GetNeighbors(i, real_neighbors);
+            REQUIRE(real_neighbors == neighbors[i]);
+        }
+        auto computer = codes->FactoryComputer(vectors.data());
+        std::vector<InnerIdType> idx(count);
+        std::iota(idx.begin(), idx.end(), 0);
+        std::vector<float> expect_dists(count);
+        std::vector<float> real_dists(count);
+        plain->Query(expect_dists.data(), computer, idx.data(), count);
+        codes->Query(real_dists.data(), computer, idx.data(), count);
+        REQUIRE(expect_dists == real_dists);
+    };
+    check(flatten, graph);
+
+    fixtures::TempDir dir("flatten");
+    auto path = dir.GenerateRandomFile();
+    std::ofstream outfile(path.c_str(), std::ios::binary);
+    IOStreamWriter writer(outfile);
+    flatten->Serialize(writer);
+    graph->Serialize(writer);
+    outfile.close();
+
+    auto other = FlattenInterface::MakeInstance(param, common_param);
+    auto other_graph = other->MakeColocatedGraph(graph_param, common_param);
+    std::ifstream infile(path.c_str(), std::ios::binary);
+    IOStreamReader reader(infile);
+    other->Deserialize(reader);
+    other_graph->Deserialize(reader);
+    check(other, other_graph);
+}
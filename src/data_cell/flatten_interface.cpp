@@ -29,8 +29,22 @@ make_instance(const FlattenDataCellParamPtr& param, const IndexCommonParam& comm
     auto& io_param = param->io_parameter_;
     auto& quantizer_param = param->quantizer_parameter_;
 
-    return std::make_shared<FlattenDataCell<QuantTemp, IOTemp>>(
-        quantizer_param, io_param, common_param);
+    if (param->transformer_parameter_ == nullptr) {
+        auto flatten = std::make_shared<FlattenDataCell<QuantTemp, IOTemp>>(
+            quantizer_param, io_param, common_param);
+        flatten->SetDriftDetection(param->drift_threshold_, param->drift_min_count_);
+        return flatten;
+    }
+
+    // the quantizer only sees transformed vectors
+    auto transformer = VectorTransformer::MakeInstance(param->transformer_parameter_, common_param);
+    auto transformed_param = common_param;
+    transformed_param.dim_ = transformer->GetOutputDim();
+    auto flatten = std::make_shared<FlattenDataCell<QuantTemp, IOTemp>>(
+        quantizer_param, io_param, transformed_param);
+    flatten->SetTransformer(transformer);
+    flatten->SetDriftDetection(param->drift_threshold_, param->drift_min_count_);
+    return flatten;
 }
 
 template <MetricType metric, typename IOTemp>
@@ -81,6 +95,9 @@ FlattenInterface::MakeInstance(const FlattenDataCellParamPtr& param,
     if (io_type_name == IO_TYPE_VALUE_MEMORY_IO) {
         return make_instance<MemoryIO>(param, common_param);
     }
+    if (io_type_name == IO_TYPE_VALUE_TIERED_IO) {
+        return make_instance<TieredIO>(param, common_param);
+    }
     return nullptr;
 }
 
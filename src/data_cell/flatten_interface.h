@@ -18,6 +18,7 @@
 #include <string>
 
 #include "flatten_datacell_parameter.h"
+#include "graph_interface.h"
 #include "index/index_common_param.h"
 #include "quantization/computer.h"
 #include "stream_reader.h"
@@ -32,6 +33,8 @@ class FlattenInterface {
 public:
     FlattenInterface() = default;
 
+    virtual ~FlattenInterface() = default;
+
     static FlattenInterfacePtr
     MakeInstance(const FlattenDataCellParamPtr& param, const IndexCommonParam& common_param);
 
@@ -61,6 +64,13 @@ public:
     virtual void
     Prefetch(InnerIdType id) = 0;
 
+    /**
+     * @brief Moves the codes of every id to new_ids[id], new_ids is a permutation of
+     * [0, TotalCount()).
+     */
+    virtual void
+    Permute(const Vector<InnerIdType>& new_ids) = 0;
+
     [[nodiscard]] virtual std::string
     GetQuantizerName() = 0;
 
@@ -73,16 +83,34 @@ public:
         this->max_capacity_ = capacity;
     };
 
+    // the returned codes may live in a per-thread buffer that is valid until the next call on
+    // the same thread, codes returned with need_release must be given back by ReleaseCodes
     [[nodiscard]] virtual const uint8_t*
     GetCodesById(InnerIdType id, bool& need_release) const {
         return nullptr;
     }
 
+    virtual void
+    ReleaseCodes(const uint8_t* codes) const {
+    }
+
     virtual bool
     GetCodesById(InnerIdType id, uint8_t* codes) const {
         return false;
     }
 
+    /**
+     * @brief Keeps the codes read by the calling thread valid until the returned pin is dropped.
+     *
+     * Prefetch, ComputePairVectors and GetCodesById called under a pin reuse it instead of
+     * pinning the codes per call, a query or a batch of build steps takes one. The pin must be
+     * dropped on the thread that took it, nullptr if the cell needs no pin.
+     */
+    [[nodiscard]] virtual std::shared_ptr<void>
+    PinCodes() const {
+        return nullptr;
+    }
+
     [[nodiscard]] virtual InnerIdType
     TotalCount() const {
         return this->total_count_;
@@ -102,6 +130,39 @@ public:
         StreamReader::ReadObj(reader, this->code_size_);
     }
 
+    virtual void
+    WaitForReEncode() {
+    }
+
+    /**
+     * @brief Returns the bytes of code storage that are backed by hugepages.
+     */
+    [[nodiscard]] virtual uint64_t
+    HugePageMemory() const {
+        return 0;
+    }
+
+    /**
+     * @brief Creates a graph whose neighbor lists are stored next to the codes of each id.
+     *
+     * Must be called before any vector is inserted, the codes and the neighbors then share
+     * one io, serialized by this cell. Returns nullptr if the cell does not support it.
+     */
+    virtual GraphInterfacePtr
+    MakeColocatedGraph(const GraphInterfaceParamPtr& graph_param,
+                       const IndexCommonParam& common_param) {
+        return nullptr;
+    }
+
+    /**
+     * @brief Returns the bytes stored per id, the codes plus the neighbor list of a
+     * colocated graph.
+     */
+    [[nodiscard]] virtual uint64_t
+    CodeStride() const {
+        return this->code_size_;
+    }
+
 public:
     InnerIdType total_count_{0};
     InnerIdType max_capacity_{1000000};
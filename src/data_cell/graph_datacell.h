@@ -58,9 +58,23 @@ public:
     void
     GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const override;
 
+    [[nodiscard]] const InnerIdType*
+    GetNeighborsPtr(InnerIdType id, uint32_t& neighbor_count, bool& need_release) const override;
+
+    void
+    ReleaseNeighbors(const InnerIdType* neighbors) const override {
+        this->io_->Release(reinterpret_cast<const uint8_t*>(neighbors));
+    }
+
     void
     Resize(InnerIdType new_size) override;
 
+    [[nodiscard]] uint64_t
+    HugePageMemory() const override {
+        // a shared io is reported by the data cell that owns it
+        return this->owns_io_ ? this->io_->HugePageMemory() : 0;
+    }
+
     inline void
     SetIO(std::shared_ptr<BasicIO<IOTmpl>> io) {
         this->io_ = io;
@@ -73,8 +87,21 @@ public:
      */
     void
     Prefetch(InnerIdType id, uint32_t neighbor_i) override {
-        io_->Prefetch(static_cast<uint64_t>(id) * static_cast<uint64_t>(this->code_line_size_) +
-                      sizeof(uint32_t) + neighbor_i * sizeof(InnerIdType));
+        io_->Prefetch(this->line_start(id) + sizeof(uint32_t) + neighbor_i * sizeof(InnerIdType));
+    }
+
+    /**
+     * @brief Stores the neighbor lists inside records of an io owned by another data cell.
+     *
+     * The neighbors of id start at id * record_size + record_offset, the io is neither
+     * serialized nor deserialized by this cell.
+     */
+    inline void
+    SetSharedIO(std::shared_ptr<BasicIO<IOTmpl>> io, uint64_t record_size, uint64_t record_offset) {
+        this->io_ = io;
+        this->record_size_ = record_size;
+        this->record_offset_ = record_offset;
+        this->owns_io_ = false;
     }
 
     void
@@ -83,10 +110,21 @@ public:
     void
     Deserialize(StreamReader& reader) override;
 
+private:
+    [[nodiscard]] inline uint64_t
+    line_start(InnerIdType id) const {
+        return static_cast<uint64_t>(id) * this->record_size_ + this->record_offset_;
+    }
+
 private:
     std::shared_ptr<BasicIO<IOTmpl>> io_{nullptr};
 
     uint32_t code_line_size_{0};
+
+    // layout of the records in io_, equal to one line each unless the io is shared
+    uint64_t record_size_{0};
+    uint64_t record_offset_{0};
+    bool owns_io_{true};
 };
 
 template <typename IOTmpl>
@@ -96,6 +134,7 @@ GraphDataCell<IOTmpl, false>::GraphDataCell(const GraphDataCellParamPtr& param,
     this->maximum_degree_ = param->max_degree_;
     this->max_capacity_ = param->init_max_capacity_;
     this->code_line_size_ = this->maximum_degree_ * sizeof(InnerIdType) + sizeof(uint32_t);
+    this->record_size_ = this->code_line_size_;
 }
 
 template <typename IOTmpl>
@@ -114,7 +153,7 @@ GraphDataCell<IOTmpl, false>::InsertNeighborsById(InnerIdType id,
             "insert neighbors count {} more than {}", neighbor_ids.size(), this->maximum_degree_));
     }
     this->max_capacity_ = std::max(this->max_capacity_, id + 1);
-    auto start = static_cast<uint64_t>(id) * static_cast<uint64_t>(this->code_line_size_);
+    auto start = this->line_start(id);
     uint32_t neighbor_count = std::min((uint32_t)(neighbor_ids.size()), this->maximum_degree_);
     this->io_->Write((uint8_t*)(&neighbor_count), sizeof(neighbor_count), start);
     start += sizeof(neighbor_count);
@@ -126,7 +165,7 @@ GraphDataCell<IOTmpl, false>::InsertNeighborsById(InnerIdType id,
 template <typename IOTmpl>
 uint32_t
 GraphDataCell<IOTmpl, false>::GetNeighborSize(InnerIdType id) const {
-    auto start = static_cast<uint64_t>(id) * static_cast<uint64_t>(this->code_line_size_);
+    auto start = this->line_start(id);
     uint32_t result = 0;
     this->io_->Read(sizeof(result), start, (uint8_t*)(&result));
     return result;
@@ -136,7 +175,7 @@ template <typename IOTmpl>
 void
 GraphDataCell<IOTmpl, false>::GetNeighbors(InnerIdType id,
                                            Vector<InnerIdType>& neighbor_ids) const {
-    auto start = static_cast<uint64_t>(id) * static_cast<uint64_t>(this->code_line_size_);
+    auto start = this->line_start(id);
     uint32_t neighbor_count = 0;
     this->io_->Read(sizeof(neighbor_count), start, (uint8_t*)(&neighbor_count));
     neighbor_ids.resize(neighbor_count);
@@ -145,6 +184,19 @@ GraphDataCell<IOTmpl, false>::GetNeighbors(InnerIdType id,
         neighbor_ids.size() * sizeof(InnerIdType), start, (uint8_t*)(neighbor_ids.data()));
 }
 
+template <typename IOTmpl>
+const InnerIdType*
+GraphDataCell<IOTmpl, false>::GetNeighborsPtr(InnerIdType id,
+                                              uint32_t& neighbor_count,
+                                              bool& need_release) const {
+    auto start = this->line_start(id);
+    neighbor_count = 0;
+    this->io_->Read(sizeof(neighbor_count), start, (uint8_t*)(&neighbor_count));
+    start += sizeof(neighbor_count);
+    return reinterpret_cast<const InnerIdType*>(this->io_->Read(
+        static_cast<uint64_t>(neighbor_count) * sizeof(InnerIdType), start, need_release));
+}
+
 template <typename IOTmpl>
 void
 GraphDataCell<IOTmpl, false>::Resize(InnerIdType new_size) {
@@ -152,7 +204,7 @@ GraphDataCell<IOTmpl, false>::Resize(InnerIdType new_size) {
         return;
     }
     this->max_capacity_ = new_size;
-    uint64_t io_size = new_size * code_line_size_;
+    uint64_t io_size = static_cast<uint64_t>(new_size) * this->record_size_;
     uint8_t end_flag =
         127;  // the value is meaningless, only to occupy the position for io allocate
     this->io_->Write(&end_flag, 1, io_size);
@@ -162,7 +214,9 @@ template <typename IOTmpl>
 void
 GraphDataCell<IOTmpl, false>::Serialize(StreamWriter& writer) {
     GraphInterface::Serialize(writer);
-    this->io_->Serialize(writer);
+    if (this->owns_io_) {
+        this->io_->Serialize(writer);
+    }
     StreamWriter::WriteObj(writer, this->code_line_size_);
 }
 
@@ -170,8 +224,13 @@ template <typename IOTmpl>
 void
 GraphDataCell<IOTmpl, false>::Deserialize(StreamReader& reader) {
     GraphInterface::Deserialize(reader);
-    this->io_->Deserialize(reader);
+    if (this->owns_io_) {
+        this->io_->Deserialize(reader);
+    }
     StreamReader::ReadObj(reader, this->code_line_size_);
+    if (this->owns_io_) {
+        this->record_size_ = this->code_line_size_;
+    }
 }
 
 }  // namespace vsag
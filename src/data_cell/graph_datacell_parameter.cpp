@@ -31,6 +31,9 @@ GraphDataCellParameter::FromJson(const JsonType& json) {
     if (json.contains(GRAPH_PARAM_INIT_MAX_CAPACITY)) {
         this->init_max_capacity_ = json[GRAPH_PARAM_INIT_MAX_CAPACITY];
     }
+    if (json.contains(GRAPH_PARAM_USE_COMPRESSION)) {
+        this->use_compression_ = json[GRAPH_PARAM_USE_COMPRESSION];
+    }
 }
 JsonType
 GraphDataCellParameter::ToJson() {
@@ -38,6 +41,9 @@ GraphDataCellParameter::ToJson() {
     json[IO_PARAMS_KEY] = this->io_parameter_->ToJson();
     json[GRAPH_PARAM_MAX_DEGREE] = this->max_degree_;
     json[GRAPH_PARAM_INIT_MAX_CAPACITY] = this->init_max_capacity_;
+    if (this->use_compression_) {
+        json[GRAPH_PARAM_USE_COMPRESSION] = true;
+    }
     return json;
 }
 
@@ -35,6 +35,9 @@ public:
     uint64_t max_degree_{64};
 
     uint64_t init_max_capacity_{100};
+
+    // store neighbor lists delta-encoded, io_parameter_ is unused then
+    bool use_compression_{false};
 };
 
 using GraphDataCellParamPtr = std::shared_ptr<GraphDataCellParameter>;
@@ -57,5 +57,38 @@ TEST_CASE("GraphDataCell Basic Test", "[ut][GraphDataCell]") {
     auto param_str = fmt::format(graph_param_temp, io_type, max_degree, max_capacity);
     auto param_json = JsonType::parse(param_str);
     auto graph_param = GraphInterfaceParameter::GetGraphParameterByJson(param_json);
+    REQUIRE(not graph_param->ToJson().contains("use_compression"));
     TestGraphDataCell(graph_param, common_param);
 }
+
+TEST_CASE("GraphDataCell Compressed Test", "[ut][GraphDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto max_degree = GENERATE(5, 32, 64, 128);
+    auto max_capacity = GENERATE(100, 10000);
+    constexpr const char* graph_param_temp =
+        R"(
+        {{
+            "io_params": {{
+                "type": "block_memory_io"
+            }},
+            "max_degree": {},
+            "init_capacity": {},
+            "use_compression": true
+        }}
+        )";
+
+    IndexCommonParam common_param;
+    common_param.dim_ = 32;
+    common_param.allocator_ = allocator;
+    auto param_str = fmt::format(graph_param_temp, max_degree, max_capacity);
+    auto param_json = JsonType::parse(param_str);
+    auto graph_param = GraphInterfaceParameter::GetGraphParameterByJson(param_json);
+    REQUIRE(graph_param->ToJson()["use_compression"] == true);
+
+    auto count = GENERATE(1000, 2000);
+    auto max_id = 10000;
+    auto graph = GraphInterface::MakeInstance(graph_param, common_param);
+    GraphInterfaceTest test(graph, true);
+    auto other = GraphInterface::MakeInstance(graph_param, common_param);
+    test.BasicTest(max_id, count, other);
+}
@@ -15,6 +15,7 @@
 
 #include "graph_interface.h"
 
+#include "compressed_graph_datacell.h"
 #include "graph_datacell.h"
 #include "io/io_headers.h"
 #include "sparse_graph_datacell.h"
@@ -29,8 +30,12 @@ GraphInterface::MakeInstance(const GraphInterfaceParamPtr& param,
         return std::make_shared<SparseGraphDataCell>(param, common_param);
     }
 
-    auto io_string =
-        std::dynamic_pointer_cast<GraphDataCellParameter>(param)->io_parameter_->GetTypeName();
+    auto graph_param = std::dynamic_pointer_cast<GraphDataCellParameter>(param);
+    if (graph_param->use_compression_) {
+        return std::make_shared<CompressedGraphDataCell>(param, common_param);
+    }
+
+    auto io_string = graph_param->io_parameter_->GetTypeName();
 
     if (io_string == IO_TYPE_VALUE_BLOCK_MEMORY_IO) {
         return std::make_shared<GraphDataCell<MemoryBlockIO, false>>(param, common_param);
@@ -42,4 +47,26 @@ GraphInterface::MakeInstance(const GraphInterfaceParamPtr& param,
 
     return nullptr;
 }
+
+void
+GraphInterface::Permute(const Vector<InnerIdType>& new_ids) {
+    auto count = static_cast<InnerIdType>(new_ids.size());
+    // snapshot all lists first, a list may be written to the place of one not read yet
+    Vector<uint64_t> offsets(static_cast<uint64_t>(count) + 1, 0, new_ids.get_allocator());
+    Vector<InnerIdType> lists(new_ids.get_allocator());
+    Vector<InnerIdType> neighbors(new_ids.get_allocator());
+    for (InnerIdType id = 0; id < count; ++id) {
+        neighbors.clear();
+        this->GetNeighbors(id, neighbors);
+        for (auto neighbor : neighbors) {
+            lists.emplace_back(neighbor < count ? new_ids[neighbor] : neighbor);
+        }
+        offsets[id + 1] = lists.size();
+    }
+    for (InnerIdType id = 0; id < count; ++id) {
+        neighbors.assign(lists.begin() + offsets[id], lists.begin() + offsets[id + 1]);
+        this->InsertNeighborsById(new_ids[id], neighbors);
+    }
+}
+
 }  // namespace vsag
@@ -54,12 +54,33 @@ public:
     virtual void
     GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const = 0;
 
+    /**
+     * @brief Returns the neighbors of id without copying them when the storage allows it.
+     *
+     * @param neighbor_count set to the number of ids the result points to
+     * @param need_release set to true if the result must be given back by ReleaseNeighbors
+     */
+    [[nodiscard]] virtual const InnerIdType*
+    GetNeighborsPtr(InnerIdType id, uint32_t& neighbor_count, bool& need_release) const = 0;
+
+    virtual void
+    ReleaseNeighbors(const InnerIdType* neighbors) const {
+    }
+
     virtual void
     Resize(InnerIdType new_size) = 0;
 
     virtual void
     Prefetch(InnerIdType id, uint32_t neighbor_i) = 0;
 
+    /**
+     * @brief Renumbers the ids stored in the graph, both the lists and their contents.
+     *
+     * @param new_ids new_ids[old_id] is the new id, a permutation of [0, new_ids.size())
+     */
+    virtual void
+    Permute(const Vector<InnerIdType>& new_ids);
+
 public:
     virtual void
     Serialize(StreamWriter& writer) {
@@ -119,6 +140,22 @@ public:
         this->max_capacity_ = std::max(capacity, this->total_count_);
     };
 
+    /**
+     * @brief Returns the bytes of neighbor storage that are backed by hugepages.
+     */
+    [[nodiscard]] virtual uint64_t
+    HugePageMemory() const {
+        return 0;
+    }
+
+    /**
+     * @brief Returns the bytes held by the neighbor storage, 0 if the cell does not track them.
+     */
+    [[nodiscard]] virtual uint64_t
+    GetMemoryUsage() const {
+        return 0;
+    }
+
 public:
     InnerIdType total_count_{0};
 
@@ -43,6 +43,9 @@ GraphInterfaceTest::BasicTest(uint64_t max_id, uint64_t count, const GraphInterf
     for (auto& [key, value] : maps) {
         this->graph_->InsertNeighborsById(key, *value);
         this->graph_->IncreaseTotalCount(1);
+        if (this->sorted_neighbors_) {
+            std::sort(value->begin(), value->end());
+        }
     }
 
     // Test GetNeighborSize
@@ -62,6 +65,20 @@ GraphInterfaceTest::BasicTest(uint64_t max_id, uint64_t count, const GraphInterf
         }
     }
 
+    SECTION("Test GetNeighborsPtr") {
+        for (auto& [key, value] : maps) {
+            uint32_t neighbor_count = 0;
+            bool need_release = false;
+            const auto* neighbors =
+                this->graph_->GetNeighborsPtr(key, neighbor_count, need_release);
+            REQUIRE(neighbor_count == value->size());
+            REQUIRE(memcmp(neighbors, value->data(), value->size() * sizeof(InnerIdType)) == 0);
+            if (need_release) {
+                this->graph_->ReleaseNeighbors(neighbors);
+            }
+        }
+    }
+
     // Test Others
     SECTION("Test Others") {
         REQUIRE(this->graph_->TotalCount() == old_count + maps.size());
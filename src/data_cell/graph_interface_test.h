@@ -23,12 +23,16 @@
 namespace vsag {
 class GraphInterfaceTest {
 public:
-    explicit GraphInterfaceTest(GraphInterfacePtr graph) : graph_(std::move(graph)){};
+    explicit GraphInterfaceTest(GraphInterfacePtr graph, bool sorted_neighbors = false)
+        : graph_(std::move(graph)), sorted_neighbors_(sorted_neighbors){};
 
     void
     BasicTest(uint64_t max_id, uint64_t count, const GraphInterfacePtr& other);
 
 public:
     GraphInterfacePtr graph_{nullptr};
+
+    // the graph returns neighbors in ascending order instead of insertion order
+    bool sorted_neighbors_{false};
 };
 }  // namespace vsag
@@ -15,13 +15,19 @@
 
 #include "sparse_graph_datacell.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "graph_datacell_parameter.h"
+#include "utils/scratch_buffer.h"
 
 namespace vsag {
 
 SparseGraphDataCell::SparseGraphDataCell(Allocator* allocator, uint32_t max_degree)
-    : allocator_(allocator), neighbors_(allocator_) {
+    : allocator_(allocator), shards_(allocator) {
     this->maximum_degree_ = max_degree;
+    this->line_size_ = static_cast<uint64_t>(max_degree) + 1;
+    this->init_shards();
 }
 
 SparseGraphDataCell::SparseGraphDataCell(const GraphInterfaceParamPtr& param,
@@ -31,65 +37,337 @@ SparseGraphDataCell::SparseGraphDataCell(const GraphInterfaceParamPtr& param,
           std::dynamic_pointer_cast<GraphDataCellParameter>(param)->max_degree_ / 2) {
 }
 
+SparseGraphDataCell::~SparseGraphDataCell() {
+    this->release_shards();
+    this->replace_frozen(nullptr, false);
+}
+
+void
+SparseGraphDataCell::init_shards() {
+    this->release_shards();
+    for (uint64_t i = 0; i < SHARD_COUNT; ++i) {
+        this->shards_.emplace_back(this->allocator_->New<Shard>(this->allocator_));
+    }
+}
+
+void
+SparseGraphDataCell::release_shards() {
+    for (auto* shard : this->shards_) {
+        this->allocator_->Delete(shard);
+    }
+    this->shards_.clear();
+}
+
 void
 SparseGraphDataCell::InsertNeighborsById(InnerIdType id, const Vector<InnerIdType>& neighbor_ids) {
     if (neighbor_ids.size() > this->maximum_degree_) {
         logger::warn(fmt::format(
             "insert neighbors count {} more than {}", neighbor_ids.size(), this->maximum_degree_));
     }
-    auto size = std::min(this->maximum_degree_, (uint32_t)(neighbor_ids.size()));
-    std::unique_lock<std::shared_mutex> wlock(this->neighbors_map_mutex_);
-    this->max_capacity_ = std::max(this->max_capacity_, id + 1);
-    if (this->neighbors_.count(id) == 0) {
-        this->neighbors_.emplace(id, std::make_unique<Vector<InnerIdType>>(allocator_));
+    auto size = std::min<uint64_t>(
+        std::min(this->maximum_degree_, (uint32_t)(neighbor_ids.size())), this->line_size_ - 1);
+    {
+        std::lock_guard<std::mutex> lock(this->global_);
+        this->max_capacity_ = std::max(this->max_capacity_, id + 1);
+    }
+
+    auto& shard = this->get_shard(id);
+    std::unique_lock<std::shared_mutex> wlock(shard.mutex);
+    auto iter = shard.lines.find(id);
+    if (iter == shard.lines.end()) {
+        iter = shard.lines.emplace(id, std::make_unique<Vector<InnerIdType>>(allocator_)).first;
+        iter->second->resize(this->line_size_, 0);
+    }
+    auto* line = iter->second->data();
+    std::copy(neighbor_ids.begin(), neighbor_ids.begin() + size, line + 1);
+    line[0] = size;
+
+    // the frozen line stays intact for the readers holding it, new readers go to the shard
+    auto* table = this->frozen_.load();
+    auto bucket = find_frozen_bucket(table, id);
+    bool compact = false;
+    if (bucket != EMPTY_BUCKET) {
+        auto offset = table->offsets[bucket].exchange(RETIRED_LINE, std::memory_order_acq_rel);
+        if (offset != RETIRED_LINE) {
+            auto line_size = table->lines[offset] + 1;
+            auto retired_size = table->retired_size.fetch_add(line_size) + line_size;
+            compact = table->lines.size() >= COMPACT_MIN_SIZE and
+                      retired_size * 2 > table->lines.size();
+        }
+    }
+    wlock.unlock();
+    if (compact) {
+        this->compact_frozen();
     }
-    this->neighbors_[id]->assign(neighbor_ids.begin(), neighbor_ids.begin() + size);
+}
+
+template <typename Func>
+void
+SparseGraphDataCell::with_line(InnerIdType id, Func&& func) const {
+    {
+        FrozenGuard guard(this);
+        const auto* line = find_frozen_line(guard.get(), id);
+        if (line != nullptr) {
+            func(line);
+            return;
+        }
+    }
+    auto& shard = this->get_shard(id);
+    std::shared_lock<std::shared_mutex> rlock(shard.mutex);
+    auto iter = shard.lines.find(id);
+    func(iter == shard.lines.end() ? nullptr : iter->second->data());
 }
 
 uint32_t
 SparseGraphDataCell::GetNeighborSize(InnerIdType id) const {
-    std::shared_lock<std::shared_mutex> rlock(this->neighbors_map_mutex_);
-    auto iter = this->neighbors_.find(id);
-    if (iter != this->neighbors_.end()) {
-        return iter->second->size();
-    }
-    return 0;
+    uint32_t size = 0;
+    this->with_line(id, [&size](const InnerIdType* line) {
+        if (line != nullptr) {
+            size = line[0];
+        }
+    });
+    return size;
 }
+
 void
 SparseGraphDataCell::GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const {
-    std::shared_lock<std::shared_mutex> rlock(this->neighbors_map_mutex_);
-    auto iter = this->neighbors_.find(id);
-    if (iter != this->neighbors_.end()) {
-        neighbor_ids.assign(iter->second->begin(), iter->second->end());
+    this->with_line(id, [&neighbor_ids](const InnerIdType* line) {
+        if (line != nullptr) {
+            neighbor_ids.assign(line + 1, line + 1 + line[0]);
+        }
+    });
+}
+
+const InnerIdType*
+SparseGraphDataCell::GetNeighborsPtr(InnerIdType id,
+                                     uint32_t& neighbor_count,
+                                     bool& need_release) const {
+    InnerIdType* neighbors = nullptr;
+    // the line may be released once the reader leaves it, hand out a copy
+    this->with_line(id, [&](const InnerIdType* line) {
+        neighbor_count = line == nullptr ? 0 : line[0];
+        auto size = std::max<uint64_t>(neighbor_count, 1) * sizeof(InnerIdType);
+        neighbors =
+            reinterpret_cast<InnerIdType*>(ScratchBuffer::Cached(size, ScratchBuffer::NEIGHBORS));
+        need_release = neighbors == nullptr;
+        if (need_release) {
+            neighbors = reinterpret_cast<InnerIdType*>(this->allocator_->Allocate(size));
+        }
+        if (neighbor_count > 0) {
+            std::copy(line + 1, line + 1 + neighbor_count, neighbors);
+        }
+    });
+    return neighbors;
+}
+
+uint64_t
+SparseGraphDataCell::find_frozen_bucket(const FrozenTable* table, InnerIdType id) {
+    if (table == nullptr or table->keys.empty()) {
+        return EMPTY_BUCKET;
+    }
+    auto mask = table->keys.size() - 1;
+    for (auto bucket = frozen_bucket(id, table->shift);; bucket = (bucket + 1) & mask) {
+        auto key = table->keys[bucket];
+        if (key == id) {
+            return bucket;
+        }
+        if (key == EMPTY_KEY) {
+            return EMPTY_BUCKET;
+        }
     }
 }
+
+const InnerIdType*
+SparseGraphDataCell::find_frozen_line(const FrozenTable* table, InnerIdType id) {
+    auto bucket = find_frozen_bucket(table, id);
+    if (bucket == EMPTY_BUCKET) {
+        return nullptr;
+    }
+    auto offset = table->offsets[bucket].load(std::memory_order_acquire);
+    return offset == RETIRED_LINE ? nullptr : table->lines.data() + offset;
+}
+
+template <typename Func>
+void
+SparseGraphDataCell::for_each_frozen_line(const FrozenTable* table, Func&& func) {
+    if (table == nullptr) {
+        return;
+    }
+    for (uint64_t bucket = 0; bucket < table->keys.size(); ++bucket) {
+        auto offset = table->offsets[bucket].load(std::memory_order_acquire);
+        if (table->keys[bucket] != EMPTY_KEY && offset != RETIRED_LINE) {
+            func(table->keys[bucket], table->lines.data() + offset);
+        }
+    }
+}
+
+template <typename Func>
+void
+SparseGraphDataCell::for_each_line(Func&& func) const {
+    {
+        FrozenGuard guard(this);
+        for_each_frozen_line(guard.get(), func);
+    }
+    for (const auto* shard : this->shards_) {
+        std::shared_lock<std::shared_mutex> rlock(shard->mutex);
+        for (const auto& [id, line] : shard->lines) {
+            func(id, line->data());
+        }
+    }
+}
+
+template <typename ForEach>
+SparseGraphDataCell::FrozenTable*
+SparseGraphDataCell::pack_lines(ForEach&& for_each) const {
+    uint64_t count = 0;
+    uint64_t line_total = 0;
+    for_each([&](InnerIdType id, const InnerIdType* line) {
+        ++count;
+        line_total += line[0] + 1;
+    });
+
+    // keep the load factor at most 1/2, the lines are packed without padding
+    uint64_t bucket_bits = 1;
+    while ((1ULL << bucket_bits) < count * 2) {
+        ++bucket_bits;
+    }
+    auto* table = this->allocator_->New<FrozenTable>(this->allocator_);
+    table->keys.resize(1ULL << bucket_bits, EMPTY_KEY);
+    Vector<std::atomic<uint64_t>>(table->keys.size(), this->allocator_).swap(table->offsets);
+    table->lines.resize(line_total);
+    table->shift = 64 - bucket_bits;
+    auto mask = table->keys.size() - 1;
+    uint64_t offset = 0;
+    for_each([&](InnerIdType id, const InnerIdType* line) {
+        auto bucket = frozen_bucket(id, table->shift);
+        while (table->keys[bucket] != EMPTY_KEY) {
+            bucket = (bucket + 1) & mask;
+        }
+        table->keys[bucket] = id;
+        table->offsets[bucket].store(offset, std::memory_order_relaxed);
+        std::copy(line, line + line[0] + 1, table->lines.data() + offset);
+        offset += line[0] + 1;
+    });
+    return table;
+}
+
+void
+SparseGraphDataCell::replace_frozen(FrozenTable* table, bool wait_readers) {
+    auto* old_table = this->frozen_.exchange(table);
+    if (old_table == nullptr) {
+        return;
+    }
+    if (wait_readers) {
+        // two flips, a reader that read the epoch before the first one may register late
+        for (int i = 0; i < 2; ++i) {
+            auto epoch = this->epoch_.fetch_add(1);
+            while (this->active_readers_[epoch & 1].load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    this->allocator_->Delete(old_table);
+}
+
+void
+SparseGraphDataCell::compact_frozen() {
+    // a retired line moves to the shards first, so readers that miss the frozen line still
+    // find it; no line is retired while every shard is locked
+    Vector<std::unique_lock<std::shared_mutex>> locks(this->allocator_);
+    for (auto* shard : this->shards_) {
+        locks.emplace_back(shard->mutex);
+    }
+    const auto* table = this->frozen_.load();
+    if (table == nullptr or table->retired_size.load() * 2 <= table->lines.size()) {
+        return;
+    }
+    auto* packed = this->pack_lines(
+        [table](auto&& func) { for_each_frozen_line(table, std::forward<decltype(func)>(func)); });
+    this->replace_frozen(packed, true);
+}
+
+void
+SparseGraphDataCell::Freeze() {
+    bool changed = false;
+    for (const auto* shard : this->shards_) {
+        changed = changed or not shard->lines.empty();
+    }
+    if (not changed) {
+        return;
+    }
+    auto* table = this->pack_lines(
+        [this](auto&& func) { this->for_each_line(std::forward<decltype(func)>(func)); });
+    for (auto* shard : this->shards_) {
+        shard->lines.clear();
+    }
+    this->replace_frozen(table, false);
+}
+
+void
+SparseGraphDataCell::Permute(const Vector<InnerIdType>& new_ids) {
+    auto count = static_cast<InnerIdType>(new_ids.size());
+    auto rename = [&](InnerIdType id) { return id < count ? new_ids[id] : id; };
+    bool frozen = this->frozen_.load() != nullptr;
+    // only the ids present are moved, rebuild the cell from its lines
+    Vector<InnerIdType> keys(this->allocator_);
+    Vector<InnerIdType> lines(this->allocator_);
+    this->for_each_line([&](InnerIdType key, const InnerIdType* line) {
+        keys.emplace_back(rename(key));
+        lines.emplace_back(line[0]);
+        for (InnerIdType i = 1; i <= line[0]; ++i) {
+            lines.emplace_back(rename(line[i]));
+        }
+    });
+
+    this->replace_frozen(nullptr, false);
+    this->init_shards();
+    Vector<InnerIdType> neighbors(this->allocator_);
+    const auto* line = lines.data();
+    for (auto key : keys) {
+        neighbors.assign(line + 1, line + 1 + line[0]);
+        this->InsertNeighborsById(key, neighbors);
+        line += line[0] + 1;
+    }
+    if (frozen) {
+        this->Freeze();
+    }
+}
+
 void
 SparseGraphDataCell::Serialize(StreamWriter& writer) {
     GraphInterface::Serialize(writer);
     StreamWriter::WriteObj(writer, this->code_line_size_);
-    auto size = this->neighbors_.size();
+    uint64_t size = 0;
+    this->for_each_line([&size](InnerIdType key, const InnerIdType* line) { ++size; });
     StreamWriter::WriteObj(writer, size);
-    for (auto& pair : this->neighbors_) {
-        auto key = pair.first;
+    Vector<InnerIdType> neighbors(this->allocator_);
+    this->for_each_line([&](InnerIdType key, const InnerIdType* line) {
         StreamWriter::WriteObj(writer, key);
-        StreamWriter::WriteVector(writer, *(pair.second));
-    }
+        neighbors.assign(line + 1, line + 1 + line[0]);
+        StreamWriter::WriteVector(writer, neighbors);
+    });
 }
 
 void
 SparseGraphDataCell::Deserialize(StreamReader& reader) {
     GraphInterface::Deserialize(reader);
     StreamReader::ReadObj(reader, this->code_line_size_);
+    this->line_size_ = static_cast<uint64_t>(this->maximum_degree_) + 1;
+    this->replace_frozen(nullptr, false);
+    this->init_shards();
     uint64_t size;
     StreamReader::ReadObj(reader, size);
+    Vector<InnerIdType> neighbors(this->allocator_);
     for (uint64_t i = 0; i < size; ++i) {
         InnerIdType key;
         StreamReader::ReadObj(reader, key);
-        this->neighbors_[key] = std::make_unique<vsag::Vector<InnerIdType>>(allocator_);
-        StreamReader::ReadVector(reader, *(this->neighbors_[key]));
+        StreamReader::ReadVector(reader, neighbors);
+        this->InsertNeighborsById(key, neighbors);
     }
     this->total_count_ = size;
+    this->Freeze();
 }
+
 void
 SparseGraphDataCell::Resize(InnerIdType new_size){};
 }  // namespace vsag
@@ -15,7 +15,11 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <limits>
 #include <shared_mutex>
+#include <vector>
 
 #include "../utils.h"
 #include "graph_interface.h"
@@ -23,6 +27,16 @@
 
 namespace vsag {
 
+/**
+ * neighbor lists of a subset of ids, used by the route layers of hgraph
+ *
+ * ids are inserted into one of SHARD_COUNT maps, each behind its own lock, where an id owns a
+ * fixed line of [count, max_degree ids] rewritten in place under the lock. Freeze() packs all
+ * lines back to back into one open addressing table that is read without locks; a frozen line
+ * is never rewritten, an update copies the id into the shards and retires its frozen line.
+ * Once most of the table is retired it is packed again, the old one is released after the
+ * readers that may still hold it are done.
+ */
 class SparseGraphDataCell : public GraphInterface {
 public:
     using NeighborCountsType = uint32_t;
@@ -32,6 +46,8 @@ public:
 
     explicit SparseGraphDataCell(Allocator* allocator = nullptr, uint32_t max_degree = 32);
 
+    ~SparseGraphDataCell() override;
+
     void
     InsertNeighborsById(InnerIdType id, const Vector<InnerIdType>& neighbor_ids) override;
 
@@ -41,6 +57,19 @@ public:
     void
     GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const override;
 
+    /**
+     * @brief Copies the neighbors into the calling thread's ScratchBuffer block, which stays
+     * valid until the thread's next call. Lists that do not fit into the block are copied into
+     * an allocated buffer and need_release is set.
+     */
+    [[nodiscard]] const InnerIdType*
+    GetNeighborsPtr(InnerIdType id, uint32_t& neighbor_count, bool& need_release) const override;
+
+    void
+    ReleaseNeighbors(const InnerIdType* neighbors) const override {
+        this->allocator_->Deallocate(const_cast<InnerIdType*>(neighbors));
+    }
+
     void
     Resize(InnerIdType new_size) override;
 
@@ -54,17 +83,146 @@ public:
         // TODO(LHT): implement
     }
 
+    void
+    Permute(const Vector<InnerIdType>& new_ids) override;
+
     void
     Serialize(StreamWriter& writer) override;
 
     void
     Deserialize(StreamReader& reader) override;
 
+    /**
+     * @brief Moves all lists into the lock free table, called after build and load.
+     *
+     * Must not run concurrently with any other call. Ids inserted afterwards for the
+     * first time go to the sharded maps again until the next Freeze().
+     */
+    void
+    Freeze();
+
 private:
+    struct Shard {
+        explicit Shard(Allocator* allocator) : lines(allocator) {
+        }
+
+        UnorderedMap<InnerIdType, std::unique_ptr<Vector<InnerIdType>>> lines;
+        mutable std::shared_mutex mutex{};
+    };
+
+    /**
+     * frozen lines: a power of two table of ids probed linearly, the line of the key in a bucket
+     * is [count, count ids] at offsets[bucket] of lines, or RETIRED_LINE once the id was updated
+     * and lives in the shards again
+     */
+    struct FrozenTable {
+        explicit FrozenTable(Allocator* allocator)
+            : keys(allocator), offsets(allocator), lines(allocator) {
+        }
+
+        Vector<InnerIdType> keys;
+        Vector<std::atomic<uint64_t>> offsets;
+        Vector<InnerIdType> lines;
+        uint64_t shift{64};
+        // InnerIdType count of the retired lines
+        std::atomic<uint64_t> retired_size{0};
+    };
+
+    // keeps the frozen table loaded by the reader alive, see release_frozen()
+    class FrozenGuard {
+    public:
+        explicit FrozenGuard(const SparseGraphDataCell* cell)
+            : readers_(cell->active_readers_[cell->epoch_.load() & 1]) {
+            readers_.fetch_add(1);
+            table_ = cell->frozen_.load();
+        }
+
+        ~FrozenGuard() {
+            readers_.fetch_sub(1);
+        }
+
+        [[nodiscard]] const FrozenTable*
+        get() const {
+            return table_;
+        }
+
+    private:
+        std::atomic<uint64_t>& readers_;
+        const FrozenTable* table_{nullptr};
+    };
+
+    // calls func with the line of id while it can not be rewritten, or with nullptr
+    template <typename Func>
+    void
+    with_line(InnerIdType id, Func&& func) const;
+
+    // the bucket of id in table, or EMPTY_BUCKET
+    [[nodiscard]] static uint64_t
+    find_frozen_bucket(const FrozenTable* table, InnerIdType id);
+
+    // the frozen line of id unless it was retired by an update
+    [[nodiscard]] static const InnerIdType*
+    find_frozen_line(const FrozenTable* table, InnerIdType id);
+
+    [[nodiscard]] inline Shard&
+    get_shard(InnerIdType id) const {
+        return *this->shards_[id & (SHARD_COUNT - 1)];
+    }
+
+    [[nodiscard]] static inline uint64_t
+    frozen_bucket(InnerIdType id, uint64_t shift) {
+        // fibonacci hashing, route layer ids are not uniformly spread over the id space
+        return (static_cast<uint64_t>(id) * 0x9E3779B97F4A7C15ULL) >> shift;
+    }
+
+    // calls func(id, line) for every line of table that is not retired
+    template <typename Func>
+    static void
+    for_each_frozen_line(const FrozenTable* table, Func&& func);
+
+    // calls func(id, line) for every frozen line that is not retired, then every shard line
+    template <typename Func>
+    void
+    for_each_line(Func&& func) const;
+
+    // packs the lines for_each(func) visits into a new frozen table
+    template <typename ForEach>
+    FrozenTable*
+    pack_lines(ForEach&& for_each) const;
+
+    void
+    init_shards();
+
+    void
+    release_shards();
+
+    // packs the lines of the frozen table that are not retired into a new one
+    void
+    compact_frozen();
+
+    // replaces the frozen table, with wait_readers the old one is deleted only after its readers
+    void
+    replace_frozen(FrozenTable* table, bool wait_readers);
+
+private:
+    static constexpr uint64_t SHARD_COUNT = 16;
+    static constexpr InnerIdType EMPTY_KEY = std::numeric_limits<InnerIdType>::max();
+    static constexpr uint64_t EMPTY_BUCKET = std::numeric_limits<uint64_t>::max();
+    static constexpr uint64_t RETIRED_LINE = std::numeric_limits<uint64_t>::max();
+    // pack the frozen table once more than half of it is retired
+    static constexpr uint64_t COMPACT_MIN_SIZE = 1 << 12;
+
     uint32_t code_line_size_{0};
     Allocator* const allocator_{nullptr};
-    UnorderedMap<InnerIdType, std::unique_ptr<Vector<InnerIdType>>> neighbors_;
-    mutable std::shared_mutex neighbors_map_mutex_{};
+
+    // InnerIdType count of a shard line, one count followed by up to line_size_ - 1 ids
+    uint64_t line_size_{0};
+
+    Vector<Shard*> shards_;
+
+    std::atomic<FrozenTable*> frozen_{nullptr};
+    mutable std::atomic<uint64_t> epoch_{0};
+    mutable std::array<std::atomic<uint64_t>, 2> active_readers_{};
 };
 
 }  // namespace vsag
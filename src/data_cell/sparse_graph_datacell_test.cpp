@@ -17,8 +17,11 @@
 
 #include <fmt/format-inl.h>
 
+#include <algorithm>
+#include <atomic>
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <thread>
 
 #include "graph_datacell_parameter.h"
 #include "graph_interface_test.h"
@@ -49,3 +52,129 @@ TEST_CASE("SparseGraphDataCell Basic Test", "[ut][SparseGraphDataCell]") {
     graph_param->max_degree_ = max_degree;
     TestSparseGraphDataCell(graph_param, common_param);
 }
+
+TEST_CASE("SparseGraphDataCell Freeze And Concurrent Insert", "[ut][SparseGraphDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    uint32_t max_degree = 16;
+    int64_t thread_count = 8;
+    InnerIdType ids_per_thread = 500;
+    auto graph = std::make_shared<SparseGraphDataCell>(allocator.get(), max_degree);
+
+    auto make_neighbors = [&](InnerIdType id, uint32_t round) {
+        Vector<InnerIdType> neighbors((id + round) % (max_degree + 1), allocator.get());
+        for (uint32_t i = 0; i < neighbors.size(); ++i) {
+            neighbors[i] = id * 7 + i + round;
+        }
+        return neighbors;
+    };
+    auto insert_range = [&](InnerIdType begin, InnerIdType end, uint32_t round) {
+        std::vector<std::thread> threads;
+        auto step = (end - begin) / thread_count;
+        for (int64_t t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&, t]() {
+                for (InnerIdType i = 0; i < step; ++i) {
+                    // sparse ids, as in a route layer
+                    auto id = (begin + t * step + i) * 13;
+                    graph->InsertNeighborsById(id, make_neighbors(id, round));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    };
+    auto check_range = [&](InnerIdType begin, InnerIdType end, uint32_t round) {
+        for (InnerIdType i = begin; i < end; ++i) {
+            auto id = i * 13;
+            auto expected = make_neighbors(id, round);
+            uint32_t neighbor_count = 0;
+            bool need_release = true;
+            const auto* neighbors = graph->GetNeighborsPtr(id, neighbor_count, need_release);
+            REQUIRE_FALSE(need_release);
+            REQUIRE(neighbor_count == expected.size());
+            REQUIRE(std::equal(expected.begin(), expected.end(), neighbors));
+        }
+        REQUIRE(graph->GetNeighborSize(end * 13 + 1) == 0);
+    };
+
+    auto half = thread_count * ids_per_thread;
+    insert_range(0, half, 0);
+    check_range(0, half, 0);
+
+    graph->Freeze();
+    check_range(0, half, 0);
+
+    // update frozen ids, their lines move back to the shards, and add new ids beside them
+    insert_range(0, half, 1);
+    insert_range(half, half * 2, 0);
+    check_range(0, half, 1);
+    check_range(half, half * 2, 0);
+
+    graph->Freeze();
+    check_range(0, half, 1);
+    check_range(half, half * 2, 0);
+}
+
+TEST_CASE("SparseGraphDataCell Read While Retired Lines Are Reclaimed",
+          "[ut][SparseGraphDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    uint32_t max_degree = 16;
+    InnerIdType count = 4000;
+    uint32_t round_count = 3;
+    int64_t reader_count = 4;
+    auto graph = std::make_shared<SparseGraphDataCell>(allocator.get(), max_degree);
+
+    auto make_neighbors = [&](InnerIdType id, uint32_t round) {
+        Vector<InnerIdType> neighbors((id + round) % (max_degree + 1), allocator.get());
+        for (uint32_t i = 0; i < neighbors.size(); ++i) {
+            neighbors[i] = id * 7 + i + round;
+        }
+        return neighbors;
+    };
+    for (InnerIdType i = 0; i < count; ++i) {
+        graph->InsertNeighborsById(i * 13, make_neighbors(i * 13, 0));
+    }
+    graph->Freeze();
+
+    // updating every id retires the whole frozen table, which is packed and released meanwhile
+    std::atomic<bool> updating{true};
+    std::atomic<uint64_t> failed_count{0};
+    std::vector<std::thread> readers;
+    for (int64_t t = 0; t < reader_count; ++t) {
+        readers.emplace_back([&, t]() {
+            for (InnerIdType i = t; updating.load() or i < count; i += reader_count) {
+                auto id = (i % count) * 13;
+                uint32_t neighbor_count = 0;
+                bool need_release = false;
+                const auto* neighbors = graph->GetNeighborsPtr(id, neighbor_count, need_release);
+                bool matched = false;
+                for (uint32_t round = 0; round <= round_count and not matched; ++round) {
+                    auto expected = make_neighbors(id, round);
+                    matched = neighbor_count == expected.size() and
+                              std::equal(expected.begin(), expected.end(), neighbors);
+                }
+                if (not matched) {
+                    ++failed_count;
+                }
+                if (need_release) {
+                    graph->ReleaseNeighbors(neighbors);
+                }
+            }
+        });
+    }
+    for (uint32_t round = 1; round <= round_count; ++round) {
+        for (InnerIdType i = 0; i < count; ++i) {
+            graph->InsertNeighborsById(i * 13, make_neighbors(i * 13, round));
+        }
+    }
+    updating.store(false);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    REQUIRE(failed_count.load() == 0);
+    for (InnerIdType i = 0; i < count; ++i) {
+        Vector<InnerIdType> neighbors(allocator.get());
+        graph->GetNeighbors(i * 13, neighbors);
+        REQUIRE(neighbors == make_neighbors(i * 13, round_count));
+    }
+}
@@ -15,15 +15,40 @@
 
 #include "default_thread_pool.h"
 
+#include "numa_utils.h"
+
 namespace vsag {
 
-DefaultThreadPool::DefaultThreadPool(std::size_t threads) {
+static std::atomic<uint64_t> next_pool_id{1};
+
+DefaultThreadPool::DefaultThreadPool(std::size_t threads, bool bind_numa)
+    : pool_id_(next_pool_id.fetch_add(1, std::memory_order_relaxed)),
+      bind_numa_(bind_numa and get_numa_node_count() > 1) {
     pool_ = std::make_unique<progschj::ThreadPool>(threads);
 }
 
 std::future<void>
 DefaultThreadPool::Enqueue(std::function<void(void)> task) {
-    return pool_->enqueue(task);
+    if (not bind_numa_) {
+        return pool_->enqueue(task);
+    }
+    return pool_->enqueue([this, task = std::move(task)]() {
+        this->bind_current_worker();
+        task();
+    });
+}
+
+void
+DefaultThreadPool::bind_current_worker() {
+    // pool ids are never reused, a thread is bound again when it runs a task of another pool
+    thread_local uint64_t bound_pool_id = 0;
+    if (bound_pool_id == pool_id_) {
+        return;
+    }
+    const auto& nodes = get_numa_nodes();
+    auto index = next_numa_node_.fetch_add(1, std::memory_order_relaxed) % nodes.size();
+    bind_current_thread_to_numa_node(nodes[index]);
+    bound_pool_id = pool_id_;
 }
 
 void
@@ -17,6 +17,7 @@
 
 #include <ThreadPool.h>
 
+#include <atomic>
 #include <functional>
 #include <future>
 
@@ -27,7 +28,13 @@ namespace vsag {
 
 class DefaultThreadPool : public ThreadPool {
 public:
-    explicit DefaultThreadPool(std::size_t threads);
+    /**
+     * @brief Creates a pool of threads workers.
+     *
+     * With bind_numa set, each worker pins itself to the cpus of one NUMA node before its
+     * first task, the nodes are assigned round-robin.
+     */
+    explicit DefaultThreadPool(std::size_t threads, bool bind_numa = false);
 
     std::future<void>
     Enqueue(std::function<void(void)> task) override;
@@ -41,8 +48,18 @@ public:
     void
     SetPoolSize(std::size_t limit) override;
 
+private:
+    void
+    bind_current_worker();
+
 private:
     std::unique_ptr<progschj::ThreadPool> pool_;
+
+    const uint64_t pool_id_{0};
+
+    bool bind_numa_{false};
+
+    std::atomic<uint32_t> next_numa_node_{0};
 };
 
 }  // namespace vsag
@@ -30,16 +30,18 @@ BasicSearcher::visit(const GraphInterfacePtr& graph_data_cell,
                      Vector<InnerIdType>& to_be_visited_rid,
                      Vector<InnerIdType>& to_be_visited_id) const {
     uint32_t count_no_visited = 0;
-    Vector<InnerIdType> neighbors(allocator_);
+    uint32_t neighbor_count = 0;
+    bool release = false;
 
-    graph_data_cell->GetNeighbors(current_node_pair.second, neighbors);
+    const auto* neighbors =
+        graph_data_cell->GetNeighborsPtr(current_node_pair.second, neighbor_count, release);
 
-    for (uint32_t i = 0; i < prefetch_jump_visit_size_; i++) {
+    for (uint32_t i = 0; i < prefetch_jump_visit_size_ and i < neighbor_count; i++) {
         vl->Prefetch(neighbors[i]);
     }
 
-    for (uint32_t i = 0; i < neighbors.size(); i++) {
-        if (i + prefetch_jump_visit_size_ < neighbors.size()) {
+    for (uint32_t i = 0; i < neighbor_count; i++) {
+        if (i + prefetch_jump_visit_size_ < neighbor_count) {
             vl->Prefetch(neighbors[i + prefetch_jump_visit_size_]);
         }
         if (not vl->Get(neighbors[i])) {
@@ -49,6 +51,9 @@ BasicSearcher::visit(const GraphInterfacePtr& graph_data_cell,
             vl->Set(neighbors[i]);
         }
     }
+    if (release) {
+        graph_data_cell->ReleaseNeighbors(neighbors);
+    }
     return count_no_visited;
 }
 
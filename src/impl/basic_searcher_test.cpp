@@ -51,6 +51,14 @@ public:
         }
     }
 
+    const InnerIdType*
+    GetNeighborsPtr(InnerIdType id, uint32_t& neighbor_count, bool& need_release) const override {
+        int* data = (int*)alg_hnsw_->get_linklist0(id);
+        neighbor_count = alg_hnsw_->getListCount((hnswlib::linklistsizeint*)data);
+        need_release = false;
+        return reinterpret_cast<const InnerIdType*>(data + 1);
+    }
+
     uint32_t
     GetNeighborSize(InnerIdType id) const override {
         int* data = (int*)alg_hnsw_->get_linklist0(id);
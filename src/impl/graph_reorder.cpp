@@ -0,0 +1,137 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "graph_reorder.h"
+
+#include <fmt/format-inl.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "common.h"
+#include "inner_string_params.h"
+
+namespace vsag {
+
+static constexpr InnerIdType UNVISITED = std::numeric_limits<InnerIdType>::max();
+
+// visits ids reachable from root in breadth first order, appending them to order
+static void
+breadth_first_visit(const GetNeighborsFunc& get_neighbors,
+                    InnerIdType root,
+                    InnerIdType count,
+                    bool sort_by_degree,
+                    const Vector<uint32_t>& degrees,
+                    Vector<InnerIdType>& new_ids,
+                    Vector<InnerIdType>& order) {
+    Vector<InnerIdType> neighbors(order.get_allocator());
+    auto head = order.size();
+    new_ids[root] = order.size();
+    order.emplace_back(root);
+    while (head < order.size()) {
+        auto id = order[head++];
+        neighbors.clear();
+        get_neighbors(id, neighbors);
+        if (sort_by_degree) {
+            auto degree_of = [&](InnerIdType neighbor) {
+                return neighbor < count ? degrees[neighbor] : 0U;
+            };
+            std::stable_sort(
+                neighbors.begin(), neighbors.end(), [&](InnerIdType a, InnerIdType b) {
+                    return degree_of(a) < degree_of(b);
+                });
+        }
+        for (auto neighbor : neighbors) {
+            if (neighbor < count and new_ids[neighbor] == UNVISITED) {
+                new_ids[neighbor] = order.size();
+                order.emplace_back(neighbor);
+            }
+        }
+    }
+}
+
+Vector<InnerIdType>
+ComputeGraphOrder(const GetNeighborsFunc& get_neighbors,
+                  InnerIdType count,
+                  InnerIdType entry_point,
+                  const std::string& reorder_type,
+                  Allocator* allocator) {
+    CHECK_ARGUMENT(
+        reorder_type == GRAPH_REORDER_TYPE_VALUE_BFS or
+            reorder_type == GRAPH_REORDER_TYPE_VALUE_RCM,
+        fmt::format("graph reorder type must be {} or {}, got {}",
+                    GRAPH_REORDER_TYPE_VALUE_BFS,
+                    GRAPH_REORDER_TYPE_VALUE_RCM,
+                    reorder_type));
+    Vector<InnerIdType> new_ids(count, UNVISITED, allocator);
+    Vector<InnerIdType> order(allocator);
+    order.reserve(count);
+    if (count == 0) {
+        return new_ids;
+    }
+
+    bool is_rcm = reorder_type == GRAPH_REORDER_TYPE_VALUE_RCM;
+    Vector<uint32_t> degrees(allocator);
+    // roots of the traversals, tried in this order until every id is numbered
+    Vector<InnerIdType> roots(count, allocator);
+    for (InnerIdType i = 0; i < count; ++i) {
+        roots[i] = i;
+    }
+    if (is_rcm) {
+        degrees.resize(count);
+        Vector<InnerIdType> neighbors(allocator);
+        for (InnerIdType i = 0; i < count; ++i) {
+            neighbors.clear();
+            get_neighbors(i, neighbors);
+            degrees[i] = neighbors.size();
+        }
+        std::stable_sort(roots.begin(), roots.end(), [&](InnerIdType a, InnerIdType b) {
+            return degrees[a] < degrees[b];
+        });
+    } else if (entry_point < count) {
+        breadth_first_visit(get_neighbors, entry_point, count, false, degrees, new_ids, order);
+    }
+
+    for (auto root : roots) {
+        if (new_ids[root] == UNVISITED) {
+            breadth_first_visit(get_neighbors, root, count, is_rcm, degrees, new_ids, order);
+        }
+    }
+
+    if (is_rcm) {
+        for (InnerIdType i = 0; i < count; ++i) {
+            new_ids[order[i]] = count - 1 - i;
+        }
+    }
+    return new_ids;
+}
+
+Vector<InnerIdType>
+ComputeGraphOrder(const GraphInterfacePtr& graph,
+                  InnerIdType count,
+                  InnerIdType entry_point,
+                  const std::string& reorder_type,
+                  Allocator* allocator) {
+    return ComputeGraphOrder(
+        [&graph](InnerIdType id, Vector<InnerIdType>& neighbors) {
+            graph->GetNeighbors(id, neighbors);
+        },
+        count,
+        entry_point,
+        reorder_type,
+        allocator);
+}
+
+}  // namespace vsag
@@ -0,0 +1,52 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "data_cell/graph_interface.h"
+#include "typing.h"
+
+namespace vsag {
+
+using GetNeighborsFunc = std::function<void(InnerIdType id, Vector<InnerIdType>& neighbors)>;
+
+/**
+ * @brief Computes a numbering of the first count ids that places graph neighbors close.
+ *
+ * "bfs" numbers ids in breadth first order from entry_point, "rcm" uses the reverse
+ * Cuthill-McKee order (breadth first from a lowest degree id, neighbors by ascending
+ * degree, reversed). Ids not reachable are appended as new traversal roots.
+ *
+ * @param get_neighbors appends the out neighbors of an id, ids >= count are ignored
+ * @return new_ids with new_ids[old_id] as the new id, a permutation of [0, count)
+ */
+Vector<InnerIdType>
+ComputeGraphOrder(const GetNeighborsFunc& get_neighbors,
+                  InnerIdType count,
+                  InnerIdType entry_point,
+                  const std::string& reorder_type,
+                  Allocator* allocator);
+
+Vector<InnerIdType>
+ComputeGraphOrder(const GraphInterfacePtr& graph,
+                  InnerIdType count,
+                  InnerIdType entry_point,
+                  const std::string& reorder_type,
+                  Allocator* allocator);
+
+}  // namespace vsag
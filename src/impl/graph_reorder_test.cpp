@@ -0,0 +1,128 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "graph_reorder.h"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <numeric>
+#include <random>
+
+#include "data_cell/graph_datacell_parameter.h"
+#include "data_cell/sparse_graph_datacell.h"
+#include "safe_allocator.h"
+
+using namespace vsag;
+
+// a ring where every id links to the next and previous two, under shuffled ids
+static GraphInterfacePtr
+make_shuffled_ring(InnerIdType count,
+                   const std::string& graph_type,
+                   const std::shared_ptr<Allocator>& allocator,
+                   Vector<InnerIdType>& position) {
+    constexpr const char* graph_param_str = R"(
+        {
+            "io_params": {
+                "type": "block_memory_io"
+            },
+            "max_degree": 8,
+            "init_capacity": 100
+        })";
+    auto graph_param =
+        GraphInterfaceParameter::GetGraphParameterByJson(JsonType::parse(graph_param_str));
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    auto graph = graph_type == "sparse"
+                     ? GraphInterface::MakeInstance(graph_param, common_param, true)
+                     : GraphInterface::MakeInstance(graph_param, common_param);
+
+    position.resize(count);
+    std::iota(position.begin(), position.end(), 0);
+    std::shuffle(position.begin(), position.end(), std::mt19937(47));
+    Vector<InnerIdType> ids_at(count, allocator.get());
+    for (InnerIdType id = 0; id < count; ++id) {
+        ids_at[position[id]] = id;
+    }
+    for (InnerIdType id = 0; id < count; ++id) {
+        Vector<InnerIdType> neighbors(allocator.get());
+        for (int64_t offset : {-2, -1, 1, 2}) {
+            auto pos = (static_cast<int64_t>(position[id]) + offset + count) % count;
+            neighbors.emplace_back(ids_at[pos]);
+        }
+        graph->InsertNeighborsById(id, neighbors);
+    }
+    return graph;
+}
+
+TEST_CASE("GraphReorder Compute Order", "[ut][GraphReorder]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    std::string reorder_type = GENERATE("bfs", "rcm");
+    InnerIdType count = 2000;
+    Vector<InnerIdType> position(allocator.get());
+    auto graph = make_shuffled_ring(count, "dense", allocator, position);
+
+    InnerIdType entry_point = 7;
+    auto new_ids = ComputeGraphOrder(graph, count, entry_point, reorder_type, allocator.get());
+    REQUIRE(new_ids.size() == count);
+    Vector<InnerIdType> sorted_ids(new_ids.begin(), new_ids.end(), allocator.get());
+    std::sort(sorted_ids.begin(), sorted_ids.end());
+    for (InnerIdType i = 0; i < count; ++i) {
+        REQUIRE(sorted_ids[i] == i);
+    }
+    if (reorder_type == "bfs") {
+        REQUIRE(new_ids[entry_point] == 0);
+    }
+
+    // neighbors on the ring end up close to each other
+    Vector<InnerIdType> neighbors(allocator.get());
+    uint64_t max_distance = 0;
+    for (InnerIdType id = 0; id < count; ++id) {
+        graph->GetNeighbors(id, neighbors);
+        for (auto neighbor : neighbors) {
+            auto distance = std::max(new_ids[id], new_ids[neighbor]) -
+                            std::min(new_ids[id], new_ids[neighbor]);
+            max_distance = std::max<uint64_t>(max_distance, distance);
+        }
+    }
+    REQUIRE(max_distance <= 8);
+
+    REQUIRE_THROWS(ComputeGraphOrder(graph, count, entry_point, "unknown", allocator.get()));
+}
+
+TEST_CASE("GraphReorder Permute Graph", "[ut][GraphReorder]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    std::string graph_type = GENERATE("dense", "sparse");
+    InnerIdType count = 1000;
+    Vector<InnerIdType> position(allocator.get());
+    auto graph = make_shuffled_ring(count, graph_type, allocator, position);
+    auto origin = make_shuffled_ring(count, graph_type, allocator, position);
+    if (graph_type == "sparse") {
+        std::dynamic_pointer_cast<SparseGraphDataCell>(graph)->Freeze();
+    }
+
+    auto new_ids = ComputeGraphOrder(graph, count, 0, "rcm", allocator.get());
+    graph->Permute(new_ids);
+    Vector<InnerIdType> expected(allocator.get());
+    Vector<InnerIdType> neighbors(allocator.get());
+    for (InnerIdType id = 0; id < count; ++id) {
+        origin->GetNeighbors(id, expected);
+        for (auto& neighbor : expected) {
+            neighbor = new_ids[neighbor];
+        }
+        graph->GetNeighbors(new_ids[id], neighbors);
+        REQUIRE(neighbors == expected);
+    }
+}
@@ -189,6 +189,19 @@ BruteForce::serialize(std::ostream& out_stream) const {
     this->serialize(writer);
 }
 
+void
+BruteForce::serialize(const WriteFuncType& write_func) const {
+    SlowTaskTimer t("brute force Serialize");
+    WriteFuncStreamWriter writer(write_func, 0);
+    StreamWriter::WriteSectionHeader(writer, INDEX_BRUTE_FORCE, this->cal_serialize_size());
+    this->serialize(writer);
+}
+
+uint64_t
+BruteForce::CalSerializeSize() const {
+    return StreamWriter::SectionHeaderSize(INDEX_BRUTE_FORCE) + this->cal_serialize_size();
+}
+
 void
 BruteForce::serialize(StreamWriter& writer) const {
     StreamWriter::WriteObj(writer, dim_);
@@ -326,6 +339,7 @@ BruteForce::init_feature_list() {
         IndexFeature::SUPPORT_DESERIALIZE_READER_SET,
         IndexFeature::SUPPORT_SERIALIZE_BINARY_SET,
         IndexFeature::SUPPORT_SERIALIZE_FILE,
+        IndexFeature::SUPPORT_SERIALIZE_WRITE_FUNC,
     });
     // others
     feature_list_.SetFeatures({
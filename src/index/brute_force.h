@@ -108,6 +108,15 @@ public:
         return {};
     }
 
+    tl::expected<void, Error>
+    Serialize(WriteFuncType write_func) const override {
+        SAFE_CALL(this->serialize(write_func));
+        return {};
+    }
+
+    [[nodiscard]] uint64_t
+    CalSerializeSize() const override;
+
     tl::expected<void, Error>
     Deserialize(std::istream& in_stream) override {
         SAFE_CALL(this->deserialize(in_stream));
@@ -172,6 +181,9 @@ private:
     void
     serialize(std::ostream& out_stream) const;
 
+    void
+    serialize(const WriteFuncType& write_func) const;
+
     void
     serialize(StreamWriter& writer) const;
 
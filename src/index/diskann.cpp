@@ -18,19 +18,26 @@
 #include <local_file_reader.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <exception>
 #include <functional>
 #include <future>
 #include <iterator>
+#include <limits>
+#include <map>
 #include <new>
 #include <nlohmann/json.hpp>
+#include <shared_mutex>
 #include <stdexcept>
 #include <utility>
 
+#include "base_filter_functor.h"
 #include "data_cell/flatten_datacell.h"
 #include "impl/odescent_graph_builder.h"
 #include "io/memory_io_parameter.h"
 #include "quantization/fp32_quantizer_parameter.h"
+#include "stream_writer.h"
 #include "vsag/constants.h"
 #include "vsag/errors.h"
 #include "vsag/expected.hpp"
@@ -48,10 +55,19 @@ const static int MAXIMAL_R = 64;
 const static int VECTOR_PER_BLOCK = 1;
 const static float GRAPH_SLACK = 1.3 * 1.05;
 const static size_t MINIMAL_SECTOR_LEN = 4096;
+const static uint64_t MAXIMAL_COALESCED_READ = 128 * 1024;
+const static uint64_t SERIALIZE_CHUNK_SIZE = 4 * 1024 * 1024;
 const static std::string BUILD_STATUS = "status";
 const static std::string BUILD_CURRENT_ROUND = "round";
-const static std::string BUILD_NODES = "builded_nodes";
 const static std::string BUILD_FAILED_LOC = "failed_loc";
+const static std::string BUILD_VALID_LOC = "valid_loc";
+const static std::string BUILD_SHARDS = "shards";
+const static std::string BUILD_SHARD_GRAPH = "shard_graph_";
+const static std::string BUILD_ELAPSED = "elapsed";
+const static int64_t DELTA_MAX_ELEMENT = 1024;
+const static double PARTITION_SAMPLE_NUM = 1500000;
+const static int64_t PARTIAL_BUILD_SHARDS_PER_ROUND = 2;
+const static int64_t PARTIAL_BUILD_MIN_SHARD_SIZE = 256;
 
 template <typename T>
 Binary
@@ -71,7 +87,57 @@ from_binary(const Binary& binary) {
     return value;
 }
 
-class LocalMemoryReader : public Reader {
+static diskann::SectorVectorType
+to_sector_vector_type(const std::string& sector_vector_type) {
+    if (sector_vector_type == DISKANN_SECTOR_VECTOR_TYPE_FP16) {
+        return diskann::SectorVectorType::FP16;
+    }
+    if (sector_vector_type == DISKANN_SECTOR_VECTOR_TYPE_SQ8) {
+        return diskann::SectorVectorType::SQ8;
+    }
+    return diskann::SectorVectorType::FP32;
+}
+
+template <typename T>
+Binary
+serialize_vector_to_binary(std::vector<T> data) {
+    if (data.empty()) {
+        return {};
+    }
+    size_t total_size = data.size() * sizeof(T);
+    std::shared_ptr<int8_t[]> raw_data(new int8_t[total_size], std::default_delete<int8_t[]>());
+    int8_t* data_ptr = raw_data.get();
+    std::memcpy(data_ptr, data.data(), total_size);
+    Binary binary_data{raw_data, total_size};
+    return binary_data;
+}
+
+template <typename T>
+std::vector<T>
+deserialize_vector_from_binary(const Binary& binary_data) {
+    std::vector<T> deserialized_container;
+    if (binary_data.size == 0) {
+        return std::move(deserialized_container);
+    }
+    const int8_t* data_ptr = binary_data.data.get();
+    size_t num_elements = binary_data.size / sizeof(T);
+    deserialized_container.resize(num_elements);
+    std::memcpy(deserialized_container.data(), data_ptr, num_elements * sizeof(T));
+    return std::move(deserialized_container);
+}
+
+template <typename T>
+std::vector<T>
+read_vector_from_reader(const std::shared_ptr<Reader>& reader) {
+    std::vector<T> data;
+    if (reader) {
+        data.resize(reader->Size() / sizeof(T));
+        reader->Read(0, data.size() * sizeof(T), data.data());
+    }
+    return data;
+}
+
+class LocalMemoryReader : public WritableReader {
 public:
     LocalMemoryReader(std::stringstream& file, bool support_async_io) {
         if (support_async_io) {
@@ -107,18 +173,123 @@ public:
         }
     }
 
+    void
+    Write(uint64_t offset, uint64_t len, const void* src) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        file_.seekp(static_cast<int64_t>(offset), std::ios::beg);
+        file_.write((const char*)src, static_cast<int64_t>(len));
+        size_ = std::max(size_, offset + len);
+    }
+
     uint64_t
     Size() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
         return size_;
     }
 
 private:
     std::stringstream file_;
     uint64_t size_;
-    std::mutex mutex_;
+    mutable std::mutex mutex_;
     std::shared_ptr<SafeThreadPool> pool_;
 };
 
+// Keeps the pages a merge patched in memory on top of a read-only layout reader, so an index
+// deserialized from external storage keeps reading the untouched pages from it
+class PatchedReader : public WritableReader {
+public:
+    PatchedReader(std::shared_ptr<Reader> base, uint64_t page_len)
+        : base_(std::move(base)), page_len_(page_len), size_(base_->Size()) {
+    }
+
+    ~PatchedReader() override = default;
+
+    void
+    Read(uint64_t offset, uint64_t len, void* dest) override {
+        std::shared_lock lock(mutex_);
+        if (not patched(offset, len)) {
+            base_->Read(offset, len, dest);
+            return;
+        }
+        auto* out = (char*)dest;
+        while (len > 0) {
+            auto page = offset / page_len_;
+            auto page_offset = offset % page_len_;
+            auto chunk = std::min(len, page_len_ - page_offset);
+            auto iter = pages_.find(page);
+            if (iter != pages_.end()) {
+                std::memcpy(out, iter->second.get() + page_offset, chunk);
+            } else {
+                base_->Read(offset, chunk, out);
+            }
+            offset += chunk;
+            out += chunk;
+            len -= chunk;
+        }
+    }
+
+    void
+    AsyncRead(uint64_t offset, uint64_t len, void* dest, CallBack callback) override {
+        {
+            std::shared_lock lock(mutex_);
+            if (not patched(offset, len)) {
+                base_->AsyncRead(offset, len, dest, callback);
+                return;
+            }
+        }
+        // the patched pages are in memory, the rest is read inline
+        this->Read(offset, len, dest);
+        callback(IOErrorCode::IO_SUCCESS, "success");
+    }
+
+    void
+    Write(uint64_t offset, uint64_t len, const void* src) override {
+        std::unique_lock lock(mutex_);
+        const auto* in = (const char*)src;
+        while (len > 0) {
+            auto page = offset / page_len_;
+            auto page_offset = offset % page_len_;
+            auto chunk = std::min(len, page_len_ - page_offset);
+            auto& buf = pages_[page];
+            if (buf == nullptr) {
+                buf.reset(new char[page_len_]);
+                auto base_size = base_->Size();
+                auto base_len =
+                    std::min(page_len_, base_size - std::min(base_size, page * page_len_));
+                if (base_len > 0) {
+                    base_->Read(page * page_len_, base_len, buf.get());
+                }
+                std::memset(buf.get() + base_len, 0, page_len_ - base_len);
+            }
+            std::memcpy(buf.get() + page_offset, in, chunk);
+            offset += chunk;
+            in += chunk;
+            len -= chunk;
+        }
+        size_ = std::max(size_, offset);
+    }
+
+    uint64_t
+    Size() const override {
+        std::shared_lock lock(mutex_);
+        return size_;
+    }
+
+private:
+    bool
+    patched(uint64_t offset, uint64_t len) const {
+        auto iter = pages_.lower_bound(offset / page_len_);
+        return iter != pages_.end() && iter->first <= (offset + len - 1) / page_len_;
+    }
+
+private:
+    std::shared_ptr<Reader> base_;
+    uint64_t page_len_;
+    uint64_t size_;
+    std::map<uint64_t, std::unique_ptr<char[]>> pages_;
+    mutable std::shared_mutex mutex_;
+};
+
 Binary
 convert_stream_to_binary(const std::stringstream& stream) {
     std::streambuf* buf = stream.rdbuf();
@@ -134,6 +305,36 @@ convert_stream_to_binary(const std::stringstream& stream) {
     return std::move(binary);
 }
 
+std::streamsize
+stream_size(const std::stringstream& stream) {
+    std::streambuf* buf = stream.rdbuf();
+    std::streamsize size = buf->pubseekoff(0, std::stringstream::end, std::stringstream::in);
+    buf->pubseekpos(0, std::stringstream::in);
+    return size;
+}
+
+// streams the content in chunks, so the stream is never copied as a whole
+void
+write_stream_section(StreamWriter& writer, const std::string& key, const std::stringstream& stream) {
+    std::streambuf* buf = stream.rdbuf();
+    std::streamsize size = stream_size(stream);
+    StreamWriter::WriteSectionHeader(writer, key, size);
+    std::vector<char> chunk(std::min(static_cast<uint64_t>(size), SERIALIZE_CHUNK_SIZE));
+    for (std::streamsize written = 0; written < size;) {
+        auto len = std::min(static_cast<std::streamsize>(chunk.size()), size - written);
+        buf->sgetn(chunk.data(), len);
+        writer.Write(chunk.data(), len);
+        written += len;
+    }
+}
+
+template <typename T>
+void
+write_vector_section(StreamWriter& writer, const std::string& key, const std::vector<T>& data) {
+    StreamWriter::WriteSectionHeader(writer, key, data.size() * sizeof(T));
+    writer.Write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+}
+
 void
 convert_binary_to_stream(const Binary& binary, std::stringstream& stream) {
     stream.str("");
@@ -154,13 +355,17 @@ DiskANN::DiskANN(DiskannParameters& diskann_params, const IndexCommonParam& inde
       use_opq_(diskann_params.use_opq),
       use_bsa_(diskann_params.use_bsa),
       use_async_io_(diskann_params.use_async_io),
+      cache_size_(diskann_params.cache_size),
+      merge_threshold_(diskann_params.merge_threshold),
+      build_memory_budget_(diskann_params.build_memory_budget),
+      sector_vector_type_(to_sector_vector_type(diskann_params.sector_vector_type)),
       diskann_params_(diskann_params),
       common_param_(index_common_param) {
     if (not use_async_io_) {
         pool_ = index_common_param_.thread_pool_;
     }
     status_ = IndexStatus::EMPTY;
-    batch_read_ =
+    auto device_read =
         [&](const std::vector<read_request>& requests, bool async, CallBack callBack) -> void {
         if (async) {
             for (const auto& req : requests) {
@@ -189,6 +394,12 @@ DiskANN::DiskANN(DiskannParameters& diskann_params, const IndexCommonParam& inde
             }
         }
     };
+    // concurrent queries share the reads of hot sectors through the scheduler
+    io_scheduler_ = std::make_shared<DiskannIOScheduler>(device_read, MAXIMAL_COALESCED_READ);
+    batch_read_ =
+        [&](const std::vector<read_request>& requests, bool async, CallBack callBack) -> uint64_t {
+        return io_scheduler_->Submit(requests, async, callBack);
+    };
 
     R_ = std::min(MAXIMAL_R, std::max(MINIMAL_R, R_));
 
@@ -225,71 +436,15 @@ DiskANN::build(const DatasetPtr& base) {
         CHECK_ARGUMENT(data_num > 1,
                        fmt::format("base.num_elements({}) must be greater than 1", data_num));
 
-        std::vector<size_t> failed_locs;
-        if (diskann_params_.graph_type == DISKANN_GRAPH_TYPE_ODESCENT) {
-            SlowTaskTimer t("odescent build full (graph)");
-            FlattenDataCellParamPtr flatten_param =
-                std::make_shared<vsag::FlattenDataCellParameter>();
-            flatten_param->quantizer_parameter_ = std::make_shared<FP32QuantizerParameter>();
-            flatten_param->io_parameter_ = std::make_shared<MemoryIOParameter>();
-            vsag::FlattenInterfacePtr flatten_interface_ptr =
-                vsag::FlattenInterface::MakeInstance(flatten_param, this->common_param_);
-            flatten_interface_ptr->Train(vectors, data_num);
-            flatten_interface_ptr->BatchInsertVector(vectors, data_num);
-            vsag::ODescent graph(2LL * R_,
-                                 diskann_params_.alpha,
-                                 diskann_params_.turn,
-                                 diskann_params_.sample_rate,
-                                 flatten_interface_ptr,
-                                 common_param_.allocator_.get(),
-                                 common_param_.thread_pool_.get());
-            graph.Build();
-            graph.SaveGraph(graph_stream_);
-            auto data_num_int32 = static_cast<int32_t>(data_num);
-            auto data_dim_int32 = static_cast<int32_t>(data_dim);
-            tag_stream_.write((char*)&data_num_int32, sizeof(data_num_int32));
-            tag_stream_.write((char*)&data_dim_int32, sizeof(data_dim_int32));
-            tag_stream_.write((char*)ids, static_cast<std::streamsize>(data_num * sizeof(ids)));
-        } else if (diskann_params_.graph_type == DISKANN_GRAPH_TYPE_VAMANA) {
-            SlowTaskTimer t("diskann build full (graph)");
-            // build graph
-            build_index_ = std::make_shared<diskann::Index<float, int64_t, int64_t>>(
-                metric_, data_dim, data_num, false, true, false, false, 0, false);
-            std::vector<int64_t> tags(ids, ids + data_num);
-            auto index_build_params =
-                diskann::IndexWriteParametersBuilder(L_, R_)
-                    .with_num_threads(Options::Instance().num_threads_building())
-                    .build();
-            failed_locs =
-                build_index_->build(vectors, data_num, index_build_params, tags, use_reference_);
-            build_index_->save(graph_stream_, tag_stream_);
-            build_index_.reset();
-        }
-        {
-            SlowTaskTimer t("diskann build full (pq)");
-            diskann::generate_disk_quantized_data<float>(vectors,
-                                                         data_num,
-                                                         data_dim,
-                                                         failed_locs,
-                                                         pq_pivots_stream_,
-                                                         disk_pq_compressed_vectors_,
-                                                         metric_,
-                                                         p_val_,
-                                                         disk_pq_dims_,
-                                                         use_opq_,
-                                                         use_bsa_);
-        }
-        {
-            SlowTaskTimer t("diskann build full (disk layout)");
-            diskann::create_disk_layout<float>(vectors,
-                                               data_num,
-                                               data_dim,
-                                               failed_locs,
-                                               graph_stream_,
-                                               disk_layout_stream_,
-                                               sector_len_,
-                                               metric_);
-        }
+        auto failed_locs = build_disk_streams(vectors,
+                                              ids,
+                                              data_num,
+                                              common_param_,
+                                              graph_stream_,
+                                              tag_stream_,
+                                              pq_pivots_stream_,
+                                              disk_pq_compressed_vectors_,
+                                              disk_layout_stream_);
 
         std::vector<int64_t> failed_ids;
         std::transform(failed_locs.begin(),
@@ -309,6 +464,7 @@ DiskANN::build(const DatasetPtr& base) {
         } else {
             graph_stream_.clear();
         }
+        warm_cache({});
         status_ = IndexStatus::MEMORY;
         return failed_ids;
     } catch (const std::invalid_argument& e) {
@@ -317,6 +473,102 @@ DiskANN::build(const DatasetPtr& base) {
     }
 }
 
+std::vector<size_t>
+DiskANN::build_disk_streams(const float* vectors,
+                            const int64_t* ids,
+                            int64_t data_num,
+                            const IndexCommonParam& common_param,
+                            std::stringstream& graph_stream,
+                            std::stringstream& tag_stream,
+                            std::stringstream& pq_pivots_stream,
+                            std::stringstream& disk_pq_compressed_vectors,
+                            std::stringstream& disk_layout_stream) {
+    std::vector<size_t> failed_locs;
+    if (diskann_params_.graph_type == DISKANN_GRAPH_TYPE_ODESCENT) {
+        SlowTaskTimer t("odescent build full (graph)");
+        FlattenDataCellParamPtr flatten_param = std::make_shared<vsag::FlattenDataCellParameter>();
+        flatten_param->quantizer_parameter_ = std::make_shared<FP32QuantizerParameter>();
+        flatten_param->io_parameter_ = std::make_shared<MemoryIOParameter>();
+        vsag::FlattenInterfacePtr flatten_interface_ptr =
+            vsag::FlattenInterface::MakeInstance(flatten_param, common_param);
+        flatten_interface_ptr->Train(vectors, data_num);
+        flatten_interface_ptr->BatchInsertVector(vectors, data_num);
+        vsag::ODescent graph(2LL * R_,
+                             diskann_params_.alpha,
+                             diskann_params_.turn,
+                             diskann_params_.sample_rate,
+                             flatten_interface_ptr,
+                             common_param.allocator_.get(),
+                             common_param.thread_pool_.get());
+        graph.Build();
+        graph.SaveGraph(graph_stream);
+        auto data_num_int32 = static_cast<int32_t>(data_num);
+        auto data_dim_int32 = static_cast<int32_t>(dim_);
+        tag_stream.write((char*)&data_num_int32, sizeof(data_num_int32));
+        tag_stream.write((char*)&data_dim_int32, sizeof(data_dim_int32));
+        tag_stream.write((char*)ids, static_cast<std::streamsize>(data_num * sizeof(ids)));
+    } else if (diskann_params_.graph_type == DISKANN_GRAPH_TYPE_VAMANA &&
+               build_memory_budget_ > 0 &&
+               diskann::estimate_ram_usage(data_num, dim_, sizeof(float), R_) >
+                   static_cast<double>(build_memory_budget_)) {
+        SlowTaskTimer t("diskann build partitioned (graph)");
+        std::vector<int64_t> tags(ids, ids + data_num);
+        auto sampling_rate = std::min(1.0, PARTITION_SAMPLE_NUM / static_cast<double>(data_num));
+        failed_locs = diskann::build_partitioned_vamana_index<float, int64_t>(
+            vectors,
+            data_num,
+            dim_,
+            tags,
+            metric_,
+            L_,
+            R_,
+            sampling_rate,
+            static_cast<double>(build_memory_budget_),
+            Options::Instance().num_threads_building(),
+            graph_stream,
+            tag_stream);
+    } else if (diskann_params_.graph_type == DISKANN_GRAPH_TYPE_VAMANA) {
+        SlowTaskTimer t("diskann build full (graph)");
+        // build graph
+        auto build_index = std::make_shared<diskann::Index<float, int64_t, int64_t>>(
+            metric_, dim_, data_num, false, true, false, false, 0, false);
+        std::vector<int64_t> tags(ids, ids + data_num);
+        auto index_build_params = diskann::IndexWriteParametersBuilder(L_, R_)
+                                      .with_num_threads(Options::Instance().num_threads_building())
+                                      .build();
+        failed_locs =
+            build_index->build(vectors, data_num, index_build_params, tags, use_reference_);
+        build_index->save(graph_stream, tag_stream);
+    }
+    {
+        SlowTaskTimer t("diskann build full (pq)");
+        diskann::generate_disk_quantized_data<float>(vectors,
+                                                     data_num,
+                                                     dim_,
+                                                     failed_locs,
+                                                     pq_pivots_stream,
+                                                     disk_pq_compressed_vectors,
+                                                     metric_,
+                                                     p_val_,
+                                                     disk_pq_dims_,
+                                                     use_opq_,
+                                                     use_bsa_);
+    }
+    {
+        SlowTaskTimer t("diskann build full (disk layout)");
+        diskann::create_disk_layout<float>(vectors,
+                                           data_num,
+                                           dim_,
+                                           failed_locs,
+                                           graph_stream,
+                                           disk_layout_stream,
+                                           sector_len_,
+                                           metric_,
+                                           sector_vector_type_);
+    }
+    return failed_locs;
+}
+
 tl::expected<DatasetPtr, Error>
 DiskANN::knn_search(const DatasetPtr& query,
                     int64_t k,
@@ -387,6 +639,7 @@ DiskANN::knn_search(const DatasetPtr& query,
         beam_search = std::min(beam_search, MAXIMAL_BEAM_SEARCH);
         beam_search = std::max(beam_search, MINIMAL_BEAM_SEARCH);
 
+        auto request_k = k;
         uint64_t labels[query_num * k];
         auto* distances = new float[query_num * k];
         auto* ids = new int64_t[query_num * k];
@@ -397,6 +650,13 @@ DiskANN::knn_search(const DatasetPtr& query,
                 {
                     std::shared_lock lock(rw_mutex_);
                     Timer timer(time_cost);
+                    // resolved under the lock, a merge moves and frees disk locations; the
+                    // preloaded graph walks keep their own entry logic
+                    std::vector<uint32_t> entry_points;
+                    if (!preload_) {
+                        entry_points = resolve_entry_points(params.entry_ids);
+                    }
+                    auto search_filter = with_deleted_filter(filter);
                     if (preload_) {
                         if (use_async_io_) {
                             k = index_->cached_beam_search_async(
@@ -406,7 +666,7 @@ DiskANN::knn_search(const DatasetPtr& query,
                                 labels + i * k,
                                 distances + i * k,
                                 beam_search,
-                                filter,
+                                search_filter,
                                 io_limit,
                                 reorder,
                                 query_stats + i);
@@ -418,11 +678,25 @@ DiskANN::knn_search(const DatasetPtr& query,
                                 labels + i * k,
                                 distances + i * k,
                                 beam_search,
-                                filter,
+                                search_filter,
                                 io_limit,
                                 reorder,
                                 query_stats + i);
                         }
+                    } else if (use_async_io_) {
+                        // overlap sector reads with node expansion
+                        k = index_->cached_beam_search_pipeline(
+                            query->GetFloat32Vectors() + i * dim_,
+                            k,
+                            ef_search,
+                            labels + i * k,
+                            distances + i * k,
+                            beam_search,
+                            search_filter,
+                            io_limit,
+                            reorder,
+                            query_stats + i,
+                            entry_points);
                     } else {
                         k = index_->cached_beam_search(query->GetFloat32Vectors() + i * dim_,
                                                        k,
@@ -430,15 +704,27 @@ DiskANN::knn_search(const DatasetPtr& query,
                                                        labels + i * k,
                                                        distances + i * k,
                                                        beam_search,
-                                                       filter,
+                                                       search_filter,
                                                        io_limit,
-                                                       false,
-                                                       query_stats + i);
+                                                       reorder,
+                                                       query_stats + i,
+                                                       entry_points);
+                    }
+                    if (not delta_ids_.empty()) {
+                        k = merge_delta_results(query->GetFloat32Vectors() + i * dim_,
+                                                request_k,
+                                                ef_search,
+                                                search_filter,
+                                                k,
+                                                labels + i * k,
+                                                distances + i * k);
                     }
                 }
                 {
                     std::lock_guard<std::mutex> lock(stats_mutex_);
                     result_queues_[STATSTIC_KNN_IO].Push(static_cast<float>(query_stats[i].n_ios));
+                    result_queues_[STATSTIC_KNN_CACHE_HIT].Push(
+                        static_cast<float>(query_stats[i].n_cache_hits));
                     result_queues_[STATSTIC_KNN_TIME].Push(static_cast<float>(time_cost));
                     result_queues_[STATSTIC_KNN_IO_TIME].Push(
                         (query_stats[i].io_us / static_cast<float>(query_stats[i].n_ios)) /
@@ -556,6 +842,12 @@ DiskANN::range_search(const DatasetPtr& query,
             {
                 std::shared_lock lock(rw_mutex_);
                 Timer timer(time_cost);
+                // resolved under the lock, a merge moves and frees disk locations
+                std::vector<uint32_t> entry_points;
+                if (!preload_) {
+                    entry_points = resolve_entry_points(params.entry_ids);
+                }
+                auto search_filter = with_deleted_filter(filter);
                 index_->range_search(query->GetFloat32Vectors(),
                                      radius,
                                      ef_search,
@@ -565,9 +857,18 @@ DiskANN::range_search(const DatasetPtr& query,
                                      beam_search,
                                      io_limit,
                                      reorder,
-                                     filter,
+                                     search_filter,
                                      preload_,
-                                     &query_stats);
+                                     &query_stats,
+                                     entry_points);
+                if (not delta_ids_.empty()) {
+                    range_search_delta(query->GetFloat32Vectors(),
+                                       radius,
+                                       ef_search,
+                                       search_filter,
+                                       labels,
+                                       range_distances);
+                }
             }
             {
                 std::lock_guard<std::mutex> lock(stats_mutex_);
@@ -645,6 +946,8 @@ DiskANN::serialize() const {
     }
 
     SlowTaskTimer t("diskann serialize");
+    // a running merge would make the serialized layout stale right away
+    wait_for_merge();
     try {
         std::shared_lock lock(rw_mutex_);
         BinarySet bs;
@@ -656,12 +959,110 @@ DiskANN::serialize() const {
         if (preload_) {
             bs.Set(DISKANN_GRAPH, convert_stream_to_binary(graph_stream_));
         }
+        std::vector<uint32_t> cache_nodes;
+        index_->get_cache_list(cache_nodes);
+        if (not cache_nodes.empty()) {
+            bs.Set(DISKANN_CACHE_NODES, serialize_vector_to_binary<uint32_t>(cache_nodes));
+        }
+        if (not delta_ids_.empty()) {
+            std::vector<float> delta_vectors(delta_ids_.size() * dim_);
+            for (size_t i = 0; i < delta_ids_.size(); ++i) {
+                const auto* vector = delta_index_->getDataByLabel(delta_ids_[i]);
+                std::memcpy(delta_vectors.data() + i * dim_, vector, dim_ * sizeof(float));
+            }
+            bs.Set(DISKANN_DELTA_IDS, serialize_vector_to_binary<int64_t>(delta_ids_));
+            bs.Set(DISKANN_DELTA_VECTORS, serialize_vector_to_binary<float>(delta_vectors));
+        }
+        if (not deleted_ids_.empty()) {
+            bs.Set(DISKANN_DELETED_IDS,
+                   serialize_vector_to_binary<int64_t>(
+                       std::vector<int64_t>(deleted_ids_.begin(), deleted_ids_.end())));
+        }
         return bs;
     } catch (const std::bad_alloc& e) {
         return tl::unexpected(Error(ErrorType::NO_ENOUGH_MEMORY, ""));
     }
 }
 
+tl::expected<void, Error>
+DiskANN::serialize(const WriteFuncType& write_func) const {
+    WriteFuncStreamWriter writer(write_func, 0);
+    if (status_ == IndexStatus::EMPTY) {
+        StreamWriter::WriteBinarySet(writer, empty_binaryset());
+        return {};
+    }
+
+    SlowTaskTimer t("diskann serialize");
+    wait_for_merge();
+    std::shared_lock lock(rw_mutex_);
+    // the same sections as serialize(), streamed one after another
+    write_stream_section(writer, DISKANN_PQ, pq_pivots_stream_);
+    write_stream_section(writer, DISKANN_COMPRESSED_VECTOR, disk_pq_compressed_vectors_);
+    write_stream_section(writer, DISKANN_LAYOUT_FILE, disk_layout_stream_);
+    write_stream_section(writer, DISKANN_TAG_FILE, tag_stream_);
+    if (preload_) {
+        write_stream_section(writer, DISKANN_GRAPH, graph_stream_);
+    }
+    std::vector<uint32_t> cache_nodes;
+    index_->get_cache_list(cache_nodes);
+    if (not cache_nodes.empty()) {
+        write_vector_section(writer, DISKANN_CACHE_NODES, cache_nodes);
+    }
+    if (not delta_ids_.empty()) {
+        write_vector_section(writer, DISKANN_DELTA_IDS, delta_ids_);
+        StreamWriter::WriteSectionHeader(
+            writer, DISKANN_DELTA_VECTORS, delta_ids_.size() * dim_ * sizeof(float));
+        for (auto id : delta_ids_) {
+            const auto* vector = delta_index_->getDataByLabel(id);
+            writer.Write(reinterpret_cast<const char*>(vector), dim_ * sizeof(float));
+        }
+    }
+    if (not deleted_ids_.empty()) {
+        write_vector_section(writer,
+                             DISKANN_DELETED_IDS,
+                             std::vector<int64_t>(deleted_ids_.begin(), deleted_ids_.end()));
+    }
+    return {};
+}
+
+uint64_t
+DiskANN::CalSerializeSize() const {
+    if (status_ == IndexStatus::EMPTY) {
+        return StreamWriter::BinarySetSize(empty_binaryset());
+    }
+
+    wait_for_merge();
+    std::shared_lock lock(rw_mutex_);
+    // the sections of serialize(write_func)
+    auto stream_section_size = [](const std::string& key, const std::stringstream& stream) {
+        return StreamWriter::SectionHeaderSize(key) + static_cast<uint64_t>(stream_size(stream));
+    };
+    uint64_t size = stream_section_size(DISKANN_PQ, pq_pivots_stream_) +
+                    stream_section_size(DISKANN_COMPRESSED_VECTOR, disk_pq_compressed_vectors_) +
+                    stream_section_size(DISKANN_LAYOUT_FILE, disk_layout_stream_) +
+                    stream_section_size(DISKANN_TAG_FILE, tag_stream_);
+    if (preload_) {
+        size += stream_section_size(DISKANN_GRAPH, graph_stream_);
+    }
+    std::vector<uint32_t> cache_nodes;
+    index_->get_cache_list(cache_nodes);
+    if (not cache_nodes.empty()) {
+        size += StreamWriter::SectionHeaderSize(DISKANN_CACHE_NODES) +
+                cache_nodes.size() * sizeof(uint32_t);
+    }
+    if (not delta_ids_.empty()) {
+        size += StreamWriter::SectionHeaderSize(DISKANN_DELTA_IDS) +
+                delta_ids_.size() * sizeof(delta_ids_[0]) +
+                StreamWriter::SectionHeaderSize(DISKANN_DELTA_VECTORS) +
+                delta_ids_.size() * dim_ * sizeof(float);
+    }
+    if (not deleted_ids_.empty()) {
+        size += StreamWriter::SectionHeaderSize(DISKANN_DELETED_IDS) +
+                deleted_ids_.size() * sizeof(int64_t);
+    }
+    return size;
+}
+
 tl::expected<void, Error>
 DiskANN::deserialize(const BinarySet& binary_set) {
     SlowTaskTimer t("diskann deserialize");
@@ -693,6 +1094,15 @@ DiskANN::deserialize(const BinarySet& binary_set) {
         }
     }
     load_disk_index(binary_set);
+    warm_cache(deserialize_vector_from_binary<uint32_t>(binary_set.Get(DISKANN_CACHE_NODES)));
+    auto delta_ids = deserialize_vector_from_binary<int64_t>(binary_set.Get(DISKANN_DELTA_IDS));
+    if (not delta_ids.empty()) {
+        auto delta_vectors =
+            deserialize_vector_from_binary<float>(binary_set.Get(DISKANN_DELTA_VECTORS));
+        load_delta(delta_ids, delta_vectors.data());
+    }
+    auto deleted_ids = deserialize_vector_from_binary<int64_t>(binary_set.Get(DISKANN_DELETED_IDS));
+    deleted_ids_.insert(deleted_ids.begin(), deleted_ids.end());
     status_ = IndexStatus::MEMORY;
 
     return {};
@@ -769,6 +1179,15 @@ DiskANN::deserialize(const ReaderSet& reader_set) {
             logger::warn("serialize without using file: {} ", DISKANN_GRAPH);
         }
     }
+
+    warm_cache(read_vector_from_reader<uint32_t>(reader_set.Get(DISKANN_CACHE_NODES)));
+    auto delta_ids = read_vector_from_reader<int64_t>(reader_set.Get(DISKANN_DELTA_IDS));
+    if (not delta_ids.empty()) {
+        auto delta_vectors = read_vector_from_reader<float>(reader_set.Get(DISKANN_DELTA_VECTORS));
+        load_delta(delta_ids, delta_vectors.data());
+    }
+    auto deleted_ids = read_vector_from_reader<int64_t>(reader_set.Get(DISKANN_DELETED_IDS));
+    deleted_ids_.insert(deleted_ids.begin(), deleted_ids.end());
     status_ = IndexStatus::HYBRID;
 
     return {};
@@ -788,16 +1207,458 @@ DiskANN::GetStats() const {
         }
     }
 
+    auto io_stats = io_scheduler_->GetStats();
+    j[STATSTIC_IO_QUEUE_DEPTH] = io_stats.queue_depth;
+    j[STATSTIC_IO_MAX_QUEUE_DEPTH] = io_stats.max_queue_depth;
+    j[STATSTIC_IO_DEVICE_READS] = io_stats.device_reads;
+    j[STATSTIC_IO_SHARED_READS] = io_stats.shared_reads;
+    j[STATSTIC_IO_COALESCED_READS] = io_stats.coalesced_reads;
+
     return j.dump();
 }
 
+tl::expected<uint32_t, Error>
+DiskANN::feedback(const DatasetPtr& query, const std::string& parameters) {
+    if (cache_size_ == 0) {
+        LOG_ERROR_AND_RETURNS(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                              "no node cache used for feedback");
+    }
+    if (empty_index_) {
+        return 0;
+    }
+    if (!index_) {
+        LOG_ERROR_AND_RETURNS(ErrorType::INDEX_EMPTY, "failed to feedback: diskann index is empty");
+    }
+    try {
+        CHECK_ARGUMENT(
+            query->GetDim() == dim_,
+            fmt::format("query.dim({}) must be equal to index.dim({})", query->GetDim(), dim_));
+
+        auto params = DiskannSearchParameters::FromJson(parameters);
+        auto ef_search = static_cast<uint64_t>(std::min(params.ef_search, GetNumElements()));
+        auto beam_search =
+            std::max(std::min(params.beam_search, MAXIMAL_BEAM_SEARCH), MINIMAL_BEAM_SEARCH);
+        auto num_nodes =
+            std::min(static_cast<uint64_t>(cache_size_) / index_->get_cached_node_size(),
+                     static_cast<uint64_t>(GetNumElements()));
+
+        // searches are blocked while the visit counters and the cache are rebuilt
+        std::unique_lock lock(rw_mutex_);
+        std::vector<uint32_t> node_list;
+        index_->generate_cache_list_from_queries(query->GetFloat32Vectors(),
+                                                 query->GetNumElements(),
+                                                 ef_search,
+                                                 beam_search,
+                                                 static_cast<uint32_t>(params.io_limit),
+                                                 num_nodes,
+                                                 node_list);
+        index_->load_cache_list(node_list);
+        return static_cast<uint32_t>(node_list.size());
+    } catch (const std::invalid_argument& e) {
+        LOG_ERROR_AND_RETURNS(
+            ErrorType::INVALID_ARGUMENT, "failed to feedback(invalid argument): ", e.what());
+    }
+}
+
+void
+DiskANN::warm_cache(std::vector<uint32_t> node_list) {
+    if (cache_size_ == 0 || !index_) {
+        return;
+    }
+    SlowTaskTimer t("diskann warm cache");
+    auto num_nodes = std::min(static_cast<uint64_t>(cache_size_) / index_->get_cached_node_size(),
+                              index_->get_data_num());
+    // without a recorded hot set, cache the levels around the medoid
+    if (node_list.empty()) {
+        index_->cache_bfs_levels(num_nodes, node_list);
+    }
+    if (node_list.size() > num_nodes) {
+        node_list.resize(num_nodes);
+    }
+    index_->load_cache_list(node_list);
+}
+
+tl::expected<std::vector<int64_t>, Error>
+DiskANN::add(const DatasetPtr& base) {
+#ifndef ENABLE_TESTS
+    SlowTaskTimer t("diskann add", 20);
+#endif
+    try {
+        auto base_dim = base->GetDim();
+        CHECK_ARGUMENT(base_dim == dim_,
+                       fmt::format("base.dim({}) must be equal to index.dim({})", base_dim, dim_));
+
+        const auto* vectors = base->GetFloat32Vectors();
+        const auto* ids = base->GetIds();
+        auto data_num = base->GetNumElements();
+        std::vector<int64_t> failed_ids;
+        {
+            std::unique_lock lock(rw_mutex_);
+            if (!index_ || status_ == IndexStatus::BUILDING) {
+                LOG_ERROR_AND_RETURNS(ErrorType::INDEX_EMPTY,
+                                      "failed to add: diskann index is not built");
+            }
+            if (!delta_index_) {
+                reset_delta();
+            }
+            for (int64_t i = 0; i < data_num; ++i) {
+                // a deleted id cannot be reused until the merge drops it from the disk layout
+                // the largest id marks the free locations of the disk layout
+                if (ids[i] == std::numeric_limits<int64_t>::max() || on_disk(ids[i]) ||
+                    is_deleted(ids[i]) ||
+                    !delta_index_->addPoint(vectors + i * dim_, ids[i])) {
+                    logger::debug("duplicate point: {}", ids[i]);
+                    failed_ids.push_back(ids[i]);
+                    continue;
+                }
+                delta_ids_.push_back(ids[i]);
+            }
+        }
+        try_trigger_merge();
+        return failed_ids;
+    } catch (const std::invalid_argument& e) {
+        LOG_ERROR_AND_RETURNS(
+            ErrorType::INVALID_ARGUMENT, "failed to add(invalid argument): ", e.what());
+    }
+}
+
+tl::expected<bool, Error>
+DiskANN::remove(int64_t id) {
+    {
+        std::unique_lock lock(rw_mutex_);
+        if (!index_ || status_ == IndexStatus::BUILDING) {
+            LOG_ERROR_AND_RETURNS(ErrorType::INDEX_EMPTY,
+                                  "failed to remove: diskann index is not built");
+        }
+        bool exists = on_disk(id) || (delta_index_ && delta_index_->isValidLabel(id));
+        if (!exists || is_deleted(id)) {
+            return false;
+        }
+        deleted_ids_.insert(id);
+    }
+    try_trigger_merge();
+    return true;
+}
+
+void
+DiskANN::reset_delta() {
+    if (!delta_space_) {
+        delta_space_ = std::make_shared<hnswlib::L2Space>(dim_);
+    }
+    delta_index_ =
+        std::make_shared<hnswlib::HierarchicalNSW>(delta_space_.get(),
+                                                   DELTA_MAX_ELEMENT,
+                                                   common_param_.allocator_.get(),
+                                                   std::max(R_ / 2, MINIMAL_R),
+                                                   L_,
+                                                   false,
+                                                   metric_ == diskann::Metric::COSINE,
+                                                   Options::Instance().block_size_limit());
+    delta_index_->init_memory_space();
+    delta_ids_.clear();
+}
+
+void
+DiskANN::load_delta(const std::vector<int64_t>& ids, const float* vectors) {
+    reset_delta();
+    for (size_t i = 0; i < ids.size(); ++i) {
+        delta_index_->addPoint(vectors + i * dim_, ids[i]);
+    }
+    delta_ids_ = ids;
+}
+
+void
+DiskANN::load_disk_locations() const {
+    if (!disk_locations_.empty() || !index_) {
+        return;
+    }
+    const auto* tags = index_->get_tags();
+    auto data_num = index_->get_data_num();
+    disk_locations_.reserve(data_num);
+    for (uint32_t loc = 0; loc < data_num; ++loc) {
+        // locations freed by a merge wait for the next insert
+        if (tags[loc] != diskann::PQFlashIndex<float, int64_t>::FREE_LOCATION_TAG) {
+            disk_locations_.emplace(tags[loc], loc);
+        }
+    }
+}
+
+bool
+DiskANN::on_disk(int64_t id) const {
+    std::lock_guard<std::mutex> lock(disk_locations_mutex_);
+    load_disk_locations();
+    return disk_locations_.count(id) > 0;
+}
+
+std::vector<uint32_t>
+DiskANN::resolve_entry_points(const std::vector<int64_t>& entry_ids) const {
+    std::vector<uint32_t> entry_points;
+    if (entry_ids.empty()) {
+        return entry_points;
+    }
+    std::lock_guard<std::mutex> lock(disk_locations_mutex_);
+    load_disk_locations();
+    entry_points.reserve(entry_ids.size());
+    for (auto id : entry_ids) {
+        // ids still in the delta graph or already deleted cannot seed the disk walk
+        auto iter = disk_locations_.find(id);
+        if (iter != disk_locations_.end() && !is_deleted(id)) {
+            entry_points.push_back(iter->second);
+        }
+    }
+    return entry_points;
+}
+
+bool
+DiskANN::is_deleted(int64_t id) const {
+    return deleted_ids_.count(id) > 0;
+}
+
+std::function<bool(int64_t)>
+DiskANN::with_deleted_filter(const std::function<bool(int64_t)>& filter) const {
+    if (deleted_ids_.empty()) {
+        return filter;
+    }
+    return [this, filter](int64_t id) -> bool {
+        return this->is_deleted(id) || (filter && filter(id));
+    };
+}
+
+int64_t
+DiskANN::merge_delta_results(const float* query,
+                             int64_t k,
+                             int64_t ef_search,
+                             const std::function<bool(int64_t)>& filter,
+                             int64_t disk_result_num,
+                             uint64_t* labels,
+                             float* distances) const {
+    FilterPtr delta_filter = nullptr;
+    if (filter) {
+        delta_filter = std::make_shared<UniqueFilter>(filter);
+    }
+    auto delta_result = delta_index_->searchKnn(query, k, std::max(ef_search, k), delta_filter);
+
+    std::vector<std::pair<float, uint64_t>> candidates;
+    candidates.reserve(disk_result_num + delta_result.size());
+    for (int64_t i = 0; i < disk_result_num; ++i) {
+        candidates.emplace_back(distances[i], labels[i]);
+    }
+    bool half_distance =
+        metric_ == diskann::Metric::INNER_PRODUCT || metric_ == diskann::Metric::COSINE;
+    while (not delta_result.empty()) {
+        auto [distance, label] = delta_result.top();
+        // align with the disk results, which halve the l2 distance for ip and cosine
+        candidates.emplace_back(half_distance ? distance / 2 : distance, label);
+        delta_result.pop();
+    }
+
+    auto result_num = std::min(k, static_cast<int64_t>(candidates.size()));
+    std::partial_sort(candidates.begin(), candidates.begin() + result_num, candidates.end());
+    for (int64_t i = 0; i < result_num; ++i) {
+        distances[i] = candidates[i].first;
+        labels[i] = candidates[i].second;
+    }
+    return result_num;
+}
+
+void
+DiskANN::range_search_delta(const float* query,
+                            float radius,
+                            int64_t ef_search,
+                            const std::function<bool(int64_t)>& filter,
+                            std::vector<uint64_t>& labels,
+                            std::vector<float>& distances) const {
+    FilterPtr delta_filter = nullptr;
+    if (filter) {
+        delta_filter = std::make_shared<UniqueFilter>(filter);
+    }
+    bool half_distance =
+        metric_ == diskann::Metric::INNER_PRODUCT || metric_ == diskann::Metric::COSINE;
+    auto delta_result = delta_index_->searchRange(
+        query, half_distance ? radius * 2 : radius, ef_search, delta_filter);
+    if (delta_result.empty()) {
+        return;
+    }
+
+    std::vector<std::pair<float, uint64_t>> candidates;
+    candidates.reserve(labels.size() + delta_result.size());
+    for (size_t i = 0; i < labels.size(); ++i) {
+        candidates.emplace_back(distances[i], labels[i]);
+    }
+    while (not delta_result.empty()) {
+        auto [distance, label] = delta_result.top();
+        candidates.emplace_back(half_distance ? distance / 2 : distance, label);
+        delta_result.pop();
+    }
+    std::sort(candidates.begin(), candidates.end());
+    labels.resize(candidates.size());
+    distances.resize(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        distances[i] = candidates[i].first;
+        labels[i] = candidates[i].second;
+    }
+}
+
+void
+DiskANN::try_trigger_merge() {
+    {
+        std::shared_lock lock(rw_mutex_);
+        if (static_cast<int64_t>(delta_ids_.size() + deleted_ids_.size()) < merge_threshold_) {
+            return;
+        }
+    }
+    bool expected = false;
+    if (not merge_running_.compare_exchange_strong(expected, true)) {
+        return;
+    }
+    if (common_param_.thread_pool_ == nullptr) {
+        this->merge();
+        return;
+    }
+    std::lock_guard<std::mutex> lock(merge_future_mutex_);
+    merge_future_ = common_param_.thread_pool_->GeneralEnqueue([this]() { this->merge(); });
+}
+
+void
+DiskANN::merge() {
+    SlowTaskTimer t("diskann merge");
+    try {
+        // snapshot the delta and the deletes, updates after this point stay in memory
+        std::shared_ptr<diskann::PQFlashIndex<float, int64_t>> index;
+        std::shared_ptr<Reader> layout_reader;
+        std::unordered_set<int64_t> merged_deleted_ids;
+        size_t merged_delta_num = 0;
+        std::vector<int64_t> merged_ids;
+        std::vector<float> merged_vectors;
+        {
+            std::shared_lock lock(rw_mutex_);
+            index = index_;
+            layout_reader = disk_layout_reader_;
+            merged_deleted_ids = deleted_ids_;
+            merged_delta_num = delta_ids_.size();
+            for (auto id : delta_ids_) {
+                if (is_deleted(id)) {
+                    continue;
+                }
+                const auto* vector = delta_index_->getDataByLabel(id);
+                merged_ids.push_back(id);
+                merged_vectors.insert(merged_vectors.end(), vector, vector + dim_);
+            }
+        }
+
+        auto live_num = static_cast<int64_t>(index->get_data_num() - index->get_free_num());
+        for (auto id : merged_deleted_ids) {
+            live_num -= on_disk(id) ? 1 : 0;
+        }
+        if (live_num + static_cast<int64_t>(merged_ids.size()) < DATA_LIMIT) {
+            logger::warn("skip diskann merge: only {} vectors left", live_num + merged_ids.size());
+            merge_running_.store(false);
+            return;
+        }
+
+        // only the delta and the neighborhoods of deleted nodes are touched, the layout is read
+        // inline: the io scheduler may wait on the pool this merge is running on
+        auto read_layout = [&layout_reader](uint64_t offset, uint64_t len, void* dest) {
+            layout_reader->Read(offset, len, dest);
+        };
+        auto plan = index->plan_merge(merged_deleted_ids,
+                                      merged_ids.data(),
+                                      merged_vectors.data(),
+                                      merged_ids.size(),
+                                      L_,
+                                      diskann_params_.alpha,
+                                      layout_reader->Size(),
+                                      read_layout);
+        std::unordered_set<int64_t> placed(plan.placed.begin(), plan.placed.end());
+        if (placed.size() < merged_ids.size()) {
+            logger::warn("{} vectors stay in the delta: the disk layout can not address more",
+                         merged_ids.size() - placed.size());
+        }
+
+        std::unique_lock lock(rw_mutex_);
+        // the patched sectors go back to the storage the index reads from
+        auto writable = std::dynamic_pointer_cast<WritableReader>(disk_layout_reader_);
+        if (writable == nullptr) {
+            writable = std::make_shared<PatchedReader>(disk_layout_reader_, sector_len_);
+            disk_layout_reader_ = writable;
+        }
+        bool in_memory = status_ == IndexStatus::MEMORY;
+        index_->apply_merge(plan, [&](uint64_t offset, uint64_t len, const void* src) {
+            writable->Write(offset, len, src);
+            if (in_memory) {
+                disk_layout_stream_.seekp(static_cast<int64_t>(offset), std::ios::beg);
+                disk_layout_stream_.write((const char*)src, static_cast<int64_t>(len));
+            }
+        });
+        if (in_memory) {
+            tag_stream_.str("");
+            index_->save_tags(tag_stream_);
+            disk_pq_compressed_vectors_.str("");
+            index_->save_compressed_vectors(disk_pq_compressed_vectors_);
+            if (preload_) {
+                graph_stream_.str("");
+                index_->save_graph(graph_stream_);
+            }
+        }
+
+        std::vector<int64_t> delta_ids;
+        for (auto id : merged_ids) {
+            if (placed.count(id) == 0) {
+                delta_ids.push_back(id);
+            }
+        }
+        delta_ids.insert(delta_ids.end(),
+                         delta_ids_.begin() + static_cast<int64_t>(merged_delta_num),
+                         delta_ids_.end());
+        std::vector<float> delta_vectors(delta_ids.size() * dim_);
+        for (size_t i = 0; i < delta_ids.size(); ++i) {
+            const auto* vector = delta_index_->getDataByLabel(delta_ids[i]);
+            std::memcpy(delta_vectors.data() + i * dim_, vector, dim_ * sizeof(float));
+        }
+        load_delta(delta_ids, delta_vectors.data());
+        for (auto id : merged_deleted_ids) {
+            deleted_ids_.erase(id);
+        }
+        {
+            std::lock_guard<std::mutex> lock(disk_locations_mutex_);
+            disk_locations_.clear();
+        }
+    } catch (const std::exception& e) {
+        logger::error("failed to merge diskann: {}", e.what());
+    }
+    merge_running_.store(false);
+}
+
+void
+DiskANN::wait_for_merge() const {
+    std::future<void> future;
+    {
+        std::lock_guard<std::mutex> lock(merge_future_mutex_);
+        future = std::move(merge_future_);
+    }
+    if (future.valid()) {
+        future.get();
+    }
+}
+
 int64_t
 DiskANN::GetEstimateBuildMemory(const int64_t num_elements) const {
     int64_t estimate_memory_usage = 0;
     // Memory usage of graph (1.365 is the relaxation factor used by DiskANN during graph construction.)
-    estimate_memory_usage += (num_elements * R_ * sizeof(uint32_t)  // NOLINT
-                              + num_elements * (R_ + 1) * sizeof(uint32_t)) *
-                             GRAPH_SLACK;
+    auto graph_memory = static_cast<int64_t>(num_elements * R_ * sizeof(uint32_t) * GRAPH_SLACK);
+    if (build_memory_budget_ > 0 &&
+        diskann::estimate_ram_usage(num_elements, dim_, sizeof(float), R_) >
+            static_cast<double>(build_memory_budget_)) {
+        // a partitioned build holds one shard graph at a time, sized to the budget, plus the shard
+        // assignment of every point (two shards each) while the spilled shard graphs are merged
+        graph_memory = build_memory_budget_ +
+                       static_cast<int64_t>(num_elements * 2 * (sizeof(uint32_t) +  // NOLINT
+                                                                2 * sizeof(uint32_t)));
+    }
+    estimate_memory_usage += graph_memory;
+    // the saved graph
+    estimate_memory_usage +=
+        static_cast<int64_t>(num_elements * (R_ + 1) * sizeof(uint32_t) * GRAPH_SLACK);
     // Memory usage of disk layout
     if (sector_len_ > MINIMAL_SECTOR_LEN) {
         estimate_memory_usage +=
@@ -822,68 +1683,33 @@ DiskANN::GetEstimateBuildMemory(const int64_t num_elements) const {
     return estimate_memory_usage;
 }
 
-template <typename Container>
-Binary
-serialize_to_binary(const Container& container) {
-    using ValueType = typename Container::value_type;
-    size_t total_size = container.size() * sizeof(ValueType);
-    std::shared_ptr<int8_t[]> raw_data(new int8_t[total_size], std::default_delete<int8_t[]>());
-
-    int8_t* data_ptr = raw_data.get();
-    for (const ValueType& value : container) {
-        std::memcpy(data_ptr, &value, sizeof(ValueType));
-        data_ptr += sizeof(ValueType);
+// shards are stored flattened as [shard_num, shard sizes..., shard ids...]
+static Binary
+serialize_shards_to_binary(const std::vector<std::vector<uint32_t>>& shard_ids) {
+    std::vector<uint32_t> flat;
+    flat.push_back(static_cast<uint32_t>(shard_ids.size()));
+    for (const auto& shard : shard_ids) {
+        flat.push_back(static_cast<uint32_t>(shard.size()));
     }
-
-    Binary binary_data{raw_data, total_size};
-    return binary_data;
-}
-
-template <typename Container>
-Container
-deserialize_from_binary(const Binary& binary_data) {
-    using ValueType = typename Container::value_type;
-
-    Container deserialized_container;
-    const int8_t* data_ptr = binary_data.data.get();
-    size_t num_elements = binary_data.size / sizeof(ValueType);
-
-    for (size_t i = 0; i < num_elements; ++i) {
-        ValueType value;
-        std::memcpy(&value, data_ptr, sizeof(ValueType));
-        deserialized_container.insert(deserialized_container.end(), value);
-        data_ptr += sizeof(ValueType);
+    for (const auto& shard : shard_ids) {
+        flat.insert(flat.end(), shard.begin(), shard.end());
     }
-
-    return std::move(deserialized_container);
+    return serialize_vector_to_binary<uint32_t>(flat);
 }
 
-template <typename T>
-Binary
-serialize_vector_to_binary(std::vector<T> data) {
-    if (data.empty()) {
-        return {};
+static std::vector<std::vector<uint32_t>>
+deserialize_shards_from_binary(const Binary& binary) {
+    auto flat = deserialize_vector_from_binary<uint32_t>(binary);
+    CHECK_ARGUMENT(not flat.empty(), "missing shards while partial building");
+    std::vector<std::vector<uint32_t>> shard_ids(flat[0]);
+    auto offset = 1 + shard_ids.size();
+    for (size_t i = 0; i < shard_ids.size(); ++i) {
+        auto size = flat[1 + i];
+        shard_ids[i].assign(flat.begin() + static_cast<int64_t>(offset),
+                            flat.begin() + static_cast<int64_t>(offset + size));
+        offset += size;
     }
-    size_t total_size = data.size() * sizeof(T);
-    std::shared_ptr<int8_t[]> raw_data(new int8_t[total_size], std::default_delete<int8_t[]>());
-    int8_t* data_ptr = raw_data.get();
-    std::memcpy(data_ptr, data.data(), total_size);
-    Binary binary_data{raw_data, total_size};
-    return binary_data;
-}
-
-template <typename T>
-std::vector<T>
-deserialize_vector_from_binary(const Binary& binary_data) {
-    std::vector<T> deserialized_container;
-    if (binary_data.size == 0) {
-        return std::move(deserialized_container);
-    }
-    const int8_t* data_ptr = binary_data.data.get();
-    size_t num_elements = binary_data.size / sizeof(T);
-    deserialized_container.resize(num_elements);
-    std::memcpy(deserialized_container.data(), data_ptr, num_elements * sizeof(T));
-    return std::move(deserialized_container);
+    return shard_ids;
 }
 
 tl::expected<Index::Checkpoint, Error>
@@ -906,23 +1732,25 @@ DiskANN::continue_build(const DatasetPtr& base, const BinarySet& binary_set) {
             LOG_ERROR_AND_RETURNS(ErrorType::BUILD_TWICE, "failed to build index: build twice");
         }
         status_ = IndexStatus::BUILDING;
-        BinarySet after_binary_set;
+        // sections of earlier checkpoints are shared rather than copied, a round only adds its own
+        BinarySet after_binary_set = binary_set;
         switch (build_status) {
             case BEGIN: {
+                SlowTaskTimer t("diskann build (partition)");
+                auto start = std::chrono::steady_clock::now();
+                partition_graph(base, after_binary_set);
+                int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      std::chrono::steady_clock::now() - start)
+                                      .count();
                 int round = 1;
-                SlowTaskTimer t(fmt::format("diskann build graph {}/{}", round, build_batch_num_));
-                build_status = BuildStatus::GRAPH;
-                build_partial_graph(base, binary_set, after_binary_set, round);
-                round++;
                 after_binary_set.Set(BUILD_CURRENT_ROUND, to_binary<int>(round));
+                after_binary_set.Set(BUILD_ELAPSED, to_binary<int64_t>(elapsed));
+                build_status = BuildStatus::GRAPH;
                 break;
             }
             case GRAPH: {
                 int round = from_binary<int>(binary_set.Get(BUILD_CURRENT_ROUND));
-                SlowTaskTimer t(
-                    fmt::format("diskann build (graph {}/{})", round, build_batch_num_));
-                build_partial_graph(base, binary_set, after_binary_set, round);
-                if (round < build_batch_num_) {
+                if (build_graph_shards(base, binary_set, after_binary_set, round)) {
                     round++;
                 } else {
                     build_status = BuildStatus::EDGE_PRUNE;
@@ -931,16 +1759,15 @@ DiskANN::continue_build(const DatasetPtr& base, const BinarySet& binary_set) {
                 break;
             }
             case EDGE_PRUNE: {
-                SlowTaskTimer t(fmt::format("diskann build (edge prune)"));
-                int round = from_binary<int>(binary_set.Get(BUILD_CURRENT_ROUND));
-                build_partial_graph(base, binary_set, after_binary_set, round);
+                SlowTaskTimer t(fmt::format("diskann build (merge shards)"));
+                merge_graph_shards(base, binary_set, after_binary_set);
                 build_status = BuildStatus::PQ;
                 break;
             }
             case PQ: {
                 SlowTaskTimer t(fmt::format("diskann build (pq)"));
                 auto failed_locs =
-                    deserialize_vector_from_binary<size_t>(after_binary_set.Get(BUILD_FAILED_LOC));
+                    deserialize_vector_from_binary<size_t>(binary_set.Get(BUILD_FAILED_LOC));
                 diskann::generate_disk_quantized_data<float>(base->GetFloat32Vectors(),
                                                              base->GetNumElements(),
                                                              dim_,
@@ -951,7 +1778,6 @@ DiskANN::continue_build(const DatasetPtr& base, const BinarySet& binary_set) {
                                                              p_val_,
                                                              disk_pq_dims_,
                                                              use_opq_);
-                after_binary_set = binary_set;
                 after_binary_set.Set(DISKANN_PQ, convert_stream_to_binary(pq_pivots_stream_));
                 after_binary_set.Set(DISKANN_COMPRESSED_VECTOR,
                                      convert_stream_to_binary(disk_pq_compressed_vectors_));
@@ -961,7 +1787,7 @@ DiskANN::continue_build(const DatasetPtr& base, const BinarySet& binary_set) {
             case DISK_LAYOUT: {
                 SlowTaskTimer t(fmt::format("diskann build (disk layout)"));
                 auto failed_locs =
-                    deserialize_vector_from_binary<size_t>(after_binary_set.Get(BUILD_FAILED_LOC));
+                    deserialize_vector_from_binary<size_t>(binary_set.Get(BUILD_FAILED_LOC));
                 convert_binary_to_stream(binary_set.Get(DISKANN_GRAPH), graph_stream_);
                 diskann::create_disk_layout<float>(base->GetFloat32Vectors(),
                                                    base->GetNumElements(),
@@ -970,8 +1796,10 @@ DiskANN::continue_build(const DatasetPtr& base, const BinarySet& binary_set) {
                                                    graph_stream_,
                                                    disk_layout_stream_,
                                                    sector_len_,
-                                                   metric_);
+                                                   metric_,
+                                                   sector_vector_type_);
                 load_disk_index(binary_set);
+                warm_cache({});
                 build_status = BuildStatus::FINISH;
                 status_ = IndexStatus::MEMORY;
                 break;
@@ -989,53 +1817,141 @@ DiskANN::continue_build(const DatasetPtr& base, const BinarySet& binary_set) {
     }
 }
 
-tl::expected<void, Error>
-DiskANN::build_partial_graph(const DatasetPtr& base,
-                             const BinarySet& binary_set,
-                             BinarySet& after_binary_set,
-                             int round) {
+void
+DiskANN::partition_graph(const DatasetPtr& base, BinarySet& after_binary_set) {
     const auto* vectors = base->GetFloat32Vectors();
     const auto* ids = base->GetIds();
     auto data_num = base->GetNumElements();
     std::vector<int64_t> tags(ids, ids + data_num);
-    {
-        // build graph
-        build_index_ = std::make_shared<diskann::Index<float, int64_t, int64_t>>(
-            metric_, dim_, data_num, false, true, false, false, 0, false);
 
-        std::unordered_set<uint32_t> builded_nodes;
-        if (round > 1) {
-            std::stringstream graph_stream;
-            std::stringstream tag_stream;
-            convert_binary_to_stream(binary_set.Get(DISKANN_GRAPH), graph_stream);
-            convert_binary_to_stream(binary_set.Get(DISKANN_TAG_FILE), tag_stream);
+    // every round builds a few shards, tiny datasets end up in a single shard
+    auto min_parts = std::min(build_batch_num_ * PARTIAL_BUILD_SHARDS_PER_ROUND,
+                              data_num / PARTIAL_BUILD_MIN_SHARD_SIZE);
+    min_parts = std::max<int64_t>(min_parts, 1);
+    auto sampling_rate = std::min(1.0, PARTITION_SAMPLE_NUM / static_cast<double>(data_num));
+    std::vector<uint32_t> valid_locs;
+    std::vector<std::vector<uint32_t>> shard_ids;
+    auto failed_locs =
+        diskann::partition_vamana_shards<float, int64_t>(vectors,
+                                                         data_num,
+                                                         dim_,
+                                                         tags,
+                                                         R_,
+                                                         sampling_rate,
+                                                         static_cast<double>(build_memory_budget_),
+                                                         min_parts,
+                                                         valid_locs,
+                                                         shard_ids);
+    after_binary_set.Set(BUILD_FAILED_LOC, serialize_vector_to_binary<size_t>(failed_locs));
+    after_binary_set.Set(BUILD_VALID_LOC, serialize_vector_to_binary<uint32_t>(valid_locs));
+    after_binary_set.Set(BUILD_SHARDS, serialize_shards_to_binary(shard_ids));
+}
 
-            build_index_->load(graph_stream, tag_stream, Options::Instance().num_threads_io(), L_);
-            builded_nodes =
-                deserialize_from_binary<std::unordered_set<uint32_t>>(binary_set.Get(BUILD_NODES));
+bool
+DiskANN::build_graph_shards(const DatasetPtr& base,
+                            const BinarySet& binary_set,
+                            BinarySet& after_binary_set,
+                            int round) {
+    auto start = std::chrono::steady_clock::now();
+    auto valid_locs = deserialize_vector_from_binary<uint32_t>(binary_set.Get(BUILD_VALID_LOC));
+    auto shard_ids = deserialize_shards_from_binary(binary_set.Get(BUILD_SHARDS));
+    int64_t shard_num = static_cast<int64_t>(shard_ids.size());
+    int64_t shards_per_round = (shard_num + build_batch_num_ - 1) / build_batch_num_;
+    int64_t round_num = (shard_num + shards_per_round - 1) / shards_per_round;
+    int64_t begin = (round - 1) * shards_per_round;
+    int64_t end = std::min(begin + shards_per_round, shard_num);
+    CHECK_ARGUMENT(begin < shard_num,
+                   fmt::format("round({}) is out of the {} graph rounds", round, round_num));
+    SlowTaskTimer t(fmt::format("diskann build (graph {}/{})", round, round_num));
+
+    // the shards of a round are built side by side on the pool, unless the memory budget only
+    // leaves room for one shard graph at a time
+    bool parallel = common_param_.thread_pool_ != nullptr && build_memory_budget_ == 0;
+    auto num_threads = static_cast<int64_t>(Options::Instance().num_threads_building());
+    auto shard_threads =
+        static_cast<uint32_t>(parallel ? std::max<int64_t>(1, num_threads / (end - begin))
+                                       : num_threads);
+    std::vector<std::stringstream> shard_graphs(end - begin);
+    auto build_shard = [&](int64_t i) {
+        diskann::build_vamana_shard<float, int64_t>(base->GetFloat32Vectors(),
+                                                    dim_,
+                                                    valid_locs,
+                                                    shard_ids[begin + i],
+                                                    metric_,
+                                                    L_,
+                                                    shard_num > 1 ? 2 * R_ / 3 : R_,
+                                                    shard_threads,
+                                                    shard_graphs[i]);
+    };
+    if (parallel) {
+        std::vector<std::future<void>> futures;
+        for (int64_t i = 0; i < end - begin; ++i) {
+            futures.push_back(common_param_.thread_pool_->GeneralEnqueue(build_shard, i));
+        }
+        for (auto& future : futures) {
+            future.get();
         }
+    } else {
+        for (int64_t i = 0; i < end - begin; ++i) {
+            build_shard(i);
+        }
+    }
+    // only the shards of this round are written, they are merged once all rounds are done
+    for (int64_t i = 0; i < end - begin; ++i) {
+        if (not shard_ids[begin + i].empty()) {
+            after_binary_set.Set(BUILD_SHARD_GRAPH + std::to_string(begin + i),
+                                 convert_stream_to_binary(shard_graphs[i]));
+        }
+    }
 
-        auto index_build_params = diskann::IndexWriteParametersBuilder(L_, R_)
-                                      .with_num_threads(Options::Instance().num_threads_building())
-                                      .build();
-        std::vector<size_t> failed_locs =
-            build_index_->build(vectors,
-                                dim_,
-                                index_build_params,
-                                tags,
-                                use_reference_,
-                                round,
-                                static_cast<int32_t>(build_batch_num_),
-                                &builded_nodes);
-        build_index_->save(graph_stream_, tag_stream_);
-        after_binary_set.Set(BUILD_NODES,
-                             serialize_to_binary<std::unordered_set<uint32_t>>(builded_nodes));
-        after_binary_set.Set(BUILD_FAILED_LOC, serialize_vector_to_binary<size_t>(failed_locs));
-        build_index_.reset();
+    // the elapsed time survives restarts in the checkpoint, the eta assumes even shards
+    int64_t elapsed = from_binary<int64_t>(binary_set.Get(BUILD_ELAPSED)) +
+                      std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    after_binary_set.Set(BUILD_ELAPSED, to_binary<int64_t>(elapsed));
+    double progress = static_cast<double>(end) / static_cast<double>(shard_num);
+    double eta = static_cast<double>(elapsed) / MACRO_TO_MILLI * (1 - progress) / progress;
+    logger::info("diskann build graph round {}/{}: {}/{} shards built ({:.1f}%), eta {:.1f}s",
+                 round,
+                 round_num,
+                 end,
+                 shard_num,
+                 progress * 100,
+                 eta);
+    return round < round_num;
+}
+
+void
+DiskANN::merge_graph_shards(const DatasetPtr& base,
+                            const BinarySet& binary_set,
+                            BinarySet& after_binary_set) {
+    const auto* ids = base->GetIds();
+    auto valid_locs = deserialize_vector_from_binary<uint32_t>(binary_set.Get(BUILD_VALID_LOC));
+    auto shard_ids = deserialize_shards_from_binary(binary_set.Get(BUILD_SHARDS));
+    std::vector<std::unique_ptr<std::iostream>> shard_graphs(shard_ids.size());
+    for (size_t i = 0; i < shard_ids.size(); ++i) {
+        auto section = binary_set.Get(BUILD_SHARD_GRAPH + std::to_string(i));
+        CHECK_ARGUMENT(shard_ids[i].empty() or section.data != nullptr,
+                       fmt::format("missing the graph of shard {} while partial building", i));
+        auto shard_graph = std::make_unique<std::stringstream>();
+        convert_binary_to_stream(section, *shard_graph);
+        shard_graphs[i] = std::move(shard_graph);
     }
+    graph_stream_.str("");
+    tag_stream_.str("");
+    diskann::merge_vamana_shards(shard_ids, shard_graphs, valid_locs.size(), R_, graph_stream_);
+    std::vector<int64_t> tags(valid_locs.size());
+    for (size_t i = 0; i < valid_locs.size(); ++i) {
+        tags[i] = ids[valid_locs[i]];
+    }
+    diskann::save_bin<int64_t>(tag_stream_, tags.data(), tags.size(), 1);
+
+    // the shard sections are dropped once they are merged
+    after_binary_set = BinarySet();
+    after_binary_set.Set(BUILD_FAILED_LOC, binary_set.Get(BUILD_FAILED_LOC));
     after_binary_set.Set(DISKANN_GRAPH, convert_stream_to_binary(graph_stream_));
     after_binary_set.Set(DISKANN_TAG_FILE, convert_stream_to_binary(tag_stream_));
-    return {};
 }
 
 tl::expected<void, Error>
@@ -1044,6 +1960,10 @@ DiskANN::load_disk_index(const BinarySet& binary_set) {
     reader_.reset(new LocalFileReader(batch_read_));
     index_.reset(
         new diskann::PQFlashIndex<float, int64_t>(reader_, metric_, sector_len_, dim_, use_bsa_));
+    {
+        std::lock_guard<std::mutex> lock(disk_locations_mutex_);
+        disk_locations_.clear();
+    }
 
     convert_binary_to_stream(binary_set.Get(DISKANN_COMPRESSED_VECTOR),
                              disk_pq_compressed_vectors_);
@@ -26,15 +26,21 @@
 #include <pq_flash_index.h>
 #pragma clang diagnostic pop
 
+#include <atomic>
 #include <functional>
+#include <future>
 #include <map>
 #include <nlohmann/json.hpp>
 #include <queue>
 #include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "../utils.h"
+#include "algorithm/hnswlib/hnswlib.h"
 #include "common.h"
+#include "diskann_io_scheduler.h"
 #include "diskann_zparameters.h"
 #include "logger.h"
 #include "typing.h"
@@ -57,18 +63,48 @@ public:
 
     DiskANN(DiskannParameters& diskann_params, const IndexCommonParam& index_common_param);
 
-    ~DiskANN() = default;
+    ~DiskANN() override {
+        this->wait_for_merge();
+    }
 
     tl::expected<std::vector<int64_t>, Error>
     Build(const DatasetPtr& base) override {
         SAFE_CALL(return this->build(base));
     }
 
+    /**
+     * @brief Builds the index in checkpointed rounds
+     *
+     * The first round partitions the base into kmeans shards, each graph round builds a few
+     * shards side by side on the thread pool, then the shards are merged once before pq training
+     * and the disk layout. A checkpoint shares the sections of the previous one and a graph round
+     * only adds the sections of its own shards. A section is never rewritten once written, so a
+     * caller persists only the keys that are new in a checkpoint.
+     */
     tl::expected<Checkpoint, Error>
     ContinueBuild(const DatasetPtr& base, const BinarySet& binary_set) override {
         SAFE_CALL(return this->continue_build(base, binary_set));
     }
 
+    /**
+     * @brief Inserts vectors into the in-memory delta graph of a built index
+     *
+     * The delta is merged into the disk layout in the background once the buffered inserts and
+     * deletes reach the merge_threshold build parameter.
+     */
+    tl::expected<std::vector<int64_t>, Error>
+    Add(const DatasetPtr& base) override {
+        SAFE_CALL(return this->add(base));
+    }
+
+    /**
+     * @brief Marks the id as deleted, the vector is dropped from the disk layout by the next merge
+     */
+    tl::expected<bool, Error>
+    Remove(int64_t id) override {
+        SAFE_CALL(return this->remove(id));
+    }
+
     tl::expected<DatasetPtr, Error>
     KnnSearch(const DatasetPtr& query,
               int64_t k,
@@ -112,12 +148,34 @@ public:
         SAFE_CALL(return this->range_search(query, radius, parameters, invalid, limited_size));
     }
 
+    /**
+     * @brief Replays the sample queries on the disk path and caches the most visited nodes
+     *
+     * The node cache is sized by the cache_size build parameter, the result is the number of
+     * cached nodes. k and global_optimum_tag_id are not used.
+     */
+    tl::expected<uint32_t, Error>
+    Feedback(const DatasetPtr& query,
+             int64_t k,
+             const std::string& parameters,
+             int64_t global_optimum_tag_id = std::numeric_limits<int64_t>::max()) override {
+        SAFE_CALL(return this->feedback(query, parameters));
+    }
+
 public:
     tl::expected<BinarySet, Error>
     Serialize() const override {
         SAFE_CALL(return this->serialize());
     }
 
+    tl::expected<void, Error>
+    Serialize(WriteFuncType write_func) const override {
+        SAFE_CALL(return this->serialize(write_func));
+    }
+
+    [[nodiscard]] uint64_t
+    CalSerializeSize() const override;
+
     tl::expected<void, Error>
     Deserialize(const BinarySet& binary_set) override {
         SAFE_CALL(return this->deserialize(binary_set));
@@ -133,7 +191,9 @@ public:
     GetNumElements() const override {
         if (status_ == EMPTY)
             return 0;
-        return index_->get_data_num();
+        std::shared_lock lock(rw_mutex_);
+        return static_cast<int64_t>(index_->get_data_num() - index_->get_free_num() +
+                                    delta_ids_.size() - deleted_ids_.size());
     }
 
     int64_t
@@ -161,6 +221,12 @@ private:
     tl::expected<Checkpoint, Error>
     continue_build(const DatasetPtr& base, const BinarySet& binary_set);
 
+    tl::expected<std::vector<int64_t>, Error>
+    add(const DatasetPtr& base);
+
+    tl::expected<bool, Error>
+    remove(int64_t id);
+
     tl::expected<DatasetPtr, Error>
     knn_search(const DatasetPtr& query,
                int64_t k,
@@ -187,31 +253,105 @@ private:
                  BitsetPtr invalid,
                  int64_t limited_size) const;
 
+    tl::expected<uint32_t, Error>
+    feedback(const DatasetPtr& query, const std::string& parameters);
+
     tl::expected<BinarySet, Error>
     serialize() const;
 
+    tl::expected<void, Error>
+    serialize(const WriteFuncType& write_func) const;
+
     tl::expected<void, Error>
     deserialize(const BinarySet& binary_set);
 
     tl::expected<void, Error>
     deserialize(const ReaderSet& reader_set);
 
-    tl::expected<void, Error>
-    build_partial_graph(const DatasetPtr& base,
-                        const BinarySet& binary_set,
-                        BinarySet& after_binary_set,
-                        int round);
+    void
+    partition_graph(const DatasetPtr& base, BinarySet& after_binary_set);
+
+    bool
+    build_graph_shards(const DatasetPtr& base,
+                       const BinarySet& binary_set,
+                       BinarySet& after_binary_set,
+                       int round);
+
+    void
+    merge_graph_shards(const DatasetPtr& base,
+                       const BinarySet& binary_set,
+                       BinarySet& after_binary_set);
 
     tl::expected<void, Error>
     load_disk_index(const BinarySet& binary_set);
 
+    void
+    warm_cache(std::vector<uint32_t> node_list);
+
+    std::vector<size_t>
+    build_disk_streams(const float* vectors,
+                       const int64_t* ids,
+                       int64_t data_num,
+                       const IndexCommonParam& common_param,
+                       std::stringstream& graph_stream,
+                       std::stringstream& tag_stream,
+                       std::stringstream& pq_pivots_stream,
+                       std::stringstream& disk_pq_compressed_vectors,
+                       std::stringstream& disk_layout_stream);
+
+    void
+    reset_delta();
+
+    void
+    load_delta(const std::vector<int64_t>& ids, const float* vectors);
+
+    void
+    load_disk_locations() const;
+
+    bool
+    on_disk(int64_t id) const;
+
+    std::vector<uint32_t>
+    resolve_entry_points(const std::vector<int64_t>& entry_ids) const;
+
+    bool
+    is_deleted(int64_t id) const;
+
+    std::function<bool(int64_t)>
+    with_deleted_filter(const std::function<bool(int64_t)>& filter) const;
+
+    int64_t
+    merge_delta_results(const float* query,
+                        int64_t k,
+                        int64_t ef_search,
+                        const std::function<bool(int64_t)>& filter,
+                        int64_t disk_result_num,
+                        uint64_t* labels,
+                        float* distances) const;
+
+    void
+    range_search_delta(const float* query,
+                       float radius,
+                       int64_t ef_search,
+                       const std::function<bool(int64_t)>& filter,
+                       std::vector<uint64_t>& labels,
+                       std::vector<float>& distances) const;
+
+    void
+    try_trigger_merge();
+
+    void
+    merge();
+
+    void
+    wait_for_merge() const;
+
     static BinarySet
     empty_binaryset();
 
 private:
     std::shared_ptr<LocalFileReader> reader_;
     std::shared_ptr<diskann::PQFlashIndex<float, int64_t>> index_;
-    std::shared_ptr<diskann::Index<float, int64_t, int64_t>> build_index_;
     std::stringstream pq_pivots_stream_;
     std::stringstream disk_pq_compressed_vectors_;
     std::stringstream disk_layout_stream_;
@@ -220,7 +360,8 @@ private:
 
     const IndexCommonParam index_common_param_;
 
-    std::function<void(const std::vector<read_request>&, bool, CallBack)> batch_read_;
+    std::function<uint64_t(const std::vector<read_request>&, bool, CallBack)> batch_read_;
+    std::shared_ptr<DiskannIOScheduler> io_scheduler_;
     diskann::Metric metric_;
     std::shared_ptr<Reader> disk_layout_reader_;
 
@@ -231,6 +372,9 @@ private:
     size_t sector_len_;
 
     int64_t build_batch_num_ = 10;
+    int64_t cache_size_ = 0;
+    int64_t build_memory_budget_ = 0;
+    diskann::SectorVectorType sector_vector_type_ = diskann::SectorVectorType::FP32;
 
     int64_t dim_;
     bool use_reference_ = true;
@@ -250,6 +394,24 @@ private:  // Request Statistics
     mutable std::mutex stats_mutex_;
     std::shared_ptr<SafeThreadPool> pool_;
 
+private:  // Incremental Update
+    int64_t merge_threshold_;
+
+    // recent inserts live in an in-memory graph until they are merged into the disk layout
+    std::shared_ptr<hnswlib::L2Space> delta_space_;
+    std::shared_ptr<hnswlib::HierarchicalNSW> delta_index_;
+    std::vector<int64_t> delta_ids_;
+
+    // deleted ids are filtered out at search time until a merge drops them from the disk layout
+    std::unordered_set<int64_t> deleted_ids_;
+    // tag -> location on the disk layout, built lazily and dropped whenever the layout changes
+    mutable std::mutex disk_locations_mutex_;
+    mutable std::unordered_map<int64_t, uint32_t> disk_locations_;
+
+    std::atomic<bool> merge_running_{false};
+    mutable std::mutex merge_future_mutex_;
+    mutable std::future<void> merge_future_;
+
     mutable std::map<std::string, WindowResultQueue> result_queues_;
 };
 
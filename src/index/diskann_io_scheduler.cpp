@@ -0,0 +1,223 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "diskann_io_scheduler.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <stdexcept>
+
+namespace vsag {
+
+struct DiskannIOScheduler::SyncWait {
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint64_t pending{0};
+    bool failed{false};
+    std::string message;
+};
+
+DiskannIOScheduler::DiskannIOScheduler(DeviceRead device_read, uint64_t max_coalesced_len)
+    : device_read_(std::move(device_read)), max_coalesced_len_(max_coalesced_len) {
+}
+
+uint64_t
+DiskannIOScheduler::Submit(const std::vector<ReadRequest>& requests,
+                           bool async,
+                           const CallBack& callback) {
+    std::vector<OwnedRead> owned;
+    owned.reserve(requests.size());
+    std::shared_ptr<SyncWait> sync;
+    uint64_t shared = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& request : requests) {
+            auto [offset, len, dest] = request;
+            auto iter = in_flight_.find(offset);
+            if (iter == in_flight_.end()) {
+                in_flight_.emplace(offset, InFlight{len, {}});
+                owned.push_back({offset, len, dest, true});
+                continue;
+            }
+            if (iter->second.len != len) {
+                owned.push_back({offset, len, dest, false});
+                continue;
+            }
+            // the same sector is being read for another query, or earlier in this batch
+            Waiter waiter;
+            waiter.dest = dest;
+            if (async) {
+                waiter.callback = callback;
+            } else {
+                if (not sync) {
+                    sync = std::make_shared<SyncWait>();
+                }
+                sync->pending++;
+                waiter.sync = sync;
+            }
+            iter->second.waiters.push_back(std::move(waiter));
+            shared++;
+        }
+        stats_.requests += requests.size();
+        stats_.shared_reads += shared;
+    }
+
+    // merge adjacent reads
+    std::sort(owned.begin(), owned.end(), [](const OwnedRead& a, const OwnedRead& b) {
+        return a.offset < b.offset;
+    });
+    auto runs = std::make_shared<std::vector<Run>>();
+    for (const auto& read : owned) {
+        if (not runs->empty()) {
+            auto& last = runs->back();
+            if (last.offset + last.len == read.offset &&
+                last.len + read.len <= max_coalesced_len_) {
+                last.len += read.len;
+                last.reads.push_back(read);
+                continue;
+            }
+        }
+        runs->push_back({read.offset, read.len, {read}, nullptr});
+    }
+    std::vector<ReadRequest> device_requests;
+    device_requests.reserve(runs->size());
+    uint64_t coalesced = 0;
+    for (auto& run : *runs) {
+        void* dest = run.reads[0].dest;
+        if (run.reads.size() > 1) {
+            run.buffer.reset(new char[run.len]);
+            dest = run.buffer.get();
+            coalesced += run.reads.size() - 1;
+        }
+        device_requests.emplace_back(run.offset, run.len, dest);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.device_reads += runs->size();
+        stats_.coalesced_reads += coalesced;
+        stats_.queue_depth += runs->size();
+        stats_.max_queue_depth = std::max(stats_.max_queue_depth, stats_.queue_depth);
+    }
+
+    if (async) {
+        auto finish = [this, runs, callback](
+                          uint64_t i, IOErrorCode code, const std::string& message) {
+            auto& run = (*runs)[i];
+            complete(run, code, message);
+            for (uint64_t j = 0; j < run.reads.size(); ++j) {
+                callback(code, message);
+            }
+        };
+        // one device call per run, the device callback can not tell the reads of a batch apart
+        for (uint64_t i = 0; i < runs->size(); ++i) {
+            try {
+                device_read_({device_requests[i]},
+                             true,
+                             [finish, i](IOErrorCode code, const std::string& message) {
+                                 finish(i, code, message);
+                             });
+            } catch (const std::exception& e) {
+                // a throwing device read is not issued, fail it and the runs not dispatched yet
+                // so that their waiters and the queue depth are released
+                for (uint64_t j = i; j < runs->size(); ++j) {
+                    finish(j, IOErrorCode::IO_ERROR, e.what());
+                }
+                break;
+            }
+        }
+        return shared;
+    }
+
+    if (not runs->empty()) {
+        try {
+            device_read_(device_requests, false, nullptr);
+        } catch (const std::exception& e) {
+            for (auto& run : *runs) {
+                complete(run, IOErrorCode::IO_ERROR, e.what());
+            }
+            // the reads this call waits for still hold its dest pointers
+            wait(sync);
+            throw;
+        }
+        for (auto& run : *runs) {
+            complete(run, IOErrorCode::IO_SUCCESS, "success");
+        }
+    }
+    if (wait(sync)) {
+        throw std::runtime_error("failed to read a shared sector: " + sync->message);
+    }
+    return shared;
+}
+
+bool
+DiskannIOScheduler::wait(const std::shared_ptr<SyncWait>& sync) {
+    if (not sync) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(sync->mutex);
+    sync->cv.wait(lock, [&sync] { return sync->pending == 0; });
+    return sync->failed;
+}
+
+void
+DiskannIOScheduler::complete(Run& run, IOErrorCode code, const std::string& message) {
+    bool success = code == IOErrorCode::IO_SUCCESS;
+    if (success && run.buffer) {
+        for (const auto& read : run.reads) {
+            std::memcpy(read.dest, run.buffer.get() + (read.offset - run.offset), read.len);
+        }
+    }
+    for (const auto& read : run.reads) {
+        std::vector<Waiter> waiters;
+        if (read.registered) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto iter = in_flight_.find(read.offset);
+            waiters.swap(iter->second.waiters);
+            in_flight_.erase(iter);
+        }
+        for (const auto& waiter : waiters) {
+            if (success) {
+                std::memcpy(waiter.dest, read.dest, read.len);
+            }
+            notify(waiter, code, message);
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.queue_depth--;
+}
+
+void
+DiskannIOScheduler::notify(const Waiter& waiter, IOErrorCode code, const std::string& message) {
+    if (waiter.callback) {
+        waiter.callback(code, message);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(waiter.sync->mutex);
+    if (code != IOErrorCode::IO_SUCCESS) {
+        waiter.sync->failed = true;
+        waiter.sync->message = message;
+    }
+    waiter.sync->pending--;
+    waiter.sync->cv.notify_all();
+}
+
+DiskannIOScheduler::Stats
+DiskannIOScheduler::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace vsag
@@ -0,0 +1,112 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "vsag/readerset.h"
+
+namespace vsag {
+
+// Shares the disk layout reads of all queries running on one DiskANN index. A read that is
+// already in flight is not issued again, the new request waits for it and receives a copy.
+// Adjacent reads of one batch are merged into a single device read.
+class DiskannIOScheduler {
+public:
+    using ReadRequest = std::tuple<uint64_t, uint64_t, void*>;
+    using DeviceRead = std::function<void(const std::vector<ReadRequest>&, bool, CallBack)>;
+
+    struct Stats {
+        uint64_t requests = 0;
+        uint64_t device_reads = 0;
+        // served by a read that was already in flight
+        uint64_t shared_reads = 0;
+        // merged into the device read of an adjacent request
+        uint64_t coalesced_reads = 0;
+        // device reads in flight
+        uint64_t queue_depth = 0;
+        uint64_t max_queue_depth = 0;
+    };
+
+public:
+    // device_read issues the reads, an async call invokes its callback once per request
+    DiskannIOScheduler(DeviceRead device_read, uint64_t max_coalesced_len);
+
+    // a blocking call fills every dest before it returns, an async call invokes callback once
+    // per request. Returns the number of requests served by reads already in flight
+    uint64_t
+    Submit(const std::vector<ReadRequest>& requests, bool async, const CallBack& callback);
+
+    Stats
+    GetStats() const;
+
+private:
+    struct SyncWait;
+
+    struct Waiter {
+        void* dest{nullptr};
+        CallBack callback;
+        std::shared_ptr<SyncWait> sync;
+    };
+
+    struct InFlight {
+        uint64_t len{0};
+        std::vector<Waiter> waiters;
+    };
+
+    struct OwnedRead {
+        uint64_t offset{0};
+        uint64_t len{0};
+        void* dest{nullptr};
+        // false if another read of a different length holds the offset
+        bool registered{false};
+    };
+
+    // one device read covering adjacent owned reads
+    struct Run {
+        uint64_t offset{0};
+        uint64_t len{0};
+        std::vector<OwnedRead> reads;
+        std::shared_ptr<char[]> buffer;
+    };
+
+    void
+    complete(Run& run, IOErrorCode code, const std::string& message);
+
+    static void
+    notify(const Waiter& waiter, IOErrorCode code, const std::string& message);
+
+    // blocks until every shared read of a blocking call is done, returns whether one failed
+    static bool
+    wait(const std::shared_ptr<SyncWait>& sync);
+
+private:
+    DeviceRead device_read_;
+    uint64_t max_coalesced_len_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, InFlight> in_flight_;
+    Stats stats_;
+};
+
+}  // namespace vsag
@@ -0,0 +1,225 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "diskann_io_scheduler.h"
+
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace {
+const uint64_t SECTOR_LEN = 64;
+const uint64_t SECTOR_NUM = 16;
+
+std::vector<char>
+GenerateLayout() {
+    std::vector<char> layout(SECTOR_LEN * SECTOR_NUM);
+    for (uint64_t i = 0; i < layout.size(); ++i) {
+        layout[i] = static_cast<char>(i * 7 + 3);
+    }
+    return layout;
+}
+}  // namespace
+
+TEST_CASE("diskann io scheduler coalesces and shares reads", "[ut][diskann]") {
+    auto layout = GenerateLayout();
+    std::atomic<uint64_t> device_requests{0};
+    vsag::DiskannIOScheduler scheduler(
+        [&](const std::vector<vsag::DiskannIOScheduler::ReadRequest>& requests,
+            bool async,
+            vsag::CallBack callback) {
+            for (const auto& [offset, len, dest] : requests) {
+                std::memcpy(dest, layout.data() + offset, len);
+                device_requests++;
+                if (async) {
+                    callback(vsag::IOErrorCode::IO_SUCCESS, "success");
+                }
+            }
+        },
+        SECTOR_LEN * 4);
+
+    // sectors 0-5 are adjacent, sector 2 is requested twice and sector 9 stands alone
+    std::vector<uint64_t> sectors = {3, 0, 2, 1, 9, 2, 4, 5};
+    std::vector<char> buffer(SECTOR_LEN * sectors.size());
+    std::vector<vsag::DiskannIOScheduler::ReadRequest> requests;
+    for (uint64_t i = 0; i < sectors.size(); ++i) {
+        requests.emplace_back(sectors[i] * SECTOR_LEN, SECTOR_LEN, buffer.data() + i * SECTOR_LEN);
+    }
+
+    SECTION("blocking") {
+        REQUIRE(scheduler.Submit(requests, false, nullptr) == 1);
+    }
+
+    SECTION("async") {
+        std::atomic<uint64_t> callbacks{0};
+        auto shared = scheduler.Submit(
+            requests, true, [&](vsag::IOErrorCode code, const std::string& message) {
+                REQUIRE(code == vsag::IOErrorCode::IO_SUCCESS);
+                callbacks++;
+            });
+        REQUIRE(shared == 1);
+        REQUIRE(callbacks == sectors.size());
+    }
+
+    for (uint64_t i = 0; i < sectors.size(); ++i) {
+        REQUIRE(std::memcmp(buffer.data() + i * SECTOR_LEN,
+                            layout.data() + sectors[i] * SECTOR_LEN,
+                            SECTOR_LEN) == 0);
+    }
+    // [0, 1, 2, 3] [4, 5] [9]
+    REQUIRE(device_requests == 3);
+    auto stats = scheduler.GetStats();
+    REQUIRE(stats.requests == sectors.size());
+    REQUIRE(stats.device_reads == 3);
+    REQUIRE(stats.shared_reads == 1);
+    REQUIRE(stats.coalesced_reads == 4);
+    REQUIRE(stats.queue_depth == 0);
+    REQUIRE(stats.max_queue_depth >= 1);
+}
+
+TEST_CASE("diskann io scheduler shares reads across threads", "[ut][diskann]") {
+    auto layout = GenerateLayout();
+    std::atomic<uint64_t> device_requests{0};
+    vsag::DiskannIOScheduler scheduler(
+        [&](const std::vector<vsag::DiskannIOScheduler::ReadRequest>& requests,
+            bool async,
+            vsag::CallBack callback) {
+            // keep the reads in flight long enough for the other threads to join them
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            for (const auto& [offset, len, dest] : requests) {
+                std::memcpy(dest, layout.data() + offset, len);
+                device_requests++;
+            }
+        },
+        SECTOR_LEN);
+
+    const uint64_t thread_num = 8;
+    std::vector<std::vector<char>> buffers(thread_num, std::vector<char>(SECTOR_LEN));
+    std::atomic<uint64_t> shared{0};
+    std::vector<std::thread> threads;
+    for (uint64_t i = 0; i < thread_num; ++i) {
+        threads.emplace_back([&, i]() {
+            std::vector<vsag::DiskannIOScheduler::ReadRequest> requests = {
+                {7 * SECTOR_LEN, SECTOR_LEN, buffers[i].data()}};
+            shared += scheduler.Submit(requests, false, nullptr);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& buffer : buffers) {
+        REQUIRE(std::memcmp(buffer.data(), layout.data() + 7 * SECTOR_LEN, SECTOR_LEN) == 0);
+    }
+    REQUIRE(device_requests + shared == thread_num);
+    auto stats = scheduler.GetStats();
+    REQUIRE(stats.device_reads == device_requests);
+    REQUIRE(stats.shared_reads == shared);
+    REQUIRE(stats.queue_depth == 0);
+}
+
+TEST_CASE("diskann io scheduler reports failed reads", "[ut][diskann]") {
+    vsag::DiskannIOScheduler scheduler(
+        [&](const std::vector<vsag::DiskannIOScheduler::ReadRequest>& requests,
+            bool async,
+            vsag::CallBack callback) { throw std::runtime_error("device error"); },
+        SECTOR_LEN);
+
+    std::vector<char> buffer(SECTOR_LEN * 2);
+    std::vector<vsag::DiskannIOScheduler::ReadRequest> requests = {
+        {0, SECTOR_LEN, buffer.data()}, {0, SECTOR_LEN, buffer.data() + SECTOR_LEN}};
+    REQUIRE_THROWS(scheduler.Submit(requests, false, nullptr));
+    REQUIRE(scheduler.GetStats().queue_depth == 0);
+}
+
+TEST_CASE("diskann io scheduler waits for shared reads before failing", "[ut][diskann]") {
+    auto layout = GenerateLayout();
+    std::atomic<bool> slow_read_done{false};
+    vsag::DiskannIOScheduler scheduler(
+        [&](const std::vector<vsag::DiskannIOScheduler::ReadRequest>& requests,
+            bool async,
+            vsag::CallBack callback) {
+            for (const auto& [offset, len, dest] : requests) {
+                if (offset != 0) {
+                    throw std::runtime_error("device error");
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                std::memcpy(dest, layout.data() + offset, len);
+                slow_read_done = true;
+            }
+        },
+        SECTOR_LEN);
+
+    std::vector<char> slow_buffer(SECTOR_LEN);
+    std::thread slow([&]() {
+        std::vector<vsag::DiskannIOScheduler::ReadRequest> requests = {
+            {0, SECTOR_LEN, slow_buffer.data()}};
+        scheduler.Submit(requests, false, nullptr);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    // sector 0 is shared with the slow read, the failed read must not return before it is copied
+    std::vector<char> buffer(SECTOR_LEN * 2);
+    std::vector<vsag::DiskannIOScheduler::ReadRequest> requests = {
+        {0, SECTOR_LEN, buffer.data()}, {SECTOR_LEN * 3, SECTOR_LEN, buffer.data() + SECTOR_LEN}};
+    REQUIRE_THROWS(scheduler.Submit(requests, false, nullptr));
+    REQUIRE(slow_read_done);
+    REQUIRE(std::memcmp(buffer.data(), layout.data(), SECTOR_LEN) == 0);
+    slow.join();
+    REQUIRE(scheduler.GetStats().queue_depth == 0);
+}
+
+TEST_CASE("diskann io scheduler fails async reads the device did not issue", "[ut][diskann]") {
+    auto layout = GenerateLayout();
+    std::atomic<bool> device_up{false};
+    vsag::DiskannIOScheduler scheduler(
+        [&](const std::vector<vsag::DiskannIOScheduler::ReadRequest>& requests,
+            bool async,
+            vsag::CallBack callback) {
+            if (not device_up) {
+                throw std::runtime_error("device error");
+            }
+            for (const auto& [offset, len, dest] : requests) {
+                std::memcpy(dest, layout.data() + offset, len);
+                if (async) {
+                    callback(vsag::IOErrorCode::IO_SUCCESS, "success");
+                }
+            }
+        },
+        SECTOR_LEN);
+
+    // sectors 2 and 6 are separate runs, both fail when the first device call throws
+    std::vector<char> buffer(SECTOR_LEN * 2);
+    std::vector<vsag::DiskannIOScheduler::ReadRequest> requests = {
+        {2 * SECTOR_LEN, SECTOR_LEN, buffer.data()},
+        {6 * SECTOR_LEN, SECTOR_LEN, buffer.data() + SECTOR_LEN}};
+    std::atomic<uint64_t> failed{0};
+    scheduler.Submit(requests, true, [&](vsag::IOErrorCode code, const std::string& message) {
+        if (code != vsag::IOErrorCode::IO_SUCCESS) {
+            failed++;
+        }
+    });
+    REQUIRE(failed == requests.size());
+    REQUIRE(scheduler.GetStats().queue_depth == 0);
+
+    // the failed reads left nothing in flight, a later read of the same sectors is issued again
+    device_up = true;
+    REQUIRE(scheduler.Submit(requests, false, nullptr) == 0);
+    REQUIRE(std::memcmp(buffer.data(), layout.data() + 2 * SECTOR_LEN, SECTOR_LEN) == 0);
+    REQUIRE(std::memcmp(buffer.data() + SECTOR_LEN, layout.data() + 6 * SECTOR_LEN, SECTOR_LEN) ==
+            0);
+}
@@ -99,6 +99,47 @@ DiskannParameters::FromJson(
         obj.use_async_io = diskann_param_obj[DISKANN_PARAMETER_USE_ASYNC_IO];
     }
 
+    // set obj.cache_size
+    if (diskann_param_obj.contains(DISKANN_PARAMETER_CACHE_SIZE)) {
+        obj.cache_size = diskann_param_obj[DISKANN_PARAMETER_CACHE_SIZE];
+        CHECK_ARGUMENT(obj.cache_size >= 0,
+                       fmt::format("{} must be greater equal than 0, now is {}",
+                                   DISKANN_PARAMETER_CACHE_SIZE,
+                                   obj.cache_size));
+    }
+
+    // set obj.merge_threshold
+    if (diskann_param_obj.contains(DISKANN_PARAMETER_MERGE_THRESHOLD)) {
+        obj.merge_threshold = diskann_param_obj[DISKANN_PARAMETER_MERGE_THRESHOLD];
+        CHECK_ARGUMENT(obj.merge_threshold > 0,
+                       fmt::format("{} must be greater than 0, now is {}",
+                                   DISKANN_PARAMETER_MERGE_THRESHOLD,
+                                   obj.merge_threshold));
+    }
+
+    // set obj.build_memory_budget
+    if (diskann_param_obj.contains(DISKANN_PARAMETER_BUILD_MEMORY_BUDGET)) {
+        obj.build_memory_budget = diskann_param_obj[DISKANN_PARAMETER_BUILD_MEMORY_BUDGET];
+        CHECK_ARGUMENT(obj.build_memory_budget >= 0,
+                       fmt::format("{} must be greater equal than 0, now is {}",
+                                   DISKANN_PARAMETER_BUILD_MEMORY_BUDGET,
+                                   obj.build_memory_budget));
+    }
+
+    // set obj.sector_vector_type
+    if (diskann_param_obj.contains(DISKANN_PARAMETER_SECTOR_VECTOR_TYPE)) {
+        obj.sector_vector_type = diskann_param_obj[DISKANN_PARAMETER_SECTOR_VECTOR_TYPE];
+        CHECK_ARGUMENT(obj.sector_vector_type == DISKANN_SECTOR_VECTOR_TYPE_FP32 or
+                           obj.sector_vector_type == DISKANN_SECTOR_VECTOR_TYPE_FP16 or
+                           obj.sector_vector_type == DISKANN_SECTOR_VECTOR_TYPE_SQ8,
+                       fmt::format("parameters[{}] must in [{}, {}, {}], now is {}",
+                                   DISKANN_PARAMETER_SECTOR_VECTOR_TYPE,
+                                   DISKANN_SECTOR_VECTOR_TYPE_FP32,
+                                   DISKANN_SECTOR_VECTOR_TYPE_FP16,
+                                   DISKANN_SECTOR_VECTOR_TYPE_SQ8,
+                                   obj.sector_vector_type));
+    }
+
     // set obj.graph_type
     if (diskann_param_obj.contains(DISKANN_PARAMETER_GRAPH_TYPE)) {
         obj.graph_type = diskann_param_obj[DISKANN_PARAMETER_GRAPH_TYPE];
@@ -188,6 +229,16 @@ DiskannSearchParameters::FromJson(const std::string& json_string) {
         obj.use_reorder = params[INDEX_DISKANN][DISKANN_PARAMETER_REORDER];
     }
 
+    // set obj.entry_ids
+    if (params[INDEX_DISKANN].contains(DISKANN_PARAMETER_ENTRY_IDS)) {
+        CHECK_ARGUMENT(params[INDEX_DISKANN][DISKANN_PARAMETER_ENTRY_IDS].is_array(),
+                       fmt::format("parameters[{}][{}] must be an array of ids",
+                                   INDEX_DISKANN,
+                                   DISKANN_PARAMETER_ENTRY_IDS));
+        obj.entry_ids =
+            params[INDEX_DISKANN][DISKANN_PARAMETER_ENTRY_IDS].get<std::vector<int64_t>>();
+    }
+
     return obj;
 }
 
@@ -18,6 +18,7 @@
 #include <distance.h>
 
 #include <string>
+#include <vector>
 
 #include "index_common_param.h"
 
@@ -43,6 +44,16 @@ public:
     bool use_opq = false;
     bool use_bsa = false;
     bool use_async_io = false;
+    // bytes of hot nodes kept in memory, 0 disables the node cache
+    int64_t cache_size = 0;
+    // inserts plus deletes buffered in memory before they are merged into the disk layout
+    int64_t merge_threshold = 10000;
+    // bytes available to build the vamana graph, a larger graph is built in kmeans partitions,
+    // 0 builds the whole graph at once
+    int64_t build_memory_budget = 0;
+    // vectors kept in the node records of the disk layout, fp16 and sq8 also pack the neighbor
+    // ids and move the full-precision vectors to a region that is only read for the rerank
+    std::string sector_vector_type = "fp32";
 
     // use new construction method
     std::string graph_type = "vamana";
@@ -67,6 +78,8 @@ public:
 
     // optional vars with default value
     bool use_reorder = false;
+    // ids to seed the graph walk with, e.g. members of the label a selective filter keeps
+    std::vector<int64_t> entry_ids;
 
 private:
     DiskannSearchParameters() = default;
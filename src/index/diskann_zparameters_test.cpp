@@ -35,3 +35,114 @@ TEST_CASE("create diskann with correct parameter", "[ut][diskann]") {
     nlohmann::json parsed_params = nlohmann::json::parse(build_parameter_json);
     vsag::DiskannParameters::FromJson(parsed_params, commom_param);
 }
+
+TEST_CASE("create diskann with node cache", "[ut][diskann]") {
+    vsag::IndexCommonParam commom_param;
+    commom_param.dim_ = 128;
+    commom_param.data_type_ = vsag::DataTypes::DATA_TYPE_FLOAT;
+    commom_param.metric_ = vsag::MetricType::METRIC_TYPE_L2SQR;
+    nlohmann::json parsed_params = nlohmann::json::parse(R"(
+        {
+            "max_degree": 16,
+            "ef_construction": 200,
+            "pq_dims": 32,
+            "pq_sample_rate": 0.5,
+            "cache_size": 1048576
+        }
+        )");
+    auto params = vsag::DiskannParameters::FromJson(parsed_params, commom_param);
+    REQUIRE(params.cache_size == 1048576);
+
+    parsed_params["cache_size"] = -1;
+    REQUIRE_THROWS(vsag::DiskannParameters::FromJson(parsed_params, commom_param));
+}
+
+TEST_CASE("create diskann with merge threshold", "[ut][diskann]") {
+    vsag::IndexCommonParam commom_param;
+    commom_param.dim_ = 128;
+    commom_param.data_type_ = vsag::DataTypes::DATA_TYPE_FLOAT;
+    commom_param.metric_ = vsag::MetricType::METRIC_TYPE_L2SQR;
+    nlohmann::json parsed_params = nlohmann::json::parse(R"(
+        {
+            "max_degree": 16,
+            "ef_construction": 200,
+            "pq_dims": 32,
+            "pq_sample_rate": 0.5
+        }
+        )");
+    auto params = vsag::DiskannParameters::FromJson(parsed_params, commom_param);
+    REQUIRE(params.merge_threshold == 10000);
+
+    parsed_params["merge_threshold"] = 100;
+    params = vsag::DiskannParameters::FromJson(parsed_params, commom_param);
+    REQUIRE(params.merge_threshold == 100);
+
+    parsed_params["merge_threshold"] = 0;
+    REQUIRE_THROWS(vsag::DiskannParameters::FromJson(parsed_params, commom_param));
+}
+
+TEST_CASE("create diskann with build memory budget", "[ut][diskann]") {
+    vsag::IndexCommonParam commom_param;
+    commom_param.dim_ = 128;
+    commom_param.data_type_ = vsag::DataTypes::DATA_TYPE_FLOAT;
+    commom_param.metric_ = vsag::MetricType::METRIC_TYPE_L2SQR;
+    nlohmann::json parsed_params = nlohmann::json::parse(R"(
+        {
+            "max_degree": 16,
+            "ef_construction": 200,
+            "pq_dims": 32,
+            "pq_sample_rate": 0.5,
+            "build_memory_budget": 1073741824
+        }
+        )");
+    auto params = vsag::DiskannParameters::FromJson(parsed_params, commom_param);
+    REQUIRE(params.build_memory_budget == 1073741824);
+
+    parsed_params["build_memory_budget"] = -1;
+    REQUIRE_THROWS(vsag::DiskannParameters::FromJson(parsed_params, commom_param));
+}
+
+TEST_CASE("diskann search parameters with entry ids", "[ut][diskann]") {
+    auto params = vsag::DiskannSearchParameters::FromJson(R"(
+        {
+            "diskann": {
+                "ef_search": 100,
+                "beam_search": 4,
+                "io_limit": 50,
+                "entry_ids": [3, 7, 11]
+            }
+        }
+        )");
+    REQUIRE(params.entry_ids == std::vector<int64_t>{3, 7, 11});
+
+    params = vsag::DiskannSearchParameters::FromJson(
+        R"({"diskann": {"ef_search": 100, "beam_search": 4, "io_limit": 50}})");
+    REQUIRE(params.entry_ids.empty());
+
+    REQUIRE_THROWS(vsag::DiskannSearchParameters::FromJson(
+        R"({"diskann": {"ef_search": 100, "beam_search": 4, "io_limit": 50, "entry_ids": 3}})"));
+}
+
+TEST_CASE("create diskann with sector vector type", "[ut][diskann]") {
+    vsag::IndexCommonParam commom_param;
+    commom_param.dim_ = 128;
+    commom_param.data_type_ = vsag::DataTypes::DATA_TYPE_FLOAT;
+    commom_param.metric_ = vsag::MetricType::METRIC_TYPE_L2SQR;
+    nlohmann::json parsed_params = nlohmann::json::parse(R"(
+        {
+            "max_degree": 16,
+            "ef_construction": 200,
+            "pq_dims": 32,
+            "pq_sample_rate": 0.5
+        }
+        )");
+    auto params = vsag::DiskannParameters::FromJson(parsed_params, commom_param);
+    REQUIRE(params.sector_vector_type == "fp32");
+
+    parsed_params["sector_vector_type"] = "sq8";
+    params = vsag::DiskannParameters::FromJson(parsed_params, commom_param);
+    REQUIRE(params.sector_vector_type == "sq8");
+
+    parsed_params["sector_vector_type"] = "int4";
+    REQUIRE_THROWS(vsag::DiskannParameters::FromJson(parsed_params, commom_param));
+}
@@ -107,6 +107,16 @@ public:
         SAFE_CALL(return this->hgraph_->Serialize(out_stream));
     }
 
+    tl::expected<void, Error>
+    Serialize(WriteFuncType write_func) const override {
+        SAFE_CALL(return this->hgraph_->Serialize(write_func));
+    }
+
+    [[nodiscard]] uint64_t
+    CalSerializeSize() const override {
+        return this->hgraph_->CalSerializeSize();
+    }
+
     tl::expected<void, Error>
     Deserialize(std::istream& in_stream) override {
         SAFE_CALL(return this->hgraph_->Deserialize(in_stream));
@@ -137,6 +147,11 @@ public:
         return this->hgraph_->EstimateMemory(num_elements);
     }
 
+    [[nodiscard]] std::string
+    GetStats() const override {
+        return this->hgraph_->GetStats();
+    }
+
     [[nodiscard]] bool
     CheckFeature(IndexFeature feature) const override {
         return this->hgraph_->CheckFeature(feature);
@@ -34,10 +34,20 @@ static const std::unordered_map<std::string, std::vector<std::string>> EXTERNAL_
      {HGRAPH_BASE_CODES_KEY, QUANTIZATION_PARAMS_KEY, QUANTIZATION_TYPE_KEY}},
     {HGRAPH_PRECISE_QUANTIZATION_TYPE,
      {HGRAPH_PRECISE_CODES_KEY, QUANTIZATION_PARAMS_KEY, QUANTIZATION_TYPE_KEY}},
+    {HGRAPH_PRECISE_IO_TYPE, {HGRAPH_PRECISE_CODES_KEY, IO_PARAMS_KEY, IO_TYPE_KEY}},
+    {HGRAPH_PRECISE_IO_HOT_SIZE, {HGRAPH_PRECISE_CODES_KEY, IO_PARAMS_KEY, TIERED_IO_HOT_SIZE_KEY}},
+    {HGRAPH_BASE_DRIFT_THRESHOLD, {HGRAPH_BASE_CODES_KEY, FLATTEN_DRIFT_THRESHOLD_KEY}},
+    {HGRAPH_BASE_TRANSFORM_TYPE, {HGRAPH_BASE_CODES_KEY, TRANSFORM_PARAMS_KEY, TRANSFORM_TYPE_KEY}},
+    {HGRAPH_BASE_TRANSFORM_DIM,
+     {HGRAPH_BASE_CODES_KEY, TRANSFORM_PARAMS_KEY, TRANSFORM_OUTPUT_DIM_KEY}},
     {HGRAPH_GRAPH_MAX_DEGREE, {HGRAPH_GRAPH_KEY, GRAPH_PARAM_MAX_DEGREE}},
+    {HGRAPH_GRAPH_USE_COMPRESSION, {HGRAPH_GRAPH_KEY, GRAPH_PARAM_USE_COMPRESSION}},
+    {HGRAPH_COLOCATE_GRAPH, {HGRAPH_COLOCATE_GRAPH_KEY}},
     {HGRAPH_BUILD_EF_CONSTRUCTION, {BUILD_PARAMS_KEY, BUILD_EF_CONSTRUCTION}},
     {HGRAPH_INIT_CAPACITY, {HGRAPH_GRAPH_KEY, GRAPH_PARAM_INIT_MAX_CAPACITY}},
-    {HGRAPH_BUILD_THREAD_COUNT, {BUILD_PARAMS_KEY, BUILD_THREAD_COUNT}}};
+    {HGRAPH_BUILD_THREAD_COUNT, {BUILD_PARAMS_KEY, BUILD_THREAD_COUNT}},
+    {HGRAPH_BUILD_GRAPH_REORDER, {BUILD_PARAMS_KEY, BUILD_GRAPH_REORDER}},
+    {HGRAPH_BUILD_TUNE_PREFETCH, {BUILD_PARAMS_KEY, BUILD_TUNE_PREFETCH}}};
 
 static const std::string HGRAPH_PARAMS_TEMPLATE =
     R"(
@@ -80,6 +90,12 @@ static const std::string HGRAPH_PARAMS_TEMPLATE =
 static void
 mapping_external_param_to_inner(const JsonType& external_json, JsonType& inner_json);
 
+static JsonType
+mapping_external_rerank_stages(const JsonType& external_stages);
+
+static void
+mapping_external_block_io_flag(const std::string& key, const JsonType& value, JsonType& inner_json);
+
 HGraphIndexParameter::HGraphIndexParameter(IndexCommonParam common_param)
     : common_param_(std::move(common_param)) {
 }
@@ -115,6 +131,14 @@ HGraphIndexParameter::ToJson() {
 void
 mapping_external_param_to_inner(const JsonType& external_json, JsonType& inner_json) {
     for (const auto& [key, value] : external_json.items()) {
+        if (key == HGRAPH_RERANK_STAGES) {
+            inner_json[HGRAPH_RERANK_STAGES_KEY] = mapping_external_rerank_stages(value);
+            continue;
+        }
+        if (key == HGRAPH_USE_HUGEPAGE or key == HGRAPH_NUMA_INTERLEAVE) {
+            // applied after the loop, they also cover the io of the rerank stages
+            continue;
+        }
         const auto& iter = EXTERNAL_MAPPING.find(key);
 
         if (iter != EXTERNAL_MAPPING.end()) {
@@ -128,6 +152,53 @@ mapping_external_param_to_inner(const JsonType& external_json, JsonType& inner_j
             throw std::invalid_argument(fmt::format("HGraph have no config param: {}", key));
         }
     }
+    for (const auto* key : {HGRAPH_USE_HUGEPAGE, HGRAPH_NUMA_INTERLEAVE}) {
+        if (external_json.contains(key)) {
+            mapping_external_block_io_flag(key, external_json[key], inner_json);
+        }
+    }
+}
+
+void
+mapping_external_block_io_flag(const std::string& key,
+                               const JsonType& value,
+                               JsonType& inner_json) {
+    // the external keys are named like the block io keys they are copied to
+    CHECK_ARGUMENT(value.is_boolean(), fmt::format("HGraph param {} must be a boolean", key));
+    for (const auto* codes_key :
+         {HGRAPH_GRAPH_KEY, HGRAPH_BASE_CODES_KEY, HGRAPH_PRECISE_CODES_KEY}) {
+        inner_json[codes_key][IO_PARAMS_KEY][key] = value;
+    }
+    if (inner_json.contains(HGRAPH_RERANK_STAGES_KEY)) {
+        for (auto& stage : inner_json[HGRAPH_RERANK_STAGES_KEY]) {
+            stage[IO_PARAMS_KEY][key] = value;
+        }
+    }
+}
+
+JsonType
+mapping_external_rerank_stages(const JsonType& external_stages) {
+    CHECK_ARGUMENT(external_stages.is_array(),
+                   fmt::format("HGraph param {} must be an array", HGRAPH_RERANK_STAGES));
+    auto inner_stages = JsonType::array();
+    for (const auto& stage : external_stages) {
+        CHECK_ARGUMENT(stage.contains(HGRAPH_RERANK_STAGE_QUANTIZATION_TYPE),
+                       fmt::format("HGraph rerank stage must contains {}",
+                                   HGRAPH_RERANK_STAGE_QUANTIZATION_TYPE));
+        JsonType inner_stage;
+        inner_stage[IO_PARAMS_KEY][IO_TYPE_KEY] = IO_TYPE_VALUE_BLOCK_MEMORY_IO;
+        if (stage.contains(HGRAPH_RERANK_STAGE_IO_TYPE)) {
+            inner_stage[IO_PARAMS_KEY][IO_TYPE_KEY] = stage[HGRAPH_RERANK_STAGE_IO_TYPE];
+        }
+        inner_stage[QUANTIZATION_PARAMS_KEY][QUANTIZATION_TYPE_KEY] =
+            stage[HGRAPH_RERANK_STAGE_QUANTIZATION_TYPE];
+        if (stage.contains(HGRAPH_RERANK_STAGE_CANDIDATE_FACTOR)) {
+            inner_stage[HGRAPH_RERANK_CANDIDATE_FACTOR_KEY] =
+                stage[HGRAPH_RERANK_STAGE_CANDIDATE_FACTOR];
+        }
+        inner_stages.push_back(inner_stage);
+    }
+    return inner_stages;
 }
 
 HGraphSearchParameters
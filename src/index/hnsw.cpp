@@ -34,6 +34,7 @@
 #include "io/memory_io_parameter.h"
 #include "quantization/fp32_quantizer_parameter.h"
 #include "safe_allocator.h"
+#include "stream_writer.h"
 #include "vsag/binaryset.h"
 #include "vsag/constants.h"
 #include "vsag/errors.h"
@@ -58,6 +59,7 @@ HNSW::HNSW(HnswParameters hnsw_params, const IndexCommonParam& index_common_para
       use_reversed_edges_(hnsw_params.use_reversed_edges),
       type_(hnsw_params.type),
       max_degree_(hnsw_params.max_degree),
+      graph_reorder_(hnsw_params.graph_reorder),
       dim_(index_common_param.dim_),
       index_common_param_(index_common_param) {
     auto M = std::min(  // NOLINT(readability-identifier-naming)
@@ -139,6 +141,10 @@ HNSW::build(const DatasetPtr& base) {
             SlowTaskTimer t("hnsw pq", 1000);
             auto* hnsw = static_cast<hnswlib::StaticHierarchicalNSW*>(alg_hnsw_.get());
             hnsw->encode_hnsw_data();
+        } else if (graph_reorder_ != GRAPH_REORDER_TYPE_VALUE_NONE) {
+            SlowTaskTimer t("hnsw graph reorder");
+            auto* hnsw = static_cast<hnswlib::HierarchicalNSW*>(alg_hnsw_.get());
+            hnsw->reorderGraph(graph_reorder_);
         }
 
         return failed_ids;
@@ -500,6 +506,45 @@ HNSW::serialize(std::ostream& out_stream) {
     return {};
 }
 
+tl::expected<void, Error>
+HNSW::serialize(const WriteFuncType& write_func) const {
+    WriteFuncStreamWriter writer(write_func, 0);
+    if (GetNumElements() == 0) {
+        StreamWriter::WriteBinarySet(writer, empty_binaryset());
+        return {};
+    }
+
+    SlowTaskTimer t("hnsw serialize");
+    std::shared_lock lock(rw_mutex_);
+    StreamWriter::WriteSectionHeader(writer, HNSW_DATA, alg_hnsw_->calcSerializeSize());
+    alg_hnsw_->saveIndex(writer);
+
+    if (use_conjugate_graph_) {
+        // the conjugate graph only holds the feedback edges, so it is small enough to copy
+        Binary b_cg = *conjugate_graph_->Serialize();
+        StreamWriter::WriteSectionHeader(writer, CONJUGATE_GRAPH_DATA, b_cg.size);
+        writer.Write(reinterpret_cast<const char*>(b_cg.data.get()), b_cg.size);
+    }
+
+    return {};
+}
+
+uint64_t
+HNSW::CalSerializeSize() const {
+    if (GetNumElements() == 0) {
+        return StreamWriter::BinarySetSize(empty_binaryset());
+    }
+
+    std::shared_lock lock(rw_mutex_);
+    uint64_t size = StreamWriter::SectionHeaderSize(HNSW_DATA) + alg_hnsw_->calcSerializeSize();
+    if (use_conjugate_graph_) {
+        // the memory usage of the conjugate graph is its serialized size
+        size += StreamWriter::SectionHeaderSize(CONJUGATE_GRAPH_DATA) +
+                conjugate_graph_->GetMemoryUsage();
+    }
+    return size;
+}
+
 tl::expected<void, Error>
 HNSW::deserialize(const BinarySet& binary_set) {
     SlowTaskTimer t("hnsw deserialize");
@@ -994,7 +1039,8 @@ HNSW::init_feature_list() {
                                IndexFeature::SUPPORT_DESERIALIZE_FILE,
                                IndexFeature::SUPPORT_DESERIALIZE_READER_SET,
                                IndexFeature::SUPPORT_SERIALIZE_BINARY_SET,
-                               IndexFeature::SUPPORT_SERIALIZE_FILE});
+                               IndexFeature::SUPPORT_SERIALIZE_FILE,
+                               IndexFeature::SUPPORT_SERIALIZE_WRITE_FUNC});
     // other
     feature_list_.SetFeatures({IndexFeature::SUPPORT_CAL_DISTANCE_BY_ID,
                                IndexFeature::SUPPORT_CHECK_ID_EXIST,
@@ -183,6 +183,14 @@ public:
         SAFE_CALL(return this->serialize(out_stream));
     }
 
+    tl::expected<void, Error>
+    Serialize(WriteFuncType write_func) const override {
+        SAFE_CALL(return this->serialize(write_func));
+    }
+
+    [[nodiscard]] uint64_t
+    CalSerializeSize() const override;
+
     tl::expected<void, Error>
     Deserialize(const BinarySet& binary_set) override {
         SAFE_CALL(return this->deserialize(binary_set));
@@ -312,6 +320,9 @@ private:
     tl::expected<void, Error>
     serialize(std::ostream& out_stream);
 
+    tl::expected<void, Error>
+    serialize(const WriteFuncType& write_func) const;
+
     tl::expected<void, Error>
     deserialize(const BinarySet& binary_set);
 
@@ -349,6 +360,7 @@ private:
     bool use_reversed_edges_ = false;
     bool is_init_memory_ = false;
     int64_t max_degree_{0};
+    std::string graph_reorder_{GRAPH_REORDER_TYPE_VALUE_NONE};
 
     DataTypes type_;
 
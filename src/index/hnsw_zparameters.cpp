@@ -19,6 +19,7 @@
 
 #include <nlohmann/json.hpp>
 
+#include "inner_string_params.h"
 #include "vsag/constants.h"
 
 // NOLINTBEGIN(readability-simplify-boolean-expr)
@@ -79,6 +80,23 @@ HnswParameters::FromJson(JsonType& hnsw_param_obj, IndexCommonParam index_common
     } else {
         obj.use_conjugate_graph = false;
     }
+
+    // set obj.graph_reorder
+    if (hnsw_param_obj.contains(HNSW_PARAMETER_GRAPH_REORDER)) {
+        obj.graph_reorder = hnsw_param_obj[HNSW_PARAMETER_GRAPH_REORDER];
+        CHECK_ARGUMENT(obj.graph_reorder == GRAPH_REORDER_TYPE_VALUE_NONE or
+                           obj.graph_reorder == GRAPH_REORDER_TYPE_VALUE_BFS or
+                           obj.graph_reorder == GRAPH_REORDER_TYPE_VALUE_RCM,
+                       fmt::format("{} must be one of {}, {}, {}, got {}",
+                                   HNSW_PARAMETER_GRAPH_REORDER,
+                                   GRAPH_REORDER_TYPE_VALUE_NONE,
+                                   GRAPH_REORDER_TYPE_VALUE_BFS,
+                                   GRAPH_REORDER_TYPE_VALUE_RCM,
+                                   obj.graph_reorder));
+        CHECK_ARGUMENT(not obj.use_static or obj.graph_reorder == GRAPH_REORDER_TYPE_VALUE_NONE,
+                       fmt::format("{} is not supported by the static hnsw",
+                                   HNSW_PARAMETER_GRAPH_REORDER));
+    }
     return obj;
 }
 
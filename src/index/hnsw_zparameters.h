@@ -21,6 +21,7 @@
 #include "../algorithm/hnswlib/hnswlib.h"
 #include "../data_type.h"
 #include "index_common_param.h"
+#include "inner_string_params.h"
 
 namespace vsag {
 
@@ -39,6 +40,8 @@ public:
     bool normalize{false};
     bool use_reversed_edges{false};
     DataTypes type{DataTypes::DATA_TYPE_FLOAT};
+    // order of the internal ids after build, see ComputeGraphOrder
+    std::string graph_reorder{GRAPH_REORDER_TYPE_VALUE_NONE};
 
 protected:
     HnswParameters() = default;
@@ -15,6 +15,8 @@
 
 #include "pyramid.h"
 
+#include "stream_writer.h"
+
 namespace vsag {
 
 Binary
@@ -296,6 +298,59 @@ Pyramid::Serialize() const {
     return binary_set;
 }
 
+tl::expected<void, Error>
+Pyramid::Serialize(WriteFuncType write_func) const {
+    WriteFuncStreamWriter writer(write_func, 0);
+    auto forward_func = [&writer](uint64_t offset, uint64_t size, void* data) {
+        writer.Write(reinterpret_cast<const char*>(data), size);
+    };
+    for (const auto& root_index : indexes_) {
+        std::string path = root_index.first;
+        std::vector<std::pair<std::string, std::shared_ptr<IndexNode>>> need_serialize_indexes;
+        need_serialize_indexes.emplace_back(path, root_index.second);
+        while (not need_serialize_indexes.empty()) {
+            auto [current_path, index_node] = need_serialize_indexes.back();
+            need_serialize_indexes.pop_back();
+            if (index_node->index) {
+                StreamWriter::WriteSectionHeader(
+                    writer, current_path, index_node->index->CalSerializeSize());
+                auto serialize_result = index_node->index->Serialize(forward_func);
+                if (not serialize_result.has_value()) {
+                    return tl::unexpected(serialize_result.error());
+                }
+            }
+            for (const auto& sub_index_node : index_node->children) {
+                need_serialize_indexes.emplace_back(
+                    current_path + PART_OCTOTHORPE + sub_index_node.first, sub_index_node.second);
+            }
+        }
+    }
+    return {};
+}
+
+uint64_t
+Pyramid::CalSerializeSize() const {
+    uint64_t size = 0;
+    for (const auto& root_index : indexes_) {
+        std::string path = root_index.first;
+        std::vector<std::pair<std::string, std::shared_ptr<IndexNode>>> need_serialize_indexes;
+        need_serialize_indexes.emplace_back(path, root_index.second);
+        while (not need_serialize_indexes.empty()) {
+            auto [current_path, index_node] = need_serialize_indexes.back();
+            need_serialize_indexes.pop_back();
+            if (index_node->index) {
+                size += StreamWriter::SectionHeaderSize(current_path) +
+                        index_node->index->CalSerializeSize();
+            }
+            for (const auto& sub_index_node : index_node->children) {
+                need_serialize_indexes.emplace_back(
+                    current_path + PART_OCTOTHORPE + sub_index_node.first, sub_index_node.second);
+            }
+        }
+    }
+    return size;
+}
+
 tl::expected<void, Error>
 Pyramid::Deserialize(const BinarySet& binary_set) {
     auto keys = binary_set.GetKeys();
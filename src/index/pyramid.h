@@ -157,6 +157,12 @@ public:
     tl::expected<BinarySet, Error>
     Serialize() const override;
 
+    tl::expected<void, Error>
+    Serialize(WriteFuncType write_func) const override;
+
+    [[nodiscard]] uint64_t
+    CalSerializeSize() const override;
+
     tl::expected<void, Error>
     Deserialize(const BinarySet& binary_set) override;
 
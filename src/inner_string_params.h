@@ -27,6 +27,13 @@ const char* const HGRAPH_USE_REORDER_KEY = "use_reorder";
 const char* const HGRAPH_GRAPH_KEY = "graph";
 const char* const HGRAPH_BASE_CODES_KEY = "base_codes";
 const char* const HGRAPH_PRECISE_CODES_KEY = "precise_codes";
+const char* const HGRAPH_RERANK_STAGES_KEY = "rerank_stages";
+const char* const HGRAPH_RERANK_CANDIDATE_FACTOR_KEY = "candidate_factor";
+const char* const HGRAPH_COLOCATE_GRAPH_KEY = "colocate_graph";
+
+// flatten codes param key
+const char* const FLATTEN_DRIFT_THRESHOLD_KEY = "drift_threshold";
+const char* const FLATTEN_DRIFT_MIN_COUNT_KEY = "drift_min_count";
 
 // IO param key
 const char* const IO_PARAMS_KEY = "io_params";
@@ -34,7 +41,14 @@ const char* const IO_PARAMS_KEY = "io_params";
 const char* const IO_TYPE_KEY = "type";
 const char* const IO_TYPE_VALUE_MEMORY_IO = "memory_io";
 const char* const IO_TYPE_VALUE_BLOCK_MEMORY_IO = "block_memory_io";
+const char* const IO_TYPE_VALUE_TIERED_IO = "tiered_io";
 const char* const BLOCK_IO_BLOCK_SIZE_KEY = "block_size";
+const char* const BLOCK_IO_USE_HUGEPAGE_KEY = "use_hugepage";
+const char* const BLOCK_IO_NUMA_INTERLEAVE_KEY = "numa_interleave";
+const char* const TIERED_IO_HOT_SIZE_KEY = "hot_size";
+const char* const TIERED_IO_PAGE_SIZE_KEY = "page_size";
+const char* const TIERED_IO_DIR_KEY = "dir";
+const char* const TIERED_IO_PROMOTE_INTERVAL_KEY = "promote_interval";
 
 // quantization params key
 const char* const QUANTIZATION_PARAMS_KEY = "quantization_params";
@@ -47,13 +61,29 @@ const char* const QUANTIZATION_TYPE_VALUE_SQ4_UNIFORM = "sq4_uniform";
 const char* const QUANTIZATION_TYPE_VALUE_FP32 = "fp32";
 const char* const QUANTIZATION_TYPE_VALUE_PQ = "pq";
 
+// transform params key
+const char* const TRANSFORM_PARAMS_KEY = "transform_params";
+// transform type
+const char* const TRANSFORM_TYPE_KEY = "type";
+const char* const TRANSFORM_TYPE_VALUE_PCA = "pca";
+const char* const TRANSFORM_TYPE_VALUE_RANDOM_ROTATION = "random_rotation";
+const char* const TRANSFORM_OUTPUT_DIM_KEY = "output_dim";
+
 // graph param value
 const char* const GRAPH_PARAM_MAX_DEGREE = "max_degree";
 const char* const GRAPH_PARAM_INIT_MAX_CAPACITY = "init_capacity";
+const char* const GRAPH_PARAM_USE_COMPRESSION = "use_compression";
 
 const char* const BUILD_PARAMS_KEY = "build_params";
 const char* const BUILD_THREAD_COUNT = "build_thread_count";
 const char* const BUILD_EF_CONSTRUCTION = "ef_construction";
+const char* const BUILD_GRAPH_REORDER = "graph_reorder";
+const char* const BUILD_TUNE_PREFETCH = "tune_prefetch";
+
+// graph reorder param value
+const char* const GRAPH_REORDER_TYPE_VALUE_NONE = "none";
+const char* const GRAPH_REORDER_TYPE_VALUE_BFS = "bfs";
+const char* const GRAPH_REORDER_TYPE_VALUE_RCM = "rcm";
 
 const std::unordered_map<std::string, std::string> DEFAULT_MAP = {
     {"INDEX_TYPE_HGRAPH", INDEX_TYPE_HGRAPH},
@@ -61,21 +91,44 @@ const std::unordered_map<std::string, std::string> DEFAULT_MAP = {
     {"HGRAPH_GRAPH_KEY", HGRAPH_GRAPH_KEY},
     {"HGRAPH_BASE_CODES_KEY", HGRAPH_BASE_CODES_KEY},
     {"HGRAPH_PRECISE_CODES_KEY", HGRAPH_PRECISE_CODES_KEY},
+    {"HGRAPH_RERANK_STAGES_KEY", HGRAPH_RERANK_STAGES_KEY},
+    {"HGRAPH_RERANK_CANDIDATE_FACTOR_KEY", HGRAPH_RERANK_CANDIDATE_FACTOR_KEY},
+    {"HGRAPH_COLOCATE_GRAPH_KEY", HGRAPH_COLOCATE_GRAPH_KEY},
+    {"FLATTEN_DRIFT_THRESHOLD_KEY", FLATTEN_DRIFT_THRESHOLD_KEY},
+    {"FLATTEN_DRIFT_MIN_COUNT_KEY", FLATTEN_DRIFT_MIN_COUNT_KEY},
     {"IO_TYPE_KEY", IO_TYPE_KEY},
     {"IO_TYPE_VALUE_MEMORY_IO", IO_TYPE_VALUE_MEMORY_IO},
     {"IO_TYPE_VALUE_BLOCK_MEMORY_IO", IO_TYPE_VALUE_BLOCK_MEMORY_IO},
+    {"IO_TYPE_VALUE_TIERED_IO", IO_TYPE_VALUE_TIERED_IO},
     {"IO_PARAMS_KEY", IO_PARAMS_KEY},
     {"BLOCK_IO_BLOCK_SIZE_KEY", BLOCK_IO_BLOCK_SIZE_KEY},
+    {"BLOCK_IO_USE_HUGEPAGE_KEY", BLOCK_IO_USE_HUGEPAGE_KEY},
+    {"BLOCK_IO_NUMA_INTERLEAVE_KEY", BLOCK_IO_NUMA_INTERLEAVE_KEY},
+    {"TIERED_IO_HOT_SIZE_KEY", TIERED_IO_HOT_SIZE_KEY},
+    {"TIERED_IO_PAGE_SIZE_KEY", TIERED_IO_PAGE_SIZE_KEY},
+    {"TIERED_IO_DIR_KEY", TIERED_IO_DIR_KEY},
+    {"TIERED_IO_PROMOTE_INTERVAL_KEY", TIERED_IO_PROMOTE_INTERVAL_KEY},
     {"QUANTIZATION_TYPE_KEY", QUANTIZATION_TYPE_KEY},
     {"QUANTIZATION_TYPE_VALUE_SQ8", QUANTIZATION_TYPE_VALUE_SQ8},
     {"QUANTIZATION_TYPE_VALUE_FP32", QUANTIZATION_TYPE_VALUE_FP32},
     {"QUANTIZATION_TYPE_VALUE_PQ", QUANTIZATION_TYPE_VALUE_PQ},
     {"QUANTIZATION_PARAMS_KEY", QUANTIZATION_PARAMS_KEY},
+    {"TRANSFORM_PARAMS_KEY", TRANSFORM_PARAMS_KEY},
+    {"TRANSFORM_TYPE_KEY", TRANSFORM_TYPE_KEY},
+    {"TRANSFORM_TYPE_VALUE_PCA", TRANSFORM_TYPE_VALUE_PCA},
+    {"TRANSFORM_TYPE_VALUE_RANDOM_ROTATION", TRANSFORM_TYPE_VALUE_RANDOM_ROTATION},
+    {"TRANSFORM_OUTPUT_DIM_KEY", TRANSFORM_OUTPUT_DIM_KEY},
     {"GRAPH_PARAM_MAX_DEGREE", GRAPH_PARAM_MAX_DEGREE},
     {"GRAPH_PARAM_INIT_MAX_CAPACITY", GRAPH_PARAM_INIT_MAX_CAPACITY},
+    {"GRAPH_PARAM_USE_COMPRESSION", GRAPH_PARAM_USE_COMPRESSION},
     {"BUILD_PARAMS_KEY", BUILD_PARAMS_KEY},
     {"BUILD_THREAD_COUNT", BUILD_THREAD_COUNT},
     {"BUILD_EF_CONSTRUCTION", BUILD_EF_CONSTRUCTION},
+    {"BUILD_GRAPH_REORDER", BUILD_GRAPH_REORDER},
+    {"BUILD_TUNE_PREFETCH", BUILD_TUNE_PREFETCH},
+    {"GRAPH_REORDER_TYPE_VALUE_NONE", GRAPH_REORDER_TYPE_VALUE_NONE},
+    {"GRAPH_REORDER_TYPE_VALUE_BFS", GRAPH_REORDER_TYPE_VALUE_BFS},
+    {"GRAPH_REORDER_TYPE_VALUE_RCM", GRAPH_REORDER_TYPE_VALUE_RCM},
 };
 
 }  // namespace vsag
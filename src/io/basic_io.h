@@ -78,6 +78,20 @@ public:
         }
     }
 
+    /**
+     * @brief Returns the data in place when the io can, otherwise copies it into buffer.
+     *
+     * Unlike the need_release read this never allocates, buffer must hold size bytes.
+     */
+    [[nodiscard]] inline const uint8_t*
+    ReadOrCopy(uint64_t size, uint64_t offset, uint8_t* buffer) const {
+        if constexpr (has_ReadOrCopyImpl<IOTmpl>::value) {
+            return cast().ReadOrCopyImpl(size, offset, buffer);
+        } else {
+            return this->Read(size, offset, buffer) ? buffer : nullptr;
+        }
+    }
+
     inline bool
     MultiRead(uint8_t* datas, uint64_t* sizes, uint64_t* offsets, uint64_t count) const {
         if constexpr (has_MultiReadImpl<IOTmpl>::value) {
@@ -128,6 +142,16 @@ public:
         }
     }
 
+    [[nodiscard]] inline uint64_t
+    HugePageMemory() const {
+        // ios without hugepage support simply report none
+        if constexpr (has_HugePageMemoryImpl<IOTmpl>::value) {
+            return cast().HugePageMemoryImpl();
+        } else {
+            return 0;
+        }
+    }
+
 private:
     inline IOTmpl&
     cast() {
@@ -143,10 +167,13 @@ private:
     GENERATE_HAS_MEMBER_FUNC(WriteImpl, void (U::*)(const uint8_t*, uint64_t, uint64_t))
     GENERATE_HAS_MEMBER_FUNC(ReadImpl, bool (U::*)(uint64_t, uint64_t, uint8_t*))
     GENERATE_HAS_MEMBER_FUNC(DirectReadImpl, const uint8_t* (U::*)(uint64_t, uint64_t, bool&))
+    GENERATE_HAS_MEMBER_FUNC(ReadOrCopyImpl,
+                             const uint8_t* (U::*)(uint64_t, uint64_t, uint8_t*))
     GENERATE_HAS_MEMBER_FUNC(MultiReadImpl, bool (U::*)(uint8_t*, uint64_t*, uint64_t*, uint64_t))
     GENERATE_HAS_MEMBER_FUNC(PrefetchImpl, void (U::*)(uint64_t, uint64_t))
     GENERATE_HAS_MEMBER_FUNC(SerializeImpl, void (U::*)(StreamWriter&))
     GENERATE_HAS_MEMBER_FUNC(DeserializeImpl, void (U::*)(StreamReader&))
     GENERATE_HAS_MEMBER_FUNC(ReleaseImpl, void (U::*)(const uint8_t*))
+    GENERATE_HAS_MEMBER_FUNC(HugePageMemoryImpl, uint64_t (U::*)() const)
 };
 }  // namespace vsag
@@ -46,6 +46,9 @@ TestBasicReadWrite(BasicIO<T>& io) {
                 if (need_release) {
                     io.Release(ptr);
                 }
+                std::vector<uint8_t> buffer(item.length_);
+                ptr = io.ReadOrCopy(item.length_, item.start_, buffer.data());
+                REQUIRE(memcmp(data.data(), ptr, item.length_) == 0);
             }
         }
     }
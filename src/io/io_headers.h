@@ -18,3 +18,4 @@
 #include "basic_io.h"
 #include "memory_block_io.h"
 #include "memory_io.h"
+#include "tiered_io.h"
@@ -18,6 +18,7 @@
 #include "inner_string_params.h"
 #include "memory_block_io_parameter.h"
 #include "memory_io_parameter.h"
+#include "tiered_io_parameter.h"
 
 namespace vsag {
 
@@ -32,6 +33,9 @@ IOParameter::GetIOParameterByJson(const JsonType& json) {
         } else if (type_name == IO_TYPE_VALUE_BLOCK_MEMORY_IO) {
             io_ptr = std::make_shared<MemoryBlockIOParameter>();
             io_ptr->FromJson(json);
+        } else if (type_name == IO_TYPE_VALUE_TIERED_IO) {
+            io_ptr = std::make_shared<TieredIOParameter>();
+            io_ptr->FromJson(json);
         }
     } catch (std::invalid_argument& error) {
         return nullptr;
@@ -15,10 +15,14 @@
 
 #pragma once
 
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <bit>
 #include <cmath>
 #include <cstring>
+#include <fstream>
 #include <nlohmann/json.hpp>
 #include <stdexcept>
 
@@ -27,6 +31,7 @@
 #include "index/index_common_param.h"
 #include "inner_string_params.h"
 #include "memory_block_io_parameter.h"
+#include "numa_utils.h"
 #include "prefetch.h"
 #include "vsag/allocator.h"
 
@@ -34,23 +39,31 @@ namespace vsag {
 
 class MemoryBlockIO : public BasicIO<MemoryBlockIO> {
 public:
-    explicit MemoryBlockIO(Allocator* allocator, uint64_t block_size)
+    explicit MemoryBlockIO(Allocator* allocator,
+                           uint64_t block_size,
+                           bool use_hugepage = false,
+                           bool numa_interleave = false)
         : block_size_(MemoryBlockIOParameter::NearestPowerOfTwo(block_size)),
           allocator_(allocator),
-          blocks_(0, allocator) {
+          blocks_(0, allocator),
+          block_bases_(0, allocator),
+          block_sources_(0, allocator),
+          use_hugepage_(use_hugepage),
+          numa_interleave_(numa_interleave) {
         this->update_by_block_size();
     }
 
     explicit MemoryBlockIO(const MemoryBlockIOParamPtr& param, const IndexCommonParam& common_param)
-        : MemoryBlockIO(common_param.allocator_.get(), param->block_size_){};
+        : MemoryBlockIO(common_param.allocator_.get(),
+                        param->block_size_,
+                        param->use_hugepage_,
+                        param->numa_interleave_){};
 
     explicit MemoryBlockIO(const IOParamPtr& param, const IndexCommonParam& common_param)
         : MemoryBlockIO(std::dynamic_pointer_cast<MemoryBlockIOParameter>(param), common_param){};
 
     ~MemoryBlockIO() override {
-        for (auto* block : blocks_) {
-            allocator_->Deallocate(block);
-        }
+        this->release_blocks();
     }
 
     inline void
@@ -62,6 +75,9 @@ public:
     [[nodiscard]] inline const uint8_t*
     DirectReadImpl(uint64_t size, uint64_t offset, bool& need_release) const;
 
+    [[nodiscard]] inline const uint8_t*
+    ReadOrCopyImpl(uint64_t size, uint64_t offset, uint8_t* buffer) const;
+
     inline void
     ReleaseImpl(const uint8_t* data) const {
         auto ptr = const_cast<uint8_t*>(data);
@@ -80,7 +96,29 @@ public:
     inline void
     DeserializeImpl(StreamReader& reader);
 
+    /**
+     * @brief Returns the bytes of the blocks advised as transparent hugepages while the
+     * kernel has them enabled. The kernel may still back parts of them with small pages.
+     */
+    [[nodiscard]] inline uint64_t
+    HugePageMemoryImpl() const;
+
 private:
+    enum class BlockSource : uint8_t {
+        ALLOCATOR = 0,
+        TRANSPARENT_HUGEPAGE = 1,
+    };
+
+    // base receives the pointer to release, the returned block may be aligned within it
+    inline uint8_t*
+    allocate_block(BlockSource& source, uint8_t*& base);
+
+    static inline bool
+    transparent_hugepage_enabled();
+
+    inline void
+    release_blocks();
+
     [[nodiscard]] inline bool
     check_valid_offset(uint64_t size) const {
         return size <= (blocks_.size() << block_bit_);
@@ -114,8 +152,20 @@ private:
 
     Allocator* const allocator_{nullptr};
 
+    // what allocate_block returned as base for each block of blocks_
+    Vector<uint8_t*> block_bases_;
+
+    // how each block of blocks_ was advised, all of them come from allocator_
+    Vector<BlockSource> block_sources_;
+
+    bool use_hugepage_{false};
+
+    bool numa_interleave_{false};
+
     static constexpr uint64_t DEFAULT_BLOCK_SIZE = 128 * 1024 * 1024;  // 128MB
 
+    static constexpr uint64_t HUGEPAGE_SIZE = 2 * 1024 * 1024;  // 2MB
+
     static constexpr uint64_t DEFAULT_BLOCK_BIT = 27;
 
     uint64_t block_bit_{DEFAULT_BLOCK_BIT};
@@ -177,6 +227,17 @@ MemoryBlockIO::DirectReadImpl(uint64_t size, uint64_t offset, bool& need_release
     }
     return nullptr;
 }
+const uint8_t*
+MemoryBlockIO::ReadOrCopyImpl(uint64_t size, uint64_t offset, uint8_t* buffer) const {
+    if (check_valid_offset(size + offset)) {
+        if (check_in_one_block(offset, size + offset)) {
+            return this->get_data_ptr(offset);
+        }
+        this->ReadImpl(size, offset, buffer);
+        return buffer;
+    }
+    return nullptr;
+}
 bool
 MemoryBlockIO::MultiReadImpl(uint8_t* datas,
                              uint64_t* sizes,
@@ -202,11 +263,77 @@ MemoryBlockIO::check_and_realloc(uint64_t size) {
     const uint64_t new_block_count = (size + this->block_size_ - 1) >> block_bit_;
     auto cur_block_size = this->blocks_.size();
     this->blocks_.reserve(new_block_count);
+    this->block_bases_.reserve(new_block_count);
+    this->block_sources_.reserve(new_block_count);
     while (cur_block_size < new_block_count) {
-        this->blocks_.emplace_back((uint8_t*)(allocator_->Allocate(block_size_)));
+        auto source = BlockSource::ALLOCATOR;
+        uint8_t* base = nullptr;
+        this->blocks_.emplace_back(this->allocate_block(source, base));
+        this->block_bases_.emplace_back(base);
+        this->block_sources_.emplace_back(source);
         ++cur_block_size;
     }
 }
+
+uint8_t*
+MemoryBlockIO::allocate_block(BlockSource& source, uint8_t*& base) {
+    source = BlockSource::ALLOCATOR;
+    bool hugepage = use_hugepage_ and block_size_ % HUGEPAGE_SIZE == 0;
+    // hugepages and the NUMA placement policy both apply to whole aligned pages
+    uint64_t alignment = 1;
+    if (hugepage) {
+        alignment = HUGEPAGE_SIZE;
+    } else if (numa_interleave_ and get_numa_node_count() > 1) {
+        alignment = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+    base = static_cast<uint8_t*>(allocator_->Allocate(block_size_ + alignment - 1));
+    auto aligned = (reinterpret_cast<uintptr_t>(base) + alignment - 1) & ~(alignment - 1);
+    auto* block = reinterpret_cast<uint8_t*>(aligned);
+#ifdef MADV_HUGEPAGE
+    if (hugepage and transparent_hugepage_enabled() and
+        madvise(block, block_size_, MADV_HUGEPAGE) == 0) {
+        source = BlockSource::TRANSPARENT_HUGEPAGE;
+    }
+#endif
+    if (numa_interleave_) {
+        interleave_memory_on_numa_nodes(block, block_size_);
+    }
+    return block;
+}
+
+bool
+MemoryBlockIO::transparent_hugepage_enabled() {
+    // e.g. "always [madvise] never", the bracket marks the active mode
+    static const bool enabled = []() {
+        std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+        std::string line;
+        if (not file.is_open() or not std::getline(file, line)) {
+            return false;
+        }
+        return line.find("[always]") != std::string::npos or
+               line.find("[madvise]") != std::string::npos;
+    }();
+    return enabled;
+}
+
+void
+MemoryBlockIO::release_blocks() {
+    for (uint64_t i = 0; i < blocks_.size(); ++i) {
+        allocator_->Deallocate(block_bases_[i]);
+    }
+    blocks_.clear();
+    block_bases_.clear();
+    block_sources_.clear();
+}
+
+uint64_t
+MemoryBlockIO::HugePageMemoryImpl() const {
+    uint64_t count = 0;
+    for (const auto& source : block_sources_) {
+        count += static_cast<uint64_t>(source == BlockSource::TRANSPARENT_HUGEPAGE);
+    }
+    return count * block_size_;
+}
 void
 MemoryBlockIO::SerializeImpl(StreamWriter& writer) {
     StreamWriter::WriteObj(writer, this->block_size_);
@@ -219,15 +346,16 @@ MemoryBlockIO::SerializeImpl(StreamWriter& writer) {
 
 void
 MemoryBlockIO::DeserializeImpl(StreamReader& reader) {
-    for (auto* block : blocks_) {
-        allocator_->Deallocate(block);
-    }
+    this->release_blocks();
     StreamReader::ReadObj(reader, this->block_size_);
+    this->update_by_block_size();
     uint64_t block_count;
     StreamReader::ReadObj(reader, block_count);
     this->blocks_.resize(block_count);
+    this->block_bases_.resize(block_count);
+    this->block_sources_.resize(block_count);
     for (uint64_t i = 0; i < block_count; ++i) {
-        blocks_[i] = static_cast<unsigned char*>(allocator_->Allocate(this->block_size_));
+        blocks_[i] = this->allocate_block(block_sources_[i], block_bases_[i]);
         reader.Read(reinterpret_cast<char*>(blocks_[i]), block_size_);
     }
 }
@@ -32,12 +32,20 @@ void
 MemoryBlockIOParameter::FromJson(const JsonType& json) {
     auto block_size = Options::Instance().block_size_limit();
     this->block_size_ = NearestPowerOfTwo(block_size);
+    if (json.contains(BLOCK_IO_USE_HUGEPAGE_KEY)) {
+        this->use_hugepage_ = json[BLOCK_IO_USE_HUGEPAGE_KEY];
+    }
+    if (json.contains(BLOCK_IO_NUMA_INTERLEAVE_KEY)) {
+        this->numa_interleave_ = json[BLOCK_IO_NUMA_INTERLEAVE_KEY];
+    }
 }
 
 JsonType
 MemoryBlockIOParameter::ToJson() {
     JsonType json;
     json[IO_TYPE_KEY] = IO_TYPE_VALUE_MEMORY_IO;
+    json[BLOCK_IO_USE_HUGEPAGE_KEY] = this->use_hugepage_;
+    json[BLOCK_IO_NUMA_INTERLEAVE_KEY] = this->numa_interleave_;
     return json;
 }
 
@@ -35,6 +35,12 @@ public:
 
 public:
     uint64_t block_size_{};
+
+    // advise the blocks as 2MB transparent hugepages if the kernel has them enabled
+    bool use_hugepage_{false};
+
+    // spread the pages of every block across all NUMA nodes
+    bool numa_interleave_{false};
 };
 
 using MemoryBlockIOParamPtr = std::shared_ptr<MemoryBlockIOParameter>;
@@ -27,4 +27,12 @@ TEST_CASE("MemoryBlockIOParameter Test", "[ut][MemoryBlockIOParameter]") {
     auto json = JsonType::parse(param_str);
     param->FromJson(json);
     ParameterTest::TestToJson(param);
+    REQUIRE_FALSE(param->use_hugepage_);
+    REQUIRE_FALSE(param->numa_interleave_);
+
+    json = JsonType::parse(R"({"use_hugepage": true, "numa_interleave": true})");
+    param->FromJson(json);
+    REQUIRE(param->use_hugepage_);
+    REQUIRE(param->numa_interleave_);
+    ParameterTest::TestToJson(param);
 }
@@ -20,6 +20,7 @@
 
 #include "basic_io_test.h"
 #include "default_allocator.h"
+#include "memory_record_allocator.h"
 #include "safe_allocator.h"
 
 using namespace vsag;
@@ -42,3 +43,42 @@ TEST_CASE("MemoryBlockIO Serialize and Deserialize Test", "[ut][MemoryBlockIO]")
         TestSerializeAndDeserialize(*wio, *rio);
     }
 }
+
+TEST_CASE("MemoryBlockIO Hugepage Test", "[ut][MemoryBlockIO]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    uint64_t block_size = 2 * 1024 * 1024;
+    auto io = std::make_unique<MemoryBlockIO>(allocator.get(), block_size, true);
+    TestBasicReadWrite(*io);
+    // transparent hugepages may be disabled, the blocks are then plain allocator memory
+    REQUIRE(io->HugePageMemory() % block_size == 0);
+
+    // hugepage blocks are accounted by the allocator
+    fixtures::MemoryRecordAllocator record_allocator;
+    {
+        MemoryBlockIO record_io(&record_allocator, block_size, true);
+        std::vector<uint8_t> data(block_size * 2, 1);
+        record_io.Write(data.data(), data.size(), 0);
+        REQUIRE(record_allocator.GetCurrentMemory() >= block_size * 2);
+    }
+    REQUIRE(record_allocator.GetCurrentMemory() == 0);
+
+    auto wio = std::make_unique<MemoryBlockIO>(allocator.get(), block_size, true);
+    auto rio = std::make_unique<MemoryBlockIO>(allocator.get(), block_size, true);
+    TestSerializeAndDeserialize(*wio, *rio);
+
+    auto plain_io = std::make_unique<MemoryBlockIO>(allocator.get(), block_size);
+    TestBasicReadWrite(*plain_io);
+    REQUIRE(plain_io->HugePageMemory() == 0);
+}
+
+TEST_CASE("MemoryBlockIO Numa Interleave Test", "[ut][MemoryBlockIO]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    uint64_t block_size = 2 * 1024 * 1024;
+    for (auto use_hugepage : {false, true}) {
+        auto io = std::make_unique<MemoryBlockIO>(allocator.get(), block_size, use_hugepage, true);
+        TestBasicReadWrite(*io);
+        auto wio = std::make_unique<MemoryBlockIO>(allocator.get(), block_size, use_hugepage, true);
+        auto rio = std::make_unique<MemoryBlockIO>(allocator.get(), block_size, use_hugepage, true);
+        TestSerializeAndDeserialize(*wio, *rio);
+    }
+}
@@ -54,6 +54,9 @@ public:
     [[nodiscard]] inline const uint8_t*
     DirectReadImpl(uint64_t size, uint64_t offset, bool& need_release) const;
 
+    [[nodiscard]] inline const uint8_t*
+    ReadOrCopyImpl(uint64_t size, uint64_t offset, uint8_t* buffer) const;
+
     inline void
     ReleaseImpl(const uint8_t* data) const {};
 
@@ -114,6 +117,13 @@ MemoryIO::DirectReadImpl(uint64_t size, uint64_t offset, bool& need_release) con
     }
     return nullptr;
 }
+const uint8_t*
+MemoryIO::ReadOrCopyImpl(uint64_t size, uint64_t offset, uint8_t* buffer) const {
+    if (check_valid_offset(size + offset)) {
+        return start_ + offset;
+    }
+    return nullptr;
+}
 bool
 MemoryIO::MultiReadImpl(uint8_t* datas, uint64_t* sizes, uint64_t* offsets, uint64_t count) const {
     bool ret = true;
@@ -0,0 +1,568 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+
+#include "basic_io.h"
+#include "index/index_common_param.h"
+#include "prefetch.h"
+#include "tiered_io_parameter.h"
+#include "vsag/allocator.h"
+
+namespace vsag {
+
+/**
+ * Stores all data in an unlinked file and keeps the most read pages in memory.
+ *
+ * Every read counts the pages it touches, after promote_interval reads the hottest pages
+ * are loaded into the hot tier and the others are dropped from it, in the thread pool if
+ * one is given. Counts are halved on each pass so that the hot set follows the workload.
+ * Writes go to the file and update hot copies. A direct read within one hot page returns
+ * the hot copy itself and pins its tier until it is released, other reads return copies.
+ */
+class TieredIO : public BasicIO<TieredIO> {
+public:
+    explicit TieredIO(Allocator* allocator,
+                      uint64_t hot_size,
+                      uint64_t page_size,
+                      const std::string& dir,
+                      uint64_t promote_interval,
+                      std::shared_ptr<SafeThreadPool> thread_pool = nullptr)
+        : allocator_(allocator),
+          page_size_(page_size),
+          hot_page_capacity_(hot_size / page_size),
+          promote_interval_(promote_interval),
+          thread_pool_(std::move(thread_pool)),
+          retired_tiers_(allocator),
+          dirty_pages_(allocator) {
+        hot_tier_ = allocator_->New<HotTier>(allocator_);
+        this->open_file(dir);
+    }
+
+    explicit TieredIO(const TieredIOParamPtr& param, const IndexCommonParam& common_param)
+        : TieredIO(common_param.allocator_.get(),
+                   param->hot_size_,
+                   param->page_size_,
+                   param->dir_,
+                   param->promote_interval_,
+                   common_param.thread_pool_){};
+
+    explicit TieredIO(const IOParamPtr& param, const IndexCommonParam& common_param)
+        : TieredIO(std::dynamic_pointer_cast<TieredIOParameter>(param), common_param){};
+
+    ~TieredIO() override {
+        {
+            std::lock_guard<std::mutex> lock(this->promote_future_mutex_);
+            if (this->promote_future_.valid()) {
+                this->promote_future_.wait();
+            }
+        }
+        allocator_->Delete(hot_tier_);
+        for (auto* tier : retired_tiers_) {
+            allocator_->Delete(tier);
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    inline void
+    WriteImpl(const uint8_t* data, uint64_t size, uint64_t offset);
+
+    inline bool
+    ReadImpl(uint64_t size, uint64_t offset, uint8_t* data) const;
+
+    [[nodiscard]] inline const uint8_t*
+    DirectReadImpl(uint64_t size, uint64_t offset, bool& need_release) const;
+
+    inline void
+    ReleaseImpl(const uint8_t* data) const;
+
+    inline bool
+    MultiReadImpl(uint8_t* datas, uint64_t* sizes, uint64_t* offsets, uint64_t count) const;
+
+    inline void
+    PrefetchImpl(uint64_t offset, uint64_t cache_line = 64);
+
+    inline void
+    SerializeImpl(StreamWriter& writer);
+
+    inline void
+    DeserializeImpl(StreamReader& reader);
+
+    /**
+     * @brief Moves the most read pages into the hot tier and drops the others from it.
+     */
+    inline void
+    Promote() const;
+
+    [[nodiscard]] uint64_t
+    HotPageCount() const {
+        std::shared_lock<std::shared_mutex> lock(this->tier_mutex_);
+        return this->hot_tier_->page_count;
+    }
+
+private:
+    /**
+     * page_count pages of page_size_, page_to_slot maps a page to its slot. Promotion passes
+     * replace the whole tier, a replaced tier is kept until its pinned reads are released.
+     */
+    struct HotTier {
+        explicit HotTier(Allocator* allocator) : pages(allocator), page_to_slot(allocator) {
+        }
+
+        [[nodiscard]] uint32_t
+        slot_of(uint64_t page) const {
+            return page < page_to_slot.size() ? page_to_slot[page] : COLD_PAGE;
+        }
+
+        [[nodiscard]] bool
+        contains(const uint8_t* data) const {
+            return data >= pages.data() and data < pages.data() + pages.size();
+        }
+
+        Vector<uint8_t> pages;
+        Vector<uint32_t> page_to_slot;
+        uint64_t page_count{0};
+        // direct reads served in place and not released yet
+        mutable std::atomic<uint64_t> pins{0};
+    };
+
+    inline void
+    open_file(const std::string& dir);
+
+    inline void
+    read_file(uint8_t* data, uint64_t size, uint64_t offset) const;
+
+    inline void
+    write_file(const uint8_t* data, uint64_t size, uint64_t offset) const;
+
+    inline void
+    grow_counts(uint64_t page_count);
+
+    inline void
+    count_access(uint64_t size, uint64_t offset) const;
+
+    inline void
+    maybe_promote() const;
+
+    // releases a replaced tier once its pinned reads are released, called under an exclusive
+    // tier_mutex_ so that no new read pins it
+    inline void
+    retire_tier(HotTier* tier) const;
+
+private:
+    Allocator* const allocator_{nullptr};
+
+    const uint64_t page_size_{4096};
+    const uint64_t hot_page_capacity_{0};
+    const uint64_t promote_interval_{100000};
+
+    std::shared_ptr<SafeThreadPool> thread_pool_{nullptr};
+
+    int fd_{-1};
+
+    // bytes written so far, the file may be larger after a deserialization
+    uint64_t size_{0};
+
+    // held shared by readers and exclusively by writers and while swapping the hot tier
+    mutable std::shared_mutex tier_mutex_;
+
+    // swapped by promotion passes that are started from reads
+    mutable HotTier* hot_tier_{nullptr};
+
+    // replaced tiers with pinned reads
+    mutable std::mutex retired_mutex_;
+    mutable Vector<HotTier*> retired_tiers_;
+
+    // read counts per page, only resized under an exclusive tier_mutex_
+    std::unique_ptr<std::atomic<uint32_t>[]> access_counts_{nullptr};
+    uint64_t access_count_capacity_{0};
+
+    mutable std::atomic<uint64_t> reads_since_promote_{0};
+
+    // pages written while a promotion pass builds its tier, reloaded before the swap
+    mutable Vector<uint64_t> dirty_pages_;
+    mutable bool track_dirty_{false};
+
+    // one promotion pass at a time
+    mutable std::mutex promote_mutex_;
+
+    mutable std::mutex promote_future_mutex_;
+    mutable std::future<void> promote_future_;
+    mutable std::atomic<bool> promote_running_{false};
+
+    static constexpr uint32_t COLD_PAGE = std::numeric_limits<uint32_t>::max();
+};
+
+void
+TieredIO::open_file(const std::string& dir) {
+    auto path = dir.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(dir);
+    auto file_template = (path / "vsag_tiered_io_XXXXXX").string();
+    fd_ = mkstemp(file_template.data());
+    if (fd_ < 0) {
+        throw std::runtime_error(
+            fmt::format("failed to create the backing file of tiered io in {}", path.string()));
+    }
+    // the file lives as long as the descriptor
+    unlink(file_template.c_str());
+}
+
+void
+TieredIO::read_file(uint8_t* data, uint64_t size, uint64_t offset) const {
+    while (size > 0) {
+        auto ret = pread(fd_, data, size, static_cast<off_t>(offset));
+        if (ret == 0) {
+            // holes past the end of the file read as zeros
+            memset(data, 0, size);
+            return;
+        }
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(fmt::format(
+                "tiered io failed to read {} bytes at {}: {}", size, offset, strerror(errno)));
+        }
+        data += ret;
+        size -= ret;
+        offset += ret;
+    }
+}
+
+void
+TieredIO::write_file(const uint8_t* data, uint64_t size, uint64_t offset) const {
+    while (size > 0) {
+        auto ret = pwrite(fd_, data, size, static_cast<off_t>(offset));
+        if (ret < 0) {
+            throw std::runtime_error(fmt::format("tiered io failed to write {} bytes", size));
+        }
+        data += ret;
+        size -= ret;
+        offset += ret;
+    }
+}
+
+void
+TieredIO::grow_counts(uint64_t page_count) {
+    if (page_count <= access_count_capacity_) {
+        return;
+    }
+    auto new_capacity = std::max(page_count, access_count_capacity_ * 2);
+    auto new_counts = std::make_unique<std::atomic<uint32_t>[]>(new_capacity);
+    for (uint64_t i = 0; i < new_capacity; ++i) {
+        auto count = i < access_count_capacity_ ? access_counts_[i].load() : 0;
+        new_counts[i].store(count, std::memory_order_relaxed);
+    }
+    access_counts_ = std::move(new_counts);
+    access_count_capacity_ = new_capacity;
+}
+
+void
+TieredIO::count_access(uint64_t size, uint64_t offset) const {
+    auto last_page = std::min((offset + size - 1) / page_size_, access_count_capacity_ - 1);
+    for (auto page = offset / page_size_; page <= last_page; ++page) {
+        access_counts_[page].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void
+TieredIO::WriteImpl(const uint8_t* data, uint64_t size, uint64_t offset) {
+    if (size == 0) {
+        return;
+    }
+    std::unique_lock<std::shared_mutex> lock(this->tier_mutex_);
+    this->write_file(data, size, offset);
+    size_ = std::max(size_, offset + size);
+    this->grow_counts((size_ + page_size_ - 1) / page_size_);
+
+    // keep the hot copies in sync
+    auto end = offset + size;
+    for (auto page = offset / page_size_; page * page_size_ < end; ++page) {
+        if (track_dirty_) {
+            dirty_pages_.push_back(page);
+        }
+        auto slot = hot_tier_->slot_of(page);
+        if (slot == COLD_PAGE) {
+            continue;
+        }
+        auto begin = std::max(offset, page * page_size_);
+        auto length = std::min(end, (page + 1) * page_size_) - begin;
+        memcpy(hot_tier_->pages.data() + slot * page_size_ + (begin - page * page_size_),
+               data + (begin - offset),
+               length);
+    }
+}
+
+bool
+TieredIO::ReadImpl(uint64_t size, uint64_t offset, uint8_t* data) const {
+    {
+        std::shared_lock<std::shared_mutex> lock(this->tier_mutex_);
+        if (size + offset > size_) {
+            return false;
+        }
+        if (size == 0) {
+            return true;
+        }
+        auto end = offset + size;
+        for (auto page = offset / page_size_; page * page_size_ < end; ++page) {
+            auto begin = std::max(offset, page * page_size_);
+            auto length = std::min(end, (page + 1) * page_size_) - begin;
+            auto slot = hot_tier_->slot_of(page);
+            if (slot == COLD_PAGE) {
+                this->read_file(data + (begin - offset), length, begin);
+            } else {
+                memcpy(data + (begin - offset),
+                       hot_tier_->pages.data() + slot * page_size_ + (begin - page * page_size_),
+                       length);
+            }
+        }
+        this->count_access(size, offset);
+    }
+    this->maybe_promote();
+    return true;
+}
+
+void
+TieredIO::maybe_promote() const {
+    if (hot_page_capacity_ > 0 and
+        reads_since_promote_.fetch_add(1, std::memory_order_relaxed) + 1 >= promote_interval_) {
+        bool expected = false;
+        if (promote_running_.compare_exchange_strong(expected, true)) {
+            reads_since_promote_.store(0, std::memory_order_relaxed);
+            if (thread_pool_ == nullptr) {
+                this->Promote();
+                promote_running_ = false;
+            } else {
+                std::lock_guard<std::mutex> lock(this->promote_future_mutex_);
+                promote_future_ = thread_pool_->GeneralEnqueue([this]() {
+                    this->Promote();
+                    promote_running_ = false;
+                });
+            }
+        }
+    }
+}
+
+const uint8_t*
+TieredIO::DirectReadImpl(uint64_t size, uint64_t offset, bool& need_release) const {
+    if (size > 0 and offset / page_size_ == (offset + size - 1) / page_size_) {
+        const uint8_t* ptr = nullptr;
+        {
+            std::shared_lock<std::shared_mutex> lock(this->tier_mutex_);
+            if (size + offset > size_) {
+                need_release = false;
+                return nullptr;
+            }
+            auto page = offset / page_size_;
+            auto slot = hot_tier_->slot_of(page);
+            if (slot != COLD_PAGE) {
+                // the tier stays alive until the read is released
+                hot_tier_->pins.fetch_add(1, std::memory_order_relaxed);
+                ptr = hot_tier_->pages.data() + slot * page_size_ + (offset - page * page_size_);
+                this->count_access(size, offset);
+            }
+        }
+        if (ptr != nullptr) {
+            this->maybe_promote();
+            need_release = true;
+            return ptr;
+        }
+    }
+    auto* ptr = reinterpret_cast<uint8_t*>(allocator_->Allocate(std::max<uint64_t>(size, 1)));
+    if (not this->ReadImpl(size, offset, ptr)) {
+        allocator_->Deallocate(ptr);
+        need_release = false;
+        return nullptr;
+    }
+    need_release = true;
+    return ptr;
+}
+
+void
+TieredIO::ReleaseImpl(const uint8_t* data) const {
+    {
+        std::shared_lock<std::shared_mutex> lock(this->tier_mutex_);
+        if (hot_tier_->contains(data)) {
+            hot_tier_->pins.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->retired_mutex_);
+        for (auto iter = retired_tiers_.begin(); iter != retired_tiers_.end(); ++iter) {
+            auto* tier = *iter;
+            if (tier->contains(data)) {
+                if (tier->pins.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    allocator_->Delete(tier);
+                    retired_tiers_.erase(iter);
+                }
+                return;
+            }
+        }
+    }
+    allocator_->Deallocate(const_cast<uint8_t*>(data));
+}
+
+void
+TieredIO::PrefetchImpl(uint64_t offset, uint64_t cache_line) {
+    // a prefetch is only a hint, never wait for a writer
+    std::shared_lock<std::shared_mutex> lock(this->tier_mutex_, std::try_to_lock);
+    if (not lock.owns_lock() or offset >= size_) {
+        return;
+    }
+    auto page = offset / page_size_;
+    auto slot = hot_tier_->slot_of(page);
+    if (slot != COLD_PAGE) {
+        auto length = std::min(cache_line, (page + 1) * page_size_ - offset);
+        PrefetchLines(hot_tier_->pages.data() + slot * page_size_ + (offset - page * page_size_),
+                      length);
+        return;
+    }
+    posix_fadvise(fd_,
+                  static_cast<off_t>(offset),
+                  static_cast<off_t>(cache_line),
+                  POSIX_FADV_WILLNEED);
+}
+
+bool
+TieredIO::MultiReadImpl(uint8_t* datas, uint64_t* sizes, uint64_t* offsets, uint64_t count) const {
+    bool ret = true;
+    for (uint64_t i = 0; i < count; ++i) {
+        ret &= this->ReadImpl(sizes[i], offsets[i], datas);
+        datas += sizes[i];
+    }
+    return ret;
+}
+
+void
+TieredIO::Promote() const {
+    std::lock_guard<std::mutex> pass_lock(this->promote_mutex_);
+    {
+        // writes from here on are reloaded into the new tier before it is swapped in
+        std::unique_lock<std::shared_mutex> lock(this->tier_mutex_);
+        dirty_pages_.clear();
+        track_dirty_ = true;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(this->tier_mutex_);
+    auto page_count = (size_ + page_size_ - 1) / page_size_;
+
+    Vector<std::pair<uint32_t, uint64_t>> candidates(allocator_);
+    candidates.reserve(page_count);
+    for (uint64_t page = 0; page < page_count; ++page) {
+        auto count = access_counts_[page].load(std::memory_order_relaxed);
+        if (count > 0) {
+            candidates.emplace_back(count, page);
+        }
+        // age the counts so that pages that went cold get demoted
+        access_counts_[page].store(count >> 1, std::memory_order_relaxed);
+    }
+    auto hot_count = std::min<uint64_t>(candidates.size(), hot_page_capacity_);
+    std::nth_element(candidates.begin(),
+                     candidates.begin() + static_cast<int64_t>(hot_count),
+                     candidates.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    auto* tier = allocator_->New<HotTier>(allocator_);
+    tier->pages.resize(hot_count * page_size_);
+    tier->page_to_slot.resize(page_count, COLD_PAGE);
+    tier->page_count = hot_count;
+    for (uint64_t slot = 0; slot < hot_count; ++slot) {
+        auto page = candidates[slot].second;
+        tier->page_to_slot[page] = static_cast<uint32_t>(slot);
+        auto old_slot = hot_tier_->slot_of(page);
+        auto* dest = tier->pages.data() + slot * page_size_;
+        if (old_slot != COLD_PAGE) {
+            memcpy(dest, hot_tier_->pages.data() + old_slot * page_size_, page_size_);
+        } else {
+            auto length = std::min(page_size_, size_ - page * page_size_);
+            this->read_file(dest, length, page * page_size_);
+        }
+    }
+    lock.unlock();
+
+    std::unique_lock<std::shared_mutex> swap_lock(this->tier_mutex_);
+    track_dirty_ = false;
+    for (auto page : dirty_pages_) {
+        auto slot = tier->slot_of(page);
+        if (slot != COLD_PAGE) {
+            auto length = std::min(page_size_, size_ - page * page_size_);
+            this->read_file(tier->pages.data() + slot * page_size_, length, page * page_size_);
+        }
+    }
+    dirty_pages_.clear();
+    std::swap(hot_tier_, tier);
+    this->retire_tier(tier);
+}
+
+void
+TieredIO::retire_tier(HotTier* tier) const {
+    std::lock_guard<std::mutex> lock(this->retired_mutex_);
+    if (tier->pins.load(std::memory_order_acquire) == 0) {
+        allocator_->Delete(tier);
+    } else {
+        retired_tiers_.push_back(tier);
+    }
+}
+
+void
+TieredIO::SerializeImpl(StreamWriter& writer) {
+    std::shared_lock<std::shared_mutex> lock(this->tier_mutex_);
+    StreamWriter::WriteObj(writer, this->size_);
+    Vector<uint8_t> buffer(page_size_, allocator_);
+    for (uint64_t offset = 0; offset < size_; offset += page_size_) {
+        auto length = std::min(page_size_, size_ - offset);
+        this->read_file(buffer.data(), length, offset);
+        writer.Write(reinterpret_cast<char*>(buffer.data()), length);
+    }
+}
+
+void
+TieredIO::DeserializeImpl(StreamReader& reader) {
+    std::unique_lock<std::shared_mutex> lock(this->tier_mutex_);
+    uint64_t size;
+    StreamReader::ReadObj(reader, size);
+    Vector<uint8_t> buffer(page_size_, allocator_);
+    for (uint64_t offset = 0; offset < size; offset += page_size_) {
+        auto length = std::min(page_size_, size - offset);
+        reader.Read(reinterpret_cast<char*>(buffer.data()), length);
+        this->write_file(buffer.data(), length, offset);
+    }
+    size_ = size;
+    auto* tier = allocator_->New<HotTier>(allocator_);
+    std::swap(hot_tier_, tier);
+    this->retire_tier(tier);
+    access_counts_.reset();
+    access_count_capacity_ = 0;
+    this->grow_counts((size_ + page_size_ - 1) / page_size_);
+}
+
+}  // namespace vsag
@@ -0,0 +1,63 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tiered_io_parameter.h"
+
+#include <fmt/format-inl.h>
+
+#include "common.h"
+#include "inner_string_params.h"
+
+namespace vsag {
+
+TieredIOParameter::TieredIOParameter() : IOParameter(IO_TYPE_VALUE_TIERED_IO) {
+}
+
+TieredIOParameter::TieredIOParameter(const JsonType& json) : TieredIOParameter() {
+    this->FromJson(json);  // NOLINT(clang-analyzer-optin.cplusplus.VirtualCall)
+}
+
+void
+TieredIOParameter::FromJson(const JsonType& json) {
+    if (json.contains(TIERED_IO_HOT_SIZE_KEY)) {
+        this->hot_size_ = json[TIERED_IO_HOT_SIZE_KEY];
+    }
+    if (json.contains(TIERED_IO_PAGE_SIZE_KEY)) {
+        this->page_size_ = json[TIERED_IO_PAGE_SIZE_KEY];
+    }
+    if (json.contains(TIERED_IO_DIR_KEY)) {
+        this->dir_ = json[TIERED_IO_DIR_KEY];
+    }
+    if (json.contains(TIERED_IO_PROMOTE_INTERVAL_KEY)) {
+        this->promote_interval_ = json[TIERED_IO_PROMOTE_INTERVAL_KEY];
+    }
+    CHECK_ARGUMENT(this->page_size_ > 0,
+                   fmt::format("{} must be greater than 0", TIERED_IO_PAGE_SIZE_KEY));
+    CHECK_ARGUMENT(this->promote_interval_ > 0,
+                   fmt::format("{} must be greater than 0", TIERED_IO_PROMOTE_INTERVAL_KEY));
+}
+
+JsonType
+TieredIOParameter::ToJson() {
+    JsonType json;
+    json[IO_TYPE_KEY] = IO_TYPE_VALUE_TIERED_IO;
+    json[TIERED_IO_HOT_SIZE_KEY] = this->hot_size_;
+    json[TIERED_IO_PAGE_SIZE_KEY] = this->page_size_;
+    json[TIERED_IO_DIR_KEY] = this->dir_;
+    json[TIERED_IO_PROMOTE_INTERVAL_KEY] = this->promote_interval_;
+    return json;
+}
+
+}  // namespace vsag
@@ -0,0 +1,49 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "io_parameter.h"
+
+namespace vsag {
+class TieredIOParameter : public IOParameter {
+public:
+    TieredIOParameter();
+
+    explicit TieredIOParameter(const JsonType& json);
+
+    void
+    FromJson(const JsonType& json) override;
+
+    JsonType
+    ToJson() override;
+
+public:
+    // bytes of the in-memory hot tier
+    uint64_t hot_size_{64 * 1024 * 1024};
+
+    // granularity of access counting, promotion and demotion
+    uint64_t page_size_{4096};
+
+    // directory of the backing file of the cold tier, the system temp directory if empty
+    std::string dir_{};
+
+    // reads between two promotion passes
+    uint64_t promote_interval_{100000};
+};
+
+using TieredIOParamPtr = std::shared_ptr<TieredIOParameter>;
+
+}  // namespace vsag
@@ -0,0 +1,44 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tiered_io_parameter.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "parameter_test.h"
+
+using namespace vsag;
+
+TEST_CASE("TieredIOParameter Test", "[ut][TieredIOParameter]") {
+    std::string param_str = R"(
+    {
+        "type": "tiered_io",
+        "hot_size": 1048576,
+        "page_size": 8192,
+        "promote_interval": 1000
+    })";
+    auto param = std::make_shared<TieredIOParameter>();
+    param->FromJson(JsonType::parse(param_str));
+    REQUIRE(param->hot_size_ == 1048576);
+    REQUIRE(param->page_size_ == 8192);
+    REQUIRE(param->promote_interval_ == 1000);
+    REQUIRE(param->dir_.empty());
+    ParameterTest::TestToJson(param);
+
+    auto io_param = IOParameter::GetIOParameterByJson(JsonType::parse(param_str));
+    REQUIRE(std::dynamic_pointer_cast<TieredIOParameter>(io_param) != nullptr);
+
+    REQUIRE_THROWS(param->FromJson(JsonType::parse(R"({"page_size": 0})")));
+}
@@ -0,0 +1,123 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tiered_io.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+
+#include "basic_io_test.h"
+#include "default_allocator.h"
+#include "safe_allocator.h"
+
+using namespace vsag;
+
+TEST_CASE("TieredIO Read and Write", "[ut][TieredIO]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto thread_pool = SafeThreadPool::FactoryDefaultThreadPool();
+    auto page_sizes = {1024, 4096};
+    for (auto page_size : page_sizes) {
+        auto io = std::make_unique<TieredIO>(allocator.get(), 64 * 1024, page_size, "", 100);
+        TestBasicReadWrite(*io);
+        auto async_io = std::make_unique<TieredIO>(
+            allocator.get(), 64 * 1024, page_size, "", 100, thread_pool);
+        TestBasicReadWrite(*async_io);
+    }
+}
+
+TEST_CASE("TieredIO Serialize and Deserialize", "[ut][TieredIO]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto wio = std::make_unique<TieredIO>(allocator.get(), 64 * 1024, 4096, "", 100);
+    auto rio = std::make_unique<TieredIO>(allocator.get(), 64 * 1024, 4096, "", 100);
+    TestSerializeAndDeserialize(*wio, *rio);
+}
+
+TEST_CASE("TieredIO Promote", "[ut][TieredIO]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    uint64_t page_size = 1024;
+    uint64_t page_count = 64;
+    auto io = std::make_unique<TieredIO>(allocator.get(), 4 * page_size, page_size, "", 1000);
+    std::vector<uint8_t> data(page_size * page_count);
+    for (uint64_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i % 251);
+    }
+    io->Write(data.data(), data.size(), 0);
+    REQUIRE(io->HotPageCount() == 0);
+
+    // pages 3 and 7 are read most
+    std::vector<uint8_t> buffer(page_size);
+    for (int i = 0; i < 100; ++i) {
+        io->Read(page_size, 3 * page_size, buffer.data());
+        io->Read(16, 7 * page_size + 8, buffer.data());
+    }
+    io->Read(page_size, 10 * page_size, buffer.data());
+    io->Promote();
+    REQUIRE(io->HotPageCount() == 3);
+
+    // hot pages serve reads and follow writes
+    io->Read(page_size, 3 * page_size, buffer.data());
+    REQUIRE(memcmp(buffer.data(), data.data() + 3 * page_size, page_size) == 0);
+    std::vector<uint8_t> update(page_size + 10, 7);
+    io->Write(update.data(), update.size(), 3 * page_size - 5);
+    memcpy(data.data() + 3 * page_size - 5, update.data(), update.size());
+    std::vector<uint8_t> result(data.size());
+    REQUIRE(io->Read(result.size(), 0, result.data()));
+    REQUIRE(result == data);
+
+    bool need_release = false;
+    const auto* ptr = io->Read(page_size * 2, 2 * page_size + 1, need_release);
+    REQUIRE(need_release);
+    REQUIRE(memcmp(ptr, data.data() + 2 * page_size + 1, page_size * 2) == 0);
+    io->Release(ptr);
+    REQUIRE_FALSE(io->Read(16, data.size() - 8, buffer.data()));
+}
+
+TEST_CASE("TieredIO Direct Read of Hot Pages", "[ut][TieredIO]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    uint64_t page_size = 1024;
+    auto io = std::make_unique<TieredIO>(allocator.get(), 2 * page_size, page_size, "", 1000);
+    std::vector<uint8_t> data(page_size * 8);
+    for (uint64_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i % 251);
+    }
+    io->Write(data.data(), data.size(), 0);
+    std::vector<uint8_t> buffer(page_size);
+    for (int i = 0; i < 10; ++i) {
+        io->Read(page_size, 2 * page_size, buffer.data());
+    }
+    io->Promote();
+    REQUIRE(io->HotPageCount() == 1);
+
+    // served from the hot copy, which outlives a promotion that demotes the page
+    bool need_release = false;
+    const auto* ptr = io->Read(16, 2 * page_size + 8, need_release);
+    REQUIRE(need_release);
+    for (int i = 0; i < 100; ++i) {
+        io->Read(page_size, 5 * page_size, buffer.data());
+        io->Read(page_size, 6 * page_size, buffer.data());
+    }
+    io->Promote();
+    io->Promote();
+    REQUIRE(memcmp(ptr, data.data() + 2 * page_size + 8, 16) == 0);
+    io->Release(ptr);
+
+    // writes reach the hot copies
+    std::vector<uint8_t> update(page_size, 9);
+    io->Write(update.data(), update.size(), 5 * page_size);
+    io->Promote();
+    ptr = io->Read(page_size, 5 * page_size, need_release);
+    REQUIRE(memcmp(ptr, update.data(), page_size) == 0);
+    io->Release(ptr);
+}
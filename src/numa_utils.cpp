@@ -0,0 +1,137 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "numa_utils.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace vsag {
+
+static const std::string NUMA_NODE_SYSFS_PATH = "/sys/devices/system/node/";
+
+// same value as MPOL_INTERLEAVE of linux/mempolicy.h, which is not installed everywhere
+static constexpr int NUMA_POLICY_INTERLEAVE = 3;
+
+static bool
+read_first_line(const std::string& path, std::string& line) {
+    std::ifstream file(path);
+    if (not file.is_open()) {
+        return false;
+    }
+    return static_cast<bool>(std::getline(file, line));
+}
+
+std::vector<uint32_t>
+parse_numa_list(const std::string& list) {
+    std::vector<uint32_t> result;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() or range == "\n") {
+            continue;
+        }
+        try {
+            auto dash = range.find('-');
+            auto begin = static_cast<uint32_t>(std::stoul(range.substr(0, dash)));
+            auto end = begin;
+            if (dash != std::string::npos) {
+                end = static_cast<uint32_t>(std::stoul(range.substr(dash + 1)));
+            }
+            for (auto i = begin; i <= end; ++i) {
+                result.emplace_back(i);
+            }
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+    return result;
+}
+
+const std::vector<uint32_t>&
+get_numa_nodes() {
+    static const std::vector<uint32_t> nodes = []() -> std::vector<uint32_t> {
+        std::string line;
+        if (not read_first_line(NUMA_NODE_SYSFS_PATH + "online", line)) {
+            return {0};
+        }
+        auto nodes = parse_numa_list(line);
+        if (nodes.empty()) {
+            return {0};
+        }
+        return nodes;
+    }();
+    return nodes;
+}
+
+uint32_t
+get_numa_node_count() {
+    return static_cast<uint32_t>(get_numa_nodes().size());
+}
+
+bool
+bind_current_thread_to_numa_node(uint32_t node) {
+    std::string line;
+    if (not read_first_line(NUMA_NODE_SYSFS_PATH + "node" + std::to_string(node) + "/cpulist",
+                            line)) {
+        return false;
+    }
+    auto cpus = parse_numa_list(line);
+    if (cpus.empty()) {
+        return false;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (auto cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+}
+
+bool
+interleave_memory_on_numa_nodes(void* addr, uint64_t size) {
+    const auto& nodes = get_numa_nodes();
+    if (nodes.size() <= 1) {
+        return false;
+    }
+#ifdef SYS_mbind
+    constexpr uint64_t bits_per_mask = sizeof(unsigned long) * 8;
+    auto max_node = static_cast<uint64_t>(nodes.back()) + 1;
+    std::vector<unsigned long> node_mask((max_node + bits_per_mask - 1) / bits_per_mask, 0);
+    for (auto node : nodes) {
+        node_mask[node / bits_per_mask] |= 1UL << (node % bits_per_mask);
+    }
+    // the kernel ignores the last bit of maxnode, hence the + 1
+    auto ret = syscall(SYS_mbind,
+                       addr,
+                       size,
+                       NUMA_POLICY_INTERLEAVE,
+                       node_mask.data(),
+                       static_cast<unsigned long>(max_node) + 1,
+                       0);
+    return ret == 0;
+#else
+    return false;
+#endif
+}
+
+}  // namespace vsag
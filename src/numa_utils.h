@@ -0,0 +1,61 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vsag {
+
+/**
+ * @brief Parses a linux cpu or node list such as "0-3,8,10-11".
+ */
+std::vector<uint32_t>
+parse_numa_list(const std::string& list);
+
+/**
+ * @brief Returns the ids of the online NUMA nodes, {0} if the topology cannot be read.
+ *
+ * The ids need not be contiguous, e.g. "0,2" if node 1 is offline.
+ */
+const std::vector<uint32_t>&
+get_numa_nodes();
+
+/**
+ * @brief Returns the number of online NUMA nodes, 1 if the topology cannot be read.
+ */
+uint32_t
+get_numa_node_count();
+
+/**
+ * @brief Restricts the calling thread to the cpus of the given NUMA node.
+ *
+ * Returns false and leaves the affinity unchanged if the node or its cpus are unknown.
+ */
+bool
+bind_current_thread_to_numa_node(uint32_t node);
+
+/**
+ * @brief Interleaves the pages of [addr, addr + size) across all online NUMA nodes.
+ *
+ * addr must be page aligned and the pages not yet touched, otherwise they keep their
+ * placement. Returns false if nothing was done, e.g. on single node machines.
+ */
+bool
+interleave_memory_on_numa_nodes(void* addr, uint64_t size);
+
+}  // namespace vsag
@@ -0,0 +1,43 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "numa_utils.h"
+
+#include <sys/mman.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace vsag;
+
+TEST_CASE("NumaUtils Parse List", "[ut][NumaUtils]") {
+    REQUIRE(parse_numa_list("0") == std::vector<uint32_t>{0});
+    REQUIRE(parse_numa_list("0-3,8,10-11\n") == std::vector<uint32_t>{0, 1, 2, 3, 8, 10, 11});
+    REQUIRE(parse_numa_list("").empty());
+    REQUIRE(parse_numa_list("a-b").empty());
+}
+
+TEST_CASE("NumaUtils Bind And Interleave", "[ut][NumaUtils]") {
+    auto node_count = get_numa_node_count();
+    REQUIRE(node_count >= 1);
+    REQUIRE(get_numa_nodes().size() == node_count);
+    REQUIRE_FALSE(bind_current_thread_to_numa_node(node_count + 1024));
+
+    uint64_t size = 4 * 1024 * 1024;
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    REQUIRE(ptr != MAP_FAILED);
+    // single node machines have nothing to interleave
+    REQUIRE(interleave_memory_on_numa_nodes(ptr, size) == (node_count > 1));
+    munmap(ptr, size);
+}
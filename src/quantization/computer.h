@@ -53,6 +53,8 @@ public:
 public:
     const T* quantizer_{nullptr};
     uint8_t* buf_{nullptr};
+    // keeps the owner of quantizer_ alive, released after ReleaseComputer
+    std::shared_ptr<const void> owner_{nullptr};
 };
 
 using ComputerInterfacePtr = std::shared_ptr<ComputerInterface>;
@@ -48,6 +48,9 @@ public:
     bool
     EncodeBatchImpl(const DataType* data, uint8_t* codes, uint64_t count);
 
+    bool
+    IsOutOfRangeImpl(const DataType* data) const;
+
     bool
     DecodeOneImpl(const uint8_t* codes, DataType* data);
 
@@ -126,6 +129,12 @@ FP32Quantizer<metric>::EncodeBatchImpl(const DataType* data, uint8_t* codes, uin
     return true;
 }
 
+template <MetricType metric>
+bool
+FP32Quantizer<metric>::IsOutOfRangeImpl(const DataType* data) const {
+    return false;
+}
+
 template <MetricType metric>
 bool
 FP32Quantizer<metric>::DecodeOneImpl(const uint8_t* codes, DataType* data) {
@@ -27,6 +27,8 @@
 namespace vsag {
 using DataType = float;
 
+class SafeThreadPool;
+
 /**
  * @class Quantizer
  * @brief This class is used for quantization and encoding/decoding of data.
@@ -89,6 +91,17 @@ public:
         return cast().EncodeBatchImpl(data, codes, count);
     }
 
+    /**
+     * @brief Checks whether an element lies outside the value range learned during training.
+     *
+     * @param data Pointer to the input data.
+     * @return True if encoding the element would clip at least one dimension; False otherwise.
+     */
+    bool
+    IsOutOfRange(const DataType* data) const {
+        return cast().IsOutOfRangeImpl(data);
+    }
+
     /**
      * @brief Decodes an encoded code back into its original data representation.
      *
@@ -221,6 +234,7 @@ private:
     bool is_trained_{false};
     MetricType metric_{MetricType::METRIC_TYPE_L2SQR};
     Allocator* const allocator_{nullptr};
+    SafeThreadPool* thread_pool_{nullptr};  // optional, used to parallelize training
 };
 
 }  // namespace vsag
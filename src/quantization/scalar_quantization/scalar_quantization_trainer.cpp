@@ -15,15 +15,25 @@
 
 #include "scalar_quantization_trainer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <queue>
-#include <random>
 
+#include "safe_thread_pool.h"
 #include "simd/normalize.h"
 
 namespace vsag {
 
-ScalarQuantizationTrainer::ScalarQuantizationTrainer(int32_t dim, int bits)
-    : dim_(dim), bits_(bits) {
+ScalarQuantizationTrainer::ScalarQuantizationTrainer(int32_t dim,
+                                                     int bits,
+                                                     SafeThreadPool* thread_pool)
+    : dim_(dim), bits_(bits), thread_pool_(thread_pool) {
 }
 
 void
@@ -60,6 +70,142 @@ ScalarQuantizationTrainer::TrainUniform(const float* data,
     }
 }
 
+void
+ScalarQuantizationTrainer::StreamingFeed(const float* data, uint64_t count, bool need_normalize) {
+    if (count == 0) {
+        return;
+    }
+    if (stream_bins_.empty()) {
+        stream_upper_bound_.resize(dim_, std::numeric_limits<float>::lowest());
+        stream_lower_bound_.resize(dim_, std::numeric_limits<float>::max());
+        stream_bins_.resize(STREAM_BIN_COUNT * dim_, 0);
+        stream_bin_origin_.resize(dim_, 0);
+        stream_bin_width_.resize(dim_, 0);
+    }
+    std::vector<float> batch;
+    if (need_normalize) {
+        batch.resize(count * dim_);
+        auto normalize_task = [&](uint64_t begin, uint64_t end) {
+            for (uint64_t j = begin; j < end; ++j) {
+                Normalize(data + j * dim_, batch.data() + j * dim_, dim_);
+            }
+        };
+        this->parallelize_task(normalize_task, count, 4096);
+        data = batch.data();
+    }
+
+    std::vector<float> upper(dim_);
+    std::vector<float> lower(dim_);
+    this->classic_train(data, count, upper.data(), lower.data());
+    for (uint64_t i = 0; i < dim_; ++i) {
+        if (stream_seen_count_ == 0) {
+            // a constant dimension still gets bins of a usable width
+            auto range = std::max(static_cast<double>(upper[i]) - lower[i],
+                                  1e-6 * std::max(1.0, std::abs(static_cast<double>(lower[i]))));
+            stream_bin_origin_[i] = lower[i];
+            stream_bin_width_[i] = range / STREAM_BIN_COUNT;
+        } else {
+            this->stream_extend(i, lower[i], upper[i]);
+        }
+        stream_upper_bound_[i] = std::max(stream_upper_bound_[i], upper[i]);
+        stream_lower_bound_[i] = std::min(stream_lower_bound_[i], lower[i]);
+    }
+
+    // the dimensions are independent, so each task fills the histograms of a range of them
+    auto task = [&](uint64_t begin, uint64_t end) {
+        for (uint64_t i = begin; i < end; ++i) {
+            auto* bins = stream_bins_.data() + i * STREAM_BIN_COUNT;
+            auto origin = stream_bin_origin_[i];
+            auto width = stream_bin_width_[i];
+            for (uint64_t j = 0; j < count; ++j) {
+                auto bin = static_cast<int64_t>((data[j * dim_ + i] - origin) / width);
+                ++bins[std::clamp<int64_t>(bin, 0, STREAM_BIN_COUNT - 1)];
+            }
+        }
+    };
+    this->parallelize_task(task, dim_, 8);
+    stream_seen_count_ += count;
+}
+
+void
+ScalarQuantizationTrainer::StreamingTrain(float* upper_bound,
+                                          float* lower_bound,
+                                          SQTrainMode mode) const {
+    if (stream_seen_count_ == 0) {
+        return;
+    }
+    if (mode == CLASSIC) {
+        memcpy(upper_bound, stream_upper_bound_.data(), dim_ * sizeof(float));
+        memcpy(lower_bound, stream_lower_bound_.data(), dim_ * sizeof(float));
+    } else if (mode == TRUNC_BOUND) {
+        // the bins holding the value trunc_bound_train would pick, at least the extreme one
+        auto ignore_count =
+            static_cast<uint64_t>(static_cast<float>(stream_seen_count_ - 1) * 0.001);
+        auto rank = std::max<uint64_t>(ignore_count, 1);
+        for (uint64_t i = 0; i < dim_; ++i) {
+            const auto* bins = stream_bins_.data() + i * STREAM_BIN_COUNT;
+            auto origin = stream_bin_origin_[i];
+            auto width = stream_bin_width_[i];
+            uint64_t seen = 0;
+            for (auto bin = static_cast<int64_t>(STREAM_BIN_COUNT) - 1; bin >= 0; --bin) {
+                seen += bins[bin];
+                if (seen >= rank) {
+                    upper_bound[i] = std::min(stream_upper_bound_[i],
+                                              static_cast<float>(origin + (bin + 1) * width));
+                    break;
+                }
+            }
+            seen = 0;
+            for (uint64_t bin = 0; bin < STREAM_BIN_COUNT; ++bin) {
+                seen += bins[bin];
+                if (seen >= rank) {
+                    lower_bound[i] = std::max(stream_lower_bound_[i],
+                                              static_cast<float>(origin + bin * width));
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void
+ScalarQuantizationTrainer::StreamingTrainUniform(float& upper_bound,
+                                                 float& lower_bound,
+                                                 SQTrainMode mode) const {
+    if (stream_seen_count_ == 0) {
+        return;
+    }
+    std::vector<float> upper(dim_);
+    std::vector<float> lower(dim_);
+    this->StreamingTrain(upper.data(), lower.data(), mode);
+    upper_bound = *std::max_element(upper.begin(), upper.end());
+    lower_bound = *std::min_element(lower.begin(), lower.end());
+}
+
+void
+ScalarQuantizationTrainer::stream_extend(uint64_t i, float lower, float upper) {
+    auto* bins = stream_bins_.data() + i * STREAM_BIN_COUNT;
+    auto& origin = stream_bin_origin_[i];
+    auto& width = stream_bin_width_[i];
+    constexpr uint64_t half = STREAM_BIN_COUNT / 2;
+    // merging pairs of bins doubles their width, keeping the lower or the upper edge
+    while (upper >= origin + width * STREAM_BIN_COUNT) {
+        for (uint64_t b = 0; b < half; ++b) {
+            bins[b] = bins[2 * b] + bins[2 * b + 1];
+        }
+        std::fill(bins + half, bins + STREAM_BIN_COUNT, 0);
+        width *= 2;
+    }
+    while (lower < origin) {
+        for (auto b = static_cast<int64_t>(half) - 1; b >= 0; --b) {
+            bins[half + b] = bins[2 * b] + bins[2 * b + 1];
+        }
+        std::fill(bins, bins + half, 0);
+        origin -= width * STREAM_BIN_COUNT;
+        width *= 2;
+    }
+}
+
 void
 ScalarQuantizationTrainer::classic_train(const float* data,
                                          uint64_t count,
@@ -68,12 +214,26 @@ ScalarQuantizationTrainer::classic_train(const float* data,
     for (uint64_t i = 0; i < dim_; ++i) {
         upper_bound[i] = std::numeric_limits<float>::lowest();
         lower_bound[i] = std::numeric_limits<float>::max();
-        for (uint64_t j = 0; j < count; ++j) {
-            auto value = data[j * dim_ + i];
-            upper_bound[i] = std::max(upper_bound[i], value);
-            lower_bound[i] = std::min(lower_bound[i], value);
-        }
     }
+    std::mutex merge_mutex;
+    // each chunk of rows is scanned row by row into local bounds, then merged
+    auto task = [&](uint64_t begin, uint64_t end) {
+        std::vector<float> upper(dim_, std::numeric_limits<float>::lowest());
+        std::vector<float> lower(dim_, std::numeric_limits<float>::max());
+        for (uint64_t j = begin; j < end; ++j) {
+            const auto* vec = data + j * dim_;
+            for (uint64_t i = 0; i < dim_; ++i) {
+                upper[i] = std::max(upper[i], vec[i]);
+                lower[i] = std::min(lower[i], vec[i]);
+            }
+        }
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        for (uint64_t i = 0; i < dim_; ++i) {
+            upper_bound[i] = std::max(upper_bound[i], upper[i]);
+            lower_bound[i] = std::min(lower_bound[i], lower[i]);
+        }
+    };
+    this->parallelize_task(task, count, 4096);
 }
 
 void
@@ -82,29 +242,33 @@ ScalarQuantizationTrainer::trunc_bound_train(const float* data,
                                              float* upper_bound,
                                              float* lower_bound) const {
     auto ignore_count = static_cast<uint64_t>(static_cast<float>(count - 1) * 0.001);
-    for (uint64_t i = 0; i < dim_; ++i) {
-        std::priority_queue<float, std::vector<float>, std::greater<>> heap_max;
-        std::priority_queue<float, std::vector<float>, std::less<>> heap_min;
-        heap_max.emplace(std::numeric_limits<float>::lowest());
-        heap_min.emplace(std::numeric_limits<float>::max());
-        for (uint64_t j = 0; j < count; ++j) {
-            auto value = data[j * dim_ + i];
-            if (value > heap_max.top() || heap_max.size() < ignore_count) {
-                heap_max.emplace(value);
-            }
-            if (heap_max.size() > ignore_count) {
-                heap_max.pop();
-            }
-            if (value < heap_min.top() || heap_min.size() < ignore_count) {
-                heap_min.emplace(value);
-            }
-            if (heap_min.size() > ignore_count) {
-                heap_min.pop();
+    // the dimensions are independent, so each task handles a range of dimensions
+    auto task = [&](uint64_t begin, uint64_t end) {
+        for (uint64_t i = begin; i < end; ++i) {
+            std::priority_queue<float, std::vector<float>, std::greater<>> heap_max;
+            std::priority_queue<float, std::vector<float>, std::less<>> heap_min;
+            heap_max.emplace(std::numeric_limits<float>::lowest());
+            heap_min.emplace(std::numeric_limits<float>::max());
+            for (uint64_t j = 0; j < count; ++j) {
+                auto value = data[j * dim_ + i];
+                if (value > heap_max.top() || heap_max.size() < ignore_count) {
+                    heap_max.emplace(value);
+                }
+                if (heap_max.size() > ignore_count) {
+                    heap_max.pop();
+                }
+                if (value < heap_min.top() || heap_min.size() < ignore_count) {
+                    heap_min.emplace(value);
+                }
+                if (heap_min.size() > ignore_count) {
+                    heap_min.pop();
+                }
             }
+            upper_bound[i] = heap_max.top();
+            lower_bound[i] = heap_min.top();
         }
-        upper_bound[i] = heap_max.top();
-        lower_bound[i] = heap_min.top();
-    }
+    };
+    this->parallelize_task(task, dim_, 8);
 }
 
 uint64_t
@@ -120,14 +284,71 @@ ScalarQuantizationTrainer::sample_train_data(const float* data,
     }
 
     sample_datas.resize(sample_count * dim_);
-    for (uint64_t j = 0; j < sample_count; ++j) {
-        auto new_index = (j * step) % count;
-        if (need_normalize) {
-            Normalize(data + new_index * dim_, sample_datas.data() + j * dim_, dim_);
-        } else {
-            memcpy(sample_datas.data() + j * dim_, data + new_index * dim_, dim_ * sizeof(float));
+    auto task = [&](uint64_t begin, uint64_t end) {
+        for (uint64_t j = begin; j < end; ++j) {
+            auto new_index = (j * step) % count;
+            if (need_normalize) {
+                Normalize(data + new_index * dim_, sample_datas.data() + j * dim_, dim_);
+            } else {
+                memcpy(sample_datas.data() + j * dim_,
+                       data + new_index * dim_,
+                       dim_ * sizeof(float));
+            }
         }
-    }
+    };
+    this->parallelize_task(task, sample_count, 4096);
     return sample_count;
 }
+
+void
+ScalarQuantizationTrainer::parallelize_task(const std::function<void(uint64_t, uint64_t)>& task,
+                                            uint64_t total,
+                                            uint64_t min_block_size) const {
+    if (thread_pool_ == nullptr or total <= min_block_size) {
+        task(0, total);
+        return;
+    }
+    auto thread_count = std::max<uint64_t>(Options::Instance().num_threads_building(), 1);
+    auto block_size = std::max((total + thread_count - 1) / thread_count, min_block_size);
+    auto block_count = (total + block_size - 1) / block_size;
+
+    // the caller claims blocks like the pool tasks do and only waits for blocks that are
+    // running, so it never waits on a task stuck in the queue, e.g. when called from the pool
+    struct SharedState {
+        std::atomic<uint64_t> next_block{0};
+        std::mutex mutex;
+        std::condition_variable cv;
+        uint64_t done_count{0};
+        std::exception_ptr error{nullptr};
+    };
+    auto state = std::make_shared<SharedState>();
+    auto run_blocks = [state, &task, total, block_size, block_count]() {
+        for (auto block = state->next_block++; block < block_count;
+             block = state->next_block++) {
+            auto begin = block * block_size;
+            std::exception_ptr error{nullptr};
+            try {
+                task(begin, std::min(begin + block_size, total));
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (error != nullptr and state->error == nullptr) {
+                state->error = error;
+            }
+            if (++state->done_count == block_count) {
+                state->cv.notify_all();
+            }
+        }
+    };
+    for (uint64_t i = 1; i < block_count; ++i) {
+        thread_pool_->Enqueue(run_blocks);
+    }
+    run_blocks();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&state, block_count]() { return state->done_count == block_count; });
+    if (state->error != nullptr) {
+        std::rethrow_exception(state->error);
+    }
+}
 }  // namespace vsag
@@ -16,11 +16,15 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <vector>
 
 #include "typing.h"
 
 namespace vsag {
 
+class SafeThreadPool;
+
 enum SQTrainMode {
     CLASSIC = 1,
     K_MEANS = 2,
@@ -29,7 +33,9 @@ enum SQTrainMode {
 
 class ScalarQuantizationTrainer {
 public:
-    explicit ScalarQuantizationTrainer(int32_t dim, int bits = 8);
+    explicit ScalarQuantizationTrainer(int32_t dim,
+                                       int bits = 8,
+                                       SafeThreadPool* thread_pool = nullptr);
 
     void
     Train(const float* data,
@@ -47,6 +53,30 @@ public:
                  bool need_normalize = false,
                  SQTrainMode mode = SQTrainMode::CLASSIC);
 
+    /**
+     * @brief Accumulates one batch of train data for the streaming training.
+     *
+     * The exact bounds of each dimension are kept together with a histogram of
+     * STREAM_BIN_COUNT bins, whose bins double in width whenever a batch falls outside their
+     * range. The caller never needs to hold the whole train set in one buffer.
+     */
+    void
+    StreamingFeed(const float* data, uint64_t count, bool need_normalize = false);
+
+    /**
+     * @brief Returns the bounds of all batches fed so far, the truncated bounds of TRUNC_BOUND
+     * are read from the histograms and are exact up to one bin.
+     */
+    void
+    StreamingTrain(float* upper_bound,
+                   float* lower_bound,
+                   SQTrainMode mode = SQTrainMode::CLASSIC) const;
+
+    void
+    StreamingTrainUniform(float& upper_bound,
+                          float& lower_bound,
+                          SQTrainMode mode = SQTrainMode::CLASSIC) const;
+
     void
     Encode(const float* origin_data, uint8_t*);
 
@@ -71,14 +101,36 @@ private:
                       std::vector<float>& sample_datas,
                       bool need_normalize = false) const;
 
+    // widens the histogram of dimension i until it covers [lower, upper]
+    void
+    stream_extend(uint64_t i, float lower, float upper);
+
+    void
+    parallelize_task(const std::function<void(uint64_t, uint64_t)>& task,
+                     uint64_t total,
+                     uint64_t min_block_size) const;
+
 private:
     int dim_{0};
 
     int bits_{8};
 
+    SafeThreadPool* const thread_pool_{nullptr};
+
+    // state of the streaming training, bin b of dimension i covers
+    // [origin + b * width, origin + (b + 1) * width) of that dimension
+    std::vector<float> stream_upper_bound_;
+    std::vector<float> stream_lower_bound_;
+    std::vector<uint64_t> stream_bins_;
+    std::vector<double> stream_bin_origin_;
+    std::vector<double> stream_bin_width_;
+    uint64_t stream_seen_count_{0};
+
     uint64_t max_sample_count_{MAX_DEFAULT_SAMPLE};
 
     const static uint64_t MAX_DEFAULT_SAMPLE{65536};
+
+    const static uint64_t STREAM_BIN_COUNT{1024};
 };
 
 }  // namespace vsag
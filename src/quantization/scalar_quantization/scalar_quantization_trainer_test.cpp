@@ -0,0 +1,86 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "scalar_quantization_trainer.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "fixtures.h"
+#include "safe_thread_pool.h"
+
+using namespace vsag;
+
+TEST_CASE("ScalarQuantizationTrainer Parallel Train", "[ut][ScalarQuantizationTrainer]") {
+    auto dim = GENERATE(7, 128);
+    auto mode = GENERATE(SQTrainMode::CLASSIC, SQTrainMode::TRUNC_BOUND);
+    uint64_t count = 20000;
+    auto vecs = fixtures::generate_vectors(count, dim, false);
+    auto thread_pool = SafeThreadPool::FactoryDefaultThreadPool();
+
+    std::vector<float> upper(dim), lower(dim), parallel_upper(dim), parallel_lower(dim);
+    ScalarQuantizationTrainer trainer(dim, 8);
+    trainer.Train(vecs.data(), count, upper.data(), lower.data(), false, mode);
+    ScalarQuantizationTrainer parallel_trainer(dim, 8, thread_pool.get());
+    parallel_trainer.Train(
+        vecs.data(), count, parallel_upper.data(), parallel_lower.data(), false, mode);
+    REQUIRE(upper == parallel_upper);
+    REQUIRE(lower == parallel_lower);
+}
+
+TEST_CASE("ScalarQuantizationTrainer Streaming Train", "[ut][ScalarQuantizationTrainer]") {
+    auto dim = GENERATE(7, 128);
+    auto need_normalize = GENERATE(false, true);
+    uint64_t batch_count = 5000;
+    uint64_t batch_num = 4;
+    uint64_t count = batch_count * batch_num;
+    auto vecs = fixtures::generate_vectors(count, dim, false);
+    // later batches spread wider, so the histograms have to grow on both sides
+    for (uint64_t i = 0; i < count; ++i) {
+        vecs[i] *= 1.0F + static_cast<float>(i / batch_count) * 0.5F;
+    }
+    auto thread_pool = SafeThreadPool::FactoryDefaultThreadPool();
+
+    ScalarQuantizationTrainer trainer(dim, 8);
+    ScalarQuantizationTrainer streaming_trainer(dim, 8, thread_pool.get());
+    for (uint64_t i = 0; i < batch_num; ++i) {
+        streaming_trainer.StreamingFeed(
+            vecs.data() + i * batch_count * dim, batch_count, need_normalize);
+    }
+
+    std::vector<float> upper(dim), lower(dim), stream_upper(dim), stream_lower(dim);
+    trainer.Train(vecs.data(), count, upper.data(), lower.data(), need_normalize, CLASSIC);
+    streaming_trainer.StreamingTrain(stream_upper.data(), stream_lower.data(), CLASSIC);
+    REQUIRE(upper == stream_upper);
+    REQUIRE(lower == stream_lower);
+
+    // the truncated bounds are off by less than one bin, kept under 1/256 of the range
+    std::vector<float> trunc_upper(dim), trunc_lower(dim);
+    trainer.Train(
+        vecs.data(), count, trunc_upper.data(), trunc_lower.data(), need_normalize, TRUNC_BOUND);
+    streaming_trainer.StreamingTrain(stream_upper.data(), stream_lower.data(), TRUNC_BOUND);
+    for (int i = 0; i < dim; ++i) {
+        auto tolerance = (upper[i] - lower[i]) / 128;
+        REQUIRE(stream_upper[i] >= trunc_upper[i]);
+        REQUIRE(stream_upper[i] <= trunc_upper[i] + tolerance);
+        REQUIRE(stream_lower[i] <= trunc_lower[i]);
+        REQUIRE(stream_lower[i] >= trunc_lower[i] - tolerance);
+    }
+
+    float uniform_upper = 0;
+    float uniform_lower = 0;
+    streaming_trainer.StreamingTrainUniform(uniform_upper, uniform_lower, CLASSIC);
+    REQUIRE(uniform_upper == *std::max_element(upper.begin(), upper.end()));
+    REQUIRE(uniform_lower == *std::min_element(lower.begin(), lower.end()));
+}
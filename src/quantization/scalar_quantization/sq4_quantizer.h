@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <cmath>
 #include <cstring>
 #include <limits>
 #include <vector>
@@ -23,6 +24,7 @@
 #include "inner_string_params.h"
 #include "quantization/quantizer.h"
 #include "scalar_quantization_trainer.h"
+#include "simd/fp32_simd.h"
 #include "simd/normalize.h"
 #include "simd/sq4_simd.h"
 #include "sq4_quantizer_parameter.h"
@@ -48,6 +50,9 @@ public:
     bool
     EncodeBatchImpl(const DataType* data, uint8_t* codes, uint64_t count);
 
+    bool
+    IsOutOfRangeImpl(const DataType* data) const;
+
     bool
     DecodeOneImpl(const uint8_t* codes, DataType* data);
 
@@ -93,7 +98,9 @@ SQ4Quantizer<metric>::SQ4Quantizer(int dim, Allocator* allocator)
 template <MetricType metric>
 SQ4Quantizer<metric>::SQ4Quantizer(const SQ4QuantizerParamPtr& param,
                                    const IndexCommonParam& common_param)
-    : SQ4Quantizer<metric>(common_param.dim_, common_param.allocator_.get()){};
+    : SQ4Quantizer<metric>(common_param.dim_, common_param.allocator_.get()) {
+    this->thread_pool_ = common_param.thread_pool_.get();
+};
 
 template <MetricType metric>
 SQ4Quantizer<metric>::SQ4Quantizer(const QuantizerParamPtr& param,
@@ -115,7 +122,7 @@ SQ4Quantizer<metric>::TrainImpl(const DataType* data, uint64_t count) {
         need_normalize = true;
     }
 
-    ScalarQuantizationTrainer trainer(this->dim_, 4);
+    ScalarQuantizationTrainer trainer(this->dim_, 4, this->thread_pool_);
     trainer.Train(data, count, this->diff_.data(), this->lower_bound_.data(), need_normalize);
 
     for (uint64_t i = 0; i < this->dim_; ++i) {
@@ -166,6 +173,26 @@ SQ4Quantizer<metric>::EncodeBatchImpl(const DataType* data, uint8_t* codes, uint
     return true;
 }
 
+template <MetricType metric>
+bool
+SQ4Quantizer<metric>::IsOutOfRangeImpl(const DataType* data) const {
+    // cosine codes are trained on normalized vectors, scale on the fly instead of copying
+    float norm = 1.0F;
+    if constexpr (metric == MetricType::METRIC_TYPE_COSINE) {
+        norm = std::sqrt(FP32ComputeIP(data, data, this->dim_));
+        if (norm == 0.0F) {
+            norm = 1.0F;
+        }
+    }
+    for (uint64_t d = 0; d < this->dim_; ++d) {
+        auto value = data[d] / norm;
+        if (value < lower_bound_[d] or value > lower_bound_[d] + diff_[d]) {
+            return true;
+        }
+    }
+    return false;
+}
+
 template <MetricType metric>
 bool
 SQ4Quantizer<metric>::DecodeOneImpl(const uint8_t* codes, DataType* data) {
@@ -25,6 +25,7 @@
 #include "inner_string_params.h"
 #include "quantization/quantizer.h"
 #include "scalar_quantization_trainer.h"
+#include "simd/fp32_simd.h"
 #include "simd/normalize.h"
 #include "simd/sq4_uniform_simd.h"
 #include "sq4_uniform_quantizer_parameter.h"
@@ -55,6 +56,9 @@ public:
     bool
     EncodeBatchImpl(const DataType* data, uint8_t* codes, uint64_t count);
 
+    bool
+    IsOutOfRangeImpl(const DataType* data) const;
+
     bool
     DecodeOneImpl(const uint8_t* codes, DataType* data);
 
@@ -141,7 +145,9 @@ SQ4UniformQuantizer<metric>::SQ4UniformQuantizer(int dim, Allocator* allocator)
 template <MetricType metric>
 SQ4UniformQuantizer<metric>::SQ4UniformQuantizer(const SQ4UniformQuantizerParamPtr& param,
                                                  const IndexCommonParam& common_param)
-    : SQ4UniformQuantizer<metric>(common_param.dim_, common_param.allocator_.get()){};
+    : SQ4UniformQuantizer<metric>(common_param.dim_, common_param.allocator_.get()) {
+    this->thread_pool_ = common_param.thread_pool_.get();
+};
 
 template <MetricType metric>
 SQ4UniformQuantizer<metric>::SQ4UniformQuantizer(const QuantizerParamPtr& param,
@@ -164,7 +170,7 @@ SQ4UniformQuantizer<metric>::TrainImpl(const DataType* data, uint64_t count) {
         need_normalize = true;
     }
 
-    ScalarQuantizationTrainer trainer(this->dim_, 4);
+    ScalarQuantizationTrainer trainer(this->dim_, 4, this->thread_pool_);
     trainer.TrainUniform(data, count, this->diff_, this->lower_bound_, need_normalize);
 
     this->diff_ -= this->lower_bound_;
@@ -228,6 +234,27 @@ SQ4UniformQuantizer<metric>::EncodeBatchImpl(const DataType* data, uint8_t* code
     return true;
 }
 
+template <MetricType metric>
+bool
+SQ4UniformQuantizer<metric>::IsOutOfRangeImpl(const DataType* data) const {
+    // cosine codes are trained on normalized vectors, scale on the fly instead of copying
+    float norm = 1.0F;
+    if constexpr (metric == MetricType::METRIC_TYPE_COSINE) {
+        norm = std::sqrt(FP32ComputeIP(data, data, this->dim_));
+        if (norm == 0.0F) {
+            norm = 1.0F;
+        }
+    }
+    auto upper_bound = lower_bound_ + diff_;
+    for (uint64_t d = 0; d < this->dim_; ++d) {
+        auto value = data[d] / norm;
+        if (value < lower_bound_ or value > upper_bound) {
+            return true;
+        }
+    }
+    return false;
+}
+
 template <MetricType metric>
 bool
 SQ4UniformQuantizer<metric>::DecodeOneImpl(const uint8_t* codes, DataType* data) {
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <limits>
 #include <memory>
@@ -25,6 +26,7 @@
 #include "inner_string_params.h"
 #include "quantization/quantizer.h"
 #include "scalar_quantization_trainer.h"
+#include "simd/fp32_simd.h"
 #include "simd/normalize.h"
 #include "simd/sq8_simd.h"
 #include "sq8_quantizer_parameter.h"
@@ -51,6 +53,9 @@ public:
     bool
     EncodeBatchImpl(const DataType* data, uint8_t* codes, uint64_t count);
 
+    bool
+    IsOutOfRangeImpl(const DataType* data) const;
+
     bool
     DecodeOneImpl(const uint8_t* codes, DataType* data);
 
@@ -98,6 +103,7 @@ template <MetricType metric>
 SQ8Quantizer<metric>::SQ8Quantizer(const SQ8QuantizerParamPtr& param,
                                    const IndexCommonParam& common_param)
     : SQ8Quantizer<metric>(common_param.dim_, common_param.allocator_.get()) {
+    this->thread_pool_ = common_param.thread_pool_.get();
 }
 
 template <MetricType metric>
@@ -117,7 +123,7 @@ SQ8Quantizer<metric>::TrainImpl(const vsag::DataType* data, uint64_t count) {
         need_normalize = true;
     }
 
-    ScalarQuantizationTrainer trainer(this->dim_, 8);
+    ScalarQuantizationTrainer trainer(this->dim_, 8, this->thread_pool_);
     trainer.Train(data, count, this->diff_.data(), this->lower_bound_.data(), need_normalize);
 
     for (uint64_t i = 0; i < this->dim_; ++i) {
@@ -171,6 +177,26 @@ SQ8Quantizer<metric>::DecodeBatchImpl(const uint8_t* codes, DataType* data, uint
     return true;
 }
 
+template <MetricType metric>
+bool
+SQ8Quantizer<metric>::IsOutOfRangeImpl(const DataType* data) const {
+    // cosine codes are trained on normalized vectors, scale on the fly instead of copying
+    float norm = 1.0F;
+    if constexpr (metric == MetricType::METRIC_TYPE_COSINE) {
+        norm = std::sqrt(FP32ComputeIP(data, data, this->dim_));
+        if (norm == 0.0F) {
+            norm = 1.0F;
+        }
+    }
+    for (uint64_t d = 0; d < this->dim_; ++d) {
+        auto value = data[d] / norm;
+        if (value < lower_bound_[d] or value > lower_bound_[d] + diff_[d]) {
+            return true;
+        }
+    }
+    return false;
+}
+
 template <MetricType metric>
 bool
 SQ8Quantizer<metric>::DecodeOneImpl(const uint8_t* codes, DataType* data) {
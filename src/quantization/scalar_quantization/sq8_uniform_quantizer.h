@@ -15,10 +15,13 @@
 
 #pragma once
 
+#include <cmath>
+
 #include "index/index_common_param.h"
 #include "inner_string_params.h"
 #include "quantization/quantizer.h"
 #include "scalar_quantization_trainer.h"
+#include "simd/fp32_simd.h"
 #include "simd/normalize.h"
 #include "simd/sq8_uniform_simd.h"
 #include "sq8_uniform_quantizer_parameter.h"
@@ -49,6 +52,9 @@ public:
     bool
     EncodeBatchImpl(const DataType* data, uint8_t* codes, uint64_t count);
 
+    bool
+    IsOutOfRangeImpl(const DataType* data) const;
+
     bool
     DecodeOneImpl(const uint8_t* codes, DataType* data);
 
@@ -128,7 +134,9 @@ SQ8UniformQuantizer<metric>::SQ8UniformQuantizer(int dim, Allocator* allocator)
 template <MetricType metric>
 SQ8UniformQuantizer<metric>::SQ8UniformQuantizer(const SQ8UniformQuantizerParamPtr& param,
                                                  const IndexCommonParam& common_param)
-    : SQ8UniformQuantizer<metric>(common_param.dim_, common_param.allocator_.get()){};
+    : SQ8UniformQuantizer<metric>(common_param.dim_, common_param.allocator_.get()) {
+    this->thread_pool_ = common_param.thread_pool_.get();
+};
 
 template <MetricType metric>
 SQ8UniformQuantizer<metric>::SQ8UniformQuantizer(const QuantizerParamPtr& param,
@@ -151,7 +159,7 @@ SQ8UniformQuantizer<metric>::TrainImpl(const DataType* data, uint64_t count) {
         need_normalize = true;
     }
 
-    ScalarQuantizationTrainer trainer(this->dim_, 8);
+    ScalarQuantizationTrainer trainer(this->dim_, 8, this->thread_pool_);
     trainer.TrainUniform(data, count, this->diff_, this->lower_bound_, need_normalize);
 
     this->diff_ -= this->lower_bound_;
@@ -210,6 +218,27 @@ SQ8UniformQuantizer<metric>::EncodeBatchImpl(const DataType* data, uint8_t* code
     return true;
 }
 
+template <MetricType metric>
+bool
+SQ8UniformQuantizer<metric>::IsOutOfRangeImpl(const DataType* data) const {
+    // cosine codes are trained on normalized vectors, scale on the fly instead of copying
+    float norm = 1.0F;
+    if constexpr (metric == MetricType::METRIC_TYPE_COSINE) {
+        norm = std::sqrt(FP32ComputeIP(data, data, this->dim_));
+        if (norm == 0.0F) {
+            norm = 1.0F;
+        }
+    }
+    auto upper_bound = lower_bound_ + diff_;
+    for (uint64_t d = 0; d < this->dim_; ++d) {
+        auto value = data[d] / norm;
+        if (value < lower_bound_ or value > upper_bound) {
+            return true;
+        }
+    }
+    return false;
+}
+
 template <MetricType metric>
 bool
 SQ8UniformQuantizer<metric>::DecodeOneImpl(const uint8_t* codes, DataType* data) {
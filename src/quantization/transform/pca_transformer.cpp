@@ -0,0 +1,104 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pca_transformer.h"
+
+#include <cblas.h>
+#include <fmt/format-inl.h>
+#include <lapacke.h>
+
+#include "common.h"
+
+namespace vsag {
+PCATransformer::PCATransformer(int64_t input_dim,
+                               int64_t output_dim,
+                               MetricType metric,
+                               Allocator* allocator)
+    : VectorTransformer(input_dim, output_dim, allocator), metric_(metric) {
+}
+
+void
+PCATransformer::train(const float* data, uint64_t count) {
+    CHECK_ARGUMENT(count > 0, "pca transform requires training data");
+    auto dim = static_cast<uint64_t>(this->input_dim_);
+    uint64_t sample_count = std::min(count, MAX_SAMPLE_COUNT);
+    Vector<float> samples(sample_count * dim, this->allocator_);
+    for (uint64_t i = 0; i < sample_count; ++i) {
+        auto id = i * count / sample_count;
+        std::copy(data + id * dim, data + (id + 1) * dim, samples.data() + i * dim);
+    }
+
+    Vector<float> mean(dim, 0.0F, this->allocator_);
+    if (this->metric_ == MetricType::METRIC_TYPE_L2SQR) {
+        for (uint64_t i = 0; i < sample_count; ++i) {
+            cblas_saxpy(static_cast<blasint>(dim),
+                        1.0F / static_cast<float>(sample_count),
+                        samples.data() + i * dim,
+                        1,
+                        mean.data(),
+                        1);
+        }
+        for (uint64_t i = 0; i < sample_count; ++i) {
+            cblas_saxpy(
+                static_cast<blasint>(dim), -1.0F, mean.data(), 1, samples.data() + i * dim, 1);
+        }
+    }
+
+    // covariance in the upper triangle, eigenvalues come back in ascending order
+    Vector<float> covariance(dim * dim, 0.0F, this->allocator_);
+    cblas_ssyrk(CblasRowMajor,
+                CblasUpper,
+                CblasTrans,
+                static_cast<blasint>(dim),
+                static_cast<blasint>(sample_count),
+                1.0F / static_cast<float>(sample_count),
+                samples.data(),
+                static_cast<blasint>(dim),
+                0.0F,
+                covariance.data(),
+                static_cast<blasint>(dim));
+    Vector<float> eigen_values(dim, this->allocator_);
+    auto ret = LAPACKE_ssyev(LAPACK_ROW_MAJOR,
+                             'V',
+                             'U',
+                             static_cast<lapack_int>(dim),
+                             covariance.data(),
+                             static_cast<lapack_int>(dim),
+                             eigen_values.data());
+    if (ret != 0) {
+        throw std::runtime_error(fmt::format("failed to train pca transform: {}", ret));
+    }
+
+    // eigenvectors are the columns, take the largest ones as rows of the matrix
+    for (int64_t k = 0; k < this->output_dim_; ++k) {
+        auto column = dim - 1 - static_cast<uint64_t>(k);
+        for (uint64_t i = 0; i < dim; ++i) {
+            this->matrix_[k * dim + i] = covariance[i * dim + column];
+        }
+    }
+    cblas_sgemv(CblasRowMajor,
+                CblasNoTrans,
+                static_cast<blasint>(this->output_dim_),
+                static_cast<blasint>(dim),
+                1.0F,
+                this->matrix_.data(),
+                static_cast<blasint>(dim),
+                mean.data(),
+                1,
+                0.0F,
+                this->bias_.data(),
+                1);
+}
+}  // namespace vsag
@@ -0,0 +1,44 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "metric_type.h"
+#include "vector_transformer.h"
+
+namespace vsag {
+
+/**
+ * @class PCATransformer
+ * @brief Projects vectors onto the principal components with the largest variance.
+ *
+ * For L2 the data is centered before the projection, for IP and COSINE the projection
+ * uses the uncentered second moment so that inner products are kept.
+ */
+class PCATransformer : public VectorTransformer {
+public:
+    PCATransformer(int64_t input_dim, int64_t output_dim, MetricType metric, Allocator* allocator);
+
+protected:
+    void
+    train(const float* data, uint64_t count) override;
+
+private:
+    const MetricType metric_{MetricType::METRIC_TYPE_L2SQR};
+
+    static constexpr uint64_t MAX_SAMPLE_COUNT = 65536;
+};
+
+}  // namespace vsag
@@ -0,0 +1,52 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "random_rotation_transformer.h"
+
+#include <cblas.h>
+
+#include <cmath>
+#include <random>
+
+namespace vsag {
+RandomRotationTransformer::RandomRotationTransformer(int64_t input_dim,
+                                                     int64_t output_dim,
+                                                     Allocator* allocator,
+                                                     uint64_t seed)
+    : VectorTransformer(input_dim, output_dim, allocator), seed_(seed) {
+}
+
+void
+RandomRotationTransformer::train(const float* data, uint64_t count) {
+    auto dim = static_cast<blasint>(this->input_dim_);
+    std::mt19937 generator(this->seed_);
+    std::normal_distribution<float> distribution(0.0F, 1.0F);
+    for (auto& value : this->matrix_) {
+        value = distribution(generator);
+    }
+
+    // modified gram-schmidt on the rows, output_dim_ <= input_dim_ keeps them independent
+    for (int64_t k = 0; k < this->output_dim_; ++k) {
+        auto* row = this->matrix_.data() + k * this->input_dim_;
+        for (int64_t j = 0; j < k; ++j) {
+            const auto* prev = this->matrix_.data() + j * this->input_dim_;
+            auto projection = cblas_sdot(dim, row, 1, prev, 1);
+            cblas_saxpy(dim, -projection, prev, 1, row, 1);
+        }
+        auto norm = cblas_snrm2(dim, row, 1);
+        cblas_sscal(dim, 1.0F / norm, row, 1);
+    }
+}
+}  // namespace vsag
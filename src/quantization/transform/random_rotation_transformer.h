@@ -0,0 +1,45 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "vector_transformer.h"
+
+namespace vsag {
+
+/**
+ * @class RandomRotationTransformer
+ * @brief Multiplies vectors with a random orthogonal matrix.
+ *
+ * The rotation spreads the variance evenly over the dimensions, which helps scalar
+ * quantizers with one range for all dimensions. With a smaller output dimension it
+ * is an orthogonal random projection. The matrix only depends on the seed.
+ */
+class RandomRotationTransformer : public VectorTransformer {
+public:
+    RandomRotationTransformer(int64_t input_dim,
+                              int64_t output_dim,
+                              Allocator* allocator,
+                              uint64_t seed = 47);
+
+protected:
+    void
+    train(const float* data, uint64_t count) override;
+
+private:
+    const uint64_t seed_{47};
+};
+
+}  // namespace vsag
@@ -0,0 +1,46 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "transformer_parameter.h"
+
+#include <fmt/format-inl.h>
+
+#include "inner_string_params.h"
+
+namespace vsag {
+TransformerParameter::TransformerParameter() = default;
+
+void
+TransformerParameter::FromJson(const JsonType& json) {
+    this->type_ = Parameter::TryToParseType(json);
+    CHECK_ARGUMENT(
+        this->type_ == TRANSFORM_TYPE_VALUE_PCA or
+            this->type_ == TRANSFORM_TYPE_VALUE_RANDOM_ROTATION,
+        fmt::format("invalid transform type {}", this->type_));
+    if (json.contains(TRANSFORM_OUTPUT_DIM_KEY)) {
+        this->output_dim_ = json[TRANSFORM_OUTPUT_DIM_KEY];
+        CHECK_ARGUMENT(this->output_dim_ >= 0,
+                       fmt::format("{} must not be negative", TRANSFORM_OUTPUT_DIM_KEY));
+    }
+}
+
+JsonType
+TransformerParameter::ToJson() {
+    JsonType json;
+    json[TRANSFORM_TYPE_KEY] = this->type_;
+    json[TRANSFORM_OUTPUT_DIM_KEY] = this->output_dim_;
+    return json;
+}
+}  // namespace vsag
@@ -0,0 +1,43 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "parameter.h"
+
+namespace vsag {
+
+class TransformerParameter : public Parameter {
+public:
+    TransformerParameter();
+
+    void
+    FromJson(const JsonType& json) override;
+
+    JsonType
+    ToJson() override;
+
+public:
+    std::string type_{};
+
+    // dimension after the transform, 0 keeps the input dimension
+    int64_t output_dim_{0};
+};
+
+using TransformerParamPtr = std::shared_ptr<TransformerParameter>;
+
+}  // namespace vsag
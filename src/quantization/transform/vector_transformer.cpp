@@ -0,0 +1,121 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector_transformer.h"
+
+#include <cblas.h>
+#include <fmt/format-inl.h>
+
+#include "inner_string_params.h"
+#include "pca_transformer.h"
+#include "random_rotation_transformer.h"
+
+namespace vsag {
+VectorTransformerPtr
+VectorTransformer::MakeInstance(const TransformerParamPtr& param,
+                                const IndexCommonParam& common_param) {
+    auto output_dim = param->output_dim_ == 0 ? common_param.dim_ : param->output_dim_;
+    CHECK_ARGUMENT(output_dim <= common_param.dim_,
+                   fmt::format("transform output dim({}) must not exceed dim({})",
+                               output_dim,
+                               common_param.dim_));
+    if (param->type_ == TRANSFORM_TYPE_VALUE_PCA) {
+        return std::make_shared<PCATransformer>(common_param.dim_,
+                                                output_dim,
+                                                common_param.metric_,
+                                                common_param.allocator_.get());
+    }
+    if (param->type_ == TRANSFORM_TYPE_VALUE_RANDOM_ROTATION) {
+        return std::make_shared<RandomRotationTransformer>(
+            common_param.dim_, output_dim, common_param.allocator_.get());
+    }
+    throw std::invalid_argument(fmt::format("invalid transform type {}", param->type_));
+}
+
+VectorTransformer::VectorTransformer(int64_t input_dim, int64_t output_dim, Allocator* allocator)
+    : input_dim_(input_dim),
+      output_dim_(output_dim),
+      allocator_(allocator),
+      matrix_(allocator),
+      bias_(allocator) {
+    this->matrix_.resize(output_dim * input_dim, 0.0F);
+    this->bias_.resize(output_dim, 0.0F);
+}
+
+void
+VectorTransformer::Train(const float* data, uint64_t count) {
+    if (this->is_trained_) {
+        return;
+    }
+    this->train(data, count);
+    this->is_trained_ = true;
+}
+
+void
+VectorTransformer::Transform(const float* data, float* result) const {
+    std::copy(this->bias_.begin(), this->bias_.end(), result);
+    cblas_sgemv(CblasRowMajor,
+                CblasNoTrans,
+                static_cast<blasint>(this->output_dim_),
+                static_cast<blasint>(this->input_dim_),
+                1.0F,
+                this->matrix_.data(),
+                static_cast<blasint>(this->input_dim_),
+                data,
+                1,
+                -1.0F,
+                result,
+                1);
+}
+
+void
+VectorTransformer::TransformBatch(const float* data, float* result, uint64_t count) const {
+    for (uint64_t i = 0; i < count; ++i) {
+        std::copy(this->bias_.begin(), this->bias_.end(), result + i * this->output_dim_);
+    }
+    cblas_sgemm(CblasRowMajor,
+                CblasNoTrans,
+                CblasTrans,
+                static_cast<blasint>(count),
+                static_cast<blasint>(this->output_dim_),
+                static_cast<blasint>(this->input_dim_),
+                1.0F,
+                data,
+                static_cast<blasint>(this->input_dim_),
+                this->matrix_.data(),
+                static_cast<blasint>(this->input_dim_),
+                -1.0F,
+                result,
+                static_cast<blasint>(this->output_dim_));
+}
+
+void
+VectorTransformer::Serialize(StreamWriter& writer) {
+    StreamWriter::WriteObj(writer, this->input_dim_);
+    StreamWriter::WriteObj(writer, this->output_dim_);
+    StreamWriter::WriteObj(writer, this->is_trained_);
+    StreamWriter::WriteVector(writer, this->matrix_);
+    StreamWriter::WriteVector(writer, this->bias_);
+}
+
+void
+VectorTransformer::Deserialize(StreamReader& reader) {
+    StreamReader::ReadObj(reader, this->input_dim_);
+    StreamReader::ReadObj(reader, this->output_dim_);
+    StreamReader::ReadObj(reader, this->is_trained_);
+    StreamReader::ReadVector(reader, this->matrix_);
+    StreamReader::ReadVector(reader, this->bias_);
+}
+}  // namespace vsag
@@ -0,0 +1,108 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "index/index_common_param.h"
+#include "stream_reader.h"
+#include "stream_writer.h"
+#include "transformer_parameter.h"
+#include "typing.h"
+
+namespace vsag {
+
+class VectorTransformer;
+using VectorTransformerPtr = std::shared_ptr<VectorTransformer>;
+
+/**
+ * @class VectorTransformer
+ * @brief Linear transform applied to vectors before they are quantized.
+ *
+ * A vector x of input_dim is mapped to matrix * x - bias of output_dim, subclasses
+ * only decide how matrix and bias are trained.
+ */
+class VectorTransformer {
+public:
+    static VectorTransformerPtr
+    MakeInstance(const TransformerParamPtr& param, const IndexCommonParam& common_param);
+
+public:
+    VectorTransformer(int64_t input_dim, int64_t output_dim, Allocator* allocator);
+
+    virtual ~VectorTransformer() = default;
+
+    /**
+     * @brief Trains the transform, does nothing if it is already trained.
+     *
+     * @param data Pointer to count vectors of input dimension.
+     * @param count The number of vectors.
+     */
+    void
+    Train(const float* data, uint64_t count);
+
+    /**
+     * @brief Transforms one vector of input dimension into output dimension.
+     *
+     * @param data Pointer to the input vector.
+     * @param result Output buffer of output dimension.
+     */
+    void
+    Transform(const float* data, float* result) const;
+
+    /**
+     * @brief Transforms count contiguous vectors.
+     *
+     * @param data Pointer to the input vectors.
+     * @param result Output buffer of count * output dimension.
+     * @param count The number of vectors.
+     */
+    void
+    TransformBatch(const float* data, float* result, uint64_t count) const;
+
+    void
+    Serialize(StreamWriter& writer);
+
+    void
+    Deserialize(StreamReader& reader);
+
+    [[nodiscard]] inline int64_t
+    GetInputDim() const {
+        return this->input_dim_;
+    }
+
+    [[nodiscard]] inline int64_t
+    GetOutputDim() const {
+        return this->output_dim_;
+    }
+
+protected:
+    virtual void
+    train(const float* data, uint64_t count) = 0;
+
+protected:
+    int64_t input_dim_{0};
+    int64_t output_dim_{0};
+    bool is_trained_{false};
+    Allocator* const allocator_{nullptr};
+
+    // output_dim_ x input_dim_, row major
+    Vector<float> matrix_;
+    Vector<float> bias_;
+};
+
+}  // namespace vsag
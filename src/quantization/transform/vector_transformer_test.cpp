@@ -0,0 +1,137 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector_transformer.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <filesystem>
+#include <fstream>
+
+#include "fixtures.h"
+#include "inner_string_params.h"
+#include "safe_allocator.h"
+#include "simd/simd.h"
+
+using namespace vsag;
+
+static VectorTransformerPtr
+make_transformer(const std::string& type,
+                 int64_t dim,
+                 int64_t output_dim,
+                 MetricType metric,
+                 const std::shared_ptr<Allocator>& allocator) {
+    auto param = std::make_shared<TransformerParameter>();
+    param->FromJson({{TRANSFORM_TYPE_KEY, type}, {TRANSFORM_OUTPUT_DIM_KEY, output_dim}});
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    common_param.dim_ = dim;
+    common_param.metric_ = metric;
+    return VectorTransformer::MakeInstance(param, common_param);
+}
+
+TEST_CASE("VectorTransformer Keeps Distance At Full Dim", "[ut][VectorTransformer]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = GENERATE(16, 100);
+    std::string type = GENERATE(TRANSFORM_TYPE_VALUE_PCA, TRANSFORM_TYPE_VALUE_RANDOM_ROTATION);
+    uint64_t count = 500;
+    auto vecs = fixtures::generate_vectors(count, dim);
+
+    auto transformer = make_transformer(type, dim, 0, MetricType::METRIC_TYPE_L2SQR, allocator);
+    REQUIRE(transformer->GetOutputDim() == dim);
+    transformer->Train(vecs.data(), count);
+
+    std::vector<float> transformed(count * dim);
+    transformer->TransformBatch(vecs.data(), transformed.data(), count);
+    std::vector<float> single(dim);
+    for (uint64_t i = 0; i < count; i += 50) {
+        transformer->Transform(vecs.data() + i * dim, single.data());
+        for (int64_t j = 0; j < dim; ++j) {
+            REQUIRE(std::abs(single[j] - transformed[i * dim + j]) < 1e-4);
+        }
+        for (uint64_t k = 1; k < count; k += 97) {
+            auto gt = L2Sqr(vecs.data() + i * dim, vecs.data() + k * dim, &dim);
+            auto value = L2Sqr(transformed.data() + i * dim, transformed.data() + k * dim, &dim);
+            REQUIRE(std::abs(gt - value) < 1e-3);
+        }
+    }
+}
+
+TEST_CASE("VectorTransformer PCA Keeps Variance Order", "[ut][VectorTransformer]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 32;
+    int64_t output_dim = 8;
+    uint64_t count = 2000;
+    auto vecs = fixtures::generate_vectors(count, dim);
+    // stretch the first dimensions so that they carry most of the variance
+    for (uint64_t i = 0; i < count; ++i) {
+        for (int64_t j = 0; j < output_dim; ++j) {
+            vecs[i * dim + j] *= static_cast<float>(10 * (output_dim - j));
+        }
+    }
+    auto transformer = make_transformer(
+        TRANSFORM_TYPE_VALUE_PCA, dim, output_dim, MetricType::METRIC_TYPE_L2SQR, allocator);
+    transformer->Train(vecs.data(), count);
+    std::vector<float> transformed(count * output_dim);
+    transformer->TransformBatch(vecs.data(), transformed.data(), count);
+
+    std::vector<double> variance(output_dim, 0.0);
+    for (uint64_t i = 0; i < count; ++i) {
+        for (int64_t j = 0; j < output_dim; ++j) {
+            variance[j] += transformed[i * output_dim + j] * transformed[i * output_dim + j];
+        }
+    }
+    for (int64_t j = 1; j < output_dim; ++j) {
+        REQUIRE(variance[j - 1] >= variance[j]);
+    }
+}
+
+TEST_CASE("VectorTransformer Serialize And Deserialize", "[ut][VectorTransformer]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 32;
+    int64_t output_dim = GENERATE(16, 32);
+    std::string type = GENERATE(TRANSFORM_TYPE_VALUE_PCA, TRANSFORM_TYPE_VALUE_RANDOM_ROTATION);
+    uint64_t count = 200;
+    auto vecs = fixtures::generate_vectors(count, dim);
+
+    auto transformer =
+        make_transformer(type, dim, output_dim, MetricType::METRIC_TYPE_IP, allocator);
+    transformer->Train(vecs.data(), count);
+    fixtures::TempDir dir("transformer");
+    auto filename = dir.GenerateRandomFile();
+    std::ofstream outfile(filename.c_str(), std::ios::binary);
+    IOStreamWriter writer(outfile);
+    transformer->Serialize(writer);
+    outfile.close();
+
+    auto other = make_transformer(type, dim, output_dim, MetricType::METRIC_TYPE_IP, allocator);
+    std::ifstream infile(filename.c_str(), std::ios::binary);
+    IOStreamReader reader(infile);
+    other->Deserialize(reader);
+    infile.close();
+
+    std::vector<float> expected(count * output_dim);
+    std::vector<float> result(count * output_dim);
+    transformer->TransformBatch(vecs.data(), expected.data(), count);
+    other->TransformBatch(vecs.data(), result.data(), count);
+    REQUIRE(expected == result);
+}
+
+TEST_CASE("VectorTransformer Invalid Parameter", "[ut][VectorTransformer]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    REQUIRE_THROWS(make_transformer("unknown", 32, 0, MetricType::METRIC_TYPE_L2SQR, allocator));
+    REQUIRE_THROWS(make_transformer(
+        TRANSFORM_TYPE_VALUE_PCA, 32, 64, MetricType::METRIC_TYPE_L2SQR, allocator));
+}
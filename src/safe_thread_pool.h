@@ -25,7 +25,9 @@ public:
     static std::shared_ptr<SafeThreadPool>
     FactoryDefaultThreadPool() {
         return std::make_shared<SafeThreadPool>(
-            new DefaultThreadPool(Options::Instance().num_threads_building()), true);
+            new DefaultThreadPool(Options::Instance().num_threads_building(),
+                                  Options::Instance().numa_bind_threads()),
+            true);
     }
 
 public:
@@ -15,7 +15,9 @@
 
 #include "safe_thread_pool.h"
 
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
+#include <vector>
 
 TEST_CASE("SafeThreadPool Basic Test", "[ut][SafeThreadPool]") {
     auto thread_pool = vsag::SafeThreadPool::FactoryDefaultThreadPool();
@@ -39,3 +41,18 @@ TEST_CASE("SafeThreadPool Basic Test", "[ut][SafeThreadPool]") {
     thread_pool->WaitUntilEmpty();
     REQUIRE(data == round);
 }
+
+TEST_CASE("SafeThreadPool Numa Bind Test", "[ut][SafeThreadPool]") {
+    auto thread_pool =
+        std::make_shared<vsag::SafeThreadPool>(new vsag::DefaultThreadPool(4, true), true);
+    std::atomic<int> data = 0;
+    int round = 20;
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < round; ++i) {
+        futures.emplace_back(thread_pool->Enqueue([&data]() { data++; }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    REQUIRE(data == round);
+}
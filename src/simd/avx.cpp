@@ -397,4 +397,11 @@ Normalize(const float* from, float* to, uint64_t dim) {
     return norm;
 }
 
+void
+DeltaDecodeIds(
+    const uint8_t* packed, uint32_t bit_width, uint32_t count, uint32_t base, uint32_t* ids) {
+    // avx has no 256-bit integer shifts or adds, the sse kernel is the widest one available
+    sse::DeltaDecodeIds(packed, bit_width, count, base, ids);
+}
+
 }  // namespace vsag::avx
@@ -77,6 +77,50 @@ PQDistanceFloat256(const void* single_dim_centers, float single_dim_val, void* r
 #endif
 }
 
+void
+PQDistanceLookupBatch(
+    const uint8_t* codes, uint64_t count, uint64_t chunks, const float* tables, float* result) {
+#if defined(ENABLE_AVX2)
+    // lane k scores candidate i + k; one 32-bit gather fetches 4 consecutive codes per lane
+    const __m256i v_offsets =
+        _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(chunks));
+    const __m256i v_mask = _mm256_set1_epi32(0xff);
+    uint64_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint8_t* block = codes + i * chunks;
+        __m256 v_sum = _mm256_setzero_ps();
+        uint64_t c = 0;
+        for (; c + 4 <= chunks; c += 4) {
+            const float* table = tables + c * 256;
+            __m256i v_codes = _mm256_i32gather_epi32((const int*)(block + c), v_offsets, 1);
+            __m256i v_idx0 = _mm256_and_si256(v_codes, v_mask);
+            __m256i v_idx1 = _mm256_and_si256(_mm256_srli_epi32(v_codes, 8), v_mask);
+            __m256i v_idx2 = _mm256_and_si256(_mm256_srli_epi32(v_codes, 16), v_mask);
+            __m256i v_idx3 = _mm256_srli_epi32(v_codes, 24);
+            v_sum = _mm256_add_ps(v_sum, _mm256_i32gather_ps(table, v_idx0, 4));
+            v_sum = _mm256_add_ps(v_sum, _mm256_i32gather_ps(table + 256, v_idx1, 4));
+            v_sum = _mm256_add_ps(v_sum, _mm256_i32gather_ps(table + 512, v_idx2, 4));
+            v_sum = _mm256_add_ps(v_sum, _mm256_i32gather_ps(table + 768, v_idx3, 4));
+        }
+        for (; c < chunks; ++c) {
+            __m256i v_idx = _mm256_setr_epi32(block[c],
+                                              block[chunks + c],
+                                              block[2 * chunks + c],
+                                              block[3 * chunks + c],
+                                              block[4 * chunks + c],
+                                              block[5 * chunks + c],
+                                              block[6 * chunks + c],
+                                              block[7 * chunks + c]);
+            v_sum = _mm256_add_ps(v_sum, _mm256_i32gather_ps(tables + c * 256, v_idx, 4));
+        }
+        _mm256_storeu_ps(result + i, v_sum);
+    }
+    generic::PQDistanceLookupBatch(codes + i * chunks, count - i, chunks, tables, result + i);
+#else
+    return generic::PQDistanceLookupBatch(codes, count, chunks, tables, result);
+#endif
+}
+
 #if defined(ENABLE_AVX2)
 __inline __m128i __attribute__((__always_inline__)) load_8_char(const uint8_t* data) {
     return _mm_set_epi8(0,
@@ -454,4 +498,48 @@ Normalize(const float* from, float* to, uint64_t dim) {
     return norm;
 }
 
+void
+DeltaDecodeIds(
+    const uint8_t* packed, uint32_t bit_width, uint32_t count, uint32_t base, uint32_t* ids) {
+#if defined(ENABLE_AVX2)
+    // a 32-bit gather covers one delta only when it fits next to the bit shift
+    if (bit_width > 25 or count < 8) {
+        return avx::DeltaDecodeIds(packed, bit_width, count, base, ids);
+    }
+    const auto width = static_cast<int32_t>(bit_width);
+    __m256i bit_pos = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                         _mm256_set1_epi32(width));
+    __m256i step = _mm256_set1_epi32(8 * width);
+    __m256i mask = _mm256_set1_epi32(static_cast<int32_t>((1U << bit_width) - 1));
+    __m256i seven = _mm256_set1_epi32(7);
+    __m256i low_last = _mm256_set1_epi32(3);
+    __m256i carry = _mm256_set1_epi32(static_cast<int32_t>(base));
+    uint32_t i = 0;
+    for (; i + 7 < count; i += 8) {
+        auto words = _mm256_i32gather_epi32(
+            reinterpret_cast<const int*>(packed), _mm256_srli_epi32(bit_pos, 3), 1);
+        auto deltas = _mm256_and_si256(
+            _mm256_srlv_epi32(words, _mm256_and_si256(bit_pos, seven)), mask);
+        // inclusive prefix sum in each 128-bit lane, then carry the low lane into the high one
+        deltas = _mm256_add_epi32(deltas, _mm256_slli_si256(deltas, 4));
+        deltas = _mm256_add_epi32(deltas, _mm256_slli_si256(deltas, 8));
+        auto low_sum = _mm256_permutevar8x32_epi32(deltas, low_last);
+        deltas = _mm256_add_epi32(
+            deltas, _mm256_blend_epi32(_mm256_setzero_si256(), low_sum, 0xF0));
+        deltas = _mm256_add_epi32(deltas, carry);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(ids + i), deltas);
+        carry = _mm256_permutevar8x32_epi32(deltas, seven);
+        bit_pos = _mm256_add_epi32(bit_pos, step);
+    }
+    // 8 deltas always end on a byte boundary
+    avx::DeltaDecodeIds(packed + static_cast<uint64_t>(i) * bit_width / 8,
+                        bit_width,
+                        count - i,
+                        ids[i - 1],
+                        ids + i);
+#else
+    avx::DeltaDecodeIds(packed, bit_width, count, base, ids);
+#endif
+}
+
 }  // namespace vsag::avx2
@@ -86,6 +86,55 @@ PQDistanceFloat256(const void* single_dim_centers, float single_dim_val, void* r
     return avx2::PQDistanceFloat256(single_dim_centers, single_dim_val, result);
 }
 
+#if defined(ENABLE_AVX512)
+__inline __m512i __attribute__((__always_inline__))
+gather_block_codes(const uint8_t* block, uint64_t chunks, uint64_t c) {
+    alignas(64) int32_t idx[16];
+    for (int k = 0; k < 16; ++k) {
+        idx[k] = block[k * chunks + c];
+    }
+    return _mm512_load_si512(idx);
+}
+#endif
+
+void
+PQDistanceLookupBatch(
+    const uint8_t* codes, uint64_t count, uint64_t chunks, const float* tables, float* result) {
+#if defined(ENABLE_AVX512)
+    // lane k scores candidate i + k; one 32-bit gather fetches 4 consecutive codes per lane
+    const __m512i v_offsets = _mm512_mullo_epi32(
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+        _mm512_set1_epi32(chunks));
+    const __m512i v_mask = _mm512_set1_epi32(0xff);
+    uint64_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8_t* block = codes + i * chunks;
+        __m512 v_sum = _mm512_setzero_ps();
+        uint64_t c = 0;
+        for (; c + 4 <= chunks; c += 4) {
+            const float* table = tables + c * 256;
+            __m512i v_codes = _mm512_i32gather_epi32(v_offsets, (const int*)(block + c), 1);
+            __m512i v_idx0 = _mm512_and_si512(v_codes, v_mask);
+            __m512i v_idx1 = _mm512_and_si512(_mm512_srli_epi32(v_codes, 8), v_mask);
+            __m512i v_idx2 = _mm512_and_si512(_mm512_srli_epi32(v_codes, 16), v_mask);
+            __m512i v_idx3 = _mm512_srli_epi32(v_codes, 24);
+            v_sum = _mm512_add_ps(v_sum, _mm512_i32gather_ps(v_idx0, table, 4));
+            v_sum = _mm512_add_ps(v_sum, _mm512_i32gather_ps(v_idx1, table + 256, 4));
+            v_sum = _mm512_add_ps(v_sum, _mm512_i32gather_ps(v_idx2, table + 512, 4));
+            v_sum = _mm512_add_ps(v_sum, _mm512_i32gather_ps(v_idx3, table + 768, 4));
+        }
+        for (; c < chunks; ++c) {
+            __m512i v_idx = gather_block_codes(block, chunks, c);
+            v_sum = _mm512_add_ps(v_sum, _mm512_i32gather_ps(v_idx, tables + c * 256, 4));
+        }
+        _mm512_storeu_ps(result + i, v_sum);
+    }
+    avx2::PQDistanceLookupBatch(codes + i * chunks, count - i, chunks, tables, result + i);
+#else
+    return avx2::PQDistanceLookupBatch(codes, count, chunks, tables, result);
+#endif
+}
+
 float
 FP32ComputeIP(const float* query, const float* codes, uint64_t dim) {
 #if defined(ENABLE_AVX512)
@@ -405,4 +454,48 @@ Normalize(const float* from, float* to, uint64_t dim) {
     return norm;
 }
 
+void
+DeltaDecodeIds(
+    const uint8_t* packed, uint32_t bit_width, uint32_t count, uint32_t base, uint32_t* ids) {
+#if defined(ENABLE_AVX512)
+    // a 32-bit gather covers one delta only when it fits next to the bit shift
+    if (bit_width > 25 or count < 16) {
+        return avx2::DeltaDecodeIds(packed, bit_width, count, base, ids);
+    }
+    const auto width = static_cast<int32_t>(bit_width);
+    __m512i bit_pos = _mm512_mullo_epi32(
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+        _mm512_set1_epi32(width));
+    __m512i step = _mm512_set1_epi32(16 * width);
+    __m512i mask = _mm512_set1_epi32(static_cast<int32_t>((1U << bit_width) - 1));
+    __m512i seven = _mm512_set1_epi32(7);
+    __m512i last = _mm512_set1_epi32(15);
+    __m512i zero = _mm512_setzero_si512();
+    __m512i carry = _mm512_set1_epi32(static_cast<int32_t>(base));
+    uint32_t i = 0;
+    for (; i + 15 < count; i += 16) {
+        auto words = _mm512_i32gather_epi32(_mm512_srli_epi32(bit_pos, 3), packed, 1);
+        auto deltas = _mm512_and_si512(
+            _mm512_srlv_epi32(words, _mm512_and_si512(bit_pos, seven)), mask);
+        // inclusive prefix sum, valignd shifts across the whole register
+        deltas = _mm512_add_epi32(deltas, _mm512_alignr_epi32(deltas, zero, 15));
+        deltas = _mm512_add_epi32(deltas, _mm512_alignr_epi32(deltas, zero, 14));
+        deltas = _mm512_add_epi32(deltas, _mm512_alignr_epi32(deltas, zero, 12));
+        deltas = _mm512_add_epi32(deltas, _mm512_alignr_epi32(deltas, zero, 8));
+        deltas = _mm512_add_epi32(deltas, carry);
+        _mm512_storeu_si512(ids + i, deltas);
+        carry = _mm512_permutexvar_epi32(last, deltas);
+        bit_pos = _mm512_add_epi32(bit_pos, step);
+    }
+    // 16 deltas always end on a byte boundary
+    avx2::DeltaDecodeIds(packed + static_cast<uint64_t>(i) * bit_width / 8,
+                         bit_width,
+                         count - i,
+                         ids[i - 1],
+                         ids + i);
+#else
+    avx2::DeltaDecodeIds(packed, bit_width, count, base, ids);
+#endif
+}
+
 }  // namespace vsag::avx512
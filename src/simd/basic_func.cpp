@@ -157,6 +157,21 @@ GetPQDistanceFloat256() {
 }
 PQDistanceFunc PQDistanceFloat256 = GetPQDistanceFloat256();
 
+static PQDistanceLookupBatchFunc
+GetPQDistanceLookupBatch() {
+    if (SimdStatus::SupportAVX512()) {
+#if defined(ENABLE_AVX512)
+        return avx512::PQDistanceLookupBatch;
+#endif
+    } else if (SimdStatus::SupportAVX2()) {
+#if defined(ENABLE_AVX2)
+        return avx2::PQDistanceLookupBatch;
+#endif
+    }
+    return generic::PQDistanceLookupBatch;
+}
+PQDistanceLookupBatchFunc PQDistanceLookupBatch = GetPQDistanceLookupBatch();
+
 static PrefetchFunc
 GetPrefetch() {
     if (SimdStatus::SupportSSE()) {
@@ -33,6 +33,9 @@ INT8InnerProductDistance(const void* pVect1, const void* pVect2, const void* qty
 void
 PQDistanceFloat256(const void* single_dim_centers, float single_dim_val, void* result);
 void
+PQDistanceLookupBatch(
+    const uint8_t* codes, uint64_t count, uint64_t chunks, const float* tables, float* result);
+void
 Prefetch(const void* data);
 }  // namespace generic
 
@@ -81,6 +84,9 @@ float
 INT8InnerProductDistance(const void* pVect1, const void* pVect2, const void* qty_ptr);
 void
 PQDistanceFloat256(const void* single_dim_centers, float single_dim_val, void* result);
+void
+PQDistanceLookupBatch(
+    const uint8_t* codes, uint64_t count, uint64_t chunks, const float* tables, float* result);
 }  // namespace avx2
 
 namespace avx512 {
@@ -96,6 +102,9 @@ float
 INT8InnerProductDistance(const void* pVect1, const void* pVect2, const void* qty_ptr);
 void
 PQDistanceFloat256(const void* single_dim_centers, float single_dim_val, void* result);
+void
+PQDistanceLookupBatch(
+    const uint8_t* codes, uint64_t count, uint64_t chunks, const float* tables, float* result);
 }  // namespace avx512
 
 using DistanceFuncType = float (*)(const void* query1, const void* query2, const void* qty_ptr);
@@ -108,6 +117,10 @@ extern DistanceFuncType INT8InnerProductDistance;
 using PQDistanceFunc = void (*)(const void* single_dim_centers, float single_dim_val, void* result);
 extern PQDistanceFunc PQDistanceFloat256;
 
+using PQDistanceLookupBatchFunc = void (*)(
+    const uint8_t* codes, uint64_t count, uint64_t chunks, const float* tables, float* result);
+extern PQDistanceLookupBatchFunc PQDistanceLookupBatch;
+
 using PrefetchFunc = void (*)(const void* data);
 extern PrefetchFunc Prefetch;
 }  // namespace vsag
@@ -105,3 +105,37 @@ TEST_CASE("PQ Calculation", "[ut][simd]") {
         check_func();
     }
 }
+
+TEST_CASE("PQ Batch Lookup Calculation", "[ut][simd]") {
+    std::vector<uint64_t> chunk_counts = {1, 7, 32, 33};
+    for (auto chunks : chunk_counts) {
+        uint64_t count = 45;
+        auto codes = fixtures::generate_uint8_codes(count, chunks);
+        auto tables = fixtures::generate_vectors(chunks, 256, false);
+        std::vector<float> results_expected(count);
+        std::vector<float> results(count);
+        generic::PQDistanceLookupBatch(
+            codes.data(), count, chunks, tables.data(), results_expected.data());
+        for (uint64_t i = 0; i < count; ++i) {
+            float expected = 0.0f;
+            for (uint64_t c = 0; c < chunks; ++c) {
+                expected += tables[c * 256 + codes[i * chunks + c]];
+            }
+            REQUIRE(std::abs(expected - results_expected[i]) < 0.001);
+        }
+        auto check_func = [&]() {
+            for (uint64_t i = 0; i < count; ++i) {
+                REQUIRE(std::abs(results_expected[i] - results[i]) < 0.001);
+            }
+        };
+        if (SimdStatus::SupportAVX2()) {
+            avx2::PQDistanceLookupBatch(codes.data(), count, chunks, tables.data(), results.data());
+            check_func();
+        }
+        if (SimdStatus::SupportAVX512()) {
+            avx512::PQDistanceLookupBatch(
+                codes.data(), count, chunks, tables.data(), results.data());
+            check_func();
+        }
+    }
+}
@@ -0,0 +1,60 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+namespace vsag {
+namespace generic {
+void
+DeltaDecodeIds(
+    const uint8_t* packed, uint32_t bit_width, uint32_t count, uint32_t base, uint32_t* ids);
+}  // namespace generic
+
+namespace sse {
+void
+DeltaDecodeIds(
+    const uint8_t* packed, uint32_t bit_width, uint32_t count, uint32_t base, uint32_t* ids);
+}  // namespace sse
+
+namespace avx {
+void
+DeltaDecodeIds(
+    const uint8_t* packed, uint32_t bit_width, uint32_t count, uint32_t base, uint32_t* ids);
+}  // namespace avx
+
+namespace avx2 {
+void
+DeltaDecodeIds(
+    const uint8_t* packed, uint32_t bit_width, uint32_t count, uint32_t base, uint32_t* ids);
+}  // namespace avx2
+
+namespace avx512 {
+void
+DeltaDecodeIds(
+    const uint8_t* packed, uint32_t bit_width, uint32_t count, uint32_t base, uint32_t* ids);
+}  // namespace avx512
+
+/**
+ * decodes count deltas of bit_width bits packed LSB first, ids[i] = base + sum(deltas[0..i]);
+ * packed must stay readable for DELTA_DECODE_PADDING bytes past the packed bits
+ */
+using DeltaDecodeIdsType = void (*)(
+    const uint8_t* packed, uint32_t bit_width, uint32_t count, uint32_t base, uint32_t* ids);
+extern DeltaDecodeIdsType DeltaDecodeIds;
+
+constexpr uint64_t DELTA_DECODE_PADDING = 8;
+}  // namespace vsag
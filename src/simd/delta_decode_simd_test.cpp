@@ -0,0 +1,79 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "delta_decode_simd.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <vector>
+
+#include "simd_status.h"
+
+using namespace vsag;
+
+static std::vector<uint8_t>
+pack_deltas(const std::vector<uint32_t>& deltas, uint32_t bit_width) {
+    std::vector<uint8_t> packed((deltas.size() * bit_width + 7) / 8 + DELTA_DECODE_PADDING, 0);
+    uint64_t bit_pos = 0;
+    for (auto delta : deltas) {
+        for (uint32_t bit = 0; bit < bit_width; ++bit, ++bit_pos) {
+            if (((delta >> bit) & 1) != 0) {
+                packed[bit_pos / 8] |= static_cast<uint8_t>(1 << (bit_pos % 8));
+            }
+        }
+    }
+    return packed;
+}
+
+#define TEST_DECODE(Simd)                                                                  \
+    {                                                                                      \
+        std::vector<uint32_t> result(count);                                               \
+        Simd::DeltaDecodeIds(packed.data(), bit_width, count, base, result.data());        \
+        REQUIRE(result == expected);                                                       \
+    }
+
+TEST_CASE("Delta Decode Ids", "[ut][simd]") {
+    std::mt19937 generator(47);
+    for (uint32_t bit_width = 0; bit_width <= 32; ++bit_width) {
+        for (uint32_t count : {0, 1, 7, 8, 9, 31, 64, 127}) {
+            std::vector<uint32_t> deltas(count);
+            for (auto& delta : deltas) {
+                delta = bit_width == 0 ? 0 : generator() >> (32 - bit_width);
+            }
+            uint32_t base = bit_width == 32 ? 0 : generator() >> 8;
+            std::vector<uint32_t> expected(count);
+            auto current = base;
+            for (uint32_t i = 0; i < count; ++i) {
+                current += deltas[i];
+                expected[i] = current;
+            }
+            auto packed = pack_deltas(deltas, bit_width);
+
+            TEST_DECODE(generic);
+            if (SimdStatus::SupportSSE()) {
+                TEST_DECODE(sse);
+            }
+            if (SimdStatus::SupportAVX()) {
+                TEST_DECODE(avx);
+            }
+            if (SimdStatus::SupportAVX2()) {
+                TEST_DECODE(avx2);
+            }
+            if (SimdStatus::SupportAVX512()) {
+                TEST_DECODE(avx512);
+            }
+        }
+    }
+}
@@ -13,6 +13,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cmath>
+#include <cstring>
+
 #include "simd.h"
 
 namespace vsag::generic {
@@ -75,6 +78,19 @@ PQDistanceFloat256(const void* single_dim_centers, float single_dim_val, void* r
     }
 }
 
+void
+PQDistanceLookupBatch(
+    const uint8_t* codes, uint64_t count, uint64_t chunks, const float* tables, float* result) {
+    for (uint64_t i = 0; i < count; ++i) {
+        const uint8_t* code = codes + i * chunks;
+        float dist = 0.0f;
+        for (uint64_t c = 0; c < chunks; ++c) {
+            dist += tables[c * 256 + code[c]];
+        }
+        result[i] = dist;
+    }
+}
+
 float
 FP32ComputeIP(const float* query, const float* codes, uint64_t dim) {
     float result = 0.0f;
@@ -310,4 +326,18 @@ DivScalar(const float* from, float* to, uint64_t dim, float scalar) {
 void
 Prefetch(const void* data){};
 
+void
+DeltaDecodeIds(
+    const uint8_t* packed, uint32_t bit_width, uint32_t count, uint32_t base, uint32_t* ids) {
+    uint64_t mask = (1ULL << bit_width) - 1;
+    uint64_t bit_pos = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t word;
+        std::memcpy(&word, packed + (bit_pos >> 3), sizeof(word));
+        base += static_cast<uint32_t>((word >> (bit_pos & 7)) & mask);
+        ids[i] = base;
+        bit_pos += bit_width;
+    }
+}
+
 }  // namespace vsag::generic
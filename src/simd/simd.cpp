@@ -83,6 +83,11 @@ GetPQDistanceFunc() {
     return vsag::PQDistanceFloat256;
 }
 
+PQDistanceLookupBatchFunc
+GetPQDistanceLookupBatchFunc() {
+    return vsag::PQDistanceLookupBatch;
+}
+
 DistanceFunc
 GetL2DistanceFunc(size_t dim) {
     return vsag::L2Sqr;
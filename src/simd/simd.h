@@ -19,6 +19,7 @@
 #include <cstdlib>
 
 #include "basic_func.h"
+#include "delta_decode_simd.h"
 #include "fp32_simd.h"
 #include "normalize.h"
 #include "simd_status.h"
@@ -46,4 +47,10 @@ typedef void (*PQDistanceFunc)(const void* single_dim_centers, float single_dim_
 PQDistanceFunc
 GetPQDistanceFunc();
 
+typedef void (*PQDistanceLookupBatchFunc)(
+    const uint8_t* codes, uint64_t count, uint64_t chunks, const float* tables, float* result);
+
+PQDistanceLookupBatchFunc
+GetPQDistanceLookupBatchFunc();
+
 }  // namespace vsag
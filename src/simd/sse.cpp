@@ -18,6 +18,7 @@
 #endif
 
 #include <cmath>
+#include <cstring>
 
 #include "simd.h"
 
@@ -438,4 +439,48 @@ Prefetch(const void* data) {
 #endif
 };
 
+void
+DeltaDecodeIds(
+    const uint8_t* packed, uint32_t bit_width, uint32_t count, uint32_t base, uint32_t* ids) {
+#if defined(ENABLE_SSE)
+    // two 64-bit loads cover four deltas only when two of them fit next to the bit shift
+    if (bit_width > 28 or count < 4) {
+        return generic::DeltaDecodeIds(packed, bit_width, count, base, ids);
+    }
+    uint64_t mask = (1ULL << bit_width) - 1;
+    uint64_t bit_pos = 0;
+    auto load_bits = [&](uint64_t pos) {
+        uint64_t word;
+        std::memcpy(&word, packed + (pos >> 3), sizeof(word));
+        return word >> (pos & 7);
+    };
+    __m128i carry = _mm_set1_epi32(static_cast<int32_t>(base));
+    uint32_t i = 0;
+    for (; i + 3 < count; i += 4) {
+        auto low = load_bits(bit_pos);
+        auto high = load_bits(bit_pos + 2 * bit_width);
+        auto deltas = _mm_setr_epi32(static_cast<int32_t>(low & mask),
+                                     static_cast<int32_t>((low >> bit_width) & mask),
+                                     static_cast<int32_t>(high & mask),
+                                     static_cast<int32_t>((high >> bit_width) & mask));
+        // inclusive prefix sum of the four deltas on top of the last decoded id
+        deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 4));
+        deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 8));
+        deltas = _mm_add_epi32(deltas, carry);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ids + i), deltas);
+        carry = _mm_shuffle_epi32(deltas, 0xFF);
+        bit_pos += 4 * bit_width;
+    }
+    // the tail may start inside a byte, decode it in place
+    base = ids[i - 1];
+    for (; i < count; ++i) {
+        base += static_cast<uint32_t>(load_bits(bit_pos) & mask);
+        ids[i] = base;
+        bit_pos += bit_width;
+    }
+#else
+    generic::DeltaDecodeIds(packed, bit_width, count, base, ids);
+#endif
+}
+
 }  // namespace vsag::sse
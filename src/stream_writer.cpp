@@ -18,6 +18,39 @@
 #include <cstring>
 #include <utility>
 
+void
+StreamWriter::WriteSectionHeader(StreamWriter& writer,
+                                 const std::string& key,
+                                 uint64_t section_size) {
+    size_t key_size = key.size();
+    WriteObj(writer, key_size);
+    writer.Write(key.data(), key_size);
+    WriteObj(writer, static_cast<size_t>(section_size));
+}
+
+void
+StreamWriter::WriteBinarySet(StreamWriter& writer, const vsag::BinarySet& binary_set) {
+    for (const auto& key : binary_set.GetKeys()) {
+        auto binary = binary_set.Get(key);
+        WriteSectionHeader(writer, key, binary.size);
+        writer.Write(reinterpret_cast<const char*>(binary.data.get()), binary.size);
+    }
+}
+
+uint64_t
+StreamWriter::SectionHeaderSize(const std::string& key) {
+    return sizeof(size_t) + key.size() + sizeof(size_t);
+}
+
+uint64_t
+StreamWriter::BinarySetSize(const vsag::BinarySet& binary_set) {
+    uint64_t size = 0;
+    for (const auto& key : binary_set.GetKeys()) {
+        size += SectionHeaderSize(key) + binary_set.Get(key).size;
+    }
+    return size;
+}
+
 BufferStreamWriter::BufferStreamWriter(char*& buffer) : buffer_(buffer) {
 }
 
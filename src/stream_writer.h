@@ -18,8 +18,10 @@
 #include <cstdint>
 #include <functional>
 #include <ostream>
+#include <string>
 
 #include "typing.h"
+#include "vsag/binaryset.h"
 
 class StreamWriter {
 public:
@@ -49,6 +51,22 @@ public:
         WriteObj(writer, size);
         writer.Write(reinterpret_cast<const char*>(val.data()), size * sizeof(T));
     }
+
+    // starts a section in the layout of binaryset_to_binary: | key_size | key | section_size |,
+    // the next section_size bytes written are the section data
+    static void
+    WriteSectionHeader(StreamWriter& writer, const std::string& key, uint64_t section_size);
+
+    static void
+    WriteBinarySet(StreamWriter& writer, const vsag::BinarySet& binary_set);
+
+    // bytes written by WriteSectionHeader
+    static uint64_t
+    SectionHeaderSize(const std::string& key);
+
+    // bytes written by WriteBinarySet
+    static uint64_t
+    BinarySetSize(const vsag::BinarySet& binary_set);
 };
 
 class BufferStreamWriter : public StreamWriter {
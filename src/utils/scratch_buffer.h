@@ -0,0 +1,95 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "vsag/allocator.h"
+
+namespace vsag {
+
+/**
+ * @brief A byte buffer for the hot paths of the data cells that avoids the allocator for
+ * small sizes.
+ *
+ * Every thread owns one fixed block of MAX_CACHED_SIZE bytes per slot, a request that fits
+ * is served from it. Larger requests are allocated from the given allocator and released
+ * with the buffer. A block stays valid until the same thread takes the same slot again, a
+ * caller that needs two buffers at once takes two slots.
+ */
+class ScratchBuffer {
+public:
+    enum Slot : uint32_t {
+        ENCODE = 0,
+        READ_FIRST = 1,
+        READ_SECOND = 2,
+        // returned to the caller of FlattenInterface::GetCodesById
+        GET_CODES = 3,
+        // returned to the caller of GraphInterface::GetNeighborsPtr
+        NEIGHBORS = 4,
+        // a single vector passed through the transform of FlattenDataCell
+        TRANSFORM = 5,
+        SLOT_COUNT = 6,
+    };
+
+    static constexpr uint64_t MAX_CACHED_SIZE = 4096;
+
+    ScratchBuffer(uint64_t size, Slot slot, Allocator* allocator) : allocator_(allocator) {
+        data_ = Cached(size, slot);
+        if (data_ == nullptr) {
+            data_ = static_cast<uint8_t*>(allocator_->Allocate(size));
+            owned_ = true;
+        }
+    }
+
+    ~ScratchBuffer() {
+        if (owned_) {
+            allocator_->Deallocate(data_);
+        }
+    }
+
+    ScratchBuffer(const ScratchBuffer&) = delete;
+    ScratchBuffer&
+    operator=(const ScratchBuffer&) = delete;
+
+    [[nodiscard]] uint8_t*
+    Data() const {
+        return data_;
+    }
+
+    /**
+     * @brief Returns the thread's block of the slot.
+     *
+     * @return nullptr if size exceeds MAX_CACHED_SIZE.
+     */
+    static uint8_t*
+    Cached(uint64_t size, Slot slot) {
+        if (size > MAX_CACHED_SIZE) {
+            return nullptr;
+        }
+        alignas(64) thread_local std::array<std::array<uint8_t, MAX_CACHED_SIZE>, SLOT_COUNT>
+            blocks;
+        return blocks[slot].data();
+    }
+
+private:
+    Allocator* const allocator_{nullptr};
+    uint8_t* data_{nullptr};
+    bool owned_{false};
+};
+
+}  // namespace vsag
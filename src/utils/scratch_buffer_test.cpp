@@ -0,0 +1,62 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "scratch_buffer.h"
+
+#include <cstring>
+#include <thread>
+
+#include "catch2/catch_test_macros.hpp"
+#include "safe_allocator.h"
+using namespace vsag;
+
+TEST_CASE("ScratchBuffer Basic Test", "[ut][ScratchBuffer]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    SECTION("reuse the same slot") {
+        uint8_t* small = nullptr;
+        {
+            ScratchBuffer buffer(16, ScratchBuffer::ENCODE, allocator.get());
+            small = buffer.Data();
+            memset(small, 1, 16);
+        }
+        ScratchBuffer again(8, ScratchBuffer::ENCODE, allocator.get());
+        REQUIRE(again.Data() == small);
+        REQUIRE(again.Data()[15] == 1);
+        REQUIRE(ScratchBuffer::Cached(ScratchBuffer::MAX_CACHED_SIZE, ScratchBuffer::ENCODE) ==
+                small);
+    }
+
+    SECTION("large sizes are allocated") {
+        uint64_t size = ScratchBuffer::MAX_CACHED_SIZE + 1;
+        REQUIRE(ScratchBuffer::Cached(size, ScratchBuffer::ENCODE) == nullptr);
+        ScratchBuffer buffer(size, ScratchBuffer::ENCODE, allocator.get());
+        REQUIRE(buffer.Data() != nullptr);
+        REQUIRE(buffer.Data() != ScratchBuffer::Cached(1, ScratchBuffer::ENCODE));
+        memset(buffer.Data(), 2, size);
+    }
+
+    SECTION("slots and threads are independent") {
+        auto* first = ScratchBuffer::Cached(64, ScratchBuffer::READ_FIRST);
+        auto* second = ScratchBuffer::Cached(64, ScratchBuffer::READ_SECOND);
+        auto* codes = ScratchBuffer::Cached(64, ScratchBuffer::GET_CODES);
+        REQUIRE(first != second);
+        REQUIRE(first != codes);
+        uint8_t* other_thread = nullptr;
+        std::thread([&]() {
+            other_thread = ScratchBuffer::Cached(64, ScratchBuffer::READ_FIRST);
+        }).join();
+        REQUIRE(other_thread != first);
+    }
+}
@@ -337,6 +337,11 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::BruteForceTestIndex,
                     auto index2 = TestFactory(name, param, true);
                     TestSerializeReaderSet(index, index2, dataset, search_param, name, true);
                 }
+                if (index->CheckFeature(vsag::SUPPORT_SERIALIZE_WRITE_FUNC) and
+                    index->CheckFeature(vsag::SUPPORT_DESERIALIZE_BINARY_SET)) {
+                    auto index2 = TestFactory(name, param, true);
+                    TestSerializeWriteFunc(index, index2, dataset, search_param, true);
+                }
             }
             vsag::Options::Instance().set_block_size_limit(origin_size);
         }
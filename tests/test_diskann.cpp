@@ -16,6 +16,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <nlohmann/json.hpp>
@@ -140,6 +141,10 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::DiskANNTestIndex,
         auto index2 = TestFactory(name, param, true);
         TestSerializeReaderSet(index, index2, dataset, search_param, name, true);
     }
+    {
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeWriteFunc(index, index2, dataset, search_param, true);
+    }
     vsag::Options::Instance().set_block_size_limit(origin_size);
 }
 
@@ -652,3 +657,396 @@ TEST_CASE("split building process", "[ft][diskann]") {
     std::cout << "Recall: " << recall_full << std::endl;
     REQUIRE(recall_full == recall_partial);
 }
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::DiskANNTestIndex,
+                             "DiskANN Pipelined Search With Async IO",
+                             "[ft][diskann]") {
+    auto metric_type = GENERATE("l2", "ip");
+    const std::string name = "diskann";
+    auto dim = 128;
+    constexpr auto build_parameter_json = R"(
+        {{
+            "dtype": "float32",
+            "metric_type": "{}",
+            "dim": {},
+            "diskann": {{
+                "max_degree": 16,
+                "ef_construction": 200,
+                "pq_dims": 32,
+                "pq_sample_rate": 0.5,
+                "use_async_io": true
+            }}
+        }}
+    )";
+    auto param = fmt::format(build_parameter_json, metric_type, dim);
+    auto index = TestFactory(name, param, true);
+    auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+    TestBuildIndex(index, dataset, true);
+    TestKnnSearch(index, dataset, search_param, 0.99, true);
+    TestFilterSearch(index, dataset, search_param, 0.99, true);
+    {
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeReaderSet(index, index2, dataset, search_param, name, true);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::DiskANNTestIndex, "DiskANN Node Cache", "[ft][diskann]") {
+    auto metric_type = GENERATE("l2", "ip");
+    auto use_async_io = GENERATE(true, false);
+    const std::string name = "diskann";
+    auto dim = 128;
+    constexpr auto build_parameter_json = R"(
+        {{
+            "dtype": "float32",
+            "metric_type": "{}",
+            "dim": {},
+            "diskann": {{
+                "max_degree": 16,
+                "ef_construction": 200,
+                "pq_dims": 32,
+                "pq_sample_rate": 0.5,
+                "use_async_io": {},
+                "cache_size": 65536
+            }}
+        }}
+    )";
+    auto param = fmt::format(build_parameter_json, metric_type, dim, use_async_io);
+    auto index = TestFactory(name, param, true);
+    auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+    TestBuildIndex(index, dataset, true);
+    TestKnnSearch(index, dataset, search_param, 0.99, true);
+
+    auto cached = index->Feedback(dataset->query_, 1, search_param);
+    REQUIRE(cached.has_value());
+    REQUIRE(cached.value() > 0);
+    TestKnnSearch(index, dataset, search_param, 0.99, true);
+    auto stats = nlohmann::json::parse(index->GetStats());
+    REQUIRE(stats["knn_cache_hit"].get<float>() > 0);
+
+    {
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeBinarySet(index, index2, dataset, search_param, true);
+    }
+    {
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeReaderSet(index, index2, dataset, search_param, name, true);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::DiskANNTestIndex,
+                             "DiskANN Add And Remove",
+                             "[ft][diskann]") {
+    auto metric_type = GENERATE("l2", "ip");
+    const std::string name = "diskann";
+    auto dim = 128;
+    constexpr auto build_parameter_json = R"(
+        {{
+            "dtype": "float32",
+            "metric_type": "{}",
+            "dim": {},
+            "diskann": {{
+                "max_degree": 16,
+                "ef_construction": 200,
+                "pq_dims": 32,
+                "pq_sample_rate": 0.5,
+                "merge_threshold": 150
+            }}
+        }}
+    )";
+    auto param = fmt::format(build_parameter_json, metric_type, dim);
+    auto index = TestFactory(name, param, true);
+    auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+    const auto* ids = dataset->base_->GetIds();
+    const auto* vectors = dataset->base_->GetFloat32Vectors();
+    auto slice = [&](int64_t begin, int64_t end) {
+        auto base = vsag::Dataset::Make();
+        base->NumElements(end - begin)
+            ->Dim(dim)
+            ->Ids(ids + begin)
+            ->Float32Vectors(vectors + begin * dim)
+            ->Owner(false);
+        return base;
+    };
+
+    // build on a part of the base, the rest goes through the delta and the merges
+    int64_t build_count = base_count / 2;
+    REQUIRE(index->Build(slice(0, build_count)).has_value());
+    for (int64_t begin = build_count; begin < base_count; begin += 100) {
+        auto add_result = index->Add(slice(begin, std::min<int64_t>(begin + 100, base_count)));
+        REQUIRE(add_result.has_value());
+        REQUIRE(add_result.value().empty());
+    }
+    REQUIRE(index->GetNumElements() == base_count);
+    auto duplicate = index->Add(slice(0, 1));
+    REQUIRE(duplicate.has_value());
+    REQUIRE(duplicate.value().size() == 1);
+    TestKnnSearch(index, dataset, search_param, 0.95, true);
+
+    // removed ids are never returned
+    std::vector<int64_t> removed_ids;
+    for (int64_t i = 0; i < base_count; i += 10) {
+        REQUIRE(index->Remove(ids[i]).value());
+        removed_ids.push_back(ids[i]);
+    }
+    REQUIRE_FALSE(index->Remove(ids[0]).value());
+    REQUIRE(index->GetNumElements() == base_count - removed_ids.size());
+    for (int64_t i = 0; i < base_count; i += 10) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)->Dim(dim)->Float32Vectors(vectors + i * dim)->Owner(false);
+        auto result = index->KnnSearch(query, 10, search_param);
+        REQUIRE(result.has_value());
+        for (int64_t j = 0; j < result.value()->GetDim(); ++j) {
+            REQUIRE(std::find(removed_ids.begin(),
+                              removed_ids.end(),
+                              result.value()->GetIds()[j]) == removed_ids.end());
+        }
+    }
+
+    {
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeBinarySet(index, index2, dataset, search_param, true);
+        REQUIRE(index2->GetNumElements() == index->GetNumElements());
+    }
+    {
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeReaderSet(index, index2, dataset, search_param, name, true);
+        REQUIRE(index2->GetNumElements() == index->GetNumElements());
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::DiskANNTestIndex,
+                             "DiskANN Partitioned Build",
+                             "[ft][diskann]") {
+    auto metric_type = GENERATE("l2", "ip");
+    const std::string name = "diskann";
+    auto dim = 128;
+    // far below the memory of the whole graph, forces several kmeans partitions
+    constexpr auto build_parameter_json = R"(
+        {{
+            "dtype": "float32",
+            "metric_type": "{}",
+            "dim": {},
+            "diskann": {{
+                "max_degree": 16,
+                "ef_construction": 200,
+                "pq_dims": 32,
+                "pq_sample_rate": 0.5,
+                "build_memory_budget": 300000
+            }}
+        }}
+    )";
+    auto param = fmt::format(build_parameter_json, metric_type, dim);
+    auto index = TestFactory(name, param, true);
+    auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+    TestBuildIndex(index, dataset, true);
+    TestKnnSearch(index, dataset, search_param, 0.95, true);
+    TestFilterSearch(index, dataset, search_param, 0.95, true);
+    {
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeBinarySet(index, index2, dataset, search_param, true);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::DiskANNTestIndex,
+                             "DiskANN Continue Build In Shard Rounds",
+                             "[ft][diskann]") {
+    auto metric_type = GENERATE("l2", "ip");
+    const std::string name = "diskann";
+    auto dim = 32;
+    // enough points for several shards per round
+    int64_t count = 6000;
+    auto param = GenerateDiskANNBuildParametersString(metric_type, dim);
+    auto index = TestFactory(name, param, true);
+    auto dataset = pool.GetDatasetAndCreate(dim, count, metric_type);
+
+    vsag::Index::Checkpoint checkpoint;
+    int64_t max_shard_sections = 0;
+    while (not checkpoint.finish) {
+        auto previous = checkpoint.data;
+        auto result = index->ContinueBuild(dataset->base_, previous);
+        REQUIRE(result.has_value());
+        checkpoint = result.value();
+        int64_t shard_sections = 0;
+        for (const auto& key : checkpoint.data.GetKeys()) {
+            if (key.rfind("shard_graph_", 0) != 0) {
+                continue;
+            }
+            shard_sections++;
+            // sections of earlier rounds are carried over instead of being rewritten
+            auto previous_section = previous.Get(key);
+            if (previous_section.data != nullptr) {
+                REQUIRE(previous_section.data == checkpoint.data.Get(key).data);
+            }
+        }
+        max_shard_sections = std::max(max_shard_sections, shard_sections);
+    }
+    REQUIRE(max_shard_sections > 1);
+    TestKnnSearch(index, dataset, search_param, 0.9, true);
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::DiskANNTestIndex,
+                             "DiskANN Continue Build Resumes From A Graph Round",
+                             "[ft][diskann]") {
+    auto metric_type = GENERATE("l2", "ip");
+    const std::string name = "diskann";
+    auto dim = 32;
+    int64_t count = 6000;
+    auto param = GenerateDiskANNBuildParametersString(metric_type, dim);
+    auto dataset = pool.GetDatasetAndCreate(dim, count, metric_type);
+
+    // build until the first graph round has written its shards
+    auto index = TestFactory(name, param, true);
+    vsag::Index::Checkpoint checkpoint;
+    auto has_shard_sections = [](const vsag::BinarySet& binary_set) {
+        for (const auto& key : binary_set.GetKeys()) {
+            if (key.rfind("shard_graph_", 0) == 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+    while (not has_shard_sections(checkpoint.data)) {
+        auto result = index->ContinueBuild(dataset->base_, checkpoint.data);
+        REQUIRE(result.has_value());
+        checkpoint = result.value();
+        REQUIRE_FALSE(checkpoint.finish);
+    }
+
+    // a preempted job reloads the persisted sections into a fresh index
+    vsag::BinarySet persisted;
+    for (const auto& key : checkpoint.data.GetKeys()) {
+        auto binary = checkpoint.data.Get(key);
+        vsag::Binary copy{
+            .data = std::shared_ptr<int8_t[]>(new int8_t[binary.size]),
+            .size = binary.size,
+        };
+        std::memcpy(copy.data.get(), binary.data.get(), binary.size);
+        persisted.Set(key, copy);
+    }
+    auto resumed = TestFactory(name, param, true);
+    checkpoint.data = persisted;
+    while (not checkpoint.finish) {
+        auto result = resumed->ContinueBuild(dataset->base_, checkpoint.data);
+        REQUIRE(result.has_value());
+        checkpoint = result.value();
+    }
+    TestKnnSearch(resumed, dataset, search_param, 0.9, true);
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::DiskANNTestIndex,
+                             "DiskANN Filter Search With Entry Ids",
+                             "[ft][diskann]") {
+    auto metric_type = GENERATE("l2", "ip");
+    const std::string name = "diskann";
+    auto dim = 128;
+    auto param = GenerateDiskANNBuildParametersString(metric_type, dim);
+    auto index = TestFactory(name, param, true);
+    auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+    TestBuildIndex(index, dataset, true);
+
+    // a selective label: only every 50th point passes the filter
+    const auto* ids = dataset->base_->GetIds();
+    const auto* vectors = dataset->base_->GetFloat32Vectors();
+    std::vector<int64_t> label_ids;
+    for (int64_t i = 0; i < base_count; i += 50) {
+        label_ids.push_back(ids[i]);
+    }
+    auto filter = [&label_ids](int64_t id) -> bool {
+        return std::find(label_ids.begin(), label_ids.end(), id) == label_ids.end();
+    };
+    auto search_param_json = nlohmann::json::parse(search_param);
+    search_param_json["diskann"]["entry_ids"] = label_ids;
+    auto entry_search_param = search_param_json.dump();
+
+    int64_t topk = 5;
+    for (int64_t i = 0; i < base_count; i += 50) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)->Dim(dim)->Float32Vectors(vectors + i * dim)->Owner(false);
+        auto result = index->KnnSearch(query, topk, entry_search_param, filter);
+        REQUIRE(result.has_value());
+        REQUIRE(result.value()->GetDim() == topk);
+        for (int64_t j = 0; j < result.value()->GetDim(); ++j) {
+            REQUIRE_FALSE(filter(result.value()->GetIds()[j]));
+        }
+        // the query itself carries the label, so it is the nearest valid point
+        if (std::string(metric_type) == "l2") {
+            REQUIRE(result.value()->GetIds()[0] == ids[i]);
+        }
+    }
+
+    // ids unknown to the index are ignored
+    search_param_json["diskann"]["entry_ids"] = std::vector<int64_t>{-1, -2};
+    auto query = vsag::Dataset::Make();
+    query->NumElements(1)->Dim(dim)->Float32Vectors(vectors)->Owner(false);
+    auto result = index->KnnSearch(query, topk, search_param_json.dump(), filter);
+    REQUIRE(result.has_value());
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::DiskANNTestIndex,
+                             "DiskANN Compact Sector Layout",
+                             "[ft][diskann]") {
+    auto metric_type = GENERATE("l2", "ip", "cosine");
+    auto sector_vector_type = GENERATE("fp16", "sq8");
+    const std::string name = "diskann";
+    auto dim = 128;
+    constexpr auto build_parameter_json = R"(
+        {{
+            "dtype": "float32",
+            "metric_type": "{}",
+            "dim": {},
+            "diskann": {{
+                "max_degree": 16,
+                "ef_construction": 200,
+                "pq_dims": 32,
+                "pq_sample_rate": 0.5,
+                "sector_vector_type": "{}"
+            }}
+        }}
+    )";
+    auto param = fmt::format(build_parameter_json, metric_type, dim, sector_vector_type);
+    auto index = TestFactory(name, param, true);
+    auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+    TestBuildIndex(index, dataset, true);
+    // the final candidates are reranked with full precision, so the recall holds
+    TestKnnSearch(index, dataset, search_param, 0.95, true);
+    TestFilterSearch(index, dataset, search_param, 0.95, true);
+    {
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeBinarySet(index, index2, dataset, search_param, true);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::DiskANNTestIndex,
+                             "DiskANN Concurrent Search With Shared IO",
+                             "[ft][diskann]") {
+    auto metric_type = GENERATE("l2", "ip");
+    auto use_async_io = GENERATE(true, false);
+    const std::string name = "diskann";
+    auto dim = 128;
+    constexpr auto build_parameter_json = R"(
+        {{
+            "dtype": "float32",
+            "metric_type": "{}",
+            "dim": {},
+            "diskann": {{
+                "max_degree": 16,
+                "ef_construction": 200,
+                "pq_dims": 32,
+                "pq_sample_rate": 0.5,
+                "use_async_io": {}
+            }}
+        }}
+    )";
+    auto param = fmt::format(build_parameter_json, metric_type, dim, use_async_io);
+    auto index = TestFactory(name, param, true);
+    auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+    TestBuildIndex(index, dataset, true);
+    TestConcurrentKnnSearch(index, dataset, search_param, 0.99, true);
+
+    auto stats = nlohmann::json::parse(index->GetStats());
+    REQUIRE(stats[vsag::STATSTIC_IO_DEVICE_READS].get<uint64_t>() > 0);
+    REQUIRE(stats[vsag::STATSTIC_IO_MAX_QUEUE_DEPTH].get<uint64_t>() > 0);
+    REQUIRE(stats[vsag::STATSTIC_IO_QUEUE_DEPTH].get<uint64_t>() == 0);
+    REQUIRE(stats.contains(vsag::STATSTIC_IO_SHARED_READS));
+    REQUIRE(stats.contains(vsag::STATSTIC_IO_COALESCED_READS));
+}
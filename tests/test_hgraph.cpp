@@ -17,9 +17,12 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <cstring>
 #include <limits>
+#include <sstream>
 
 #include "fixtures/test_dataset_pool.h"
+#include "fixtures/test_reader.h"
 #include "test_index.h"
 #include "vsag/options.h"
 
@@ -45,7 +48,11 @@ public:
         }})";
 
     const std::vector<std::pair<std::string, float>> test_cases = {
-        {"sq8_uniform,fp32", 0.98}, {"sq8", 0.95}, {"fp32", 0.99}, {"sq8_uniform", 0.95}};
+        {"sq8_uniform,fp32", 0.98},
+        {"sq4_uniform,sq8,fp32", 0.95},
+        {"sq8", 0.95},
+        {"fp32", 0.99},
+        {"sq8_uniform", 0.95}};
 };
 
 TestDatasetPool HgraphTestIndex::pool{};
@@ -69,11 +76,18 @@ HgraphTestIndex::GenerateHGraphBuildParametersString(const std::string& metric_t
             "max_degree": 96,
             "ef_construction": 500,
             "build_thread_count": {},
-            "precise_quantization_type": "{}"
+            "precise_quantization_type": "{}",
+            "rerank_stages": [{}]
         }}
     }}
     )";
 
+    constexpr auto rerank_stage_temp = R"(
+            {{
+                "quantization_type": "{}",
+                "candidate_factor": 4
+            }})";
+
     constexpr auto parameter_temp_origin = R"(
     {{
         "dtype": "float32",
@@ -92,14 +106,23 @@ HgraphTestIndex::GenerateHGraphBuildParametersString(const std::string& metric_t
     std::string high_quantizer_str;
     auto& base_quantizer_str = strs[0];
     if (strs.size() > 1) {
-        high_quantizer_str = strs[1];
+        // the last one is the precise codes, the middle ones are intermediate rerank stages
+        high_quantizer_str = strs.back();
+        std::string rerank_stages;
+        for (uint64_t i = 1; i + 1 < strs.size(); ++i) {
+            if (not rerank_stages.empty()) {
+                rerank_stages += ",";
+            }
+            rerank_stages += fmt::format(rerank_stage_temp, strs[i]);
+        }
         build_parameters_str = fmt::format(parameter_temp_reorder,
                                            metric_type,
                                            dim,
                                            true, /* reorder */
                                            base_quantizer_str,
                                            thread_count,
-                                           high_quantizer_str);
+                                           high_quantizer_str,
+                                           rerank_stages);
     } else {
         build_parameters_str =
             fmt::format(parameter_temp_origin, metric_type, dim, base_quantizer_str, thread_count);
@@ -232,6 +255,237 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex,
     }
 }
 
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex,
+                             "HGraph Build With Graph Reorder",
+                             "[ft][hgraph]") {
+    auto metric_type = GENERATE("l2", "ip");
+    std::string graph_reorder = GENERATE("bfs", "rcm");
+    bool colocate_graph = GENERATE(false, true);
+    constexpr auto parameter_temp = R"(
+    {{
+        "dtype": "float32",
+        "metric_type": "{}",
+        "dim": {},
+        "index_param": {{
+            "base_quantization_type": "fp32",
+            "max_degree": 32,
+            "ef_construction": 200,
+            "build_thread_count": 5,
+            "graph_reorder": "{}",
+            "colocate_graph": {}
+        }}
+    }}
+    )";
+
+    const std::string name = "hgraph";
+    auto search_param = fmt::format(search_param_tmp, 200);
+    for (auto& dim : dims) {
+        auto param = fmt::format(parameter_temp, metric_type, dim, graph_reorder, colocate_graph);
+        auto index = TestFactory(name, param, true);
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+        TestBuildIndex(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.95, true);
+        TestFilterSearch(index, dataset, search_param, 0.95, true);
+        TestCalcDistanceById(index, dataset);
+        TestCheckIdExist(index, dataset);
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeFile(index, index2, dataset, search_param, true);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex,
+                             "HGraph Build With Hugepage And Numa Interleave",
+                             "[ft][hgraph]") {
+    auto origin_size = vsag::Options::Instance().block_size_limit();
+    uint64_t size = 1024 * 1024 * 2;
+    auto metric_type = GENERATE("l2", "ip");
+    constexpr auto parameter_temp = R"(
+    {{
+        "dtype": "float32",
+        "metric_type": "{}",
+        "dim": {},
+        "index_param": {{
+            "use_reorder": true,
+            "base_quantization_type": "sq8",
+            "precise_quantization_type": "fp32",
+            "max_degree": 32,
+            "ef_construction": 200,
+            "build_thread_count": 5,
+            "use_hugepage": true,
+            "numa_interleave": true
+        }}
+    }}
+    )";
+
+    const std::string name = "hgraph";
+    auto search_param = fmt::format(search_param_tmp, 200);
+    for (auto& dim : dims) {
+        vsag::Options::Instance().set_block_size_limit(size);
+        auto param = fmt::format(parameter_temp, metric_type, dim);
+        auto index = TestFactory(name, param, true);
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+        TestBuildIndex(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.95, true);
+
+        // hugepages may be unavailable on the test machine, the index then uses the allocator
+        auto stats = nlohmann::json::parse(index->GetStats());
+        REQUIRE(stats[vsag::STATSTIC_DATA_NUM] == base_count);
+        REQUIRE(stats[vsag::STATSTIC_INDEX_NAME] == name);
+        REQUIRE(stats[vsag::STATSTIC_HUGEPAGE_MEMORY].get<uint64_t>() % size == 0);
+
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeFile(index, index2, dataset, search_param, true);
+        vsag::Options::Instance().set_block_size_limit(origin_size);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex,
+                             "HGraph Build With Tiered Precise Codes",
+                             "[ft][hgraph]") {
+    auto metric_type = GENERATE("l2", "ip", "cosine");
+    constexpr auto parameter_temp = R"(
+    {{
+        "dtype": "float32",
+        "metric_type": "{}",
+        "dim": {},
+        "index_param": {{
+            "use_reorder": true,
+            "base_quantization_type": "sq8",
+            "precise_quantization_type": "fp32",
+            "precise_io_type": "tiered_io",
+            "precise_io_hot_size": 65536,
+            "max_degree": 32,
+            "ef_construction": 200,
+            "build_thread_count": 5
+        }}
+    }}
+    )";
+
+    const std::string name = "hgraph";
+    auto search_param = fmt::format(search_param_tmp, 200);
+    for (auto& dim : dims) {
+        auto param = fmt::format(parameter_temp, metric_type, dim);
+        auto index = TestFactory(name, param, true);
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+        TestBuildIndex(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.95, true);
+        TestCalcDistanceById(index, dataset);
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeFile(index, index2, dataset, search_param, true);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex,
+                             "HGraph Build With Prefetch Tuning",
+                             "[ft][hgraph]") {
+    auto metric_type = GENERATE("l2", "ip");
+    std::string base_quantization_str = GENERATE("sq8", "fp32");
+    constexpr auto parameter_temp = R"(
+    {{
+        "dtype": "float32",
+        "metric_type": "{}",
+        "dim": {},
+        "index_param": {{
+            "base_quantization_type": "{}",
+            "max_degree": 32,
+            "ef_construction": 200,
+            "build_thread_count": 5,
+            "tune_prefetch": true
+        }}
+    }}
+    )";
+
+    const std::string name = "hgraph";
+    auto search_param = fmt::format(search_param_tmp, 200);
+    for (auto& dim : dims) {
+        auto param = fmt::format(parameter_temp, metric_type, dim, base_quantization_str);
+        auto index = TestFactory(name, param, true);
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+        TestBuildIndex(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.95, true);
+
+        auto stats = nlohmann::json::parse(index->GetStats());
+        REQUIRE(stats[vsag::STATSTIC_PREFETCH_JUMP_CODE_SIZE].get<uint32_t>() > 0);
+        REQUIRE(stats[vsag::STATSTIC_PREFETCH_CACHE_LINE_SIZE].get<uint32_t>() > 0);
+        REQUIRE(stats[vsag::STATSTIC_PREFETCH_NEIGHBOR_VISIT_NUM].get<uint32_t>() > 0);
+
+        // the tuned values are restored on load instead of being tuned again
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeFile(index, index2, dataset, search_param, true);
+        auto loaded_stats = nlohmann::json::parse(index2->GetStats());
+        for (const auto* key : {vsag::STATSTIC_PREFETCH_JUMP_CODE_SIZE,
+                                vsag::STATSTIC_PREFETCH_CACHE_LINE_SIZE,
+                                vsag::STATSTIC_PREFETCH_NEIGHBOR_VISIT_NUM}) {
+            REQUIRE(loaded_stats[key] == stats[key]);
+        }
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex,
+                             "HGraph Load Index Without Prefetch Trailer",
+                             "[ft][hgraph]") {
+    auto metric_type = GENERATE("l2", "ip");
+    constexpr auto parameter_temp = R"(
+    {{
+        "dtype": "float32",
+        "metric_type": "{}",
+        "dim": {},
+        "index_param": {{
+            "base_quantization_type": "sq8",
+            "max_degree": 32,
+            "ef_construction": 200,
+            "build_thread_count": 5,
+            "tune_prefetch": true
+        }}
+    }}
+    )";
+    // magic, jump_code_size, cache_line_size and neighbor_visit_num
+    constexpr uint64_t trailer_size = sizeof(uint64_t) + 3 * sizeof(uint32_t);
+
+    const std::string name = "hgraph";
+    auto search_param = fmt::format(search_param_tmp, 200);
+    for (auto& dim : dims) {
+        auto param = fmt::format(parameter_temp, metric_type, dim);
+        auto index = TestFactory(name, param, true);
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+        TestBuildIndex(index, dataset, true);
+
+        // an index written before the prefetch trailer existed ends after the route graphs
+        auto binary_set = index->Serialize();
+        REQUIRE(binary_set.has_value());
+        auto binary = binary_set.value().Get(vsag::INDEX_HGRAPH);
+        REQUIRE(binary.size > trailer_size);
+        vsag::Binary baseline{
+            .data = std::shared_ptr<int8_t[]>(new int8_t[binary.size - trailer_size]),
+            .size = binary.size - trailer_size,
+        };
+        std::memcpy(baseline.data.get(), binary.data.get(), baseline.size);
+        vsag::BinarySet baseline_set;
+        baseline_set.Set(vsag::INDEX_HGRAPH, baseline);
+        vsag::ReaderSet baseline_readers;
+        baseline_readers.Set(vsag::INDEX_HGRAPH, std::make_shared<fixtures::TestReader>(baseline));
+        std::stringstream baseline_stream;
+        baseline_stream.write(reinterpret_cast<const char*>(baseline.data.get()),
+                              static_cast<std::streamsize>(baseline.size));
+
+        std::vector<IndexPtr> loaded;
+        for (int i = 0; i < 3; ++i) {
+            loaded.emplace_back(TestFactory(name, param, true));
+        }
+        REQUIRE(loaded[0]->Deserialize(baseline_set).has_value());
+        REQUIRE(loaded[1]->Deserialize(baseline_readers).has_value());
+        REQUIRE(loaded[2]->Deserialize(baseline_stream).has_value());
+        for (const auto& index_to : loaded) {
+            // the configured values are kept instead of the tuned ones
+            auto stats = nlohmann::json::parse(index_to->GetStats());
+            REQUIRE(stats[vsag::STATSTIC_PREFETCH_JUMP_CODE_SIZE].get<uint32_t>() == 1);
+            REQUIRE(stats[vsag::STATSTIC_PREFETCH_CACHE_LINE_SIZE].get<uint32_t>() == 1);
+            REQUIRE(stats[vsag::STATSTIC_PREFETCH_NEIGHBOR_VISIT_NUM].get<uint32_t>() == 1);
+            TestKnnSearch(index_to, dataset, search_param, 0.95, true);
+        }
+    }
+}
+
 TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex,
                              "HGraph Build & ContinueAdd Test",
                              "[ft][hgraph]") {
@@ -438,6 +692,11 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex, "HGraph Serialize File",
                     auto index2 = TestFactory(name, param, true);
                     TestSerializeReaderSet(index, index2, dataset, search_param, name, true);
                 }
+                if (index->CheckFeature(vsag::SUPPORT_SERIALIZE_WRITE_FUNC) and
+                    index->CheckFeature(vsag::SUPPORT_DESERIALIZE_BINARY_SET)) {
+                    auto index2 = TestFactory(name, param, true);
+                    TestSerializeWriteFunc(index, index2, dataset, search_param, true);
+                }
             }
             vsag::Options::Instance().set_block_size_limit(origin_size);
         }
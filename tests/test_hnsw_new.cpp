@@ -270,6 +270,41 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::HNSWTestIndex, "HNSW Build", "[ft][hnsw]"
     vsag::Options::Instance().set_block_size_limit(origin_size);
 }
 
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HNSWTestIndex,
+                             "HNSW Build With Graph Reorder",
+                             "[ft][hnsw]") {
+    auto metric_type = GENERATE("l2", "cosine");
+    std::string graph_reorder = GENERATE("bfs", "rcm");
+    // fresh_hnsw keeps reversed edges, they are renumbered as well
+    std::string name = GENERATE("hnsw", "fresh_hnsw");
+    constexpr auto parameter_temp = R"(
+    {{
+        "dtype": "float32",
+        "metric_type": "{}",
+        "dim": {},
+        "{}": {{
+            "max_degree": 32,
+            "ef_construction": 200,
+            "graph_reorder": "{}"
+        }}
+    }}
+    )";
+
+    auto search_param = fmt::format(search_param_tmp, 100);
+    for (auto& dim : dims) {
+        auto param = fmt::format(parameter_temp, metric_type, dim, name, graph_reorder);
+        auto index = TestFactory(name, param, true);
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+        TestBuildIndex(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.99, true);
+        TestFilterSearch(index, dataset, search_param, 0.99, true);
+        TestCalcDistanceById(index, dataset);
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeFile(index, index2, dataset, search_param, true);
+        TestUpdateId(index, dataset, search_param, true);
+    }
+}
+
 TEST_CASE_PERSISTENT_FIXTURE(fixtures::HNSWTestIndex, "HNSW Merge", "[ft][hnsw]") {
     auto origin_size = vsag::Options::Instance().block_size_limit();
     auto size = GENERATE(1024 * 1024 * 2);
@@ -488,6 +523,11 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::HNSWTestIndex, "static HNSW Serialize Fil
         auto index2 = TestFactory(name, param, true);
         TestSerializeReaderSet(index, index2, dataset, search_param, name, true);
     }
+    if (index->CheckFeature(vsag::SUPPORT_SERIALIZE_WRITE_FUNC) and
+        index->CheckFeature(vsag::SUPPORT_DESERIALIZE_BINARY_SET)) {
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeWriteFunc(index, index2, dataset, search_param, true);
+    }
     vsag::Options::Instance().set_block_size_limit(origin_size);
 }
 
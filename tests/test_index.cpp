@@ -603,6 +603,79 @@ TestIndex::TestSerializeBinarySet(const IndexPtr& index_from,
     }
 }
 
+void
+TestIndex::TestSerializeWriteFunc(const IndexPtr& index_from,
+                                  const IndexPtr& index_to,
+                                  const TestDatasetPtr& dataset,
+                                  const std::string& search_param,
+                                  bool expected_success) {
+    std::vector<int8_t> buffer;
+    auto write_func = [&buffer](uint64_t offset, uint64_t size, void* data) {
+        REQUIRE(offset == buffer.size());
+        auto* begin = reinterpret_cast<int8_t*>(data);
+        buffer.insert(buffer.end(), begin, begin + size);
+    };
+    auto serialize_result = index_from->Serialize(write_func);
+    REQUIRE(serialize_result.has_value() == expected_success);
+    if (not expected_success) {
+        return;
+    }
+    REQUIRE(index_from->CalSerializeSize() == buffer.size());
+
+    // the written sections hold the same keys and bytes as the binaryset
+    vsag::BinarySet binary_set;
+    uint64_t offset = 0;
+    while (offset < buffer.size()) {
+        size_t key_size = 0;
+        memcpy(&key_size, buffer.data() + offset, sizeof(size_t));
+        offset += sizeof(size_t);
+        std::string key(reinterpret_cast<const char*>(buffer.data() + offset), key_size);
+        offset += key_size;
+        vsag::Binary binary;
+        memcpy(&binary.size, buffer.data() + offset, sizeof(size_t));
+        offset += sizeof(size_t);
+        binary.data.reset(new int8_t[binary.size]);
+        memcpy(binary.data.get(), buffer.data() + offset, binary.size);
+        offset += binary.size;
+        binary_set.Set(key, binary);
+    }
+    REQUIRE(offset == buffer.size());
+    auto serialize_binary = index_from->Serialize();
+    REQUIRE(serialize_binary.has_value());
+    auto keys = serialize_binary.value().GetKeys();
+    REQUIRE(binary_set.GetKeys().size() == keys.size());
+    for (const auto& key : keys) {
+        auto expected = serialize_binary.value().Get(key);
+        auto written = binary_set.Get(key);
+        REQUIRE(written.size == expected.size);
+        REQUIRE(memcmp(written.data.get(), expected.data.get(), expected.size) == 0);
+    }
+
+    auto deserialize_index = index_to->Deserialize(binary_set);
+    REQUIRE(deserialize_index.has_value());
+
+    const auto& queries = dataset->query_;
+    auto query_count = queries->GetNumElements();
+    auto dim = queries->GetDim();
+    auto topk = 10;
+    for (auto i = 0; i < query_count; ++i) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)
+            ->Dim(dim)
+            ->Paths(queries->GetPaths() + i)
+            ->Float32Vectors(queries->GetFloat32Vectors() + i * dim)
+            ->Owner(false);
+        auto res_from = index_from->KnnSearch(query, topk, search_param);
+        auto res_to = index_to->KnnSearch(query, topk, search_param);
+        REQUIRE(res_from.has_value());
+        REQUIRE(res_to.has_value());
+        REQUIRE(res_from.value()->GetDim() == res_to.value()->GetDim());
+        for (auto j = 0; j < topk; ++j) {
+            REQUIRE(res_to.value()->GetIds()[j] == res_from.value()->GetIds()[j]);
+        }
+    }
+}
+
 void
 TestIndex::TestSerializeReaderSet(const IndexPtr& index_from,
                                   const IndexPtr& index_to,
@@ -136,6 +136,13 @@ protected:
                            const std::string& search_param,
                            bool expected_success = true);
 
+    static void
+    TestSerializeWriteFunc(const IndexPtr& index_from,
+                           const IndexPtr& index_to,
+                           const TestDatasetPtr& dataset,
+                           const std::string& search_param,
+                           bool expected_success = true);
+
     static void
     TestSerializeReaderSet(const IndexPtr& index_from,
                            const IndexPtr& index_to,
@@ -111,6 +111,10 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::PyramidTestIndex,
             auto index2 = TestFactory(name, param, true);
             TestSerializeReaderSet(index, index2, dataset, search_param, name, true);
         }
+        SECTION("serialize/deserialize by write func") {
+            auto index2 = TestFactory(name, param, true);
+            TestSerializeWriteFunc(index, index2, dataset, search_param, true);
+        }
     }
     vsag::Options::Instance().set_block_size_limit(origin_size);
 }
\ No newline at end of file